@@ -222,9 +222,11 @@ endif()
 if (NOT MUSE_ENABLE_UNIT_TESTS)
 
     set(MUE_BUILD_BRAILLE_TESTS OFF)
+    set(MUE_BUILD_CONVERTER_TESTS OFF)
     set(MUE_BUILD_ENGRAVING_TESTS OFF)
     set(MUE_BUILD_IMPORTEXPORT_TESTS OFF)
     set(MUE_BUILD_NOTATION_TESTS OFF)
+    set(MUE_BUILD_PALETTE_TESTS OFF)
     set(MUE_BUILD_PLAYBACK_TESTS OFF)
     set(MUE_BUILD_PROJECT_TESTS OFF)
 
@@ -19,7 +19,8 @@ enum class ConvertType {
     ExportScorePartsPdf,
     ExportScoreTranspose,
     SourceUpdate,
-    ExportScoreVideo
+    ExportScoreVideo,
+    Serve
 };
 
 enum class DiagnosticType {
@@ -38,6 +39,8 @@ struct CmdOptions {
         ScoreTransposeOptions,
         ForceMode,
         SoundProfile,
+        ScoreMediaPipelined,
+        ServeSocketName,
 
         // Video
     };
@@ -90,6 +93,7 @@ struct CmdOptions {
     struct {
         std::optional<bool> revertToFactorySettings;
         std::optional<muse::logger::Level> loggerLevel;
+        std::optional<muse::io::path_t> traceOutputPath;
     } app;
 
     struct {
@@ -68,6 +68,9 @@ void CommandLineParser::init()
 
     m_parser.addOption(QCommandLineOption("long-version", "Print detailed version information"));
     m_parser.addOption(QCommandLineOption({ "d", "debug" }, "Debug mode"));
+    m_parser.addOption(QCommandLineOption("trace-out",
+                                          "Record a timeline of the traced functions and write it to 'file' in Chrome trace event format",
+                                          "file"));
 
     m_parser.addOption(QCommandLineOption({ "D", "monitor-resolution" }, "Specify monitor resolution", "DPI"));
     m_parser.addOption(QCommandLineOption({ "T", "trim-image" },
@@ -84,6 +87,9 @@ void CommandLineParser::init()
     // Converter mode
     m_parser.addOption(QCommandLineOption({ "r", "image-resolution" }, "Set output resolution for image export", "DPI"));
     m_parser.addOption(QCommandLineOption({ "j", "job" }, "Process a conversion job", "file"));
+    m_parser.addOption(QCommandLineOption("serve", "Keep running and process conversion jobs, one JSON object per line, from stdin"));
+    m_parser.addOption(QCommandLineOption("serve-socket",
+                                          "Use with '--serve', process the conversion jobs from a local socket instead of stdin", "name"));
     m_parser.addOption(QCommandLineOption({ "o", "export-to" }, "Export to 'file'. Format depends on file's extension", "file"));
     m_parser.addOption(QCommandLineOption({ "F", "factory-settings" }, "Use factory settings"));
     m_parser.addOption(QCommandLineOption({ "R", "revert-settings" }, "Revert to factory settings, but keep default preferences"));
@@ -95,6 +101,8 @@ void CommandLineParser::init()
     m_parser.addOption(QCommandLineOption("score-media",
                                           "Export all media (excepting mp3) for a given score in a single JSON file and print it to stdout"));
     m_parser.addOption(QCommandLineOption("highlight-config", "Set highlight to svg, generated from a given score", "highlight-config"));
+    m_parser.addOption(QCommandLineOption("score-media-pipelined",
+                                          "Use with '--score-media', encode the media on worker threads and report per-writer timings"));
     m_parser.addOption(QCommandLineOption("score-meta", "Export score metadata to JSON document and print it to stdout"));
     m_parser.addOption(QCommandLineOption("score-parts", "Generate parts data for the given score and save them to separate mscz files"));
     m_parser.addOption(QCommandLineOption("score-parts-pdf",
@@ -212,6 +220,10 @@ void CommandLineParser::parse(int argc, char** argv)
         m_options.app.loggerLevel = logger::Level::Debug;
     }
 
+    if (m_parser.isSet("trace-out")) {
+        m_options.app.traceOutputPath = fromUserInputPath(m_parser.value("trace-out"));
+    }
+
     if (m_parser.isSet("D")) {
         std::optional<double> val = doubleValue("D");
         if (val) {
@@ -307,6 +319,14 @@ void CommandLineParser::parse(int argc, char** argv)
         m_options.converterTask.inputFile = fromUserInputPath(m_parser.value("j"));
     }
 
+    if (m_parser.isSet("serve") || m_parser.isSet("serve-socket")) {
+        m_options.runMode = IApplication::RunMode::ConsoleApp;
+        m_options.converterTask.type = ConvertType::Serve;
+        if (m_parser.isSet("serve-socket")) {
+            m_options.converterTask.params[CmdOptions::ParamKey::ServeSocketName] = m_parser.value("serve-socket");
+        }
+    }
+
     if (m_parser.isSet("score-media")) {
         m_options.runMode = IApplication::RunMode::ConsoleApp;
         m_options.converterTask.type = ConvertType::ExportScoreMedia;
@@ -315,6 +335,9 @@ void CommandLineParser::parse(int argc, char** argv)
             m_options.converterTask.params[CmdOptions::ParamKey::HighlightConfigPath]
                 = fromUserInputPath(m_parser.value("highlight-config"));
         }
+        if (m_parser.isSet("score-media-pipelined")) {
+            m_options.converterTask.params[CmdOptions::ParamKey::ScoreMediaPipelined] = true;
+        }
     }
 
     if (m_parser.isSet("score-meta")) {
@@ -259,6 +259,10 @@ void ConsoleApp::applyCommandLineOptions(const CmdOptions& options, IApplication
     if (options.app.loggerLevel) {
         m_globalModule.setLoggerLevel(options.app.loggerLevel.value());
     }
+
+    if (options.app.traceOutputPath) {
+        m_globalModule.setTraceOutputPath(options.app.traceOutputPath.value());
+    }
 }
 
 int ConsoleApp::processConverter(const CmdOptions::ConverterTask& task)
@@ -277,6 +281,10 @@ int ConsoleApp::processConverter(const CmdOptions::ConverterTask& task)
     case ConvertType::Batch:
         ret = converter()->batchConvert(task.inputFile, stylePath, forceMode, soundProfile);
         break;
+    case ConvertType::Serve: {
+        muse::io::path_t socketName = task.params[CmdOptions::ParamKey::ServeSocketName].toString();
+        ret = converter()->serve(socketName, stylePath, forceMode, soundProfile);
+    } break;
     case ConvertType::File:
         ret = converter()->fileConvert(task.inputFile, task.outputFile, stylePath, forceMode, soundProfile);
         break;
@@ -285,7 +293,8 @@ int ConsoleApp::processConverter(const CmdOptions::ConverterTask& task)
         break;
     case ConvertType::ExportScoreMedia: {
         muse::io::path_t highlightConfigPath = task.params[CmdOptions::ParamKey::HighlightConfigPath].toString();
-        ret = converter()->exportScoreMedia(task.inputFile, task.outputFile, highlightConfigPath, stylePath, forceMode);
+        bool pipelined = task.params[CmdOptions::ParamKey::ScoreMediaPipelined].toBool();
+        ret = converter()->exportScoreMedia(task.inputFile, task.outputFile, highlightConfigPath, stylePath, forceMode, pipelined);
     } break;
     case ConvertType::ExportScoreMeta:
         ret = converter()->exportScoreMeta(task.inputFile, task.outputFile, stylePath, forceMode);
@@ -251,4 +251,8 @@ void GuiApp::applyCommandLineOptions(const CmdOptions& options)
     if (options.app.loggerLevel) {
         m_globalModule.setLoggerLevel(options.app.loggerLevel.value());
     }
+
+    if (options.app.traceOutputPath) {
+        m_globalModule.setTraceOutputPath(options.app.traceOutputPath.value());
+    }
 }
@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "braillemeasurecache.h"
+
+#include "containers.h"
+
+#include "engraving/dom/measure.h"
+
+using namespace mu::engraving;
+
+static bool isStructuralChange(const ScoreChangesRange& range)
+{
+    //! NOTE: measures may have been added, removed or replaced,
+    //! so the cached pointers can no longer be trusted
+    static const ElementType STRUCTURAL_TYPES[] = {
+        ElementType::MEASURE,
+        ElementType::MMREST,
+        ElementType::PART,
+        ElementType::STAFF,
+        ElementType::INSTRUMENT_CHANGE,
+    };
+
+    for (ElementType type : STRUCTURAL_TYPES) {
+        if (muse::contains(range.changedTypes, type)) {
+            return true;
+        }
+    }
+
+    return !range.changedStyleIdSet.empty();
+}
+
+const BrailleEngravingItemList& BrailleMeasureCache::measureItems(Score* score, Measure* measure)
+{
+    auto it = m_entries.find(measure);
+    if (it != m_entries.end()) {
+        return it->second.items;
+    }
+
+    Entry& entry = m_entries[measure];
+    entry.tickFrom = measure->tick().ticks();
+    entry.tickTo = measure->endTick().ticks();
+
+    Braille lb(score);
+    lb.convertMeasure(measure, &entry.items);
+
+    return entry.items;
+}
+
+void BrailleMeasureCache::invalidate(const ScoreChangesRange& range)
+{
+    if (!range.isValidBoundary() || isStructuralChange(range)) {
+        clear();
+        return;
+    }
+
+    //! NOTE: boundaries are inclusive, a change at the barline touches both neighbours
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        const Entry& entry = it->second;
+        if (entry.tickFrom <= range.tickTo && entry.tickTo >= range.tickFrom) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void BrailleMeasureCache::clear()
+{
+    m_entries.clear();
+}
+
+size_t BrailleMeasureCache::size() const
+{
+    return m_entries.size();
+}
+
+bool BrailleMeasureCache::contains(const Measure* measure) const
+{
+    return m_entries.find(measure) != m_entries.end();
+}
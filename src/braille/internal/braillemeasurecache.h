@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_BRAILLE_BRAILLEMEASURECACHE_H
+#define MU_BRAILLE_BRAILLEMEASURECACHE_H
+
+#include <map>
+
+#include "engraving/dom/types.h"
+
+#include "braille.h"
+
+namespace mu::engraving {
+class Measure;
+class Score;
+
+//! NOTE: Caches the live braille translation of each measure.
+//! Every measure is translated with a fresh Braille context (see NotationBraille::doBraille),
+//! so the result only depends on the measure itself and on the spanners overlapping it.
+//! Entries are dropped when a change touches the measure's tick range.
+class BrailleMeasureCache
+{
+public:
+    const BrailleEngravingItemList& measureItems(Score* score, Measure* measure);
+
+    void invalidate(const ScoreChangesRange& range);
+    void clear();
+
+    size_t size() const;
+    bool contains(const Measure* measure) const;
+
+private:
+    struct Entry {
+        int tickFrom = 0;
+        int tickTo = 0;
+        BrailleEngravingItemList items;
+    };
+
+    std::map<const Measure*, Entry> m_entries;
+};
+}
+
+#endif // MU_BRAILLE_BRAILLEMEASURECACHE_H
@@ -66,6 +66,7 @@ void NotationBraille::init()
     updateTableForLyricsFromPreferences();
     brailleConfiguration()->brailleTableChanged().onNotify(this, [this]() {
         updateTableForLyricsFromPreferences();
+        m_measureCache.clear();
     });
 
     setIntervalDirection(brailleConfiguration()->intervalDirection());
@@ -75,7 +76,14 @@ void NotationBraille::init()
     });
 
     globalContext()->currentNotationChanged().onNotify(this, [this]() {
+        m_measureCache.clear();
+        current_measure = nullptr;
+
         if (notation()) {
+            notation()->undoStack()->changesChannel().onReceive(this, [this](const ChangesRange& range) {
+                m_measureCache.invalidate(range);
+            });
+
             notation()->interaction()->selectionChanged().onNotify(this, [this]() {
                 doBraille();
             });
@@ -169,9 +177,7 @@ void NotationBraille::doBraille(bool force)
                 current_measure = nullptr;
             } else {
                 if (m != current_measure || force) {
-                    brailleEngravingItemList()->clear();
-                    Braille lb(score());
-                    lb.convertMeasure(m, brailleEngravingItemList());
+                    m_beil = m_measureCache.measureItems(score(), m);
                     setBrailleInfo(brailleEngravingItemList()->brailleStr());
                     current_measure = m;
                 }
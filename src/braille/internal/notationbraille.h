@@ -36,6 +36,7 @@
 
 #include "braille.h"
 #include "brailleinput.h"
+#include "braillemeasurecache.h"
 
 namespace mu::engraving {
 class Score;
@@ -118,6 +119,7 @@ private:
     EngravingItem* current_engraving_item = nullptr;
     BrailleEngravingItem* current_bei = nullptr;
     BrailleEngravingItemList m_beil;
+    BrailleMeasureCache m_measureCache;
     BrailleInputState m_braille_input;
 
     muse::ValCh<std::string> m_brailleInfo;
@@ -28,7 +28,9 @@
 #include "engraving/tests/utils/scorecomp.h"
 
 #include "engraving/dom/masterscore.h"
+#include "engraving/dom/measure.h"
 #include "../internal/braille.h"
+#include "../internal/braillemeasurecache.h"
 
 using namespace mu;
 using namespace mu::engraving;
@@ -244,3 +246,48 @@ TEST_F(Braille_Tests, hairpins) {
 TEST_F(Braille_Tests, sectionBreak) {
     brailleSaveTest("testSectionBreak");
 }
+
+TEST_F(Braille_Tests, measureCache) {
+    MasterScore* score = ScoreRW::readScore(BRAILLE_DIR + u"testPitches.mscx", false);
+    ASSERT_TRUE(score);
+    fixupScore(score);
+    score->doLayout();
+
+    Measure* first = score->firstMeasure();
+    ASSERT_TRUE(first);
+    Measure* second = first->nextMeasure();
+    ASSERT_TRUE(second);
+
+    BrailleMeasureCache cache;
+
+    // [GIVEN] The cached translation matches the direct one
+    BrailleEngravingItemList expected;
+    Braille(score).convertMeasure(first, &expected);
+
+    BrailleEngravingItemList cached = cache.measureItems(score, first);
+    EXPECT_EQ(cached.brailleStr(), expected.brailleStr());
+    EXPECT_EQ(cached.items()->size(), expected.items()->size());
+
+    cache.measureItems(score, second);
+    EXPECT_EQ(cache.size(), 2u);
+
+    // [WHEN] A change touches only the second measure
+    ScoreChangesRange range;
+    range.tickFrom = second->tick().ticks() + 1;
+    range.tickTo = second->endTick().ticks() - 1;
+    range.staffIdxFrom = 0;
+    range.staffIdxTo = 0;
+    cache.invalidate(range);
+
+    // [THEN] Only the second measure is dropped
+    EXPECT_TRUE(cache.contains(first));
+    EXPECT_FALSE(cache.contains(second));
+
+    // [WHEN] The change range is unknown
+    cache.invalidate(ScoreChangesRange());
+
+    // [THEN] Everything is dropped
+    EXPECT_EQ(cache.size(), 0u);
+
+    delete score;
+}
@@ -41,6 +41,9 @@ enum class Err {
 
     OutFileFailedOpen = 1330,
     OutFileFailedWrite = 1331,
+
+    ServeFailedListen = 1340,
+    ServeFailedOpenOutput = 1341,
 };
 
 inline muse::Ret make_ret(Err e)
@@ -40,12 +40,20 @@ public:
                                    const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
                                    const muse::String& soundProfile = muse::String()) = 0;
 
+    //! NOTE Converts the jobs of a local socket, or of stdin when there is no socket name, until it is asked to quit.
+    //! Every line is a job object, with the same fields as the ones of a batch job file,
+    //! and every job is answered with a line of JSON
+    virtual muse::Ret serve(const muse::io::path_t& socketName = muse::io::path_t(),
+                            const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
+                            const muse::String& soundProfile = muse::String()) = 0;
+
     virtual muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                         const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) = 0;
 
     virtual muse::Ret exportScoreMedia(const muse::io::path_t& in, const muse::io::path_t& out,
                                        const muse::io::path_t& highlightConfigPath = muse::io::path_t(),
-                                       const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) = 0;
+                                       const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
+                                       bool pipelined = false) = 0;
     virtual muse::Ret exportScoreMeta(const muse::io::path_t& in, const muse::io::path_t& out,
                                       const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) = 0;
     virtual muse::Ret exportScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
@@ -22,14 +22,18 @@
 #include "backendapi.h"
 
 #include <stdio.h>
+#include <deque>
+#include <future>
 
 #include <QString>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
 #include <QRandomGenerator>
 
+#include "concurrency/taskscheduler.h"
 #include "io/buffer.h"
 
 #include "engraving/infrastructure/mscwriter.h"
@@ -61,17 +65,173 @@ static const std::string MUSICXML_WRITER_NAME = "mxl";
 static const std::string MUSICXML_JSON_NAME = "mxml";
 static const std::string META_DATA_NAME = "metadata";
 static const std::string DEV_INFO_NAME = "devinfo";
+static const std::string TIMINGS_NAME = "timings";
 
 static constexpr bool ADD_SEPARATOR = true;
 static constexpr auto NO_STYLE = "";
 
+static double elapsedMs(const QElapsedTimer& timer)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+}
+
+namespace {
+//! NOTE Writes the media produced by exportScoreMediaPipelined().
+//! The writers read the score and the MScore printing globals, so they still run one after
+//! another on the calling thread. What comes after a writer does not touch the score anymore:
+//! the base64 encoding is done by the task scheduler, and every entry is written to the JSON
+//! output as soon as it and all the entries before it are encoded.
+class MediaPipeline
+{
+public:
+    explicit MediaPipeline(BackendJsonWriter& jsonWriter)
+        : m_jsonWriter(jsonWriter) {}
+
+    void beginEntry(const std::string& key, bool isArray, bool isJson = false)
+    {
+        Entry entry;
+        entry.key = key;
+        entry.isArray = isArray;
+        entry.isJson = isJson;
+        m_entries.push_back(std::move(entry));
+        m_timer.start();
+    }
+
+    void addValue(const ByteArray& data)
+    {
+        Entry& entry = m_entries.back();
+        if (entry.isJson) {
+            std::promise<EncodedValue> ready;
+            ready.set_value({ data.toQByteArray(), 0.0 });
+            entry.values.push_back(ready.get_future());
+            return;
+        }
+
+        entry.values.push_back(muse::TaskScheduler::instance()->submit([data]() {
+            QElapsedTimer timer;
+            timer.start();
+            QByteArray encoded = data.toQByteArrayNoCopy().toBase64();
+            return EncodedValue { std::move(encoded), elapsedMs(timer) };
+        }));
+    }
+
+    void endEntry()
+    {
+        Entry& entry = m_entries.back();
+        entry.renderMs = elapsedMs(m_timer);
+        entry.isComplete = true;
+
+        flush(false);
+    }
+
+    //! NOTE Drops the current entry, e.g. if its writer failed
+    void cancelEntry()
+    {
+        m_entries.pop_back();
+    }
+
+    void finish()
+    {
+        flush(true);
+
+        QJsonObject timings;
+        for (const auto& pair : m_timings) {
+            QJsonObject writerTimings;
+            writerTimings["render"] = pair.second.first;
+            writerTimings["encode"] = pair.second.second;
+            timings[QString::fromStdString(pair.first)] = writerTimings;
+        }
+
+        m_jsonWriter.addKey(TIMINGS_NAME.c_str());
+        m_jsonWriter.addValue(QJsonDocument(timings).toJson(QJsonDocument::Compact), ADD_SEPARATOR, true);
+    }
+
+private:
+    struct EncodedValue {
+        QByteArray data;
+        double encodeMs = 0.0;
+    };
+
+    struct Entry {
+        std::string key;
+        bool isArray = false;
+        bool isJson = false;
+        bool isComplete = false;
+        double renderMs = 0.0;
+        std::vector<std::future<EncodedValue> > values;
+    };
+
+    static bool isReady(const Entry& entry)
+    {
+        if (!entry.isComplete) {
+            return false;
+        }
+
+        for (const std::future<EncodedValue>& value : entry.values) {
+            if (value.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void flush(bool wait)
+    {
+        while (m_writtenCount < m_entries.size()) {
+            Entry& entry = m_entries[m_writtenCount];
+            if (!wait && !isReady(entry)) {
+                return;
+            }
+
+            write(entry);
+            entry.values.clear();
+            ++m_writtenCount;
+        }
+    }
+
+    void write(Entry& entry)
+    {
+        double encodeMs = 0.0;
+
+        m_jsonWriter.addKey(entry.key.c_str());
+
+        if (entry.isArray) {
+            m_jsonWriter.openArray();
+        }
+
+        for (size_t i = 0; i < entry.values.size(); ++i) {
+            EncodedValue value = entry.values[i].get();
+            encodeMs += value.encodeMs;
+
+            bool lastValue = i == entry.values.size() - 1;
+            m_jsonWriter.addValue(value.data, entry.isArray ? !lastValue : ADD_SEPARATOR, entry.isJson);
+        }
+
+        if (entry.isArray) {
+            m_jsonWriter.closeArray(ADD_SEPARATOR);
+        }
+
+        m_timings.emplace_back(entry.key, std::make_pair(entry.renderMs, encodeMs));
+    }
+
+    BackendJsonWriter& m_jsonWriter;
+    std::deque<Entry> m_entries;
+    size_t m_writtenCount = 0;
+    QElapsedTimer m_timer;
+    std::vector<std::pair<std::string, std::pair<double, double> > > m_timings;
+};
+}
+
 Ret BackendApi::exportScoreMedia(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& highlightConfigPath,
                                  const muse::io::path_t& stylePath,
-                                 bool forceMode)
+                                 bool forceMode, bool pipelined)
 {
     TRACEFUNC
 
-    RetVal<INotationProjectPtr> prj = openProject(in, stylePath, forceMode);
+    //! NOTE The media are exported for the main score only, so in the pipelined mode
+    //! the excerpts are not laid out
+    RetVal<INotationProjectPtr> prj = openProject(in, stylePath, forceMode, !pipelined);
     if (!prj.ret) {
         return prj.ret;
     }
@@ -85,6 +245,10 @@ Ret BackendApi::exportScoreMedia(const muse::io::path_t& in, const muse::io::pat
 
     BackendJsonWriter jsonWriter(&outputFile);
 
+    if (pipelined) {
+        return exportScoreMediaPipelined(notation, highlightConfigPath, jsonWriter);
+    }
+
     result &= exportScorePngs(notation, jsonWriter, ADD_SEPARATOR);
     result &= exportScoreSvgs(notation, highlightConfigPath, jsonWriter, ADD_SEPARATOR);
     result &= exportScoreElementsPositions(SEGMENTS_POSITIONS_WRITER_NAME, SEGMENTS_POSITIONS_TAG_NAME,
@@ -205,7 +369,8 @@ Ret BackendApi::openOutputFile(QFile& file, const muse::io::path_t& out)
 
 RetVal<project::INotationProjectPtr> BackendApi::openProject(const muse::io::path_t& path,
                                                              const muse::io::path_t& stylePath,
-                                                             bool forceMode)
+                                                             bool forceMode,
+                                                             bool layoutExcerpts)
 {
     TRACEFUNC
 
@@ -231,7 +396,10 @@ RetVal<project::INotationProjectPtr> BackendApi::openProject(const muse::io::pat
     }
 
     switchToPageView(masterNotation);
-    renderExcerptsContents(masterNotation);
+
+    if (layoutExcerpts) {
+        renderExcerptsContents(masterNotation);
+    }
 
     return RetVal<INotationProjectPtr>::make_ok(notationProject);
 }
@@ -472,7 +640,80 @@ Ret BackendApi::devInfo(const notation::INotationPtr notation, BackendJsonWriter
     return make_ret(Ret::Code::Ok);
 }
 
-RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName, const INotationPtr notation)
+Ret BackendApi::exportScoreMediaPipelined(const INotationPtr notation, const muse::io::path_t& highlightConfigPath,
+                                          BackendJsonWriter& jsonWriter)
+{
+    TRACEFUNC
+
+    MediaPipeline pipeline(jsonWriter);
+    bool result = true;
+
+    //! NOTE Shared by the png and the svg pages
+    const size_t pageCount = pages(notation).size();
+    const QVariantMap beatsColors = readBeatsColors(highlightConfigPath);
+
+    auto writePages = [&](const std::string& key, const std::string& writerName, const INotationWriter::Options& commonOptions) {
+        pipeline.beginEntry(key, true);
+
+        for (size_t i = 0; i < pageCount; ++i) {
+            INotationWriter::Options options = commonOptions;
+            options[INotationWriter::OptionKey::PAGE_NUMBER] = Val(static_cast<int>(i));
+
+            RetVal<ByteArray> page = writeRaw(writerName, notation, options);
+            result &= bool(page.ret);
+            pipeline.addValue(page.val);
+        }
+
+        pipeline.endEntry();
+    };
+
+    auto writeMedia = [&](const std::string& key, const std::string& writerName) {
+        pipeline.beginEntry(key, false);
+
+        RetVal<ByteArray> media = writeRaw(writerName, notation);
+        if (!media.ret) {
+            pipeline.cancelEntry();
+            result = false;
+            return;
+        }
+
+        pipeline.addValue(media.val);
+        pipeline.endEntry();
+    };
+
+    writePages("pngs", PNG_WRITER_NAME, {
+        { INotationWriter::OptionKey::TRANSPARENT_BACKGROUND, Val(false) }
+    });
+    writePages("svgs", SVG_WRITER_NAME, {
+        { INotationWriter::OptionKey::TRANSPARENT_BACKGROUND, Val(false) },
+        { INotationWriter::OptionKey::BEATS_COLORS, Val::fromQVariant(beatsColors) }
+    });
+    writeMedia(SEGMENTS_POSITIONS_TAG_NAME, SEGMENTS_POSITIONS_WRITER_NAME);
+    writeMedia(MEASURES_POSITIONS_TAG_NAME, MEASURES_POSITIONS_WRITER_NAME);
+    writeMedia(PDF_WRITER_NAME, PDF_WRITER_NAME);
+    writeMedia(MIDI_WRITER_NAME, MIDI_WRITER_NAME);
+    writeMedia(MUSICXML_JSON_NAME, MUSICXML_WRITER_NAME);
+
+    pipeline.beginEntry(META_DATA_NAME, false, true);
+    RetVal<std::string> meta = NotationMeta::metaJson(notation);
+    if (meta.ret) {
+        pipeline.addValue(ByteArray(meta.val.c_str(), meta.val.size()));
+        pipeline.endEntry();
+    } else {
+        LOGW() << meta.ret.toString();
+        pipeline.cancelEntry();
+        result = false;
+    }
+
+    pipeline.finish();
+
+    result &= bool(devInfo(notation, jsonWriter));
+
+    return result ? make_ret(Ret::Code::Ok) : make_ret(Ret::Code::InternalError);
+}
+
+RetVal<ByteArray> BackendApi::writeRaw(const std::string& writerName, const INotationPtr notation,
+                                       const INotationWriter::Options& options)
 {
     auto writer = writers()->writer(writerName);
     if (!writer) {
@@ -484,17 +725,30 @@ RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName, cons
     Buffer device(&data);
     device.open(IODevice::ReadWrite);
 
-    Ret writeRet = writer->write(notation, device);
+    Ret writeRet = writer->write(notation, device, options);
+    device.close();
+
     if (!writeRet) {
         LOGW() << writeRet.toString();
-        return writeRet;
+    }
+
+    RetVal<ByteArray> result;
+    result.ret = writeRet;
+    result.val = data;
+
+    return result;
+}
+
+RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName, const INotationPtr notation)
+{
+    RetVal<ByteArray> data = writeRaw(writerName, notation);
+    if (!data.ret) {
+        return data.ret;
     }
 
     RetVal<QByteArray> result;
     result.ret = make_ret(Ret::Code::Ok);
-    result.val = data.toQByteArrayNoCopy().toBase64();
-
-    device.close();
+    result.val = data.val.toQByteArrayNoCopy().toBase64();
 
     return result;
 }
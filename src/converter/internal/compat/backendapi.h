@@ -24,6 +24,7 @@
 
 #include <QFile>
 
+#include "types/bytearray.h"
 #include "types/retval.h"
 
 #include "io/path.h"
@@ -49,7 +50,7 @@ class BackendApi
 
 public:
     static muse::Ret exportScoreMedia(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& highlightConfigPath,
-                                      const muse::io::path_t& stylePath = "", bool forceMode = false);
+                                      const muse::io::path_t& stylePath = "", bool forceMode = false, bool pipelined = false);
     static muse::Ret exportScoreMeta(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
                                      bool forceMode = false);
     static muse::Ret exportScoreParts(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
@@ -65,7 +66,8 @@ private:
     static muse::Ret openOutputFile(QFile& file, const muse::io::path_t& out);
 
     static muse::RetVal<project::INotationProjectPtr> openProject(const muse::io::path_t& path,
-                                                                  const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false);
+                                                                  const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
+                                                                  bool layoutExcerpts = true);
 
     static notation::PageList pages(const notation::INotationPtr notation);
 
@@ -84,6 +86,11 @@ private:
     static muse::Ret exportScoreMetaData(const notation::INotationPtr notation, BackendJsonWriter& jsonWriter, bool addSeparator = false);
     static muse::Ret devInfo(const notation::INotationPtr notation, BackendJsonWriter& jsonWriter, bool addSeparator = false);
 
+    static muse::Ret exportScoreMediaPipelined(const notation::INotationPtr notation, const muse::io::path_t& highlightConfigPath,
+                                               BackendJsonWriter& jsonWriter);
+
+    static muse::RetVal<muse::ByteArray> writeRaw(const std::string& writerName, const notation::INotationPtr notation,
+                                                  const project::INotationWriter::Options& options = {});
     static muse::RetVal<QByteArray> processWriter(const std::string& writerName, const notation::INotationPtr notation);
     static muse::RetVal<QByteArray> processWriter(const std::string& writerName, const notation::INotationPtrList notations,
                                                   const project::INotationWriter::Options& options);
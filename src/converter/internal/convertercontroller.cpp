@@ -25,6 +25,19 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonParseError>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QFile>
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "global/io/file.h"
 #include "global/io/dir.h"
@@ -45,6 +58,27 @@ static const std::string PDF_SUFFIX = "pdf";
 static const std::string PNG_SUFFIX = "png";
 static const std::string SVG_SUFFIX = "svg";
 
+static constexpr int STDOUT_FD = 1;
+static constexpr int STDERR_FD = 2;
+
+static int duplicateFd(int fd)
+{
+#ifdef Q_OS_WIN
+    return _dup(fd);
+#else
+    return dup(fd);
+#endif
+}
+
+static int redirectFd(int fromFd, int toFd)
+{
+#ifdef Q_OS_WIN
+    return _dup2(fromFd, toFd);
+#else
+    return dup2(fromFd, toFd);
+#endif
+}
+
 Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, const muse::io::path_t& stylePath, bool forceMode,
                                       const String& soundProfile)
 {
@@ -58,11 +92,27 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
 
     StringList errors;
 
-    for (const Job& job : batchJob.val) {
-        Ret ret = fileConvert(job.in, job.out, stylePath, forceMode, soundProfile);
-        if (!ret) {
-            errors.emplace_back(String(u"failed convert, err: %1, in: %2, out: %3")
-                                .arg(String::fromStdString(ret.toString())).arg(job.in.toString()).arg(job.out.toString()));
+    auto addError = [&errors](const Ret& ret, const muse::io::path_t& in, const muse::io::path_t& out) {
+        errors.emplace_back(String(u"failed convert, err: %1, in: %2, out: %3")
+                            .arg(String::fromStdString(ret.toString())).arg(in.toString()).arg(out.toString()));
+    };
+
+    //! NOTE The jobs are converted in the order of the file,
+    //! the outputs of one job share the loaded and laid out input
+    for (const ConvertJob& job : batchJob.val) {
+        RetVal<INotationProjectPtr> notationProject = loadProject(job.in, stylePath, forceMode, soundProfile);
+        if (!notationProject.ret) {
+            for (const muse::io::path_t& out : job.outs) {
+                addError(notationProject.ret, job.in, out);
+            }
+            continue;
+        }
+
+        for (const muse::io::path_t& out : job.outs) {
+            Ret ret = convertProject(notationProject.val, out);
+            if (!ret) {
+                addError(ret, job.in, out);
+            }
         }
     }
 
@@ -73,6 +123,143 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
     return make_ret(Ret::Code::Ok);
 }
 
+Ret ConverterController::serve(const muse::io::path_t& socketName, const muse::io::path_t& stylePath, bool forceMode,
+                                const String& soundProfile)
+{
+    TRACEFUNC;
+
+    ServeOptions options;
+    options.stylePath = stylePath;
+    options.forceMode = forceMode;
+    options.soundProfile = soundProfile;
+
+    ConvertJobServer server([this, &options](const ConvertJob& job) {
+        return convertServeJob(job, options);
+    });
+
+    if (!socketName.empty()) {
+        return serveSocket(socketName.toQString(), server);
+    }
+
+    LOGI() << "serving jobs from stdin";
+
+    //! NOTE stdout is kept for the responses: the log, and whatever else writes to stdout,
+    //! goes to stderr while serving
+    std::cout.flush();
+    std::fflush(stdout);
+
+    const int responseFd = duplicateFd(STDOUT_FD);
+    if (responseFd < 0 || redirectFd(STDERR_FD, STDOUT_FD) < 0) {
+        LOGE() << "failed redirect stdout";
+        return make_ret(Err::ServeFailedOpenOutput);
+    }
+
+    QFile responseFile;
+    if (!responseFile.open(responseFd, QIODevice::WriteOnly | QIODevice::Unbuffered, QFileDevice::AutoCloseHandle)) {
+        redirectFd(responseFd, STDOUT_FD);
+        LOGE() << "failed open output, err: " << responseFile.errorString();
+        return make_ret(Err::ServeFailedOpenOutput, responseFile.errorString().toStdString());
+    }
+
+    ConvertJobServer::ReadLine readLine = [](QByteArray& line) {
+        std::string str;
+        if (!std::getline(std::cin, str)) {
+            return false;
+        }
+
+        line = QByteArray::fromStdString(str);
+        return true;
+    };
+
+    ConvertJobServer::WriteLine writeLine = [&responseFile](const QByteArray& line) {
+        responseFile.write(line + '\n');
+    };
+
+    server.serveLines(readLine, writeLine);
+
+    std::cout.flush();
+    std::fflush(stdout);
+    redirectFd(responseFd, STDOUT_FD);
+
+    responseFile.close();
+
+    return make_ret(Ret::Code::Ok);
+}
+
+Ret ConverterController::serveSocket(const QString& socketName, ConvertJobServer& jobServer)
+{
+    QLocalServer server;
+
+    //! NOTE A socket file left behind by a crashed worker would make listen() fail
+    QLocalServer::removeServer(socketName);
+
+    if (!server.listen(socketName)) {
+        LOGE() << "failed listen: " << socketName << ", err: " << server.errorString();
+        return make_ret(Err::ServeFailedListen, server.errorString().toStdString());
+    }
+
+    LOGI() << "serving jobs from socket: " << server.fullServerName();
+
+    //! NOTE The clients are served one by one, a worker converts one job at a time
+    bool quit = false;
+    while (!quit) {
+        if (!server.waitForNewConnection(-1)) {
+            LOGE() << "failed wait for connection, err: " << server.errorString();
+            return make_ret(Err::ServeFailedListen, server.errorString().toStdString());
+        }
+
+        QLocalSocket* socket = server.nextPendingConnection();
+        if (!socket) {
+            continue;
+        }
+
+        ConvertJobServer::ReadLine readLine = [socket](QByteArray& line) {
+            while (!socket->canReadLine()) {
+                if (socket->state() != QLocalSocket::ConnectedState || !socket->waitForReadyRead(-1)) {
+                    // the last line may have no line break
+                    line = socket->readAll();
+                    return !line.isEmpty();
+                }
+            }
+
+            line = socket->readLine();
+            return true;
+        };
+
+        ConvertJobServer::WriteLine writeLine = [socket](const QByteArray& line) {
+            if (socket->state() != QLocalSocket::ConnectedState) {
+                return;
+            }
+
+            socket->write(line);
+            socket->write("\n");
+            socket->waitForBytesWritten(-1);
+        };
+
+        quit = jobServer.serveLines(readLine, writeLine);
+
+        socket->disconnectFromServer();
+        delete socket;
+    }
+
+    return make_ret(Ret::Code::Ok);
+}
+
+std::vector<Ret> ConverterController::convertServeJob(const ConvertJob& job, const ServeOptions& options)
+{
+    TRACEFUNC;
+
+    //! NOTE Every job gets a project of its own, which is gone before the next job starts
+    RetVal<INotationProjectPtr> notationProject = loadProject(job.in, options.stylePath, options.forceMode, options.soundProfile);
+
+    std::vector<Ret> rets;
+    for (const muse::io::path_t& out : job.outs) {
+        rets.push_back(notationProject.ret ? convertProject(notationProject.val, out) : notationProject.ret);
+    }
+
+    return rets;
+}
+
 Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
                                      bool forceMode,
                                      const String& soundProfile)
@@ -80,35 +267,66 @@ Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io:
     TRACEFUNC;
 
     LOGI() << "in: " << in << ", out: " << out;
-    auto notationProject = notationCreator()->newProject();
-    IF_ASSERT_FAILED(notationProject) {
-        return make_ret(Err::UnknownError);
-    }
 
-    std::string suffix = io::suffix(out);
-    auto writer = writers()->writer(suffix);
-    if (!writer) {
+    if (!writers()->writer(io::suffix(out))) {
         return make_ret(Err::ConvertTypeUnknown);
     }
 
-    Ret ret = notationProject->load(in, stylePath, forceMode);
+    RetVal<INotationProjectPtr> notationProject = loadProject(in, stylePath, forceMode, soundProfile);
+    if (!notationProject.ret) {
+        return notationProject.ret;
+    }
+
+    return convertProject(notationProject.val, out);
+}
+
+RetVal<INotationProjectPtr> ConverterController::loadProject(const muse::io::path_t& in, const muse::io::path_t& stylePath,
+                                                             bool forceMode, const String& soundProfile)
+{
+    TRACEFUNC;
+
+    RetVal<INotationProjectPtr> rv;
+
+    rv.val = notationCreator()->newProject();
+    IF_ASSERT_FAILED(rv.val) {
+        rv.ret = make_ret(Err::UnknownError);
+        return rv;
+    }
+
+    Ret ret = rv.val->load(in, stylePath, forceMode);
     if (!ret) {
         LOGE() << "failed load notation, err: " << ret.toString() << ", path: " << in;
-        return make_ret(Err::InFileFailedLoad);
+        rv.ret = make_ret(Err::InFileFailedLoad);
+        return rv;
     }
 
     if (!soundProfile.isEmpty()) {
-        notationProject->audioSettings()->clearTrackInputParams();
-        notationProject->audioSettings()->setActiveSoundProfile(soundProfile);
+        rv.val->audioSettings()->clearTrackInputParams();
+        rv.val->audioSettings()->setActiveSoundProfile(soundProfile);
     }
 
-    globalContext()->setCurrentProject(notationProject);
+    rv.ret = make_ret(Ret::Code::Ok);
+    return rv;
+}
 
-    if (suffix == engraving::MSCZ || suffix == engraving::MSCX || suffix == engraving::MSCS) {
-        return notationProject->save(out);
+Ret ConverterController::convertProject(INotationProjectPtr notationProject, const muse::io::path_t& out)
+{
+    TRACEFUNC;
+
+    LOGI() << "out: " << out;
+
+    std::string suffix = io::suffix(out);
+    auto writer = writers()->writer(suffix);
+    if (!writer) {
+        return make_ret(Err::ConvertTypeUnknown);
     }
 
-    if (isConvertPageByPage(suffix)) {
+    globalContext()->setCurrentProject(notationProject);
+
+    Ret ret;
+    if (suffix == engraving::MSCZ || suffix == engraving::MSCX || suffix == engraving::MSCS) {
+        ret = notationProject->save(out);
+    } else if (isConvertPageByPage(suffix)) {
         ret = convertPageByPage(writer, notationProject->masterNotation()->notation(), out);
         if (!ret) {
             LOGE() << "Failed to convert page by page, err: " << ret.toString();
@@ -179,18 +397,9 @@ RetVal<ConverterController::BatchJob> ConverterController::parseBatchJob(const m
 
     QJsonArray arr = doc.array();
 
-    auto correctUserInputPath = [](const QString& path) -> QString {
-        return io::Dir::fromNativeSeparators(path).toQString();
-    };
-
     for (const QJsonValue v : arr) {
-        QJsonObject obj = v.toObject();
-
-        Job job;
-        job.in = correctUserInputPath(obj["in"].toString());
-        job.out = correctUserInputPath(obj["out"].toString());
-
-        if (!job.in.empty() && !job.out.empty()) {
+        ConvertJob job = ConvertJobServer::parseJob(v.toObject());
+        if (!job.in.empty() && !job.outs.empty()) {
             rv.val.push_back(std::move(job));
         }
     }
@@ -322,11 +531,11 @@ Ret ConverterController::convertScorePartsToPngs(INotationWriterPtr writer, mu::
 
 Ret ConverterController::exportScoreMedia(const muse::io::path_t& in, const muse::io::path_t& out,
                                           const muse::io::path_t& highlightConfigPath,
-                                          const muse::io::path_t& stylePath, bool forceMode)
+                                          const muse::io::path_t& stylePath, bool forceMode, bool pipelined)
 {
     TRACEFUNC;
 
-    return BackendApi::exportScoreMedia(in, out, highlightConfigPath, stylePath, forceMode);
+    return BackendApi::exportScoreMedia(in, out, highlightConfigPath, stylePath, forceMode, pipelined);
 }
 
 Ret ConverterController::exportScoreMeta(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
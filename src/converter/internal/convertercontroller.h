@@ -23,8 +23,12 @@
 #define MU_CONVERTER_CONVERTERCONTROLLER_H
 
 #include <list>
+#include <vector>
+
+#include <QString>
 
 #include "../iconvertercontroller.h"
+#include "convertjobserver.h"
 
 #include "modularity/ioc.h"
 #include "project/iprojectcreator.h"
@@ -37,10 +41,11 @@
 namespace mu::converter {
 class ConverterController : public IConverterController
 {
-    INJECT(project::IProjectCreator, notationCreator)
-    INJECT(project::INotationWritersRegister, writers)
-    INJECT(project::IProjectRWRegister, projectRW)
-    INJECT(context::IGlobalContext, globalContext)
+public:
+    muse::Inject<project::IProjectCreator> notationCreator;
+    muse::Inject<project::INotationWritersRegister> writers;
+    muse::Inject<project::IProjectRWRegister> projectRW;
+    muse::Inject<context::IGlobalContext> globalContext;
 
 public:
     ConverterController() = default;
@@ -51,13 +56,17 @@ public:
     muse::Ret batchConvert(const muse::io::path_t& batchJobFile,
                            const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
                            const muse::String& soundProfile = muse::String()) override;
+    muse::Ret serve(const muse::io::path_t& socketName = muse::io::path_t(),
+                    const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
+                    const muse::String& soundProfile = muse::String()) override;
 
     muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                 const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) override;
 
     muse::Ret exportScoreMedia(const muse::io::path_t& in, const muse::io::path_t& out,
                                const muse::io::path_t& highlightConfigPath = muse::io::path_t(),
-                               const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) override;
+                               const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
+                               bool pipelined = false) override;
     muse::Ret exportScoreMeta(const muse::io::path_t& in, const muse::io::path_t& out,
                               const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) override;
     muse::Ret exportScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
@@ -73,14 +82,22 @@ public:
 
 private:
 
-    struct Job {
-        muse::io::path_t in;
-        muse::io::path_t out;
+    using BatchJob = std::list<ConvertJob>;
+
+    muse::RetVal<BatchJob> parseBatchJob(const muse::io::path_t& batchJobFile) const;
+
+    struct ServeOptions {
+        muse::io::path_t stylePath;
+        bool forceMode = false;
+        muse::String soundProfile;
     };
 
-    using BatchJob = std::list<Job>;
+    muse::Ret serveSocket(const QString& socketName, ConvertJobServer& server);
+    std::vector<muse::Ret> convertServeJob(const ConvertJob& job, const ServeOptions& options);
 
-    muse::RetVal<BatchJob> parseBatchJob(const muse::io::path_t& batchJobFile) const;
+    muse::RetVal<project::INotationProjectPtr> loadProject(const muse::io::path_t& in, const muse::io::path_t& stylePath,
+                                                           bool forceMode, const muse::String& soundProfile);
+    muse::Ret convertProject(project::INotationProjectPtr notationProject, const muse::io::path_t& out);
 
     bool isConvertPageByPage(const std::string& suffix) const;
     muse::Ret convertPageByPage(project::INotationWriterPtr writer, notation::INotationPtr notation, const muse::io::path_t& out) const;
@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "convertjobserver.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+#include "global/io/dir.h"
+
+#include "convertercodes.h"
+
+#include "log.h"
+
+using namespace mu::converter;
+using namespace muse;
+
+ConvertJobServer::ConvertJobServer(const ConvertFunc& convert)
+    : m_convert(convert)
+{
+}
+
+ConvertJob ConvertJobServer::parseJob(const QJsonObject& obj)
+{
+    auto correctUserInputPath = [](const QString& path) -> QString {
+        return io::Dir::fromNativeSeparators(path).toQString();
+    };
+
+    ConvertJob job;
+    job.in = correctUserInputPath(obj["in"].toString());
+
+    //! NOTE "out" is a path or an array of paths
+    std::vector<muse::io::path_t> outs;
+    QJsonValue outVal = obj["out"];
+    if (outVal.isArray()) {
+        for (const QJsonValue outItem : outVal.toArray()) {
+            outs.push_back(correctUserInputPath(outItem.toString()));
+        }
+    } else {
+        outs.push_back(correctUserInputPath(outVal.toString()));
+    }
+
+    for (muse::io::path_t& out : outs) {
+        if (!out.empty()) {
+            job.outs.push_back(std::move(out));
+        }
+    }
+
+    return job;
+}
+
+bool ConvertJobServer::serveLines(const ReadLine& readLine, const WriteLine& writeLine)
+{
+    QByteArray request;
+    while (readLine(request)) {
+        request = request.trimmed();
+        if (request.isEmpty()) {
+            continue;
+        }
+
+        bool quit = false;
+        writeLine(processRequest(request, quit));
+
+        //! NOTE The event loop does not run while serving,
+        //! deliver what the job has posted, before the next one is read
+        QCoreApplication::processEvents();
+
+        if (quit) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QByteArray ConvertJobServer::processRequest(const QByteArray& request, bool& quit)
+{
+    TRACEFUNC;
+
+    QJsonObject response;
+
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(request, &err);
+    if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+        response["ok"] = false;
+        response["error"] = QString::fromStdString(make_ret(Err::BatchJobFileFailedParse, err.errorString().toStdString()).toString());
+        return QJsonDocument(response).toJson(QJsonDocument::Compact);
+    }
+
+    const QJsonObject obj = doc.object();
+
+    //! NOTE The id is up to the client, it is just passed back
+    if (obj.contains("id")) {
+        response["id"] = obj["id"];
+    }
+
+    if (obj["command"].toString() == "quit") {
+        quit = true;
+        response["ok"] = true;
+        return QJsonDocument(response).toJson(QJsonDocument::Compact);
+    }
+
+    const ConvertJob job = parseJob(obj);
+    response["in"] = job.in.toQString();
+
+    if (job.in.empty() || job.outs.empty()) {
+        response["ok"] = false;
+        response["error"] = QString::fromStdString(make_ret(Err::BatchJobFileFailedParse, "no input or output").toString());
+        return QJsonDocument(response).toJson(QJsonDocument::Compact);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const std::vector<Ret> rets = m_convert(job);
+
+    bool ok = true;
+    QJsonArray outs;
+    for (size_t i = 0; i < job.outs.size(); ++i) {
+        const Ret ret = i < rets.size() ? rets.at(i) : make_ret(Err::UnknownError);
+
+        QJsonObject outObj;
+        outObj["path"] = job.outs.at(i).toQString();
+        outObj["ok"] = ret.success();
+        if (!ret) {
+            outObj["error"] = QString::fromStdString(ret.toString());
+            ok = false;
+        }
+
+        outs.append(outObj);
+    }
+
+    response["ok"] = ok;
+    response["out"] = outs;
+    response["elapsedMs"] = static_cast<qint64>(timer.elapsed());
+
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_CONVERTER_CONVERTJOBSERVER_H
+#define MU_CONVERTER_CONVERTJOBSERVER_H
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+
+#include "io/path.h"
+#include "types/ret.h"
+
+class QJsonObject;
+
+namespace mu::converter {
+struct ConvertJob {
+    muse::io::path_t in;
+    std::vector<muse::io::path_t> outs;
+};
+
+//! NOTE The JSON-lines protocol of the serve mode: a response is written for every request.
+//! Where the lines come from, and how a job is converted, is up to the caller
+class ConvertJobServer
+{
+public:
+    using ReadLine = std::function<bool (QByteArray& line)>;
+    using WriteLine = std::function<void (const QByteArray& line)>;
+
+    //! NOTE Returns the result of every output of the job, in their order
+    using ConvertFunc = std::function<std::vector<muse::Ret>(const ConvertJob& job)>;
+
+    explicit ConvertJobServer(const ConvertFunc& convert);
+
+    //! NOTE The fields of a batch job entry, "out" is a path or an array of paths
+    static ConvertJob parseJob(const QJsonObject& obj);
+
+    //! NOTE Returns true if the serving has been stopped by a quit request, false if the input has ended
+    bool serveLines(const ReadLine& readLine, const WriteLine& writeLine);
+
+    QByteArray processRequest(const QByteArray& request, bool& quit);
+
+private:
+    ConvertFunc m_convert;
+};
+}
+
+#endif // MU_CONVERTER_CONVERTJOBSERVER_H
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "converter/internal/convertercontroller.h"
+
+#include "project/tests/mocks/notationprojectmock.h"
+#include "project/tests/mocks/projectcreatormock.h"
+#include "project/tests/mocks/notationwritersregistermock.h"
+#include "context/tests/mocks/globalcontextmock.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace mu;
+using namespace mu::converter;
+using namespace mu::project;
+using namespace mu::context;
+using namespace muse;
+
+class Converter_ConverterControllerTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_controller = std::make_shared<ConverterController>();
+        m_projectCreator = std::make_shared<NiceMock<ProjectCreatorMock> >();
+        m_writers = std::make_shared<NiceMock<NotationWritersRegisterMock> >();
+        m_globalContext = std::make_shared<NiceMock<GlobalContextMock> >();
+
+        m_controller->notationCreator.set(m_projectCreator);
+        m_controller->writers.set(m_writers);
+        m_controller->globalContext.set(m_globalContext);
+
+        ON_CALL(*m_writers, writer(_)).WillByDefault(Return(std::make_shared<NiceMock<NotationWriterMock> >()));
+
+        //! NOTE Every loaded project records what is done with it
+        ON_CALL(*m_projectCreator, newProject()).WillByDefault([this]() {
+            auto project = std::make_shared<NiceMock<NotationProjectMock> >();
+
+            ON_CALL(*project, load(_, _, _, _)).WillByDefault([this](const io::path_t& path, const io::path_t&, bool, const std::string&) {
+                m_calls.push_back("load " + path.toStdString());
+                return m_failedLoads.count(path.toStdString()) ? make_ret(Ret::Code::UnknownError) : make_ok();
+            });
+
+            ON_CALL(*project, save(_, _)).WillByDefault([this](const io::path_t& path, SaveMode mode) {
+                m_calls.push_back("save " + path.toStdString() + (mode == SaveMode::Save ? "" : " (not Save)"));
+                return make_ok();
+            });
+
+            return project;
+        });
+    }
+
+    io::path_t writeBatchJob(const QJsonArray& jobs)
+    {
+        const QString path = m_dir.filePath("job.json");
+
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(QJsonDocument(jobs).toJson());
+
+        return path;
+    }
+
+    static QJsonObject job(const QString& in, const QJsonValue& out)
+    {
+        QJsonObject obj;
+        obj["in"] = in;
+        obj["out"] = out;
+        return obj;
+    }
+
+    std::shared_ptr<ConverterController> m_controller;
+    std::shared_ptr<ProjectCreatorMock> m_projectCreator;
+    std::shared_ptr<NotationWritersRegisterMock> m_writers;
+    std::shared_ptr<GlobalContextMock> m_globalContext;
+
+    QTemporaryDir m_dir;
+    std::vector<std::string> m_calls;
+    std::set<std::string> m_failedLoads;
+};
+
+TEST_F(Converter_ConverterControllerTests, BatchConvert_JobsInFileOrder)
+{
+    //! [GIVEN] A job file, with an input that has several outputs and an input that comes twice
+    QJsonArray jobs;
+    jobs.append(job("a.mscz", QJsonArray { "a1.mscx", "a2.mscz" }));
+    jobs.append(job("b.mscz", "b.mscx"));
+    jobs.append(job("a.mscz", "a3.mscx"));
+
+    EXPECT_CALL(*m_projectCreator, newProject()).Times(3);
+
+    //! [WHEN] The batch is converted
+    Ret ret = m_controller->batchConvert(writeBatchJob(jobs));
+
+    //! [THEN] The jobs are done in the order of the file, the outputs of a job share its load
+    EXPECT_TRUE(ret);
+
+    std::vector<std::string> expected = {
+        "load a.mscz",
+        "save a1.mscx",
+        "save a2.mscz",
+        "load b.mscz",
+        "save b.mscx",
+        "load a.mscz",
+        "save a3.mscx",
+    };
+
+    EXPECT_EQ(m_calls, expected);
+}
+
+TEST_F(Converter_ConverterControllerTests, BatchConvert_FailedLoad_OtherJobsConverted)
+{
+    //! [GIVEN] A job with empty outputs, and a job whose input fails to load
+    QJsonArray jobs;
+    jobs.append(job("empty.mscz", QJsonArray()));
+    jobs.append(job("broken.mscz", QJsonArray { "x.mscx", "y.mscx" }));
+    jobs.append(job("b.mscz", "b.mscx"));
+
+    m_failedLoads.insert("broken.mscz");
+
+    //! [WHEN] The batch is converted
+    Ret ret = m_controller->batchConvert(writeBatchJob(jobs));
+
+    //! [THEN] The failure is reported for every output of the broken input
+    EXPECT_FALSE(ret);
+    EXPECT_NE(ret.text().find("out: x.mscx"), std::string::npos);
+    EXPECT_NE(ret.text().find("out: y.mscx"), std::string::npos);
+
+    //! [THEN] The empty job is skipped, the next job is converted
+    std::vector<std::string> expected = {
+        "load broken.mscz",
+        "load b.mscz",
+        "save b.mscx",
+    };
+
+    EXPECT_EQ(m_calls, expected);
+}
@@ -0,0 +1,237 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "converter/internal/convertjobserver.h"
+#include "converter/convertercodes.h"
+
+using namespace mu;
+using namespace mu::converter;
+using namespace muse;
+
+class Converter_ConvertJobServerTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        //! NOTE Every job records what is done with it, the outputs of a failed input fail too
+        m_server = std::make_unique<ConvertJobServer>([this](const ConvertJob& job) {
+            m_calls.push_back("load " + job.in.toStdString());
+
+            const bool loaded = !m_failedLoads.count(job.in.toStdString());
+
+            std::vector<Ret> rets;
+            for (const io::path_t& out : job.outs) {
+                if (loaded) {
+                    m_calls.push_back("save " + out.toStdString());
+                    rets.push_back(make_ok());
+                } else {
+                    rets.push_back(make_ret(Err::InFileFailedLoad));
+                }
+            }
+
+            return rets;
+        });
+    }
+
+    QJsonObject processRequest(const QByteArray& request, bool& quit)
+    {
+        return QJsonDocument::fromJson(m_server->processRequest(request, quit)).object();
+    }
+
+    bool serveLines(const std::vector<QByteArray>& requests, std::vector<QJsonObject>& responses, size_t& readCount)
+    {
+        readCount = 0;
+
+        ConvertJobServer::ReadLine readLine = [&requests, &readCount](QByteArray& line) {
+            if (readCount >= requests.size()) {
+                return false;
+            }
+
+            line = requests[readCount++];
+            return true;
+        };
+
+        ConvertJobServer::WriteLine writeLine = [&responses](const QByteArray& line) {
+            responses.push_back(QJsonDocument::fromJson(line).object());
+        };
+
+        return m_server->serveLines(readLine, writeLine);
+    }
+
+    std::unique_ptr<ConvertJobServer> m_server;
+    std::vector<std::string> m_calls;
+    std::set<std::string> m_failedLoads;
+};
+
+TEST_F(Converter_ConvertJobServerTests, ParseJob_OutPathOrPaths)
+{
+    //! [GIVEN] A job with one output, and a job with several outputs, one of them empty
+    QJsonObject single;
+    single["in"] = "a.mscz";
+    single["out"] = "a.pdf";
+
+    QJsonObject several;
+    several["in"] = "b.mscz";
+    several["out"] = QJsonArray { "b.pdf", "", "b.png" };
+
+    //! [WHEN] They are parsed
+    ConvertJob singleJob = ConvertJobServer::parseJob(single);
+    ConvertJob severalJob = ConvertJobServer::parseJob(several);
+
+    //! [THEN] The outputs are kept in their order, without the empty one
+    EXPECT_EQ(singleJob.in, "a.mscz");
+    ASSERT_EQ(singleJob.outs.size(), 1u);
+    EXPECT_EQ(singleJob.outs[0], "a.pdf");
+
+    EXPECT_EQ(severalJob.in, "b.mscz");
+    ASSERT_EQ(severalJob.outs.size(), 2u);
+    EXPECT_EQ(severalJob.outs[0], "b.pdf");
+    EXPECT_EQ(severalJob.outs[1], "b.png");
+}
+
+TEST_F(Converter_ConvertJobServerTests, Process_Job_ResponseForEveryOutput)
+{
+    //! [GIVEN] A job with two outputs, and an id
+    QByteArray request = R"({"id": "job-1", "in": "a.mscz", "out": ["a.mscx", "a.mscz"]})";
+
+    //! [WHEN] It is processed
+    bool quit = false;
+    QJsonObject response = processRequest(request, quit);
+
+    //! [THEN] The response passes the id back and reports every output
+    EXPECT_FALSE(quit);
+    EXPECT_EQ(response["id"].toString(), "job-1");
+    EXPECT_EQ(response["in"].toString(), "a.mscz");
+    EXPECT_TRUE(response["ok"].toBool());
+    EXPECT_TRUE(response.contains("elapsedMs"));
+
+    QJsonArray outs = response["out"].toArray();
+    ASSERT_EQ(outs.size(), 2);
+    EXPECT_EQ(outs[0].toObject()["path"].toString(), "a.mscx");
+    EXPECT_TRUE(outs[0].toObject()["ok"].toBool());
+    EXPECT_EQ(outs[1].toObject()["path"].toString(), "a.mscz");
+    EXPECT_TRUE(outs[1].toObject()["ok"].toBool());
+
+    std::vector<std::string> expected = { "load a.mscz", "save a.mscx", "save a.mscz" };
+    EXPECT_EQ(m_calls, expected);
+}
+
+TEST_F(Converter_ConvertJobServerTests, Process_FailedLoad_ErrorForEveryOutput)
+{
+    //! [GIVEN] A job whose input fails to load
+    m_failedLoads.insert("broken.mscz");
+
+    //! [WHEN] It is processed
+    bool quit = false;
+    QJsonObject response = processRequest(R"({"in": "broken.mscz", "out": ["x.mscx", "y.mscx"]})", quit);
+
+    //! [THEN] Every output reports the error
+    EXPECT_FALSE(response["ok"].toBool());
+    EXPECT_FALSE(response.contains("id"));
+
+    QJsonArray outs = response["out"].toArray();
+    ASSERT_EQ(outs.size(), 2);
+    for (const QJsonValue out : outs) {
+        EXPECT_FALSE(out.toObject()["ok"].toBool());
+        EXPECT_FALSE(out.toObject()["error"].toString().isEmpty());
+    }
+}
+
+TEST_F(Converter_ConvertJobServerTests, Process_InvalidRequests_Errors)
+{
+    bool quit = false;
+
+    //! [WHEN] A request is not JSON
+    QJsonObject response = processRequest("not json", quit);
+
+    //! [THEN] It is an error
+    EXPECT_FALSE(response["ok"].toBool());
+    EXPECT_FALSE(response["error"].toString().isEmpty());
+
+    //! [WHEN] A request has no output
+    response = processRequest(R"({"id": 3, "in": "a.mscz"})", quit);
+
+    //! [THEN] It is an error too, nothing is converted
+    EXPECT_EQ(response["id"].toInt(), 3);
+    EXPECT_FALSE(response["ok"].toBool());
+    EXPECT_FALSE(response["error"].toString().isEmpty());
+
+    EXPECT_FALSE(quit);
+    EXPECT_TRUE(m_calls.empty());
+}
+
+TEST_F(Converter_ConvertJobServerTests, ServeLines_StopsAtQuit)
+{
+    //! [GIVEN] Requests with an empty line, an invalid one and a quit before the last one
+    std::vector<QByteArray> requests = {
+        R"({"id": 1, "in": "a.mscz", "out": "a.mscx"})",
+        "",
+        "garbage",
+        R"(  {"id": 2, "command": "quit"}  )",
+        R"({"id": 3, "in": "b.mscz", "out": "b.mscx"})",
+    };
+
+    //! [WHEN] They are served
+    std::vector<QJsonObject> responses;
+    size_t readCount = 0;
+    bool quit = serveLines(requests, responses, readCount);
+
+    //! [THEN] There is a response per request up to the quit, the empty line is skipped
+    EXPECT_TRUE(quit);
+    EXPECT_EQ(readCount, 4u);
+    ASSERT_EQ(responses.size(), 3u);
+
+    EXPECT_EQ(responses[0]["id"].toInt(), 1);
+    EXPECT_TRUE(responses[0]["ok"].toBool());
+    EXPECT_FALSE(responses[1]["ok"].toBool());
+    EXPECT_EQ(responses[2]["id"].toInt(), 2);
+    EXPECT_TRUE(responses[2]["ok"].toBool());
+
+    //! [THEN] The job after the quit is not done
+    std::vector<std::string> expected = { "load a.mscz", "save a.mscx" };
+    EXPECT_EQ(m_calls, expected);
+}
+
+TEST_F(Converter_ConvertJobServerTests, ServeLines_EndOfInput_NoQuit)
+{
+    //! [GIVEN] Requests without a quit
+    std::vector<QByteArray> requests = {
+        R"({"in": "a.mscz", "out": "a.mscx"})",
+    };
+
+    //! [WHEN] They are served until the input ends
+    std::vector<QJsonObject> responses;
+    size_t readCount = 0;
+    bool quit = serveLines(requests, responses, readCount);
+
+    //! [THEN] The serving ends without a quit request
+    EXPECT_FALSE(quit);
+    EXPECT_EQ(responses.size(), 1u);
+}
@@ -141,6 +141,12 @@ PluginAPI::PluginAPI(QQuickItem* parent)
     setRequiresScore(true); // by default plugins require a score to work
 }
 
+void PluginAPI::runPlugin()
+{
+    m_wrapperCache.start();
+    emit run();
+}
+
 apiv1::Score* PluginAPI::curScore() const
 {
     if (currentScore()) {
@@ -349,6 +355,8 @@ FractionWrapper* PluginAPI::fraction(int num, int den) const
 
 void PluginAPI::quit()
 {
+    m_wrapperCache.end();
+
     emit closeRequested();
     m_closeRequested.notify();
 }
@@ -34,6 +34,7 @@
 
 #include "enums.h"
 #include "apitypes.h"
+#include "scoreelement.h"
 
 // #include "engraving/dom/score.h"
 // #include "engraving/dom/types.h"
@@ -264,7 +265,7 @@ public:
     static void registerQmlTypes();
 
     void setup(QQmlEngine* e) override;
-    void runPlugin() override { emit run(); }
+    void runPlugin() override;
     muse::async::Notification closeRequest() const override { return m_closeRequested; }
 
     void endCmd(const QMap<QString, QVariant>& stateInfo) { emit scoreStateChanged(stateInfo); }
@@ -338,6 +339,8 @@ private:
     QString m_thumbnailName;
     QString m_categoryCode;
     muse::async::Notification m_closeRequested;
+
+    WrapperCache m_wrapperCache;
 };
 
 #undef DECLARE_API_ENUM
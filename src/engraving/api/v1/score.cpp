@@ -24,9 +24,11 @@
 
 #include "engraving/compat/midi/compatmidirender.h"
 
+#include "engraving/dom/chord.h"
 #include "engraving/dom/factory.h"
 #include "engraving/dom/instrtemplate.h"
 #include "engraving/dom/measure.h"
+#include "engraving/dom/note.h"
 #include "engraving/dom/score.h"
 #include "engraving/dom/segment.h"
 #include "engraving/dom/text.h"
@@ -42,6 +44,63 @@ Cursor* Score::newCursor()
     return new Cursor(score());
 }
 
+//---------------------------------------------------------
+//   Score::noteValues
+//---------------------------------------------------------
+
+QVariantList Score::noteValues(int startTrack, int endTrack, int startTick, int endTick)
+{
+    QVariantList result;
+
+    mu::engraving::Score* s = score();
+    startTrack = std::max(startTrack, 0);
+    endTrack = std::min(endTrack, static_cast<int>(s->ntracks()));
+    if (startTrack >= endTrack) {
+        return result;
+    }
+
+    const mu::engraving::Fraction from = mu::engraving::Fraction::fromTicks(std::max(startTick, 0));
+    const mu::engraving::Fraction to = endTick < 0 ? s->endTick() : mu::engraving::Fraction::fromTicks(endTick);
+
+    mu::engraving::Measure* measure = s->tick2measure(from);
+    if (!measure) {
+        return result;
+    }
+
+    const mu::engraving::SegmentType segType = mu::engraving::SegmentType::ChordRest;
+    for (mu::engraving::Segment* seg = measure->first(segType); seg && seg->tick() < to; seg = seg->next1(segType)) {
+        if (seg->tick() < from) {
+            continue;
+        }
+
+        for (int track = startTrack; track < endTrack; ++track) {
+            mu::engraving::EngravingItem* item = seg->element(track);
+            if (!item || !item->isChord()) {
+                continue;
+            }
+
+            const mu::engraving::Chord* chord = mu::engraving::toChord(item);
+            const int tick = chord->tick().ticks();
+            const int duration = chord->actualTicks().ticks();
+
+            for (const mu::engraving::Note* note : chord->notes()) {
+                QVariantMap value;
+                value["tick"] = tick;
+                value["duration"] = duration;
+                value["track"] = track;
+                value["pitch"] = note->pitch();
+                value["tpc"] = note->tpc();
+                value["userVelocity"] = note->userVelocity();
+                value["tieBack"] = note->tieBack() != nullptr;
+                value["tieForward"] = note->tieFor() != nullptr;
+                result.push_back(value);
+            }
+        }
+    }
+
+    return result;
+}
+
 //---------------------------------------------------------
 //   Score::addText
 ///   \brief Adds a header text to the score.
@@ -198,6 +198,19 @@ public:
     /// Creates and returns a cursor to be used to navigate in the score
     Q_INVOKABLE apiv1::Cursor* newCursor();
 
+    /**
+     * Returns all notes of the tracks from \p startTrack (inclusive) to \p endTrack
+     * (exclusive) starting between \p startTick and \p endTick, in score order.
+     * Each note is returned as a plain object with the fields \p tick, \p duration
+     * (both in ticks), \p track, \p pitch, \p tpc, \p userVelocity, \p tieBack
+     * and \p tieForward.
+     * Unlike walking the score with a Cursor, no element wrappers are created, so
+     * this is the preferred way for analysis plugins to read large scores.
+     * \param endTick - end of the range, or -1 for the end of the score.
+     * \since MuseScore 4.4
+     */
+    Q_INVOKABLE QVariantList noteValues(int startTrack, int endTrack, int startTick = 0, int endTick = -1);
+
     Q_INVOKABLE apiv1::Segment* firstSegment();   // TODO: segment type
     /// \cond MS_INTERNAL
     Segment* lastSegment();
@@ -22,6 +22,9 @@
 
 #include "scoreelement.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include "engraving/dom/engravingobject.h"
 #include "engraving/dom/score.h"
 
@@ -32,8 +35,14 @@
 #include "part.h"
 #include "elements.h"
 
+#include "log.h"
+
 using namespace mu::engraving::apiv1;
 
+//! NOTE Objects may be deleted on the layout threads, so the caches are locked
+static std::mutex s_wrappersMutex;
+static std::vector<WrapperCache*> s_runningCaches;
+
 ScoreElement::~ScoreElement()
 {
     if (_ownership == Ownership::PLUGIN) {
@@ -176,6 +185,178 @@ void ScoreElement::set(mu::engraving::Pid pid, const QVariant& val)
     }
 }
 
+//---------------------------------------------------------
+//   WrapperCache
+//---------------------------------------------------------
+
+WrapperCache::~WrapperCache()
+{
+    end();
+}
+
+WrapperCache* WrapperCache::current()
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+    return s_runningCaches.empty() ? nullptr : s_runningCaches.back();
+}
+
+void WrapperCache::start()
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+    if (m_isRunning) {
+        return;
+    }
+
+    if (s_runningCaches.empty()) {
+        mu::engraving::EngravingObject::setDeletionObserver(&WrapperCache::onObjectDeleted);
+    }
+
+    s_runningCaches.push_back(this);
+    m_isRunning = true;
+}
+
+void WrapperCache::end()
+{
+    WrapperList wrappers;
+
+    {
+        std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+        if (!m_isRunning) {
+            return;
+        }
+
+        s_runningCaches.erase(std::remove(s_runningCaches.begin(), s_runningCaches.end(), this), s_runningCaches.end());
+        m_isRunning = false;
+
+        if (s_runningCaches.empty()) {
+            mu::engraving::EngravingObject::setDeletionObserver(nullptr);
+        }
+
+        for (auto& scoreWrappers : m_wrappers) {
+            for (auto& objWrappers : scoreWrappers.second) {
+                wrappers.insert(wrappers.end(), objWrappers.second.begin(), objWrappers.second.end());
+            }
+        }
+
+        m_wrappers.clear();
+    }
+
+    //! NOTE JavaScript references to the wrappers become null
+    for (ScoreElement* wrapper : wrappers) {
+        wrapper->deleteLater();
+    }
+}
+
+bool WrapperCache::isRunning() const
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+    return m_isRunning;
+}
+
+ScoreElement* WrapperCache::find(const mu::engraving::EngravingObject* obj, const QMetaObject* wrapperType) const
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+    auto scoreIt = m_wrappers.find(obj->score());
+    if (scoreIt == m_wrappers.end()) {
+        return nullptr;
+    }
+
+    auto it = scoreIt->second.find(obj);
+    if (it == scoreIt->second.end()) {
+        return nullptr;
+    }
+
+    for (ScoreElement* wrapper : it->second) {
+        if (wrapper->metaObject() == wrapperType && wrapper->ownership() == Ownership::SCORE) {
+            return wrapper;
+        }
+    }
+
+    return nullptr;
+}
+
+void WrapperCache::insert(const mu::engraving::EngravingObject* obj, ScoreElement* wrapper)
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+    IF_ASSERT_FAILED(m_isRunning) {
+        return;
+    }
+
+    m_wrappers[obj->score()][obj].push_back(wrapper);
+}
+
+size_t WrapperCache::size() const
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+    size_t result = 0;
+    for (const auto& scoreWrappers : m_wrappers) {
+        result += scoreWrappers.second.size();
+    }
+
+    return result;
+}
+
+size_t WrapperCache::size(const mu::engraving::Score* score) const
+{
+    std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+    auto it = m_wrappers.find(score);
+    return it != m_wrappers.end() ? it->second.size() : 0;
+}
+
+void WrapperCache::takeWrappers(const mu::engraving::EngravingObject* obj, WrapperList& wrappers)
+{
+    // a score takes the wrappers of all its objects with it
+    if (obj->isScore()) {
+        auto scoreIt = m_wrappers.find(static_cast<const mu::engraving::Score*>(obj));
+        if (scoreIt != m_wrappers.end()) {
+            for (auto& objWrappers : scoreIt->second) {
+                wrappers.insert(wrappers.end(), objWrappers.second.begin(), objWrappers.second.end());
+            }
+            m_wrappers.erase(scoreIt);
+        }
+        return;
+    }
+
+    auto scoreIt = m_wrappers.find(obj->score());
+    if (scoreIt == m_wrappers.end()) {
+        return;
+    }
+
+    auto it = scoreIt->second.find(obj);
+    if (it == scoreIt->second.end()) {
+        return;
+    }
+
+    wrappers.insert(wrappers.end(), it->second.begin(), it->second.end());
+    scoreIt->second.erase(it);
+}
+
+void WrapperCache::onObjectDeleted(mu::engraving::EngravingObject* obj)
+{
+    WrapperList wrappers;
+
+    {
+        std::lock_guard<std::mutex> lock(s_wrappersMutex);
+
+        for (WrapperCache* cache : s_runningCaches) {
+            cache->takeWrappers(obj, wrappers);
+        }
+    }
+
+    //! NOTE The wrapper may be in the middle of a call which deleted its object
+    //! (e.g. removeElement()), so it is destroyed on the next event loop iteration.
+    //! JavaScript references to it become null at that point.
+    for (ScoreElement* wrapper : wrappers) {
+        wrapper->deleteLater();
+    }
+}
+
 //---------------------------------------------------------
 //   wrap
 ///   \cond PLUGIN_API \private \endcond
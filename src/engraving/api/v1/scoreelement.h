@@ -23,6 +23,9 @@
 #ifndef MU_ENGRAVING_APIV1_SCOREELEMENT_H
 #define MU_ENGRAVING_APIV1_SCOREELEMENT_H
 
+#include <unordered_map>
+#include <vector>
+
 #include <QVariant>
 #include <QQmlEngine>
 
@@ -31,6 +34,7 @@
 
 namespace mu::engraving {
 class EngravingObject;
+class Score;
 }
 
 namespace mu::engraving::apiv1 {
@@ -102,6 +106,52 @@ public:
     Q_INVOKABLE bool is(apiv1::ScoreElement* other) { return other && element() == other->element(); }
 };
 
+//---------------------------------------------------------
+//   WrapperCache
+///   \cond PLUGIN_API \private \endcond
+///   \internal
+///   Keeps a single wrapper per score-owned object and
+///   wrapper type while a plugin runs, so that walking a
+///   score does not create a new QObject on every access.
+///   Each plugin owns its cache, which keeps the wrappers
+///   of every score apart. Cached wrappers are deleted
+///   together with the object they wrap, or when the
+///   plugin ends.
+//---------------------------------------------------------
+
+class WrapperCache
+{
+public:
+    WrapperCache() = default;
+    ~WrapperCache();
+
+    WrapperCache(const WrapperCache&) = delete;
+    WrapperCache& operator=(const WrapperCache&) = delete;
+
+    //! NOTE The cache of the plugin which has started last and is still running, if any
+    static WrapperCache* current();
+
+    void start();
+    void end();
+    bool isRunning() const;
+
+    ScoreElement* find(const mu::engraving::EngravingObject* obj, const QMetaObject* wrapperType) const;
+    void insert(const mu::engraving::EngravingObject* obj, ScoreElement* wrapper);
+
+    size_t size() const;
+    size_t size(const mu::engraving::Score* score) const;
+
+private:
+    using WrapperList = std::vector<ScoreElement*>;
+    using ScoreWrappers = std::unordered_map<const mu::engraving::EngravingObject*, WrapperList>;
+
+    static void onObjectDeleted(mu::engraving::EngravingObject* obj);
+    void takeWrappers(const mu::engraving::EngravingObject* obj, WrapperList& wrappers);
+
+    std::unordered_map<const mu::engraving::Score*, ScoreWrappers> m_wrappers;
+    bool m_isRunning = false;
+};
+
 //---------------------------------------------------------
 //   wrap
 ///   \cond PLUGIN_API \private \endcond
@@ -112,8 +162,25 @@ public:
 template<class Wrapper, class T>
 Wrapper* wrap(T* t, Ownership own = Ownership::SCORE)
 {
-    Wrapper* w = t ? new Wrapper(t, own) : nullptr;
-    // All wrapper objects should belong to JavaScript code.
+    if (!t) {
+        return nullptr;
+    }
+
+    // Objects owned by the score outlive the wrapper, so it can be shared while the plugin runs.
+    WrapperCache* cache = own == Ownership::SCORE ? WrapperCache::current() : nullptr;
+    if (cache) {
+        if (ScoreElement* cached = cache->find(t, &Wrapper::staticMetaObject)) {
+            return static_cast<Wrapper*>(cached);
+        }
+
+        Wrapper* w = new Wrapper(t, own);
+        QQmlEngine::setObjectOwnership(w, QQmlEngine::CppOwnership);
+        cache->insert(t, w);
+        return w;
+    }
+
+    Wrapper* w = new Wrapper(t, own);
+    // Wrappers outside of the cache should belong to JavaScript code.
     QQmlEngine::setObjectOwnership(w, QQmlEngine::JavaScriptOwnership);
     return w;
 }
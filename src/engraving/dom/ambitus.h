@@ -59,7 +59,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     double mag() const override;
 
@@ -76,7 +76,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     BarLine* clone() const override { return new BarLine(*this); }
     Fraction playTick() const override;
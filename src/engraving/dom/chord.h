@@ -103,7 +103,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
     void scanElements(void* data, void (* func)(void*, EngravingItem*), bool all=true) override;
 
     Chord* clone() const override { return new Chord(*this, false); }
@@ -175,6 +175,13 @@ EngravingItemList EngravingItem::childrenItems(bool all) const
     return list;
 }
 
+std::vector<EngravingItem*>& EngravingItem::childItemStack()
+{
+    //! NOTE The layout visits the children on several threads
+    thread_local std::vector<EngravingItem*> stack;
+    return stack;
+}
+
 #ifndef ENGRAVING_NO_ACCESSIBILITY
 AccessibleItemPtr EngravingItem::createAccessible()
 {
@@ -305,12 +312,16 @@ void EngravingItem::deleteLater()
 
 void EngravingItem::scanElements(void* data, void (* func)(void*, EngravingItem*), bool all)
 {
-    if (scanChildren().size() == 0) {
+    bool hasChildren = false;
+    forEachChild([data, func, all, &hasChildren](EngravingObject* child) {
+        hasChildren = true;
+        child->scanElements(data, func, all);
+    });
+
+    if (!hasChildren) {
         if (all || visible() || score()->isShowInvisible()) {
             func(data, this);
         }
-    } else {
-        EngravingObject::scanElements(data, func, all);
     }
 }
 
@@ -1642,9 +1653,9 @@ RectF EngravingItem::symBbox(const SymIdList& symbols) const
 Shape EngravingItem::symShapeWithCutouts(SymId id) const
 {
     Shape shape = score()->engravingFont()->shapeWithCutouts(id, magS());
-    for (ShapeElement& element : shape.elements()) {
+    shape.for_each([this](ShapeElement& element) {
         element.setItem(this);
-    }
+    });
 
     return shape;
 }
@@ -24,6 +24,7 @@
 #define MU_ENGRAVING_ELEMENT_H
 
 #include <optional>
+#include <vector>
 
 #include "draw/types/color.h"
 #include "draw/types/geometry.h"
@@ -175,6 +176,29 @@ public:
     EngravingItem* parentItem(bool explicitParent = true) const;
     EngravingItemList childrenItems(bool all = false) const;
 
+    //! NOTE Visits the same items as childrenItems(false), without building a list.
+    //! The children are visited from a snapshot, so func may add or remove children (layout does);
+    //! the snapshot is kept on a per-thread stack, which stops allocating once it has grown
+    template<typename Func>
+    void forEachChildItem(Func&& func) const
+    {
+        std::vector<EngravingItem*>& stack = childItemStack();
+        const size_t begin = stack.size();
+
+        for (EngravingObject* ch : children()) {
+            if (ch->isEngravingItem()) {
+                stack.push_back(static_cast<EngravingItem*>(ch));
+            }
+        }
+
+        const size_t end = stack.size();
+        for (size_t i = begin; i < end; ++i) {
+            func(stack[i]);
+        }
+
+        stack.resize(begin);
+    }
+
     EngravingItem* findAncestor(ElementType t);
     const EngravingItem* findAncestor(ElementType t) const;
 
@@ -675,6 +699,8 @@ private:
 
     friend class Factory;
 
+    static std::vector<EngravingItem*>& childItemStack();
+
 #ifndef ENGRAVING_NO_ACCESSIBILITY
     void doInitAccessible();
     AccessibleItemPtr m_accessible;
@@ -22,6 +22,7 @@
 
 #include "engravingobject.h"
 
+#include <atomic>
 #include <iterator>
 #include <unordered_set>
 
@@ -43,6 +44,9 @@ using namespace mu::engraving;
 namespace mu::engraving {
 ElementStyle const EngravingObject::EMPTY_STYLE;
 
+//! NOTE Set only while a plugin runs, deletions pay for a load otherwise
+static std::atomic<EngravingObject::DeletionObserver> s_deletionObserver = nullptr;
+
 EngravingObject* EngravingObjectList::at(size_t i) const
 {
     return *std::next(begin(), i);
@@ -122,6 +126,10 @@ EngravingObject::EngravingObject(const EngravingObject& se)
 
 EngravingObject::~EngravingObject()
 {
+    if (DeletionObserver observer = s_deletionObserver.load(std::memory_order_acquire)) {
+        observer(this);
+    }
+
     if (m_parent) {
         m_parent->removeChild(this);
     }
@@ -161,6 +169,11 @@ EngravingObject::~EngravingObject()
     delete[] m_propertyFlagsList;
 }
 
+void EngravingObject::setDeletionObserver(DeletionObserver observer)
+{
+    s_deletionObserver.store(observer, std::memory_order_release);
+}
+
 void EngravingObject::doSetParent(EngravingObject* p)
 {
     if (m_parent == p) {
@@ -316,9 +329,22 @@ const MStyle& EngravingObject::style() const
 
 void EngravingObject::scanElements(void* data, void (* func)(void*, EngravingItem*), bool all)
 {
-    for (EngravingObject* child : scanChildren()) {
+    forEachChild([data, func, all](EngravingObject* child) {
         child->scanElements(data, func, all);
-    }
+    });
+}
+
+//---------------------------------------------------------
+//   scanChildren
+//---------------------------------------------------------
+
+EngravingObjectList EngravingObject::scanChildren() const
+{
+    EngravingObjectList children;
+    forEachChild([&children](EngravingObject* child) {
+        children.push_back(child);
+    });
+    return children;
 }
 
 //---------------------------------------------------------
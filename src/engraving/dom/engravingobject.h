@@ -23,6 +23,9 @@
 #ifndef MU_ENGRAVING_OBJECT_H
 #define MU_ENGRAVING_OBJECT_H
 
+#include <memory>
+#include <type_traits>
+
 #include "global/allocator.h"
 #include "types/string.h"
 
@@ -196,6 +199,25 @@ public:
     EngravingObject* at(size_t i) const;
 };
 
+//! NOTE Non-owning reference to a `void(EngravingObject*)` callable,
+//! lets the score tree be visited without building a list of children per node
+class ChildVisitor
+{
+public:
+    template<typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, ChildVisitor> > >
+    ChildVisitor(Func&& func)
+        : m_func(const_cast<void*>(static_cast<const void*>(std::addressof(func)))),
+        m_call([](void* f, EngravingObject* child) { (*static_cast<std::remove_reference_t<Func>*>(f))(child); })
+    {
+    }
+
+    void operator()(EngravingObject* child) const { m_call(m_func, child); }
+
+private:
+    void* m_func = nullptr;
+    void (* m_call)(void*, EngravingObject*) = nullptr;
+};
+
 class EngravingObject
 {
 public:
@@ -207,6 +229,10 @@ public:
 
     virtual ~EngravingObject();
 
+    //! NOTE Lets the caches of a running plugin forget deleted objects
+    using DeletionObserver = void (*)(EngravingObject*);
+    static void setDeletionObserver(DeletionObserver observer);
+
     inline ElementType type() const { return m_type; }
     inline bool isType(ElementType t) const { return t == m_type; }
     const char* typeName() const;
@@ -227,7 +253,8 @@ public:
     // Score Tree functions for scan function
     friend class EngravingElementsProvider;
     virtual EngravingObject* scanParent() const { return m_parent; }
-    virtual EngravingObjectList scanChildren() const { return {}; }
+    virtual void forEachChild(const ChildVisitor&) const {}
+    EngravingObjectList scanChildren() const; // collects forEachChild(), prefer the latter in hot paths
     virtual void scanElements(void* data, void (* func)(void*, EngravingItem*), bool all=true);
 
     // context
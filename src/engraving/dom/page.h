@@ -51,7 +51,7 @@ class Page final : public EngravingItem
 public:
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     Page* clone() const override { return new Page(*this); }
     const std::vector<System*>& systems() const { return m_systems; }
@@ -0,0 +1,289 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "playbacktimeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "types/constants.h"
+
+#include "repeatlist.h"
+#include "tempo.h"
+
+using namespace mu::engraving;
+
+static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+
+// the tempo TempoMap uses before its first event
+static constexpr double DEFAULT_TEMPO = 2.0;
+
+//---------------------------------------------------------
+//   build
+//---------------------------------------------------------
+
+void PlaybackTimeline::build(const std::vector<RepeatSegment*>& segments, const TempoMap& tempomap)
+{
+    clear();
+
+    m_tempoSN = tempomap.tempoSN();
+    m_tempoMultiplier = tempomap.tempoMultiplier().val;
+
+    for (const auto& pair : tempomap) {
+        m_tempoTicks.push_back(pair.first);
+        m_tempoTimes.push_back(pair.second.time);
+        m_tempoPauses.push_back(pair.second.pause);
+        m_tempoValues.push_back(pair.second.tempo.val);
+    }
+
+    auto addBreakpoint = [this](int utick, int tickOffset, size_t tempoIdx, double timeOffset) {
+        m_uticks.push_back(utick);
+        m_tickOffsets.push_back(tickOffset);
+        m_timeOffsets.push_back(timeOffset);
+
+        if (tempoIdx == NO_INDEX) {
+            m_refTicks.push_back(0);
+            m_refTimes.push_back(0.0);
+            m_ticksPerSecond.push_back(Constants::DIVISION * DEFAULT_TEMPO * m_tempoMultiplier);
+        } else {
+            m_refTicks.push_back(m_tempoTicks[tempoIdx]);
+            m_refTimes.push_back(m_tempoTimes[tempoIdx]);
+            m_ticksPerSecond.push_back(Constants::DIVISION * m_tempoValues[tempoIdx] * m_tempoMultiplier);
+        }
+    };
+
+    std::vector<int> tickBounds;
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const RepeatSegment* s = segments[i];
+        const int endTick = s->tick + s->len();
+        const int tickOffset = s->utick - s->tick;
+
+        m_segmentUticks.push_back(s->utick);
+        m_segmentTicks.push_back(s->tick);
+        m_segmentUtimes.push_back(s->utime);
+        m_segmentTimeOffsets.push_back(s->timeOffset);
+
+        tickBounds.push_back(s->tick);
+        tickBounds.push_back(endTick);
+
+        // the tempo in effect at the start of the segment
+        size_t tempoIdx = std::upper_bound(m_tempoTicks.cbegin(), m_tempoTicks.cend(), s->tick) - m_tempoTicks.cbegin();
+        addBreakpoint(s->utick, tickOffset, tempoIdx > 0 ? tempoIdx - 1 : NO_INDEX, s->timeOffset);
+
+        // the tempo changes inside it; the last segment is open-ended
+        const bool isLast = i + 1 == segments.size();
+        for (; tempoIdx < m_tempoTicks.size() && (isLast || m_tempoTicks[tempoIdx] < endTick); ++tempoIdx) {
+            addBreakpoint(m_tempoTicks[tempoIdx] + tickOffset, tickOffset, tempoIdx, s->timeOffset);
+        }
+    }
+
+    std::sort(tickBounds.begin(), tickBounds.end());
+    tickBounds.erase(std::unique(tickBounds.begin(), tickBounds.end()), tickBounds.end());
+
+    for (size_t k = 0; k + 1 < tickBounds.size(); ++k) {
+        size_t segmentIdx = NO_INDEX;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (m_segmentTicks[i] <= tickBounds[k] && tickBounds[k + 1] <= m_segmentTicks[i] + segments[i]->len()) {
+                segmentIdx = i;
+                break;
+            }
+        }
+        m_tickBounds.push_back(tickBounds[k]);
+        m_tickBoundSegments.push_back(segmentIdx);
+    }
+
+    if (!tickBounds.empty()) {
+        m_tickBounds.push_back(tickBounds.back());
+        m_tickBoundSegments.push_back(NO_INDEX);
+    }
+
+    m_built = true;
+}
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void PlaybackTimeline::clear()
+{
+    m_built = false;
+
+    m_segmentUticks.clear();
+    m_segmentTicks.clear();
+    m_segmentUtimes.clear();
+    m_segmentTimeOffsets.clear();
+
+    m_tickBounds.clear();
+    m_tickBoundSegments.clear();
+
+    m_uticks.clear();
+    m_tickOffsets.clear();
+    m_refTicks.clear();
+    m_refTimes.clear();
+    m_ticksPerSecond.clear();
+    m_timeOffsets.clear();
+
+    m_tempoTicks.clear();
+    m_tempoTimes.clear();
+    m_tempoPauses.clear();
+    m_tempoValues.clear();
+}
+
+bool PlaybackTimeline::isValid(const TempoMap& tempomap) const
+{
+    return m_built && m_tempoSN == tempomap.tempoSN();
+}
+
+//---------------------------------------------------------
+//   utick2tick
+//---------------------------------------------------------
+
+int PlaybackTimeline::utick2tick(int utick) const
+{
+    if (m_segmentUticks.empty()) {
+        return utick;
+    }
+    if (utick < 0) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(m_segmentUticks.cbegin(), m_segmentUticks.cend(), utick);
+    if (it == m_segmentUticks.cbegin()) {
+        return 0;
+    }
+
+    const size_t idx = it - m_segmentUticks.cbegin() - 1;
+    return utick - (m_segmentUticks[idx] - m_segmentTicks[idx]);
+}
+
+//---------------------------------------------------------
+//   tick2utick
+//    The first time the tick is played
+//---------------------------------------------------------
+
+int PlaybackTimeline::tick2utick(int tick) const
+{
+    if (m_segmentUticks.empty()) {
+        return 0;
+    }
+
+    size_t segmentIdx = m_segmentUticks.size() - 1;
+
+    auto it = std::upper_bound(m_tickBounds.cbegin(), m_tickBounds.cend(), tick);
+    if (it != m_tickBounds.cbegin()) {
+        const size_t k = it - m_tickBounds.cbegin() - 1;
+        if (m_tickBoundSegments[k] != NO_INDEX) {
+            segmentIdx = m_tickBoundSegments[k];
+        }
+    }
+
+    return m_segmentUticks[segmentIdx] + (tick - m_segmentTicks[segmentIdx]);
+}
+
+//---------------------------------------------------------
+//   utick2utime
+//---------------------------------------------------------
+
+size_t PlaybackTimeline::findBreakpoint(int utick) const
+{
+    auto it = std::upper_bound(m_uticks.cbegin(), m_uticks.cend(), utick);
+    if (it == m_uticks.cbegin()) {
+        return NO_INDEX;
+    }
+    return it - m_uticks.cbegin() - 1;
+}
+
+double PlaybackTimeline::breakpointTime(size_t idx, int utick) const
+{
+    // same operations as TempoMap::tick2time(), so that the result is the same to the bit
+    const int tick = utick - m_tickOffsets[idx];
+    const double time = m_refTimes[idx] + double(tick - m_refTicks[idx]) / m_ticksPerSecond[idx];
+    return time + m_timeOffsets[idx];
+}
+
+double PlaybackTimeline::utick2utime(int utick) const
+{
+    const size_t idx = findBreakpoint(utick);
+    return idx == NO_INDEX ? 0.0 : breakpointTime(idx, utick);
+}
+
+void PlaybackTimeline::utick2utime(const std::vector<int>& uticks, std::vector<double>& utimes) const
+{
+    utimes.resize(uticks.size());
+
+    size_t idx = NO_INDEX;
+    for (size_t i = 0; i < uticks.size(); ++i) {
+        const int utick = uticks[i];
+
+        if (idx == NO_INDEX || utick < m_uticks[idx]) {
+            idx = findBreakpoint(utick);
+        } else {
+            while (idx + 1 < m_uticks.size() && m_uticks[idx + 1] <= utick) {
+                ++idx;
+            }
+        }
+
+        utimes[i] = idx == NO_INDEX ? 0.0 : breakpointTime(idx, utick);
+    }
+}
+
+//---------------------------------------------------------
+//   utime2utick
+//---------------------------------------------------------
+
+int PlaybackTimeline::tempoTime2tick(double time) const
+{
+    // same as TempoMap::time2tick(): the first event at or after the time
+    // tells whether the time falls into its pause
+    const size_t idx = std::lower_bound(m_tempoTimes.cbegin(), m_tempoTimes.cend(), time) - m_tempoTimes.cbegin();
+
+    int tick = 0;
+    double delta = 0.0;
+    double tempo = DEFAULT_TEMPO;
+
+    if (idx > 0) {
+        tick = m_tempoTicks[idx - 1];
+        delta = m_tempoTimes[idx - 1];
+        tempo = m_tempoValues[idx - 1];
+    }
+
+    if (idx < m_tempoTimes.size() && time > m_tempoTimes[idx] - m_tempoPauses[idx]) {
+        delta = (time - (m_tempoTimes[idx] - m_tempoPauses[idx]) + delta);
+    }
+
+    delta = time - delta;
+    tick += lrint(delta * m_tempoMultiplier * Constants::DIVISION * tempo);
+
+    return tick;
+}
+
+int PlaybackTimeline::utime2utick(double utime) const
+{
+    auto it = std::upper_bound(m_segmentUtimes.cbegin(), m_segmentUtimes.cend(), utime);
+    if (it == m_segmentUtimes.cbegin()) {
+        return 0;
+    }
+
+    const size_t idx = it - m_segmentUtimes.cbegin() - 1;
+    return tempoTime2tick(utime - m_segmentTimeOffsets[idx]) + (m_segmentUticks[idx] - m_segmentTicks[idx]);
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_ENGRAVING_PLAYBACKTIMELINE_H
+#define MU_ENGRAVING_PLAYBACKTIMELINE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace mu::engraving {
+class RepeatSegment;
+class TempoMap;
+
+//---------------------------------------------------------
+//   PlaybackTimeline
+//    Compiled form of a RepeatList and the TempoMap, kept
+//    in flat arrays, so that conversions between uticks,
+//    ticks and seconds are binary searches instead of
+//    walking the repeat segments and the tempo map.
+//    The results are exactly the same as the ones of
+//    RepeatList and TempoMap.
+//---------------------------------------------------------
+
+class PlaybackTimeline
+{
+public:
+    void build(const std::vector<RepeatSegment*>& segments, const TempoMap& tempomap);
+    void clear();
+
+    //! NOTE The timeline is a snapshot: it is out of date as soon as the tempo map changes
+    bool isValid(const TempoMap& tempomap) const;
+
+    int utick2tick(int utick) const;
+    int tick2utick(int tick) const;
+    double utick2utime(int utick) const;
+    int utime2utick(double utime) const;
+
+    //! NOTE Converts many uticks at once, walking the timeline instead of searching it
+    //! for every value. The uticks are expected to be sorted, unsorted ones are just slower
+    void utick2utime(const std::vector<int>& uticks, std::vector<double>& utimes) const;
+
+private:
+    size_t findBreakpoint(int utick) const;
+    double breakpointTime(size_t idx, int utick) const;
+    int tempoTime2tick(double time) const;
+
+    bool m_built = false;
+    int m_tempoSN = 0;
+
+    // repeat segments
+    std::vector<int> m_segmentUticks;
+    std::vector<int> m_segmentTicks;
+    std::vector<double> m_segmentUtimes;
+    std::vector<double> m_segmentTimeOffsets;
+
+    // first segment playing every tick range, see tick2utick()
+    std::vector<int> m_tickBounds;
+    std::vector<size_t> m_tickBoundSegments;
+
+    // breakpoints: the start of every segment and every tempo change inside it.
+    // The time of a utick is refTime + (tick - refTick) / ticksPerSecond + timeOffset
+    std::vector<int> m_uticks;
+    std::vector<int> m_tickOffsets;
+    std::vector<int> m_refTicks;
+    std::vector<double> m_refTimes;
+    std::vector<double> m_ticksPerSecond;
+    std::vector<double> m_timeOffsets;
+
+    // tempo map events
+    std::vector<int> m_tempoTicks;
+    std::vector<double> m_tempoTimes;
+    std::vector<double> m_tempoPauses;
+    std::vector<double> m_tempoValues;
+    double m_tempoMultiplier = 1.0;
+};
+}
+
+#endif // MU_ENGRAVING_PLAYBACKTIMELINE_H
@@ -171,21 +171,32 @@ void RepeatList::update(bool expand)
 void RepeatList::updateTempo()
 {
     const TempoMap* tl = m_score->tempomap();
-    if (tl->empty()) {
-        return;
+    if (!tl->empty()) {
+        int utick = 0;
+        double t  = 0;
+
+        for (RepeatSegment* s : *this) {
+            s->utick      = utick;
+            s->utime      = t;
+            double ct      = tl->tick2time(s->tick);
+            s->timeOffset = t - ct;
+            utick        += s->len();
+            t            += tl->tick2time(s->tick + s->len()) - ct;
+        }
     }
 
-    int utick = 0;
-    double t  = 0;
+    m_timeline.build(*this, *tl);
+}
 
-    for (RepeatSegment* s : *this) {
-        s->utick      = utick;
-        s->utime      = t;
-        double ct      = tl->tick2time(s->tick);
-        s->timeOffset = t - ct;
-        utick        += s->len();
-        t            += tl->tick2time(s->tick + s->len()) - ct;
-    }
+//---------------------------------------------------------
+//   timelineValid
+//    The tempo map may change without the repeat list
+//    being updated, the slow path is used until it is
+//---------------------------------------------------------
+
+bool RepeatList::timelineValid() const
+{
+    return m_timeline.isValid(*m_score->tempomap());
 }
 
 //---------------------------------------------------------
@@ -194,6 +205,10 @@ void RepeatList::updateTempo()
 
 int RepeatList::utick2tick(int tick) const
 {
+    if (timelineValid()) {
+        return m_timeline.utick2tick(tick);
+    }
+
     size_t n = size();
     if (n == 0) {
         return tick;
@@ -219,6 +234,10 @@ int RepeatList::utick2tick(int tick) const
 
 int RepeatList::tick2utick(int tick) const
 {
+    if (timelineValid()) {
+        return m_timeline.tick2utick(tick);
+    }
+
     if (empty()) {
         return 0;
     }
@@ -236,6 +255,10 @@ int RepeatList::tick2utick(int tick) const
 
 double RepeatList::utick2utime(int tick) const
 {
+    if (timelineValid()) {
+        return m_timeline.utick2utime(tick);
+    }
+
     size_t n = size();
     unsigned ii = (m_idx1 < n) && (tick >= at(m_idx1)->utick) ? m_idx1 : 0;
     for (unsigned i = ii; i < n; ++i) {
@@ -248,12 +271,29 @@ double RepeatList::utick2utime(int tick) const
     return 0.0;
 }
 
+void RepeatList::utick2utime(const std::vector<int>& uticks, std::vector<double>& utimes) const
+{
+    if (timelineValid()) {
+        m_timeline.utick2utime(uticks, utimes);
+        return;
+    }
+
+    utimes.resize(uticks.size());
+    for (size_t i = 0; i < uticks.size(); ++i) {
+        utimes[i] = utick2utime(uticks[i]);
+    }
+}
+
 //---------------------------------------------------------
 //   utime2utick
 //---------------------------------------------------------
 
 int RepeatList::utime2utick(double secs) const
 {
+    if (timelineValid()) {
+        return m_timeline.utime2utick(secs);
+    }
+
     size_t repeatSegmentsCount = size();
     unsigned ii = (m_idx2 < repeatSegmentsCount) && (secs >= at(m_idx2)->utime) ? m_idx2 : 0;
     for (unsigned i = ii; i < repeatSegmentsCount; ++i) {
@@ -291,6 +331,7 @@ void RepeatList::flatten()
 {
     muse::DeleteAll(*this);
     clear();
+    m_timeline.clear();
 
     Measure* m = m_score->firstMeasure();
     if (!m) {
@@ -305,6 +346,8 @@ void RepeatList::flatten()
     push_back(s);
 
     m_expanded = false;
+
+    m_timeline.build(*this, *m_score->tempomap());
 }
 
 //---------------------------------------------------------
@@ -776,6 +819,7 @@ void RepeatList::unwind()
 
     muse::DeleteAll(*this);
     clear();
+    m_timeline.clear();
     m_jumpsTaken.clear();
 
     if (!m_score->firstMeasure()) {
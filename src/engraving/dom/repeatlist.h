@@ -29,6 +29,8 @@
 #include "global/allocator.h"
 #include "types/string.h"
 
+#include "playbacktimeline.h"
+
 namespace mu::engraving {
 class Score;
 class Measure;
@@ -93,6 +95,7 @@ public:
     int tick2utick(int tick) const;
     int utime2utick(double secs) const;
     double utick2utime(int) const;
+    void utick2utime(const std::vector<int>& uticks, std::vector<double>& utimes) const;
     void updateTempo();
     int ticks() const;
 
@@ -109,9 +112,11 @@ private:
                      Volta const** const activeVolta, RepeatListElement const** const startRepeatReference) const;
     void unwind();
     void flatten();
+    bool timelineValid() const;
 
     Score* m_score = nullptr;
     mutable unsigned m_idx1, m_idx2 = 0;     // cached values
+    PlaybackTimeline m_timeline;
 
     bool m_expanded = false;
     bool m_scoreChanged = true;
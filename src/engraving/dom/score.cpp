@@ -695,11 +695,18 @@ void Score::dragPosition(const PointF& p, staff_idx_t* rst, Segment** seg, doubl
 
 void Score::setShowInvisible(bool v)
 {
+    if (m_showInvisible == v) {
+        return;
+    }
+
     m_showInvisible = v;
     // BSP tree does not include elements which are not
     // displayed, so we need to refresh it to get
     // invisible elements displayed or properly hidden.
     rebuildBspTree();
+    // the elements are shown or hidden all over the score, nothing is laid out again:
+    // the viewers have to paint everything again
+    setUpdateAll();
 }
 
 //---------------------------------------------------------
@@ -708,7 +715,12 @@ void Score::setShowInvisible(bool v)
 
 void Score::setShowUnprintable(bool v)
 {
+    if (m_showUnprintable == v) {
+        return;
+    }
+
     m_showUnprintable = v;
+    setUpdateAll();
 }
 
 //---------------------------------------------------------
@@ -717,7 +729,12 @@ void Score::setShowUnprintable(bool v)
 
 void Score::setShowFrames(bool v)
 {
+    if (m_showFrames == v) {
+        return;
+    }
+
     m_showFrames = v;
+    setUpdateAll();
 }
 
 //---------------------------------------------------------
@@ -726,7 +743,12 @@ void Score::setShowFrames(bool v)
 
 void Score::setShowPageborders(bool v)
 {
+    if (m_showPageborders == v) {
+        return;
+    }
+
     m_showPageborders = v;
+    setUpdateAll();
 }
 
 void Score::setShowSoundFlags(bool v)
@@ -745,7 +767,12 @@ void Score::setShowSoundFlags(bool v)
 
 void Score::setMarkIrregularMeasures(bool v)
 {
+    if (m_markIrregularMeasures == v) {
+        return;
+    }
+
     m_markIrregularMeasures = v;
+    setUpdateAll();
 }
 
 void Score::updateShowAnchors(staff_idx_t staffIdx, const Fraction& startTick, const Fraction& endTick)
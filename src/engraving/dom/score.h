@@ -280,7 +280,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
     void scanElements(void* data, void (* func)(void*, EngravingItem*), bool all=true) override;
 
     void dumpScoreTree();  // for debugging purposes
@@ -75,15 +75,11 @@ EngravingObject* Score::scanParent() const
     return nullptr;  // Score is root node
 }
 
-EngravingObjectList Score::scanChildren() const
+void Score::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (Page* page : pages()) {
-        children.push_back(page);
+        visit(page);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -95,15 +91,11 @@ EngravingObject* Page::scanParent() const
     return score();
 }
 
-EngravingObjectList Page::scanChildren() const
+void Page::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (System* system : systems()) {
-        children.push_back(system);
+        visit(system);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -115,33 +107,29 @@ EngravingObject* System::scanParent() const
     return page();
 }
 
-EngravingObjectList System::scanChildren() const
+void System::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (Bracket* bracket : brackets()) {
-        children.push_back(bracket);
+        visit(bracket);
     }
 
     if (auto dividerLeft = systemDividerLeft()) {
-        children.push_back(dividerLeft);
+        visit(dividerLeft);
     }
 
     if (auto dividerRight = systemDividerRight()) {
-        children.push_back(dividerRight);
+        visit(dividerRight);
     }
 
     for (SysStaff* staff : m_staves) {
         for (InstrumentName* instrName : staff->instrumentNames) {
-            children.push_back(instrName);
+            visit(instrName);
         }
     }
 
     for (MeasureBase* measure : measures()) {
-        children.push_back(measure);
+        visit(measure);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -153,15 +141,11 @@ EngravingObject* MeasureBase::scanParent() const
     return system();
 }
 
-EngravingObjectList MeasureBase::scanChildren() const
+void MeasureBase::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (EngravingItem* element : el()) {
-        children.push_back(element);
+        visit(element);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -181,51 +165,49 @@ EngravingObject* Measure::scanParent() const
     return system();
 }
 
-EngravingObjectList Measure::scanChildren() const
+void Measure::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (EngravingItem* element : el()) {
-        children.push_back(element);
+        visit(element);
     }
 
     if (isMMRest()) {
         Measure* m1 = mmRestFirst();
         Measure* m2 = mmRestLast();
         while (m1 != m2) {
-            children.push_back(m1);
+            visit(m1);
             m1 = m1->nextMeasure();
         }
 
-        return children;
+        return;
     }
 
     Segment* seg = m_segments.first();
     while (seg) {
-        children.push_back(seg);
+        visit(seg);
         seg = seg->next();
     }
 
     size_t nstaves = score()->nstaves();
     for (staff_idx_t staffIdx = 0; staffIdx < nstaves; ++staffIdx) {
         if (auto _staffLines = m_mstaves[staffIdx]->lines()) {
-            children.push_back(_staffLines);
+            visit(_staffLines);
         }
 
         if (auto _vspacerUp = vspacerUp(staffIdx)) {
-            children.push_back(_vspacerUp);
+            visit(_vspacerUp);
         }
 
         if (auto _vspacerDown = vspacerDown(staffIdx)) {
-            children.push_back(_vspacerDown);
+            visit(_vspacerDown);
         }
 
         if (auto _noText = noText(staffIdx)) {
-            children.push_back(_noText);
+            visit(_noText);
         }
 
         if (auto _mmRangeText = mmRangeText(staffIdx)) {
-            children.push_back(_mmRangeText);
+            visit(_mmRangeText);
         }
     }
 
@@ -234,22 +216,18 @@ EngravingObjectList Measure::scanChildren() const
     for (auto i = spannerMap.lower_bound(start_tick); i != spannerMap.upper_bound(start_tick); ++i) {
         Spanner* s = i->second;
         if (s->anchor() == Spanner::Anchor::MEASURE) {
-            children.push_back(s);
+            visit(s);
         }
     }
 
     const std::set<Spanner*>& unmanagedSpanners = score()->unmanagedSpanners();
     for (Spanner* s : unmanagedSpanners) {
         if (s->scanParent() == this) {
-            children.push_back(s);
+            visit(s);
         }
     }
 
-    for (EngravingObject* obj : MeasureBase::scanChildren()) {
-        children.push_back(obj);
-    }
-
-    return children;
+    MeasureBase::forEachChild(visit);
 }
 
 //---------------------------------------------------------
@@ -261,18 +239,16 @@ EngravingObject* Segment::scanParent() const
     return measure();
 }
 
-EngravingObjectList Segment::scanChildren() const
+void Segment::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (EngravingItem* element : m_elist) {
         if (element) {
-            children.push_back(element);
+            visit(element);
         }
     }
 
     for (EngravingItem* annotation : m_annotations) {
-        children.push_back(annotation);
+        visit(annotation);
     }
 
     if (segmentType() == SegmentType::ChordRest) {
@@ -281,18 +257,16 @@ EngravingObjectList Segment::scanChildren() const
         for (auto i = spannerMap.lower_bound(start_tick); i != spannerMap.upper_bound(start_tick); ++i) {
             Spanner* s = i->second;
             if (s->anchor() == Spanner::Anchor::SEGMENT) {
-                children.push_back(s);
+                visit(s);
             }
         }
         const std::set<Spanner*>& unmanagedSpanners = score()->unmanagedSpanners();
         for (Spanner* s : unmanagedSpanners) {
             if (s->scanParent() == this) {
-                children.push_back(s);
+                visit(s);
             }
         }
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -309,31 +283,29 @@ EngravingObject* ChordRest::scanParent() const
     return segment();
 }
 
-EngravingObjectList ChordRest::scanChildren() const
+void ChordRest::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     Beam* _b = beam();
     if (_b && _b->scanParent() == this) {
-        children.push_back(_b);
+        visit(_b);
     }
 
     for (Lyrics* lyrics : m_lyrics) {
-        children.push_back(lyrics);
+        visit(lyrics);
     }
 
     const DurationElement* de = this;
     while (de->tuplet() && de->tuplet()->elements().front() == de) {
-        children.push_back(de->tuplet());
+        visit(de->tuplet());
         de = de->tuplet();
     }
 
     if (auto tabDuration = m_tabDur) {
-        children.push_back(tabDuration);
+        visit(tabDuration);
     }
 
     for (EngravingItem* element : m_el) {
-        children.push_back(element);
+        visit(element);
     }
 
     const std::multimap<int, Spanner*>& spannerMap = score()->spanner();
@@ -341,17 +313,15 @@ EngravingObjectList ChordRest::scanChildren() const
     for (auto i = spannerMap.lower_bound(start_tick); i != spannerMap.upper_bound(start_tick); ++i) {
         Spanner* s = i->second;
         if (s->anchor() == Spanner::Anchor::CHORD && s->scanParent() == this) {
-            children.push_back(s);
+            visit(s);
         }
     }
     const std::set<Spanner*>& unmanagedSpanners = score()->unmanagedSpanners();
     for (Spanner* s : unmanagedSpanners) {
         if (s->scanParent() == this) {
-            children.push_back(s);
+            visit(s);
         }
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -363,57 +333,51 @@ EngravingObject* Chord::scanParent() const
     return ChordRest::scanParent();
 }
 
-EngravingObjectList Chord::scanChildren() const
+void Chord::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (Note* note : notes()) {
-        children.push_back(note);
+        visit(note);
     }
 
     if (m_arpeggio) {
-        children.push_back(m_arpeggio);
+        visit(m_arpeggio);
     }
 
     if (m_tremoloSingleChord && m_tremoloSingleChord->chord() == this) {
-        children.push_back(m_tremoloSingleChord);
+        visit(m_tremoloSingleChord);
     }
 
     if (m_tremoloTwoChord && m_tremoloTwoChord->chord1() == this) {
-        children.push_back(m_tremoloTwoChord);
+        visit(m_tremoloTwoChord);
     }
 
     for (Chord* chord : graceNotes()) {
-        children.push_back(chord);
+        visit(chord);
     }
 
     for (Articulation* art : articulations()) {
-        children.push_back(art);
+        visit(art);
     }
 
     if (m_stem) {
-        children.push_back(m_stem);
+        visit(m_stem);
     }
 
     if (m_hook) {
-        children.push_back(m_hook);
+        visit(m_hook);
     }
 
     if (m_stemSlash) {
-        children.push_back(m_stemSlash);
+        visit(m_stemSlash);
     }
 
     LedgerLine* ledgerLines = m_ledgerLines;
     while (ledgerLines) {
-        children.push_back(ledgerLines);
+        visit(ledgerLines);
         ledgerLines = ledgerLines->next();
     }
 
-    for (EngravingObject* child : ChordRest::scanChildren()) {
-        children.push_back(child);
-    }
-
-    return children;
+    ChordRest::forEachChild(visit);
 }
 
 //---------------------------------------------------------
@@ -425,19 +389,13 @@ EngravingObject* Rest::scanParent() const
     return ChordRest::scanParent();
 }
 
-EngravingObjectList Rest::scanChildren() const
+void Rest::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (NoteDot* noteDot : m_dots) {
-        children.push_back(noteDot);
-    }
-
-    for (EngravingObject* child : ChordRest::scanChildren()) {
-        children.push_back(child);
+        visit(noteDot);
     }
 
-    return children;
+    ChordRest::forEachChild(visit);
 }
 
 //---------------------------------------------------------
@@ -449,31 +407,27 @@ EngravingObject* Note::scanParent() const
     return chord();
 }
 
-EngravingObjectList Note::scanChildren() const
+void Note::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_accidental) {
-        children.push_back(m_accidental);
+        visit(m_accidental);
     }
 
     for (NoteDot* noteDot : m_dots) {
-        children.push_back(noteDot);
+        visit(noteDot);
     }
 
     if (m_tieFor) {
-        children.push_back(m_tieFor);
+        visit(m_tieFor);
     }
 
     for (EngravingItem* element : el()) {
-        children.push_back(element);
+        visit(element);
     }
 
     for (Spanner* spanner : spannerFor()) {
-        children.push_back(spanner);
+        visit(spanner);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -506,21 +460,17 @@ EngravingObject* Ambitus::scanParent() const
     return segment();
 }
 
-EngravingObjectList Ambitus::scanChildren() const
+void Ambitus::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     Accidental* topAccid = const_cast<Accidental*>(m_topAccidental);
     if (topAccid && topAccid->accidentalType() != AccidentalType::NONE) {
-        children.push_back(topAccid);
+        visit(topAccid);
     }
 
     Accidental* bottomAccid = const_cast<Accidental*>(m_bottomAccidental);
     if (bottomAccid && bottomAccid->accidentalType() != AccidentalType::NONE) {
-        children.push_back(bottomAccid);
+        visit(bottomAccid);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -532,15 +482,11 @@ EngravingObject* FretDiagram::scanParent() const
     return segment();
 }
 
-EngravingObjectList FretDiagram::scanChildren() const
+void FretDiagram::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_harmony) {
-        children.push_back(m_harmony);
+        visit(m_harmony);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -563,15 +509,11 @@ EngravingObject* Spanner::scanParent() const
     }
 }
 
-EngravingObjectList Spanner::scanChildren() const
+void Spanner::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (SpannerSegment* segment : spannerSegments()) {
-        children.push_back(segment);
+        visit(segment);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -592,15 +534,11 @@ EngravingObject* BSymbol::scanParent() const
     return segment();
 }
 
-EngravingObjectList BSymbol::scanChildren() const
+void BSymbol::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (EngravingItem* leaf : m_leafs) {
-        children.push_back(leaf);
+        visit(leaf);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -612,15 +550,11 @@ EngravingObject* Tuplet::scanParent() const
     return elements()[0];
 }
 
-EngravingObjectList Tuplet::scanChildren() const
+void Tuplet::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_number) {
-        children.push_back(m_number);
+        visit(m_number);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -632,15 +566,11 @@ EngravingObject* BarLine::scanParent() const
     return segment();
 }
 
-EngravingObjectList BarLine::scanChildren() const
+void BarLine::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     for (EngravingItem* element : m_el) {
-        children.push_back(element);
+        visit(element);
     }
-
-    return children;
 }
 
 //---------------------------------------------------------
@@ -652,19 +582,13 @@ EngravingObject* Trill::scanParent() const
     return Spanner::scanParent();
 }
 
-EngravingObjectList Trill::scanChildren() const
+void Trill::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_accidental) {
-        children.push_back(m_accidental);
+        visit(m_accidental);
     }
 
-    for (EngravingObject* child : Spanner::scanChildren()) {
-        children.push_back(child);
-    }
-
-    return children;
+    Spanner::forEachChild(visit);
 }
 
 //---------------------------------------------------------
@@ -676,15 +600,11 @@ EngravingObject* TBox::scanParent() const
     return explicitParent();
 }
 
-EngravingObjectList TBox::scanChildren() const
+void TBox::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_text) {
-        children.push_back(m_text);
+        visit(m_text);
     }
-
-    return children;
 }
 
 void TBox::scanElements(void* data, void (* func)(void*, EngravingItem*), bool all)
@@ -700,9 +620,9 @@ void TBox::scanElements(void* data, void (* func)(void*, EngravingItem*), bool a
 
 void _dumpScoreTree(EngravingObject* s, int depth)
 {
-    for (EngravingObject* child : s->scanChildren()) {
+    s->forEachChild([depth](EngravingObject* child) {
         _dumpScoreTree(child, depth + 1);
-    }
+    });
 }
 
 void Score::dumpScoreTree()
@@ -96,7 +96,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     Segment* clone() const override { return new Segment(*this); }
 
@@ -242,7 +242,7 @@ public:
     using EngravingItem::prevElement;
     EngravingItem* prevElement(staff_idx_t activeStaff);
 
-    std::vector<Shape> shapes() { return m_shapes; }
+    std::vector<Shape>& shapes() { return m_shapes; }
     const std::vector<Shape>& shapes() const { return m_shapes; }
     const Shape& staffShape(staff_idx_t staffIdx) const { return m_shapes[staffIdx]; }
     Shape& staffShape(staff_idx_t staffIdx) { return m_shapes[staffIdx]; }
@@ -574,13 +574,13 @@ void Spanner::scanElements(void* data, void (* func)(void*, EngravingItem*), boo
         return;
     }
 
-    for (EngravingObject* child : scanChildren()) {
+    forEachChild([data, func, all](EngravingObject* child) {
         if (child->isSpannerSegment()) {
             // spanner segments are scanned by the system
-            continue;
+            return;
         }
         child->scanElements(data, func, all);
-    }
+    });
 }
 
 //---------------------------------------------------------
@@ -71,23 +71,19 @@ PropertyValue StaffText::propertyDefault(Pid id) const
 
 void StaffText::scanElements(void* data, void (* func)(void*, EngravingItem*), bool all)
 {
-    for (EngravingObject* child: scanChildren()) {
+    forEachChild([data, func, all](EngravingObject* child) {
         child->scanElements(data, func, all);
-    }
+    });
     if (all || visible() || score()->isShowInvisible()) {
         func(data, this);
     }
 }
 
-EngravingObjectList StaffText::scanChildren() const
+void StaffText::forEachChild(const ChildVisitor& visit) const
 {
-    EngravingObjectList children;
-
     if (m_soundFlag) {
-        children.push_back(m_soundFlag);
+        visit(m_soundFlag);
     }
-
-    return children;
 }
 
 void StaffText::add(EngravingItem* e)
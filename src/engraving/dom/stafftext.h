@@ -39,7 +39,7 @@ public:
     EngravingItem* linkedClone() override;
 
     void scanElements(void* data, void (* func)(void*, EngravingItem*), bool all=true) override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     void add(EngravingItem*) override;
     void remove(EngravingItem*) override;
@@ -80,7 +80,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     Trill* clone() const override { return new Trill(*this); }
     EngravingItem* linkedClone() override;
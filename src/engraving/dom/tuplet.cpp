@@ -255,12 +255,12 @@ bool Tuplet::calcHasBracket(const DurationElement* cr1, const DurationElement* c
 
 void Tuplet::scanElements(void* data, void (* func)(void*, EngravingItem*), bool all)
 {
-    for (EngravingObject* child : scanChildren()) {
+    forEachChild([this, data, func, all](EngravingObject* child) {
         if (child == m_number && !all) {
-            continue; // don't scan number unless all is true
+            return; // don't scan number unless all is true
         }
         child->scanElements(data, func, all);
-    }
+    });
     if (all || visible() || score()->isShowInvisible()) {
         func(data, this);
     }
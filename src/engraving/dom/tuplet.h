@@ -57,7 +57,7 @@ public:
 
     // Score Tree functions
     EngravingObject* scanParent() const override;
-    EngravingObjectList scanChildren() const override;
+    void forEachChild(const ChildVisitor& visit) const override;
 
     Tuplet* clone() const override { return new Tuplet(*this); }
     void setTrack(track_idx_t val) override;
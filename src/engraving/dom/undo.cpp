@@ -273,6 +273,75 @@ void UndoCommand::filterChildren(UndoCommand::Filter f, EngravingItem* target)
     childList = std::move(acceptedList);
 }
 
+//---------------------------------------------------------
+//   memoryUsage
+//---------------------------------------------------------
+
+size_t UndoCommand::memoryUsage() const
+{
+    // a list node holds the pointer and two links
+    size_t usage = objectSize() + childList.size() * 3 * sizeof(void*);
+    for (const UndoCommand* c : childList) {
+        usage += c->memoryUsage();
+    }
+    return usage;
+}
+
+//---------------------------------------------------------
+//   coalescePropertyChanges
+///   Remove the child ChangeProperty commands which repeat
+///   an earlier change of the same property: the first one
+///   keeps the value to restore on undo, and on redo it
+///   takes the value the property had at the end.
+///   Only done if nothing in between depends on the element.
+///   Returns the number of removed commands.
+//---------------------------------------------------------
+
+size_t UndoCommand::coalescePropertyChanges()
+{
+    std::map<std::pair<const EngravingObject*, Pid>, size_t> firstChanges;
+    std::unordered_map<const EngravingObject*, size_t> lastUsages;
+    size_t lastUnknownUsage = 0;   // commands which don't tell what they change
+    size_t pos = 0;
+    size_t removed = 0;
+
+    std::list<UndoCommand*> acceptedList;
+    for (UndoCommand* cmd : childList) {
+        ++pos;
+
+        if (!strcmp(cmd->name(), "ChangeProperty")) {
+            const ChangeProperty* cp = static_cast<const ChangeProperty*>(cmd);
+            const std::pair<const EngravingObject*, Pid> key(cp->getElement(), cp->getId());
+
+            auto first = firstChanges.find(key);
+            if (first != firstChanges.end() && first->second > lastUnknownUsage) {
+                auto usage = lastUsages.find(key.first);
+                if (usage == lastUsages.end() || first->second > usage->second) {
+                    delete cmd;
+                    ++removed;
+                    continue;
+                }
+            }
+
+            firstChanges[key] = pos;
+            acceptedList.push_back(cmd);
+            continue;
+        }
+
+        const std::vector<const EngravingObject*> objects = cmd->objectItems();
+        if (objects.empty()) {
+            lastUnknownUsage = pos;
+        }
+        for (const EngravingObject* o : objects) {
+            lastUsages[o] = pos;
+        }
+        acceptedList.push_back(cmd);
+    }
+    childList = std::move(acceptedList);
+
+    return removed;
+}
+
 //---------------------------------------------------------
 //   unwind
 //---------------------------------------------------------
@@ -414,6 +483,16 @@ void UndoStack::remove(size_t idx)
 
 void UndoStack::mergeCommands(size_t startIdx)
 {
+    // The steps before the start may have been merged or forgotten meanwhile by the
+    // memory budget. Then the first step of the edit can't be told apart anymore
+    // from the ones before it, and merging would take unrelated steps in
+    if (startIdx < m_firstIdx || (startIdx == m_firstIdx && m_firstIdx > 0 && !list.empty() && list.front()->compacted())) {
+        LOGW() << "the steps from " << startIdx << " were compacted, they are not merged";
+        return;
+    }
+
+    startIdx -= m_firstIdx;
+
     assert(startIdx <= curIdx);
 
     if (startIdx >= list.size()) {
@@ -428,6 +507,217 @@ void UndoStack::mergeCommands(size_t startIdx)
     remove(startIdx + 1);   // TODO: remove from startIdx to curIdx only
 }
 
+//---------------------------------------------------------
+//   setMemoryBudget
+//---------------------------------------------------------
+
+void UndoStack::setMemoryBudget(size_t bytes)
+{
+    if (m_memoryBudget == bytes) {
+        return;
+    }
+
+    m_memoryBudget = bytes;
+
+    if (!curCmd) {
+        applyMemoryBudget();
+    }
+}
+
+//---------------------------------------------------------
+//   memoryUsage
+//---------------------------------------------------------
+
+size_t UndoStack::memoryUsage() const
+{
+    size_t usage = 0;
+    for (const UndoMacro* macro : list) {
+        usage += macro->memoryUsage();
+    }
+    return usage;
+}
+
+//---------------------------------------------------------
+//   statistics
+//---------------------------------------------------------
+
+static size_t commandCount(const UndoCommand* cmd)
+{
+    size_t count = cmd->childCount();
+    for (const UndoCommand* c : cmd->commands()) {
+        count += commandCount(c);
+    }
+    return count;
+}
+
+std::vector<UndoStack::MacroStatistic> UndoStack::statistics() const
+{
+    std::vector<MacroStatistic> result;
+    result.reserve(list.size());
+
+    for (size_t idx = 0; idx < list.size(); ++idx) {
+        MacroStatistic stat;
+        stat.index = m_firstIdx + idx;
+        stat.commandCount = commandCount(list[idx]);
+        stat.memoryUsage = list[idx]->memoryUsage();
+        stat.compacted = list[idx]->compacted();
+        result.push_back(stat);
+    }
+
+    return result;
+}
+
+//---------------------------------------------------------
+//   applyMemoryBudget
+//    The most recent steps are never touched: text editing
+//    and some dialogs merge the steps done since an index
+//    they remembered.
+//    Once over the budget, the history is reduced to 3/4
+//    of it, so that the whole history isn't scanned after
+//    every command.
+//---------------------------------------------------------
+
+static constexpr size_t KEPT_MACRO_COUNT = 100;
+static constexpr size_t COMPACT_GROUP_SIZE = 16;
+
+void UndoStack::applyMemoryBudget()
+{
+    if (m_memoryBudget == 0 || curIdx <= KEPT_MACRO_COUNT) {
+        return;
+    }
+
+    size_t usage = memoryUsage();
+    if (usage <= m_memoryBudget) {
+        return;
+    }
+
+    const size_t targetUsage = m_memoryBudget - m_memoryBudget / 4;
+
+    usage = compactMacros(curIdx - KEPT_MACRO_COUNT, usage, targetUsage);
+    if (usage > targetUsage && curIdx > KEPT_MACRO_COUNT) {
+        usage = dropMacros(curIdx - KEPT_MACRO_COUNT, usage, targetUsage);
+    }
+
+    if (usage > m_memoryBudget) {
+        LOGW() << "undo history takes " << usage << " bytes, budget: " << m_memoryBudget;
+    }
+}
+
+//---------------------------------------------------------
+//   compactMacros
+//    Merge the steps before endIdx in groups and remove
+//    the redundant property changes, returns the new usage
+//---------------------------------------------------------
+
+size_t UndoStack::compactMacros(size_t endIdx, size_t usage, size_t targetUsage)
+{
+    for (size_t idx = 0; idx < endIdx && usage > targetUsage; ++idx) {
+        UndoMacro* macro = list[idx];
+        if (macro->compacted()) {
+            continue;
+        }
+
+        const size_t groupEnd = std::min(idx + COMPACT_GROUP_SIZE, endIdx);
+        usage -= macro->memoryUsage();
+
+        for (size_t i = idx + 1; i < groupEnd; ++i) {
+            usage -= list[i]->memoryUsage();
+            macro->append(std::move(*list[i]));
+            delete list[i];
+        }
+
+        const size_t merged = groupEnd - idx - 1;
+        list.erase(list.begin() + idx + 1, list.begin() + groupEnd);
+        stateList.erase(stateList.begin() + idx + 1, stateList.begin() + groupEnd);
+        curIdx -= merged;
+        endIdx -= merged;
+        m_firstIdx += merged;
+
+        macro->compact();
+        usage += macro->memoryUsage();
+    }
+
+    return usage;
+}
+
+//---------------------------------------------------------
+//   dropMacros
+//    Forget the steps before endIdx, starting from the
+//    oldest one, returns the new usage.
+//    A done step owns the elements it removed, so these are
+//    deleted with it, unless a later command uses them again.
+//---------------------------------------------------------
+
+static void countObjectUsages(const UndoCommand* cmd, std::unordered_map<const EngravingObject*, size_t>& usages)
+{
+    for (const UndoCommand* c : cmd->commands()) {
+        countObjectUsages(c, usages);
+    }
+    for (const EngravingObject* o : cmd->objectItems()) {
+        ++usages[o];
+    }
+}
+
+static bool canForget(const UndoCommand* cmd, std::unordered_map<const EngravingObject*, size_t>& usages)
+{
+    for (const UndoCommand* c : cmd->commands()) {
+        if (!canForget(c, usages)) {
+            return false;
+        }
+    }
+
+    const std::vector<const EngravingObject*> objects = cmd->objectItems();
+    for (const EngravingObject* o : objects) {
+        --usages[o];
+    }
+
+    switch (cmd->type()) {
+    case CommandType::RemoveExcerpt:
+        return false;
+    case CommandType::RemoveElement:
+    case CommandType::RemovePart:
+    case CommandType::RemoveStaff:
+        for (const EngravingObject* o : objects) {
+            if (usages[o] > 0) {
+                return false;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+size_t UndoStack::dropMacros(size_t endIdx, size_t usage, size_t targetUsage)
+{
+    std::unordered_map<const EngravingObject*, size_t> usages;
+    for (const UndoMacro* macro : list) {
+        countObjectUsages(macro, usages);
+    }
+
+    size_t dropped = 0;
+    while (dropped < endIdx && usage > targetUsage) {
+        UndoMacro* macro = list[dropped];
+        if (!canForget(macro, usages)) {
+            break;
+        }
+
+        usage -= macro->memoryUsage();
+        macro->cleanup(true);
+        delete macro;
+        ++dropped;
+    }
+
+    list.erase(list.begin(), list.begin() + dropped);
+    stateList.erase(stateList.begin(), stateList.begin() + dropped);
+    curIdx -= dropped;
+    m_firstIdx += dropped;
+
+    return usage;
+}
+
 //---------------------------------------------------------
 //   pop
 //---------------------------------------------------------
@@ -468,11 +758,16 @@ void UndoStack::endMacro(bool rollback)
             cmd->cleanup(false);        // delete elements for which UndoCommand() holds ownership
             delete cmd;
         }
+        curCmd->resetMemoryUsage();
         list.push_back(curCmd);
         stateList.push_back(nextState++);
         ++curIdx;
     }
     curCmd = 0;
+
+    if (!rollback) {
+        applyMemoryBudget();
+    }
 }
 
 //---------------------------------------------------------
@@ -506,7 +801,7 @@ void UndoStack::undo(EditData* ed)
     // Are we currently editing text?
     if (ed && ed->element && ed->element->isTextBase()) {
         TextEditData* ted = static_cast<TextEditData*>(ed->getData(ed->element).get());
-        if (ted && ted->startUndoIdx == curIdx) {
+        if (ted && ted->startUndoIdx == getCurIdx()) {
             // No edits to undo, so do nothing
             return;
         }
@@ -624,6 +919,30 @@ void UndoMacro::append(UndoMacro&& other)
         m_redoInputState = std::move(other.m_redoInputState);
         m_redoSelectionInfo = std::move(other.m_redoSelectionInfo);
     }
+    m_memoryUsage = 0;
+    other.m_memoryUsage = 0;
+}
+
+//---------------------------------------------------------
+//   memoryUsage
+//    Cached, as the commands of a macro don't change
+//    once it is on the stack
+//---------------------------------------------------------
+
+size_t UndoMacro::memoryUsage() const
+{
+    if (m_memoryUsage == 0) {
+        m_memoryUsage = UndoCommand::memoryUsage()
+                        + (m_undoSelectionInfo.elements.capacity() + m_redoSelectionInfo.elements.capacity()) * sizeof(EngravingItem*);
+    }
+    return m_memoryUsage;
+}
+
+void UndoMacro::compact()
+{
+    coalescePropertyChanges();
+    m_memoryUsage = 0;
+    m_compacted = true;
 }
 
 const InputState& UndoMacro::undoInputState() const
@@ -98,7 +98,8 @@ class TremoloBar;
 enum class PlayEventType : char;
 
 #define UNDO_TYPE(t) CommandType type() const override { return t; }
-#define UNDO_NAME(a) const char* name() const override { return a; }
+#define UNDO_NAME(a) const char* name() const override { return a; } \
+    size_t objectSize() const override { return sizeof(*this); }
 #define UNDO_CHANGED_OBJECTS(...) std::vector<const EngravingObject*> objectItems() const override { return __VA_ARGS__; }
 
 class UndoCommand
@@ -137,6 +138,11 @@ public:
 // #endif
     virtual CommandType type() const { return CommandType::Unknown; }
 
+    //! NOTE Estimated size of the command tree, without the elements it owns
+    virtual size_t objectSize() const { return sizeof(*this); }
+    virtual size_t memoryUsage() const;
+    size_t coalescePropertyChanges();
+
     virtual bool isFiltered(Filter, const EngravingItem* /* target */) const { return false; }
     bool hasFilteredChildren(Filter, const EngravingItem* target) const;
     bool hasUnfilteredChildren(const std::vector<Filter>& filters, const EngravingItem* target) const;
@@ -185,9 +191,17 @@ public:
 
     static bool canRecordSelectedElement(const EngravingItem* e);
 
+    size_t memoryUsage() const override;
+    void resetMemoryUsage() { m_memoryUsage = 0; }
+    bool compacted() const { return m_compacted; }
+    void compact();
+
     UNDO_NAME("UndoMacro")
 
 private:
+    mutable size_t m_memoryUsage = 0;
+    bool m_compacted = false;
+
     InputState m_undoInputState;
     InputState m_redoInputState;
     SelectionInfo m_undoSelectionInfo;
@@ -209,9 +223,22 @@ class UndoStack
     size_t curIdx = 0;
     bool isLocked = false;
 
+    size_t m_memoryBudget = 0;
+    size_t m_firstIdx = 0;
+
     void remove(size_t idx);
+    void applyMemoryBudget();
+    size_t compactMacros(size_t endIdx, size_t usage, size_t targetUsage);
+    size_t dropMacros(size_t endIdx, size_t usage, size_t targetUsage);
 
 public:
+    struct MacroStatistic {
+        size_t index = 0;
+        size_t commandCount = 0;
+        size_t memoryUsage = 0;
+        bool compacted = false;
+    };
+
     UndoStack();
     ~UndoStack();
 
@@ -226,7 +253,8 @@ public:
     bool canUndo() const { return curIdx > 0; }
     bool canRedo() const { return curIdx < list.size(); }
     bool isClean() const { return cleanState == stateList[curIdx]; }
-    size_t getCurIdx() const { return curIdx; }
+    //! NOTE The index stays valid when the oldest steps are compacted or dropped
+    size_t getCurIdx() const { return m_firstIdx + curIdx; }
     UndoMacro* current() const { return curCmd; }
     UndoMacro* last() const { return curIdx > 0 ? list[curIdx - 1] : 0; }
     UndoMacro* prev() const { return curIdx > 1 ? list[curIdx - 2] : 0; }
@@ -236,6 +264,14 @@ public:
 
     void mergeCommands(size_t startIdx);
     void cleanRedoStack() { remove(curIdx); }
+
+    //! NOTE When the history takes more than the budget, the oldest steps are merged
+    //! and compacted first, then forgotten. 0 means no limit
+    size_t memoryBudget() const { return m_memoryBudget; }
+    void setMemoryBudget(size_t bytes);
+
+    size_t memoryUsage() const;
+    std::vector<MacroStatistic> statistics() const;
 };
 
 class InsertPart : public UndoCommand
@@ -71,6 +71,10 @@ EngravingProject::~EngravingProject()
     // muse::AllocatorsRegister::instance()->printStatistic("=== Destroy engraving project ===");
     //! NOTE At the moment, the allocator is working as leak detector. No need to do cleanup, at the moment it can lead to crashes
     // AllocatorsRegister::instance()->cleanupAll("engraving");
+
+    //! NOTE Give the memory of the destroyed objects back to the system,
+    //! the blocks which still contain objects of other projects are kept
+    muse::AllocatorsRegister::instance()->trimAll("engraving");
 }
 
 void EngravingProject::init(const MStyle& style)
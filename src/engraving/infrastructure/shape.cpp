@@ -98,10 +98,11 @@ void Shape::translateY(double yo)
 
 Shape Shape::translated(const PointF& pt) const
 {
-    Shape s;
-    s.m_elements.reserve(m_elements.size());
-    for (const ShapeElement& r : m_elements) {
-        s.add(r.translated(pt), r.item());
+    // copy the elements at once instead of adding them one by one
+    Shape s(m_elements.empty() ? Type::Fixed : Type::Composite);
+    s.m_elements = m_elements;
+    for (RectF& r : s.m_elements) {
+        r.translate(pt);
     }
     return s;
 }
@@ -117,10 +118,10 @@ Shape& Shape::scale(const SizeF& mag)
 
 Shape Shape::scaled(const SizeF& mag) const
 {
-    Shape s;
-    s.m_elements.reserve(m_elements.size());
-    for (const ShapeElement& r : m_elements) {
-        s.add(r.scaled(mag), r.item());
+    Shape s(m_elements.empty() ? Type::Fixed : Type::Composite);
+    s.m_elements = m_elements;
+    for (RectF& r : s.m_elements) {
+        r.scale(mag);
     }
     return s;
 }
@@ -128,6 +129,34 @@ Shape Shape::scaled(const SizeF& mag) const
 void Shape::invalidateBBox()
 {
     m_bbox = RectF();
+    m_edges.data.clear();
+}
+
+//---------------------------------------------------------
+//   edges
+//    Built on the first distance query after a change
+//---------------------------------------------------------
+
+Shape::Edges Shape::edges() const
+{
+    const size_t n = m_elements.size();
+
+    if (m_edges.data.size() != 5 * n) {
+        m_edges.data.resize(5 * n);
+
+        double* data = m_edges.data.data();
+        for (size_t i = 0; i < n; ++i) {
+            const RectF& r = m_elements[i];
+            data[i] = r.left();
+            data[n + i] = r.right();
+            data[2 * n + i] = r.top();
+            data[3 * n + i] = r.bottom();
+            data[4 * n + i] = r.height();
+        }
+    }
+
+    const double* data = m_edges.data.data();
+    return { data, data + n, data + 2 * n, data + 3 * n, data + 4 * n };
 }
 
 const RectF& Shape::bbox() const
@@ -187,22 +216,23 @@ double Shape::minVerticalDistance(const Shape& a) const
         return 0.0;
     }
 
+    const Edges e1 = edges();
+    const Edges e2 = a.edges();
+    const size_t n1 = size();
+    const size_t n2 = a.size();
+
     double dist = -DBL_MAX; // min real
-    for (const RectF& r2 : a.m_elements) {
-        if (r2.height() <= 0.0) {
+    for (size_t j = 0; j < n2; ++j) {
+        double bx1 = e2.left[j];
+        double bx2 = e2.right[j];
+        if (e2.height[j] <= 0.0 || bx1 == bx2) {
             continue;
         }
-        double bx1 = r2.left();
-        double bx2 = r2.right();
-        for (const RectF& r1 : m_elements) {
-            if (r1.height() <= 0.0) {
-                continue;
-            }
-            double ax1 = r1.left();
-            double ax2 = r1.right();
-            if (mu::engraving::intersects(ax1, ax2, bx1, bx2, 0.0)) {
-                dist = std::max(dist, r1.bottom() - r2.top());
-            }
+        double by1 = e2.top[j];
+        // same test as intersects(), written without branches so that it can be vectorized
+        for (size_t i = 0; i < n1; ++i) {
+            bool collides = e1.height[i] > 0.0 && e1.left[i] != e1.right[i] && e1.right[i] > bx1 && e1.left[i] < bx2;
+            dist = std::max(dist, collides ? e1.bottom[i] - by1 : -DBL_MAX);
         }
     }
     return dist;
@@ -222,22 +252,22 @@ double Shape::verticalClearance(const Shape& a, double minHorizontalDistance) co
         return 0.0;
     }
 
+    const Edges e1 = edges();
+    const Edges e2 = a.edges();
+    const size_t n1 = size();
+    const size_t n2 = a.size();
+
     double dist = DBL_MAX; // max real
-    for (const RectF& r2 : a.m_elements) {
-        if (r2.height() <= 0.0) {
+    for (size_t j = 0; j < n2; ++j) {
+        double bx1 = e2.left[j] - minHorizontalDistance;
+        double bx2 = e2.right[j] + minHorizontalDistance;
+        if (e2.height[j] <= 0.0 || bx1 == bx2) {
             continue;
         }
-        double bx1 = r2.left() - minHorizontalDistance;
-        double bx2 = r2.right() + minHorizontalDistance;
-        for (const RectF& r1 : m_elements) {
-            if (r1.height() <= 0.0) {
-                continue;
-            }
-            double ax1 = r1.left();
-            double ax2 = r1.right();
-            if (mu::engraving::intersects(ax1, ax2, bx1, bx2, 0.0)) {
-                dist = std::min(dist, r2.top() - r1.bottom());
-            }
+        double by1 = e2.top[j];
+        for (size_t i = 0; i < n1; ++i) {
+            bool collides = e1.height[i] > 0.0 && e1.left[i] != e1.right[i] && e1.right[i] > bx1 && e1.left[i] < bx2;
+            dist = std::min(dist, collides ? by1 - e1.bottom[i] : DBL_MAX);
         }
     }
     return dist;
@@ -400,6 +430,8 @@ void Shape::setBBox(const RectF& r, const EngravingItem* p)
     } else {
         m_elements[0] = ShapeElement(r, p);
     }
+
+    invalidateBBox();
 }
 
 void Shape::addBBox(const RectF& r)
@@ -413,6 +445,8 @@ void Shape::addBBox(const RectF& r)
     }
 
     m_elements[0].unite(r);
+
+    invalidateBBox();
 }
 
 //---------------------------------------------------------
@@ -442,6 +476,7 @@ void Shape::remove(const RectF& r)
     for (auto i = m_elements.begin(); i != m_elements.end(); ++i) {
         if (*i == r) {
             m_elements.erase(i);
+            invalidateBBox();
             return;
         }
     }
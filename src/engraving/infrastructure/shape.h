@@ -86,7 +86,7 @@ public:
 
     size_t size() const { return m_elements.size(); }
     bool empty() const { return m_elements.empty(); }
-    void clear() { m_elements.clear(); }
+    void clear() { m_elements.clear(); invalidateBBox(); }
 
     bool equal(const Shape& sh) const
     {
@@ -126,8 +126,15 @@ public:
 
     // ---
 
+    //! NOTE Changes the elements in place, the caches are dropped once afterwards
+    template<typename Func>
+    inline void for_each(Func f)
+    {
+        std::for_each(m_elements.begin(), m_elements.end(), f);
+        invalidateBBox();
+    }
+
     const std::vector<ShapeElement>& elements() const { return m_elements; }
-    std::vector<ShapeElement>& elements() { return m_elements; }
 
     std::optional<ShapeElement> find_if(const std::function<bool(const ShapeElement&)>& func) const;
     std::optional<ShapeElement> find_first(ElementType type) const;
@@ -166,11 +173,32 @@ public:
 
 private:
 
+    //! NOTE The edges of the elements, one array per edge, so that the distance
+    //! queries run over contiguous doubles instead of the elements and their items
+    struct Edges {
+        const double* left = nullptr;
+        const double* right = nullptr;
+        const double* top = nullptr;
+        const double* bottom = nullptr;
+        const double* height = nullptr;
+    };
+
     void invalidateBBox();
+    Edges edges() const;
+
+    //! NOTE Not copied nor moved with the shape: most copies are changed right away
+    struct EdgesCache {
+        EdgesCache() = default;
+        EdgesCache(const EdgesCache&) {}
+        EdgesCache& operator=(const EdgesCache&) { data.clear(); return *this; }
+
+        std::vector<double> data;
+    };
 
     Type m_type = Type::Fixed;
     std::vector<ShapeElement> m_elements;
     mutable RectF m_bbox;   // cache
+    mutable EdgesCache m_edges; // cache, see edges()
 };
 
 void dump(const ShapeElement& sh, std::stringstream& ss);
@@ -34,6 +34,7 @@
 #include "dom/tempo.h"
 #include "dom/tie.h"
 #include "dom/tremolotwochord.h"
+#include "dom/undo.h"
 
 #include "log.h"
 
@@ -69,6 +70,7 @@ void PlaybackModel::load(Score* score)
     }
 
     m_score = score;
+    m_pendingUpdate.reset();
 
     auto changesChannel = score->changesChannel();
     changesChannel.resetOnReceive(this);
@@ -81,6 +83,11 @@ void PlaybackModel::load(Score* score)
         TickBoundaries tickRange = tickBoundaries(range);
         TrackBoundaries trackRange = trackBoundaries(range);
 
+        if (m_deferredUpdate) {
+            addPendingUpdate(tickRange, trackRange);
+            return;
+        }
+
         clearExpiredTracks();
         clearExpiredContexts(trackRange.trackFrom, trackRange.trackTo);
         clearExpiredEvents(tickRange.tickFrom, tickRange.tickTo, trackRange.trackFrom, trackRange.trackTo);
@@ -106,6 +113,8 @@ void PlaybackModel::reload()
 {
     TRACEFUNC;
 
+    flushPendingUpdate();
+
     int trackFrom = 0;
     size_t trackTo = m_score->ntracks();
 
@@ -135,6 +144,108 @@ Notification PlaybackModel::dataChanged() const
     return m_dataChanged;
 }
 
+bool PlaybackModel::isDeferredUpdateEnabled() const
+{
+    return m_deferredUpdate;
+}
+
+void PlaybackModel::setDeferredUpdateEnabled(bool enabled)
+{
+    if (m_deferredUpdate == enabled) {
+        return;
+    }
+
+    if (!enabled) {
+        flushPendingUpdate();
+    }
+
+    m_deferredUpdate = enabled;
+}
+
+bool PlaybackModel::hasPendingUpdate() const
+{
+    return m_pendingUpdate != nullptr;
+}
+
+Notification PlaybackModel::pendingUpdateAdded() const
+{
+    return m_pendingUpdateAdded;
+}
+
+bool PlaybackModel::processPendingUpdate(std::chrono::milliseconds budget)
+{
+    TRACEFUNC;
+
+    if (!m_pendingUpdate) {
+        return true;
+    }
+
+    //! NOTE The score may be in an intermediate state, e.g. while dragging
+    if (m_score->undoStack()->active()) {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+
+    if (!m_pendingUpdate->started) {
+        startPendingUpdate();
+    }
+
+    PendingUpdate& update = *m_pendingUpdate;
+    m_renderingPendingUpdate = true;
+
+    const int tickFrom = update.tickRange.tickFrom;
+    const int tickTo = update.tickRange.tickTo;
+
+    while (update.nextMeasureIdx < update.measures.size()) {
+        const MeasureToRender& measureToRender = update.measures[update.nextMeasureIdx];
+        renderMeasure(measureToRender, tickFrom, tickTo, update.staffIdxSet, &update.trackChanges);
+
+        //! NOTE The events of the measures that follow each other are removed at once on publishing,
+        //! so that nothing is left between them, e.g. the grace notes before the first beat
+        const MeasureToRender* prevMeasure = update.nextMeasureIdx > 0 ? &update.measures[update.nextMeasureIdx - 1] : nullptr;
+        const bool isContinuation = prevMeasure && prevMeasure->tickPositionOffset == measureToRender.tickPositionOffset
+                                    && prevMeasure->measure->nextMeasure() == measureToRender.measure;
+
+        if (!isContinuation || update.renderedEventRanges.empty()) {
+            update.renderedEventRanges.emplace_back(std::numeric_limits<timestamp_t>::max(), -std::numeric_limits<timestamp_t>::max());
+        }
+
+        extendEventRange(update.renderedEventRanges.back(), measureToRender, tickFrom, tickTo);
+        ++update.nextMeasureIdx;
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+
+    m_renderingPendingUpdate = false;
+
+    if (update.nextMeasureIdx < update.measures.size()) {
+        //! NOTE Remembered now: the measures may be gone with the next change
+        update.unrenderedTickFrom = tickTo;
+        for (size_t i = update.nextMeasureIdx; i < update.measures.size(); ++i) {
+            update.unrenderedTickFrom = std::min(update.unrenderedTickFrom, update.measures[i].measure->tick().ticks());
+        }
+        update.unrenderedTickFrom = std::max(update.unrenderedTickFrom, tickFrom);
+
+        return false;
+    }
+
+    publishPendingUpdate(update.expiredEventRanges);
+    return true;
+}
+
+void PlaybackModel::flushPendingUpdate()
+{
+    if (!m_pendingUpdate || m_score->undoStack()->active()) {
+        return;
+    }
+
+    while (!processPendingUpdate(std::chrono::milliseconds(100))) {
+    }
+}
+
 bool PlaybackModel::isPlayRepeatsEnabled() const
 {
     return m_expandRepeats;
@@ -389,8 +500,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
         }
 
         if (chordSymbol->play()) {
-            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile,
-                                         m_playbackDataMap[trackId].originEvents);
+            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile, trackEvents(trackId));
         }
 
         collectChangesTracks(trackId, trackChanges);
@@ -432,7 +542,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
             }
         }
 
-        const PlaybackContext& ctx = m_playbackCtxMap[trackId];
+        const PlaybackContext& ctx = trackContext(trackId);
 
         ArticulationsProfilePtr profile = defaultActiculationProfile(trackId);
         if (!profile) {
@@ -442,7 +552,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
 
         m_renderer.render(item, tickPositionOffset, ctx.appliableDynamicLevel(segmentStartTick + tickPositionOffset),
                           ctx.persistentArticulationType(segmentStartTick + tickPositionOffset), std::move(profile),
-                          m_playbackDataMap[trackId].originEvents);
+                          trackEvents(trackId));
 
         collectChangesTracks(trackId, trackChanges);
     }
@@ -485,9 +595,27 @@ void PlaybackModel::updateEvents(const int tickFrom, const int tickTo, const tra
 {
     TRACEFUNC;
 
-    std::set<staff_idx_t> staffToProcessIdxSet = m_score->staffIdxSetFromRange(trackFrom, trackTo, [](const Staff& staff) {
+    std::set<staff_idx_t> staffToProcessIdxSet = staffIdxSetToProcess(trackFrom, trackTo);
+
+    size_t renderedSegmentCount = 0;
+
+    for (const MeasureToRender& measureToRender : measuresToRender(tickFrom, tickTo)) {
+        renderedSegmentCount += renderMeasure(measureToRender, tickFrom, tickTo, staffToProcessIdxSet, trackChanges);
+    }
+
+    TRACE_COUNTER("playback/rendered segments", renderedSegmentCount);
+}
+
+std::set<staff_idx_t> PlaybackModel::staffIdxSetToProcess(const track_idx_t trackFrom, const track_idx_t trackTo) const
+{
+    return m_score->staffIdxSetFromRange(trackFrom, trackTo, [](const Staff& staff) {
         return staff.isPrimaryStaff(); // skip linked staves
     });
+}
+
+std::vector<PlaybackModel::MeasureToRender> PlaybackModel::measuresToRender(const int tickFrom, const int tickTo) const
+{
+    std::vector<MeasureToRender> result;
 
     for (const RepeatSegment* repeatSegment : repeatList()) {
         int tickPositionOffset = repeatSegment->utick - repeatSegment->tick;
@@ -506,29 +634,195 @@ void PlaybackModel::updateEvents(const int tickFrom, const int tickTo, const tra
                 continue;
             }
 
-            bool isFirstSegmentOfMeasure = true;
+            result.push_back({ measure, tickPositionOffset });
+        }
+    }
 
-            for (Segment* segment = measure->first(); segment; segment = segment->next()) {
-                if (!segment->isChordRestType()) {
-                    continue;
-                }
+    return result;
+}
 
-                int segmentStartTick = segment->tick().ticks();
-                int segmentEndTick = segmentStartTick + segment->ticks().ticks();
+size_t PlaybackModel::renderMeasure(const MeasureToRender& measureToRender, const int tickFrom, const int tickTo,
+                                    const std::set<staff_idx_t>& staffIdxSet, ChangedTrackIdSet* trackChanges)
+{
+    const Measure* measure = measureToRender.measure;
+    const int tickPositionOffset = measureToRender.tickPositionOffset;
 
-                if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
-                    continue;
-                }
+    size_t renderedSegmentCount = 0;
+    bool isFirstSegmentOfMeasure = true;
 
-                processSegment(tickPositionOffset, segment, staffToProcessIdxSet, isFirstSegmentOfMeasure, trackChanges);
-                isFirstSegmentOfMeasure = false;
-            }
+    for (const Segment* segment = measure->first(); segment; segment = segment->next()) {
+        if (!segment->isChordRestType()) {
+            continue;
+        }
+
+        int segmentStartTick = segment->tick().ticks();
+        int segmentEndTick = segmentStartTick + segment->ticks().ticks();
+
+        if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
+            continue;
+        }
+
+        processSegment(tickPositionOffset, segment, staffIdxSet, isFirstSegmentOfMeasure, trackChanges);
+        isFirstSegmentOfMeasure = false;
+        ++renderedSegmentCount;
+    }
+
+    m_renderer.renderMetronome(m_score, measure->tick().ticks(), measure->endTick().ticks(), tickPositionOffset,
+                               trackEvents(METRONOME_TRACK_ID));
+    collectChangesTracks(METRONOME_TRACK_ID, trackChanges);
+
+    return renderedSegmentCount;
+}
 
-            m_renderer.renderMetronome(m_score, measureStartTick, measureEndTick, tickPositionOffset,
-                                       m_playbackDataMap[METRONOME_TRACK_ID].originEvents);
-            collectChangesTracks(METRONOME_TRACK_ID, trackChanges);
+void PlaybackModel::addPendingUpdate(const TickBoundaries& tickRange, const TrackBoundaries& trackRange)
+{
+    clearExpiredTracks();
+
+    TickBoundaries newTickRange = tickRange;
+    TrackBoundaries newTrackRange = trackRange;
+
+    //! NOTE The score has changed under the rendering. The measures rendered so far are published,
+    //! the rest is rendered again together with the new range
+    if (m_pendingUpdate && m_pendingUpdate->started && m_pendingUpdate->nextMeasureIdx > 0) {
+        newTickRange.tickFrom = std::min(newTickRange.tickFrom, m_pendingUpdate->unrenderedTickFrom);
+        newTickRange.tickTo = std::max(newTickRange.tickTo, m_pendingUpdate->tickRange.tickTo);
+        newTrackRange.trackFrom = std::min(newTrackRange.trackFrom, m_pendingUpdate->trackRange.trackFrom);
+        newTrackRange.trackTo = std::max(newTrackRange.trackTo, m_pendingUpdate->trackRange.trackTo);
+
+        publishPendingUpdate(m_pendingUpdate->renderedEventRanges);
+    }
+
+    if (!m_pendingUpdate) {
+        m_pendingUpdate = std::make_unique<PendingUpdate>();
+        m_pendingUpdate->tickRange = newTickRange;
+        m_pendingUpdate->trackRange = newTrackRange;
+        m_pendingUpdate->oldTracks = existingTrackIdSet();
+        m_pendingUpdateAdded.notify();
+        return;
+    }
+
+    //! NOTE Nothing is rendered yet, start again over both ranges.
+    //! The old tracks are kept: the ones added since then have not been announced yet
+    PendingUpdate& update = *m_pendingUpdate;
+    update.tickRange.tickFrom = std::min(update.tickRange.tickFrom, tickRange.tickFrom);
+    update.tickRange.tickTo = std::max(update.tickRange.tickTo, tickRange.tickTo);
+    update.trackRange.trackFrom = std::min(update.trackRange.trackFrom, trackRange.trackFrom);
+    update.trackRange.trackTo = std::max(update.trackRange.trackTo, trackRange.trackTo);
+
+    update.started = false;
+    update.expiredEventRanges.clear();
+    update.staffIdxSet.clear();
+    update.measures.clear();
+    update.nextMeasureIdx = 0;
+    update.contexts.clear();
+    update.events.clear();
+    update.trackChanges.clear();
+}
+
+void PlaybackModel::startPendingUpdate()
+{
+    TRACEFUNC;
+
+    PendingUpdate& update = *m_pendingUpdate;
+    const int tickFrom = update.tickRange.tickFrom;
+    const int tickTo = update.tickRange.tickTo;
+    const track_idx_t trackFrom = update.trackRange.trackFrom;
+    const track_idx_t trackTo = update.trackRange.trackTo;
+
+    update.started = true;
+    update.expiredEventRanges = expiredEventRanges(tickFrom, tickTo);
+
+    //! NOTE New tracks are added without events, they are announced on publishing
+    updateSetupData();
+
+    auto updateTrackContext = [this, &update](const InstrumentTrackId& trackId) {
+        TrackContext& trackCtx = update.contexts[trackId];
+        trackCtx.ctx.update(trackId.partId, m_score);
+        trackCtx.dynamicLevelMap = trackCtx.ctx.dynamicLevelMap(m_score);
+        trackCtx.paramMap = trackCtx.ctx.playbackParamMap(m_score);
+    };
+
+    for (const Part* part : m_score->parts()) {
+        if (trackTo < part->startTrack() || trackFrom >= part->endTrack()) {
+            continue;
+        }
+
+        for (const InstrumentTrackId& trackId : part->instrumentTrackIdSet()) {
+            updateTrackContext(trackId);
+        }
+
+        if (part->hasChordSymbol()) {
+            updateTrackContext(chordSymbolsTrackId(part->id()));
         }
     }
+
+    update.staffIdxSet = staffIdxSetToProcess(trackFrom, trackTo);
+    update.measures = measuresToRender(tickFrom, tickTo);
+}
+
+void PlaybackModel::publishPendingUpdate(const std::vector<TimestampRange>& expiredRanges)
+{
+    TRACEFUNC;
+
+    std::unique_ptr<PendingUpdate> update = std::move(m_pendingUpdate);
+
+    for (const TimestampRange& range : expiredRanges) {
+        if (range.first > range.second) {
+            continue;
+        }
+
+        removeEventsFromRange(update->trackRange.trackFrom, update->trackRange.trackTo, range.first, range.second);
+    }
+
+    for (auto& pair : update->contexts) {
+        // removed by a change of the score since the rendering started
+        if (!containsTrack(pair.first)) {
+            continue;
+        }
+
+        m_playbackCtxMap[pair.first] = std::move(pair.second.ctx);
+
+        PlaybackData& trackData = m_playbackDataMap[pair.first];
+        trackData.dynamicLevelMap = std::move(pair.second.dynamicLevelMap);
+        trackData.paramMap = std::move(pair.second.paramMap);
+    }
+
+    for (auto& pair : update->events) {
+        if (!containsTrack(pair.first)) {
+            continue;
+        }
+
+        PlaybackEventsMap& originEvents = m_playbackDataMap[pair.first].originEvents;
+
+        for (auto& eventsPair : pair.second) {
+            PlaybackEventList& events = originEvents[eventsPair.first];
+            events.insert(events.end(), std::make_move_iterator(eventsPair.second.begin()),
+                          std::make_move_iterator(eventsPair.second.end()));
+        }
+    }
+
+    notifyAboutChanges(update->oldTracks, update->trackChanges);
+}
+
+PlaybackEventsMap& PlaybackModel::trackEvents(const InstrumentTrackId& trackId)
+{
+    if (m_renderingPendingUpdate) {
+        return m_pendingUpdate->events[trackId];
+    }
+
+    return m_playbackDataMap[trackId].originEvents;
+}
+
+const PlaybackContext& PlaybackModel::trackContext(const InstrumentTrackId& trackId)
+{
+    if (m_renderingPendingUpdate) {
+        auto it = m_pendingUpdate->contexts.find(trackId);
+        if (it != m_pendingUpdate->contexts.end()) {
+            return it->second.ctx;
+        }
+    }
+
+    return m_playbackCtxMap[trackId];
 }
 
 bool PlaybackModel::hasToReloadTracks(const ScoreChangesRange& changesRange) const
@@ -698,20 +992,29 @@ void PlaybackModel::clearExpiredEvents(const int tickFrom, const int tickTo, con
 {
     TRACEFUNC;
 
+    for (const TimestampRange& range : expiredEventRanges(tickFrom, tickTo)) {
+        removeEventsFromRange(trackFrom, trackTo, range.first, range.second);
+    }
+}
+
+std::vector<PlaybackModel::TimestampRange> PlaybackModel::expiredEventRanges(const int tickFrom, const int tickTo) const
+{
     if (!m_score) {
-        return;
+        return {};
     }
 
     const Measure* lastMeasure = m_score->lastMeasure();
     if (!lastMeasure) {
-        return;
+        return {};
     }
 
+    // the whole score: all the events
     if (tickFrom == 0 && lastMeasure->endTick().ticks() == tickTo) {
-        removeEventsFromRange(trackFrom, trackTo);
-        return;
+        return { { -1, -1 } };
     }
 
+    std::vector<TimestampRange> result;
+
     for (const RepeatSegment* repeatSegment : repeatList()) {
         int tickPositionOffset = repeatSegment->utick - repeatSegment->tick;
         int repeatStartTick = repeatSegment->tick;
@@ -721,8 +1024,7 @@ void PlaybackModel::clearExpiredEvents(const int tickFrom, const int tickTo, con
             continue;
         }
 
-        timestamp_t removeEventsFrom = std::numeric_limits<timestamp_t>::max();
-        timestamp_t removeEventsTo = -std::numeric_limits<timestamp_t>::max();
+        TimestampRange range(std::numeric_limits<timestamp_t>::max(), -std::numeric_limits<timestamp_t>::max());
 
         for (const Measure* measure : repeatSegment->measureList()) {
             int measureStartTick = measure->tick().ticks();
@@ -732,26 +1034,34 @@ void PlaybackModel::clearExpiredEvents(const int tickFrom, const int tickTo, con
                 continue;
             }
 
-            for (const Segment* segment = measure->first(); segment; segment = segment->next()) {
-                if (!segment->isChordRestType()) {
-                    continue;
-                }
+            extendEventRange(range, { measure, tickPositionOffset }, tickFrom, tickTo);
+        }
+
+        result.push_back(range);
+    }
 
-                int segmentStartTick = segment->tick().ticks();
-                int segmentEndTick = segmentStartTick + segment->ticks().ticks();
+    return result;
+}
 
-                if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
-                    continue;
-                }
+void PlaybackModel::extendEventRange(TimestampRange& range, const MeasureToRender& measureToRender, const int tickFrom,
+                                     const int tickTo) const
+{
+    for (const Segment* segment = measureToRender.measure->first(); segment; segment = segment->next()) {
+        if (!segment->isChordRestType()) {
+            continue;
+        }
 
-                timestamp_t segmentStartTime = timestampFromTicks(m_score, segmentStartTick + tickPositionOffset);
+        int segmentStartTick = segment->tick().ticks();
+        int segmentEndTick = segmentStartTick + segment->ticks().ticks();
 
-                removeEventsFrom = std::min(removeEventsFrom, segmentStartTime);
-                removeEventsTo = std::max(removeEventsTo, segmentStartTime);
-            }
+        if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
+            continue;
         }
 
-        removeEventsFromRange(trackFrom, trackTo, removeEventsFrom, removeEventsTo);
+        timestamp_t segmentStartTime = timestampFromTicks(m_score, segmentStartTick + measureToRender.tickPositionOffset);
+
+        range.first = std::min(range.first, segmentStartTime);
+        range.second = std::max(range.second, segmentStartTime);
     }
 }
 
@@ -23,8 +23,10 @@
 #ifndef MU_ENGRAVING_PLAYBACKMODEL_H
 #define MU_ENGRAVING_PLAYBACKMODEL_H
 
+#include <chrono>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <functional>
 
 #include "async/asyncable.h"
@@ -46,6 +48,7 @@ class Note;
 class EngravingItem;
 class Segment;
 class Instrument;
+class Measure;
 class RepeatList;
 
 class PlaybackModel : public muse::async::Asyncable
@@ -59,6 +62,21 @@ public:
 
     muse::async::Notification dataChanged() const;
 
+    //! NOTE In the deferred mode the changes of the score are not rendered right away.
+    //! The changed range is remembered, rendered piece by piece from processPendingUpdate()
+    //! and published at once when it is complete; until then the previous events stay in use.
+    //! A newer change publishes the measures rendered so far, then renders the rest together with its own range
+    bool isDeferredUpdateEnabled() const;
+    void setDeferredUpdateEnabled(bool enabled);
+
+    bool hasPendingUpdate() const;
+    muse::async::Notification pendingUpdateAdded() const;
+
+    //! NOTE Renders the pending update for about the given time, returns true when it is published.
+    //! Nothing is rendered while a command of the score is in progress
+    bool processPendingUpdate(std::chrono::milliseconds budget);
+    void flushPendingUpdate();
+
     bool isPlayRepeatsEnabled() const;
     void setPlayRepeats(const bool isEnabled);
 
@@ -100,6 +118,44 @@ private:
         track_idx_t trackTo = muse::nidx;
     };
 
+    struct MeasureToRender
+    {
+        const Measure* measure = nullptr;
+        int tickPositionOffset = 0;
+    };
+
+    using TimestampRange = std::pair<muse::mpe::timestamp_t, muse::mpe::timestamp_t>;
+
+    struct TrackContext
+    {
+        PlaybackContext ctx;
+        muse::mpe::DynamicLevelMap dynamicLevelMap;
+        muse::mpe::PlaybackParamMap paramMap;
+    };
+
+    //! NOTE The state of a deferred update. The measures to render are taken when the rendering starts.
+    //! Any change of the score after that ends it: the measures rendered so far are published,
+    //! the rest is rendered again with the new change, so the measures are never out of date
+    struct PendingUpdate
+    {
+        TickBoundaries tickRange;
+        TrackBoundaries trackRange;
+        InstrumentTrackIdSet oldTracks;
+
+        bool started = false;
+        std::vector<TimestampRange> expiredEventRanges;
+        std::set<staff_idx_t> staffIdxSet;
+        std::vector<MeasureToRender> measures;
+        size_t nextMeasureIdx = 0;
+        std::vector<TimestampRange> renderedEventRanges;
+        int unrenderedTickFrom = -1;
+
+        // rendered aside, published when all the measures are done
+        std::unordered_map<InstrumentTrackId, TrackContext> contexts;
+        std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackEventsMap> events;
+        ChangedTrackIdSet trackChanges;
+    };
+
     InstrumentTrackId idKey(const EngravingItem* item) const;
     InstrumentTrackId idKey(const std::vector<const EngravingItem*>& items) const;
     InstrumentTrackId idKey(const ID& partId, const String& instrumentId) const;
@@ -112,6 +168,18 @@ private:
     void updateEvents(const int tickFrom, const int tickTo, const track_idx_t trackFrom, const track_idx_t trackTo,
                       ChangedTrackIdSet* trackChanges = nullptr);
 
+    std::set<staff_idx_t> staffIdxSetToProcess(const track_idx_t trackFrom, const track_idx_t trackTo) const;
+    std::vector<MeasureToRender> measuresToRender(const int tickFrom, const int tickTo) const;
+    size_t renderMeasure(const MeasureToRender& measureToRender, const int tickFrom, const int tickTo,
+                         const std::set<staff_idx_t>& staffIdxSet, ChangedTrackIdSet* trackChanges);
+
+    void addPendingUpdate(const TickBoundaries& tickRange, const TrackBoundaries& trackRange);
+    void startPendingUpdate();
+    void publishPendingUpdate(const std::vector<TimestampRange>& expiredRanges);
+
+    muse::mpe::PlaybackEventsMap& trackEvents(const InstrumentTrackId& trackId);
+    const PlaybackContext& trackContext(const InstrumentTrackId& trackId);
+
     void processSegment(const int tickPositionOffset, const Segment* segment, const std::set<staff_idx_t>& staffIdxSet,
                         bool isFirstSegmentOfMeasure, ChangedTrackIdSet* trackChanges);
     void processMeasureRepeat(const int tickPositionOffset, const MeasureRepeat* measureRepeat, const Measure* currentMeasure,
@@ -124,6 +192,8 @@ private:
     void clearExpiredTracks();
     void clearExpiredContexts(const track_idx_t trackFrom, const track_idx_t trackTo);
     void clearExpiredEvents(const int tickFrom, const int tickTo, const track_idx_t trackFrom, const track_idx_t trackTo);
+    std::vector<TimestampRange> expiredEventRanges(const int tickFrom, const int tickTo) const;
+    void extendEventRange(TimestampRange& range, const MeasureToRender& measureToRender, const int tickFrom, const int tickTo) const;
     void collectChangesTracks(const InstrumentTrackId& trackId, ChangedTrackIdSet* result);
     void notifyAboutChanges(const InstrumentTrackIdSet& oldTracks, const InstrumentTrackIdSet& changedTracks);
 
@@ -144,6 +214,7 @@ private:
     Score* m_score = nullptr;
     bool m_expandRepeats = true;
     bool m_playChordSymbols = true;
+    bool m_deferredUpdate = false;
 
     PlaybackEventsRenderer m_renderer;
     PlaybackSetupDataResolver m_setupResolver;
@@ -151,7 +222,11 @@ private:
     std::unordered_map<InstrumentTrackId, PlaybackContext> m_playbackCtxMap;
     std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackData> m_playbackDataMap;
 
+    std::unique_ptr<PendingUpdate> m_pendingUpdate;
+    bool m_renderingPendingUpdate = false;
+
     muse::async::Notification m_dataChanged;
+    muse::async::Notification m_pendingUpdateAdded;
     muse::async::Channel<InstrumentTrackId> m_trackAdded;
     muse::async::Channel<InstrumentTrackId> m_trackRemoved;
 };
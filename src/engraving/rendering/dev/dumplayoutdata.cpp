@@ -32,9 +32,9 @@ static void dumpLayoutData(const EngravingItem* item, std::stringstream& ss)
 {
     item->ldata()->dump(ss);
 
-    for (EngravingItem* ch : item->childrenItems()) {
+    item->forEachChildItem([&ss](const EngravingItem* ch) {
         dumpLayoutData(ch, ss);
-    }
+    });
 }
 
 std::string DumpLayoutData::dump(const Score* s)
@@ -49,6 +49,14 @@ double HorizontalSpacing::minHorizontalDistance(const Shape& f, const Shape& s,
     double dist = -DBL_MAX;        // min real
     double absoluteMinPadding = 0.1 * spatium * squeezeFactor;
     double verticalClearance = 0.2 * spatium * squeezeFactor;
+
+    // most items have several shape elements, so the padding and the kerning
+    // of the last pair of items are kept instead of being computed for every pair of rects
+    const EngravingItem* lastItem1 = nullptr;
+    const EngravingItem* lastItem2 = nullptr;
+    double lastPadding = 0.0;
+    KerningType lastKerningType = KerningType::NON_KERNING;
+
     for (const ShapeElement& r2 : s.elements()) {
         if (r2.isNull()) {
             continue;
@@ -67,10 +75,16 @@ double HorizontalSpacing::minHorizontalDistance(const Shape& f, const Shape& s,
             double padding = 0;
             KerningType kerningType = KerningType::NON_KERNING;
             if (item1 && item2) {
-                padding = computePadding(item1, item2);
-                padding *= squeezeFactor;
-                padding = std::max(padding, absoluteMinPadding);
-                kerningType = computeKerning(item1, item2);
+                if (item1 != lastItem1 || item2 != lastItem2) {
+                    lastItem1 = item1;
+                    lastItem2 = item2;
+                    lastPadding = computePadding(item1, item2);
+                    lastPadding *= squeezeFactor;
+                    lastPadding = std::max(lastPadding, absoluteMinPadding);
+                    lastKerningType = computeKerning(item1, item2);
+                }
+                padding = lastPadding;
+                kerningType = lastKerningType;
             }
             if ((intersection && kerningType != KerningType::ALLOW_COLLISION)
                 || (r1.width() == 0 || r2.width() == 0)  // Temporary hack: shapes of zero-width are assumed to collide with everyghin
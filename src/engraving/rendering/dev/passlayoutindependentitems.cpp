@@ -21,20 +21,21 @@
  */
 #include "passlayoutindependentitems.h"
 
+#include "global/concurrency/taskscheduler.h"
+
 #include "dom/score.h"
+#include "dom/staff.h"
 
 #include "tlayout.h"
 
 using namespace mu::engraving;
 using namespace mu::engraving::rendering::dev;
 
-void PassLayoutIndependentItems::doRun(Score* score, LayoutContext& ctx)
-{
-    RootItem* rootItem = score->rootItem();
-    scan(rootItem, ctx);
-}
+//! NOTE Below this number of measures the scheduling costs more than it saves
+static constexpr size_t MIN_PARALLEL_MEASURES = 16;
+static constexpr size_t MEASURES_PER_TASK = 4;
 
-void PassLayoutIndependentItems::scan(EngravingItem* item, LayoutContext& ctx)
+static bool isIndependent(const EngravingItem* item)
 {
     //! NOTE These items are independent
     switch (item->type()) {
@@ -59,15 +60,140 @@ void PassLayoutIndependentItems::scan(EngravingItem* item, LayoutContext& ctx)
     case ElementType::SYSTEM_DIVIDER:
     case ElementType::TIMESIG:
     case ElementType::TREMOLOBAR:
-        TLayout::layoutItem(item, ctx);
+        return true;
+    default:
+        break;
+    }
+
+    return false;
+}
+
+//! NOTE The layout of these items is not safe to run concurrently:
+//! text goes through the font metrics caches, accidentals fill the shapes with cutouts
+//! of the engraving font lazily, neither is synchronized,
+//! and tablature notes may add generated parentheses through the undo stack
+static bool isLayoutOnCallingThread(const EngravingItem* item)
+{
+    switch (item->type()) {
+    case ElementType::ACCIDENTAL:
+    case ElementType::ACTION_ICON:
+    case ElementType::FSYMBOL:
+    case ElementType::HARMONY:
+    case ElementType::INSTRUMENT_NAME:
+        return true;
+    case ElementType::NOTE:
+        return item->staff() && item->staff()->isTabStaff(item->tick());
     default:
         break;
     }
 
-    for (EngravingItem* ch : item->childrenItems()) {
+    return false;
+}
+
+PassLayoutIndependentItems::PassLayoutIndependentItems(Mode mode)
+    : m_mode(mode)
+{
+#ifdef MUE_ENABLE_ENGRAVING_RENDER_DEBUG
+    //! NOTE The layout call tracking is not thread-safe
+    m_mode = Mode::Serial;
+#endif
+}
+
+void PassLayoutIndependentItems::doRun(Score* score, LayoutContext& ctx)
+{
+    RootItem* rootItem = score->rootItem();
+
+    if (m_mode == Mode::Serial) {
+        scan(rootItem, ctx);
+        return;
+    }
+
+    std::vector<EngravingItem*> measures;
+    scanOutsideMeasures(rootItem, ctx, measures);
+
+    if (measures.size() < MIN_PARALLEL_MEASURES) {
+        for (EngravingItem* measure : measures) {
+            scan(measure, ctx);
+        }
+        return;
+    }
+
+    layoutMeasuresParallel(measures, ctx);
+}
+
+void PassLayoutIndependentItems::scan(EngravingItem* item, LayoutContext& ctx)
+{
+    if (isIndependent(item)) {
+        TLayout::layoutItem(item, ctx);
+    }
+
+    item->forEachChildItem([this, &ctx](EngravingItem* ch) {
         if (ch->isType(ElementType::DUMMY)) {
-            continue;
+            return;
         }
         scan(ch, ctx);
+    });
+}
+
+void PassLayoutIndependentItems::scanOutsideMeasures(EngravingItem* item, LayoutContext& ctx, std::vector<EngravingItem*>& measures)
+{
+    if (isIndependent(item)) {
+        TLayout::layoutItem(item, ctx);
+    }
+
+    item->forEachChildItem([this, &ctx, &measures](EngravingItem* ch) {
+        if (ch->isType(ElementType::DUMMY)) {
+            return;
+        }
+
+        if (ch->isType(ElementType::MEASURE)) {
+            measures.push_back(ch);
+            return;
+        }
+
+        scanOutsideMeasures(ch, ctx, measures);
+    });
+}
+
+void PassLayoutIndependentItems::scanMeasure(EngravingItem* item, LayoutContext& ctx, std::vector<EngravingItem*>& deferred)
+{
+    if (isIndependent(item)) {
+        //! NOTE The subtree is deferred too, so the children are still laid out after their parent
+        if (isLayoutOnCallingThread(item)) {
+            deferred.push_back(item);
+            return;
+        }
+
+        TLayout::layoutItem(item, ctx);
+    }
+
+    item->forEachChildItem([this, &ctx, &deferred](EngravingItem* ch) {
+        if (ch->isType(ElementType::DUMMY)) {
+            return;
+        }
+        scanMeasure(ch, ctx, deferred);
+    });
+}
+
+void PassLayoutIndependentItems::layoutMeasuresParallel(const std::vector<EngravingItem*>& measures, LayoutContext& ctx)
+{
+    //! NOTE Load the fonts now, otherwise they would be loaded lazily by the first worker that needs them
+    if (engravingFonts()) {
+        engravingFonts()->fallbackFont();
+    }
+    ctx.engravingFont();
+
+    //! NOTE Every measure has its own scratch list of deferred items,
+    //! so the workers need no synchronization and the order does not depend on scheduling
+    std::vector<std::vector<EngravingItem*> > deferred(measures.size());
+
+    muse::TaskScheduler::instance()->parallelFor(0, measures.size(), [this, &measures, &deferred, &ctx](size_t i) {
+        scanMeasure(measures.at(i), ctx, deferred.at(i));
+    }, MEASURES_PER_TASK);
+
+    for (const std::vector<EngravingItem*>& items : deferred) {
+        for (EngravingItem* item : items) {
+            scan(item, ctx);
+        }
     }
 }
@@ -22,8 +22,13 @@
 #ifndef MU_ENGRAVING_PASSLAYOUTINDEPENDEDITEMS_DEV_H
 #define MU_ENGRAVING_PASSLAYOUTINDEPENDEDITEMS_DEV_H
 
+#include <vector>
+
 #include "passbase.h"
 
+#include "modularity/ioc.h"
+#include "../../iengravingfontsprovider.h"
+
 namespace mu::engraving {
 class EngravingItem;
 }
@@ -31,13 +36,28 @@ class EngravingItem;
 namespace mu::engraving::rendering::dev {
 class PassLayoutIndependentItems : public PassBase
 {
+    INJECT_STATIC(IEngravingFontsProvider, engravingFonts)
+
 public:
 
+    enum class Mode {
+        Serial,
+        Parallel    // measures are laid out concurrently on the task scheduler
+    };
+
+    explicit PassLayoutIndependentItems(Mode mode = Mode::Serial);
+
 private:
 
     void doRun(Score* score, LayoutContext& ctx) override;
 
     void scan(EngravingItem* item, LayoutContext& ctx);
+
+    void scanOutsideMeasures(EngravingItem* item, LayoutContext& ctx, std::vector<EngravingItem*>& measures);
+    void scanMeasure(EngravingItem* item, LayoutContext& ctx, std::vector<EngravingItem*>& deferred);
+    void layoutMeasuresParallel(const std::vector<EngravingItem*>& measures, LayoutContext& ctx);
+
+    Mode m_mode = Mode::Serial;
 };
 }
 
@@ -34,9 +34,7 @@ static void resetLayoutData(EngravingItem* item)
         item->mutldata()->reset();
     }
 
-    for (EngravingItem* ch : item->childrenItems()) {
-        resetLayoutData(ch);
-    }
+    item->forEachChildItem(resetLayoutData);
 }
 
 void PassResetLayoutData::doRun(Score* score, LayoutContext& ctx)
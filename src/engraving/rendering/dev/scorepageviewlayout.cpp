@@ -182,7 +182,7 @@ void ScorePageViewLayout::layoutPageView(Score* score, LayoutContext& ctx, const
 
 #ifdef MUE_ENABLE_ENGRAVING_LD_PASSES
     if (ctx.state().isLayoutAll()) {
-        PassLayoutIndependentItems independentPass;
+        PassLayoutIndependentItems independentPass(PassLayoutIndependentItems::Mode::Parallel);
         independentPass.run(score, ctx);
     }
 #endif
@@ -191,6 +191,8 @@ void ScorePageViewLayout::layoutPageView(Score* score, LayoutContext& ctx, const
 
     layoutFinished(score, ctx);
 
+    TRACE_COUNTER("engraving/systems", score->systems().size());
+
     LAYOUT_CALL_PRINT();
 }
 
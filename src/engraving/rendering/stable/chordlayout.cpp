@@ -1148,11 +1148,11 @@ void ChordLayout::layoutArticulations3(Chord* item, Slur* slur, LayoutContext& c
                 aa->mutldata()->moveY(minDist);
                 if (sstaff && aa->addToSkyline()) {
                     sstaff->skyline().add(aa->shape().translated(aa->pos() + item->pos() + s->pos() + m->pos()));
-                    for (ShapeElement& sh : s->staffShape(item->staffIdx()).elements()) {
+                    s->staffShape(item->staffIdx()).for_each([aa, minDist](ShapeElement& sh) {
                         if (sh.item() == aa) {
                             sh.translate(0.0, minDist);
                         }
-                    }
+                    });
                 }
             }
         }
@@ -274,9 +274,9 @@ static void paintRecursive(Painter& painter, const EngravingItem* item)
 {
     DebugPaint::paintTreeElement(painter, item);
 
-    for (const EngravingItem* eItem : item->childrenItems()) {
+    item->forEachChildItem([&painter](const EngravingItem* eItem) {
         paintRecursive(painter, eItem);
-    }
+    });
 }
 
 void DebugPaint::paintPageTree(Painter& painter, const Page* page)
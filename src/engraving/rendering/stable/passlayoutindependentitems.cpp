@@ -64,10 +64,10 @@ void PassLayoutIndependentItems::scan(EngravingItem* item, LayoutContext& ctx)
         break;
     }
 
-    for (EngravingItem* ch : item->childrenItems()) {
+    item->forEachChildItem([this, &ctx](EngravingItem* ch) {
         if (ch->isType(ElementType::DUMMY)) {
-            continue;
+            return;
         }
         scan(ch, ctx);
-    }
+    });
 }
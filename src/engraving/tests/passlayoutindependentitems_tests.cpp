@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dom/masterscore.h"
+
+#include "modularity/ioc.h"
+#include "iengravingfontsprovider.h"
+
+#include "rendering/dev/layoutcontext.h"
+#include "rendering/dev/passresetlayoutdata.h"
+#include "rendering/dev/passlayoutindependentitems.h"
+#include "rendering/dev/dumplayoutdata.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+using namespace mu::engraving::rendering::dev;
+
+static const String ALL_ELEMENTS_DATA_DIR("all_elements_data/");
+
+class Engraving_PassLayoutIndependentItemsTests : public ::testing::Test
+{
+    INJECT_STATIC(IEngravingFontsProvider, engravingFonts)
+
+public:
+    void tstSerialAndParallelEqual(const String& file);
+
+    std::string layoutIndependentItems(Score* score, PassLayoutIndependentItems::Mode mode);
+};
+
+std::string Engraving_PassLayoutIndependentItemsTests::layoutIndependentItems(Score* score, PassLayoutIndependentItems::Mode mode)
+{
+    LayoutContext ctx(score);
+
+    PassResetLayoutData resetPass;
+    resetPass.run(score, ctx);
+
+    PassLayoutIndependentItems independentPass(mode);
+    independentPass.run(score, ctx);
+
+    return DumpLayoutData::dump(score);
+}
+
+void Engraving_PassLayoutIndependentItemsTests::tstSerialAndParallelEqual(const String& file)
+{
+    // [GIVEN] Laid out score
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + file);
+    ASSERT_TRUE(score);
+
+    // [WHEN] Independent items are laid out in parallel, then serially
+    std::string parallel = layoutIndependentItems(score, PassLayoutIndependentItems::Mode::Parallel);
+    std::string serial = layoutIndependentItems(score, PassLayoutIndependentItems::Mode::Serial);
+
+    // [THEN] The layout data is the same
+    EXPECT_FALSE(serial.empty());
+    EXPECT_EQ(serial, parallel);
+
+    // [WHEN] The parallel run is repeated
+    std::string parallel2 = layoutIndependentItems(score, PassLayoutIndependentItems::Mode::Parallel);
+
+    // [THEN] The result does not depend on scheduling
+    EXPECT_EQ(parallel, parallel2);
+
+    delete score;
+}
+
+TEST_F(Engraving_PassLayoutIndependentItemsTests, layoutElements)
+{
+    tstSerialAndParallelEqual(u"layout_elements.mscx");
+}
+
+TEST_F(Engraving_PassLayoutIndependentItemsTests, layoutElementsTab)
+{
+    tstSerialAndParallelEqual(u"layout_elements_tab.mscx");
+}
+
+TEST_F(Engraving_PassLayoutIndependentItemsTests, moonlight)
+{
+    tstSerialAndParallelEqual(u"moonlight.mscx");
+}
+
+TEST_F(Engraving_PassLayoutIndependentItemsTests, parallelFirstOnColdFont)
+{
+    // [GIVEN] A score with accidentals, engraved with a font whose symbol caches are still empty
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    engravingFonts()->addFont("Leland (cold)", "Leland", ":/fonts/leland/Leland.otf");
+    score->setEngravingFont(engravingFonts()->fontByName("Leland (cold)"));
+
+    // [WHEN] The first layout with this font is the parallel one
+    std::string parallel = layoutIndependentItems(score, PassLayoutIndependentItems::Mode::Parallel);
+    std::string serial = layoutIndependentItems(score, PassLayoutIndependentItems::Mode::Serial);
+
+    // [THEN] It is the same as the serial one
+    EXPECT_FALSE(parallel.empty());
+    EXPECT_EQ(parallel, serial);
+
+    delete score;
+}
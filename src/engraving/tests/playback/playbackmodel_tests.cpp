@@ -858,6 +858,101 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
     score->changesChannel().send(range);
 }
 
+/**
+ * @brief PlaybackModelTests_Deferred_Update
+ * @details The changes are rendered piece by piece and published at once,
+ *          a newer change publishes the measures rendered so far and renders the rest again with its own range
+ */
+TEST_F(Engraving_PlaybackModelTests, Deferred_Update)
+{
+    // [GIVEN] Simple piece of score (Violin, 4/4, 120 bpm, Treble Cleff)
+    Score* score = ScoreRW::readScore(PLAYBACK_MODEL_TEST_FILES_DIR + "repeat_range/repeat_range.mscx");
+
+    ASSERT_TRUE(score);
+    ASSERT_EQ(score->parts().size(), 1);
+
+    const Part* part = score->parts().at(0);
+    ASSERT_TRUE(part);
+
+    ON_CALL(*m_repositoryMock, defaultProfile(ArticulationFamily::Strings)).WillByDefault(Return(m_defaultProfile));
+
+    // [GIVEN] The playback model in the deferred mode
+    PlaybackModel model;
+    model.profilesRepository.set(m_repositoryMock);
+    model.setDeferredUpdateEnabled(true);
+    model.load(score);
+
+    const PlaybackData& result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
+    const PlaybackEventsMap expectedEvents = result.originEvents;
+    ASSERT_EQ(expectedEvents.size(), 24);
+
+    int pendingUpdateCount = 0;
+    model.pendingUpdateAdded().onNotify(this, [&pendingUpdateCount]() {
+        ++pendingUpdateCount;
+    });
+
+    int receivedCount = 0;
+    auto mainStream = result.mainStream;
+    mainStream.onReceive(this, [&receivedCount](const PlaybackEventsMap& updatedEvents, const DynamicLevelMap&, const PlaybackParamMap&) {
+        EXPECT_EQ(updatedEvents.size(), 24);
+        ++receivedCount;
+    });
+
+    ScoreChangesRange range;
+    range.tickFrom = 480;
+    range.tickTo = 3840;
+    range.staffIdxFrom = 0;
+    range.staffIdxTo = 0;
+    range.changedTypes = { ElementType::NOTE };
+
+    // [WHEN] Notation has been changed
+    score->changesChannel().send(range);
+
+    // [THEN] Nothing is rendered yet, the events stay in use
+    EXPECT_TRUE(model.hasPendingUpdate());
+    EXPECT_EQ(pendingUpdateCount, 1);
+    EXPECT_EQ(receivedCount, 0);
+    EXPECT_EQ(result.originEvents.size(), expectedEvents.size());
+
+    // [WHEN] A part of the update is rendered and the notation changes again
+    model.processPendingUpdate(std::chrono::milliseconds(0));
+
+    range.tickFrom = 5760;
+    range.tickTo = 7680;
+    score->changesChannel().send(range);
+
+    // [THEN] The rendered measure is published, the rest is pending together with the new range
+    EXPECT_TRUE(model.hasPendingUpdate());
+    EXPECT_EQ(pendingUpdateCount, 2);
+    EXPECT_EQ(receivedCount, 1);
+    EXPECT_EQ(result.originEvents.size(), expectedEvents.size());
+
+    // [WHEN] The notation changes again before anything is rendered
+    range.tickFrom = 1920;
+    range.tickTo = 3840;
+    score->changesChannel().send(range);
+
+    // [THEN] The same update goes on, nothing is published
+    EXPECT_TRUE(model.hasPendingUpdate());
+    EXPECT_EQ(pendingUpdateCount, 2);
+    EXPECT_EQ(receivedCount, 1);
+
+    // [WHEN] The update is rendered to the end
+    while (!model.processPendingUpdate(std::chrono::milliseconds(0))) {
+    }
+
+    // [THEN] The rest is published once, the events are the same as before
+    EXPECT_FALSE(model.hasPendingUpdate());
+    EXPECT_EQ(receivedCount, 2);
+
+    ASSERT_EQ(result.originEvents.size(), expectedEvents.size());
+    for (const auto& pair : expectedEvents) {
+        auto it = result.originEvents.find(pair.first);
+        ASSERT_TRUE(it != result.originEvents.end());
+        EXPECT_EQ(it->second.size(), pair.second.size());
+    }
+}
+
 /**
  * @brief PlaybackModelTests_TempoChangesDuringNotes
  * @details Test that notes and other elements have the correct length when tempo changes occur during them
@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "api/v1/scoreelement.h"
+
+#include "dom/factory.h"
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/stafftext.h"
+#include "compat/dummyelement.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String ALL_ELEMENTS_DATA_DIR("all_elements_data/");
+
+class Engraving_PluginApiWrapperCacheTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_PluginApiWrapperCacheTests, Wrap_WhilePluginRuns_SameWrapper)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"layout_elements.mscx");
+    ASSERT_TRUE(score);
+
+    Measure* measure = score->firstMeasure();
+    ASSERT_TRUE(measure && measure->nextMeasure());
+
+    //! [GIVEN] No plugin runs
+    ASSERT_FALSE(apiv1::WrapperCache::current());
+
+    //! [THEN] Every access creates a new wrapper, owned by JavaScript
+    apiv1::ScoreElement* w1 = apiv1::wrap(measure);
+    apiv1::ScoreElement* w2 = apiv1::wrap(measure);
+    EXPECT_NE(w1, w2);
+    delete w1;
+    delete w2;
+
+    //! [WHEN] A plugin runs
+    apiv1::WrapperCache cache;
+    cache.start();
+    EXPECT_EQ(apiv1::WrapperCache::current(), &cache);
+
+    //! [THEN] An object keeps its wrapper
+    apiv1::ScoreElement* cached = apiv1::wrap(measure);
+    EXPECT_EQ(apiv1::wrap(measure), cached);
+    EXPECT_NE(apiv1::wrap(measure->nextMeasure()), cached);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.size(score), 2u);
+
+    //! [THEN] Plugin-owned wrappers are never cached
+    apiv1::ScoreElement* owned = apiv1::wrap(measure, apiv1::Ownership::PLUGIN);
+    EXPECT_NE(owned, cached);
+    EXPECT_EQ(cache.size(), 2u);
+
+    //! [WHEN] The plugin ends
+    cache.end();
+
+    //! [THEN] The wrappers are released
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(apiv1::WrapperCache::current());
+
+    delete score;
+}
+
+TEST_F(Engraving_PluginApiWrapperCacheTests, Delete_Object_WrapperReleased)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"layout_elements.mscx");
+    MasterScore* otherScore = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score && otherScore);
+
+    apiv1::WrapperCache cache;
+    cache.start();
+
+    //! [GIVEN] Wrappers of two scores
+    StaffText* text = Factory::createStaffText(score->dummy()->segment());
+    apiv1::wrap(text);
+    apiv1::wrap(score->firstMeasure());
+    apiv1::wrap(otherScore->firstMeasure());
+
+    EXPECT_EQ(cache.size(score), 2u);
+    EXPECT_EQ(cache.size(otherScore), 1u);
+
+    //! [WHEN] An object is deleted
+    delete text;
+
+    //! [THEN] Only its wrapper is released
+    EXPECT_EQ(cache.size(score), 1u);
+    EXPECT_EQ(cache.size(otherScore), 1u);
+
+    //! [WHEN] A score is closed
+    delete otherScore;
+
+    //! [THEN] The wrappers of its objects are released
+    EXPECT_EQ(cache.size(otherScore), 0u);
+    EXPECT_EQ(cache.size(), 1u);
+
+    cache.end();
+    delete score;
+}
@@ -25,6 +25,8 @@
 #include "dom/masterscore.h"
 #include "dom/measure.h"
 #include "dom/repeatlist.h"
+#include "dom/tempo.h"
+#include "types/constants.h"
 
 #include "utils/scorerw.h"
 
@@ -415,3 +417,59 @@ TEST_F(Engraving_RepeatTests, repeat68) {
     // Entire score skipped by volta: gh#14685
     repeat("repeat68.mscx", u"");
 }
+
+//---------------------------------------------------------
+//   timeline
+//    The repeat list converts with a precompiled timeline,
+//    it must give the same results as walking the repeat
+//    segments and the tempo map
+//---------------------------------------------------------
+
+TEST_F(Engraving_RepeatTests, timeline) {
+    MasterScore* score = ScoreRW::readScore(REPEAT_DATA_DIR + u"repeat01.mscx");
+    ASSERT_TRUE(score);
+
+    // [GIVEN] Repeats, tempo changes and a pause
+    score->setExpandRepeats(true);
+    score->setTempo(Fraction(1, 1), BeatsPerSecond(3.0));
+    score->setTempo(Fraction(5, 2), BeatsPerSecond(1.5));
+    score->setPause(Fraction(2, 1), 0.5);
+
+    const RepeatList& repeats = score->repeatList();
+    const TempoMap* tempomap = score->tempomap();
+    ASSERT_GT(repeats.size(), size_t(1));
+
+    std::vector<int> uticks;
+
+    for (int utick = 0; utick < repeats.ticks(); utick += Constants::DIVISION / 4) {
+        const RepeatSegment* rs = nullptr;
+        for (const RepeatSegment* s : repeats) {
+            if (utick >= s->utick) {
+                rs = s;
+            }
+        }
+        ASSERT_TRUE(rs);
+
+        // [THEN] Conversions match the segment and the tempo map
+        const int tick = utick - (rs->utick - rs->tick);
+        const double time = tempomap->tick2time(tick) + rs->timeOffset;
+
+        EXPECT_EQ(repeats.utick2tick(utick), tick);
+        EXPECT_DOUBLE_EQ(repeats.utick2utime(utick), time);
+        EXPECT_NEAR(repeats.utime2utick(time), utick, 1);
+        EXPECT_LE(repeats.tick2utick(tick), utick);
+
+        uticks.push_back(utick);
+    }
+
+    // [THEN] The batch conversion gives the same results
+    std::vector<double> times;
+    repeats.utick2utime(uticks, times);
+    ASSERT_EQ(times.size(), uticks.size());
+
+    for (size_t i = 0; i < uticks.size(); ++i) {
+        EXPECT_DOUBLE_EQ(times[i], repeats.utick2utime(uticks[i]));
+    }
+
+    delete score;
+}
@@ -22,7 +22,30 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+
+#include "containers.h"
+
+#include "dom/accidental.h"
+#include "dom/arpeggio.h"
+#include "dom/articulation.h"
+#include "dom/bracket.h"
+#include "dom/chord.h"
+#include "dom/hook.h"
+#include "dom/ledgerline.h"
 #include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/note.h"
+#include "dom/notedot.h"
+#include "dom/page.h"
+#include "dom/rootitem.h"
+#include "dom/segment.h"
+#include "dom/stem.h"
+#include "dom/stemslash.h"
+#include "dom/system.h"
 
 #include "utils/scorerw.h"
 
@@ -118,3 +141,245 @@ TEST_F(Engraving_ScanTreeTests, DISABLED_tstTreeGoldberg) // too long
 {
     tstTree(u"goldberg.mscx");
 }
+
+static size_t countByChildLists(const EngravingObject* element)
+{
+    size_t count = 1;
+    for (const EngravingObject* child : element->scanChildren()) {
+        count += countByChildLists(child);
+    }
+    return count;
+}
+
+static size_t countByVisitor(const EngravingObject* element)
+{
+    size_t count = 1;
+    element->forEachChild([&count](EngravingObject* child) {
+        count += countByVisitor(child);
+    });
+    return count;
+}
+
+//! NOTE How the layout passes visited the items before forEachChildItem()
+static size_t countItemsByChildLists(const EngravingItem* item)
+{
+    size_t count = 1;
+    for (const EngravingItem* child : item->childrenItems()) {
+        count += countItemsByChildLists(child);
+    }
+    return count;
+}
+
+static size_t countItemsByVisitor(const EngravingItem* item)
+{
+    size_t count = 1;
+    item->forEachChildItem([&count](const EngravingItem* child) {
+        count += countItemsByVisitor(child);
+    });
+    return count;
+}
+
+//---------------------------------------------------------
+//   expectedChildren
+///   The children of the main structural elements, enumerated
+///   from their own accessors, independently of forEachChild()
+//---------------------------------------------------------
+
+static std::vector<const EngravingObject*> expectedChildren(const EngravingObject* element)
+{
+    std::vector<const EngravingObject*> children;
+
+    if (element->isScore()) {
+        for (const Page* page : toScore(element)->pages()) {
+            children.push_back(page);
+        }
+    } else if (element->isPage()) {
+        for (const System* system : toPage(element)->systems()) {
+            children.push_back(system);
+        }
+    } else if (element->isSystem()) {
+        const System* system = toSystem(element);
+        for (const Bracket* bracket : system->brackets()) {
+            children.push_back(bracket);
+        }
+        for (const MeasureBase* measure : system->measures()) {
+            children.push_back(measure);
+        }
+    } else if (element->isMeasure()) {
+        const Measure* measure = toMeasure(element);
+        if (!measure->isMMRest()) {
+            for (const Segment* segment = measure->first(); segment; segment = segment->next()) {
+                children.push_back(segment);
+            }
+        }
+    } else if (element->isSegment()) {
+        const Segment* segment = toSegment(element);
+        for (const EngravingItem* item : segment->elist()) {
+            if (item) {
+                children.push_back(item);
+            }
+        }
+        for (const EngravingItem* annotation : segment->annotations()) {
+            children.push_back(annotation);
+        }
+    } else if (element->isChord()) {
+        const Chord* chord = toChord(element);
+        for (const Note* note : chord->notes()) {
+            children.push_back(note);
+        }
+        for (const Chord* grace : chord->graceNotes()) {
+            children.push_back(grace);
+        }
+        for (const Articulation* articulation : chord->articulations()) {
+            children.push_back(articulation);
+        }
+        for (const LedgerLine* ledgerLine = chord->ledgerLines(); ledgerLine; ledgerLine = ledgerLine->next()) {
+            children.push_back(ledgerLine);
+        }
+        for (const EngravingObject* item : { static_cast<const EngravingObject*>(chord->stem()),
+                                             static_cast<const EngravingObject*>(chord->hook()),
+                                             static_cast<const EngravingObject*>(chord->stemSlash()),
+                                             static_cast<const EngravingObject*>(chord->arpeggio()) }) {
+            if (item) {
+                children.push_back(item);
+            }
+        }
+    } else if (element->isNote()) {
+        const Note* note = toNote(element);
+        if (note->accidental()) {
+            children.push_back(note->accidental());
+        }
+        for (const NoteDot* dot : note->dots()) {
+            children.push_back(dot);
+        }
+        for (const EngravingItem* item : note->el()) {
+            children.push_back(item);
+        }
+    }
+
+    return children;
+}
+
+static void checkVisitedChildren(const EngravingObject* element, std::map<ElementType, size_t>& visitedCounts)
+{
+    std::vector<const EngravingObject*> visited;
+    element->forEachChild([&visited](EngravingObject* child) {
+        visited.push_back(child);
+    });
+
+    // every child is visited once
+    std::set<const EngravingObject*> visitedSet(visited.begin(), visited.end());
+    EXPECT_EQ(visitedSet.size(), visited.size()) << elementToText(const_cast<EngravingObject*>(element)).toStdString();
+
+    std::vector<const EngravingObject*> expected = expectedChildren(element);
+    for (const EngravingObject* child : expected) {
+        EXPECT_TRUE(muse::contains(visitedSet, child))
+            << child->typeName() << " not visited as a child of " << element->typeName();
+    }
+
+    visitedCounts[element->type()]++;
+
+    for (const EngravingObject* child : visited) {
+        checkVisitedChildren(child, visitedCounts);
+    }
+}
+
+TEST_F(Engraving_ScanTreeTests, forEachChildVisitsStructure)
+{
+    // [GIVEN] A score with all kinds of elements
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"layout_elements.mscx");
+    ASSERT_TRUE(score);
+
+    // [WHEN] The tree is visited from the score
+    std::map<ElementType, size_t> visitedCounts;
+    checkVisitedChildren(score, visitedCounts);
+
+    // [THEN] Every child enumerated from the accessors was visited (checked above),
+    // and so were all the chords and notes found by walking the segments
+    size_t chords = 0;
+    size_t notes = 0;
+    for (const Segment* segment = score->firstSegment(SegmentType::ChordRest); segment;
+         segment = segment->next1(SegmentType::ChordRest)) {
+        for (const EngravingItem* item : segment->elist()) {
+            if (!item || !item->isChord()) {
+                continue;
+            }
+
+            const Chord* chord = toChord(item);
+            chords += 1 + chord->graceNotes().size();
+            notes += chord->notes().size();
+            for (const Chord* grace : chord->graceNotes()) {
+                notes += grace->notes().size();
+            }
+        }
+    }
+
+    EXPECT_EQ(visitedCounts[ElementType::PAGE], score->pages().size());
+    EXPECT_EQ(visitedCounts[ElementType::SYSTEM], score->systems().size());
+    EXPECT_GT(chords, 0u);
+    EXPECT_EQ(visitedCounts[ElementType::CHORD], chords);
+    EXPECT_EQ(visitedCounts[ElementType::NOTE], notes);
+
+    delete score;
+}
+
+template<typename Func>
+static int64_t measureMicroseconds(int iterations, Func&& func)
+{
+    using namespace std::chrono;
+
+    const auto start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        func();
+    }
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+TEST_F(Engraving_ScanTreeTests, DISABLED_fullTraversalBenchmark)
+{
+    // [GIVEN] A large score
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    constexpr int ITERATIONS = 200;
+
+    // [WHEN] The whole tree is traversed by building a list of children per node, as before forEachChild()
+    size_t listCount = 0;
+    const int64_t listTime = measureMicroseconds(ITERATIONS, [score, &listCount]() {
+        listCount += countByChildLists(score);
+    });
+
+    // [WHEN] And by visiting the children
+    size_t visitorCount = 0;
+    const int64_t visitorTime = measureMicroseconds(ITERATIONS, [score, &visitorCount]() {
+        visitorCount += countByVisitor(score);
+    });
+
+    // [WHEN] The items are traversed as the layout passes did before forEachChildItem(), and as they do now
+    size_t itemListCount = 0;
+    const int64_t itemListTime = measureMicroseconds(ITERATIONS, [score, &itemListCount]() {
+        itemListCount += countItemsByChildLists(score->rootItem());
+    });
+
+    size_t itemVisitorCount = 0;
+    const int64_t itemVisitorTime = measureMicroseconds(ITERATIONS, [score, &itemVisitorCount]() {
+        itemVisitorCount += countItemsByVisitor(score->rootItem());
+    });
+
+    // [THEN] Both ways traverse the same tree
+    EXPECT_EQ(listCount, visitorCount);
+    EXPECT_EQ(itemListCount, itemVisitorCount);
+
+    // [THEN] The visitors are faster than the lists they replace
+    EXPECT_LT(visitorTime, listTime);
+    EXPECT_LT(itemVisitorTime, itemListTime);
+
+    LOGI() << "Full traversal of " << listCount / ITERATIONS << " objects, " << ITERATIONS << " times: "
+           << "children lists " << listTime << " us, visitor " << visitorTime << " us, speed-up "
+           << static_cast<double>(listTime) / std::max<int64_t>(visitorTime, 1);
+    LOGI() << "Item traversal of " << itemListCount / ITERATIONS << " items, " << ITERATIONS << " times: "
+           << "childrenItems " << itemListTime << " us, forEachChildItem " << itemVisitorTime << " us, speed-up "
+           << static_cast<double>(itemListTime) / std::max<int64_t>(itemVisitorTime, 1);
+
+    delete score;
+}
@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <random>
+
+#include "infrastructure/shape.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+class Engraving_ShapeTests : public ::testing::Test
+{
+protected:
+    static Shape randomShape(std::mt19937& gen, size_t count)
+    {
+        std::uniform_real_distribution<double> pos(-10.0, 10.0);
+        std::uniform_real_distribution<double> size(0.0, 4.0);
+        std::bernoulli_distribution flat(0.1);
+
+        Shape shape(Shape::Type::Composite);
+        for (size_t i = 0; i < count; ++i) {
+            shape.add(RectF(pos(gen), pos(gen), flat(gen) ? 0.0 : size(gen), flat(gen) ? 0.0 : size(gen)));
+        }
+        return shape;
+    }
+
+    // the element by element version of Shape::minVerticalDistance()
+    static double referenceMinVerticalDistance(const Shape& above, const Shape& below)
+    {
+        double dist = -DBL_MAX;
+        for (const RectF& r2 : below.elements()) {
+            for (const RectF& r1 : above.elements()) {
+                if (r1.height() > 0.0 && r2.height() > 0.0
+                    && mu::engraving::intersects(r1.left(), r1.right(), r2.left(), r2.right(), 0.0)) {
+                    dist = std::max(dist, r1.bottom() - r2.top());
+                }
+            }
+        }
+        return dist;
+    }
+
+    // the element by element version of Shape::verticalClearance()
+    static double referenceVerticalClearance(const Shape& above, const Shape& below, double minHorizontalDistance)
+    {
+        double dist = DBL_MAX;
+        for (const RectF& r2 : below.elements()) {
+            for (const RectF& r1 : above.elements()) {
+                if (r1.height() > 0.0 && r2.height() > 0.0
+                    && mu::engraving::intersects(r1.left(), r1.right(), r2.left() - minHorizontalDistance,
+                                                 r2.right() + minHorizontalDistance, 0.0)) {
+                    dist = std::min(dist, r2.top() - r1.bottom());
+                }
+            }
+        }
+        return dist;
+    }
+};
+
+TEST_F(Engraving_ShapeTests, VerticalDistances_MatchElementByElement)
+{
+    std::mt19937 gen(42);
+
+    for (int i = 0; i < 1000; ++i) {
+        // [GIVEN] Two random shapes
+        const Shape above = randomShape(gen, 1 + i % 17);
+        const Shape below = randomShape(gen, 1 + i % 23);
+
+        // [THEN] The distances are exactly the ones of the element by element computation
+        EXPECT_EQ(above.minVerticalDistance(below), referenceMinVerticalDistance(above, below));
+        EXPECT_EQ(above.verticalClearance(below), referenceVerticalClearance(above, below, 0.0));
+        EXPECT_EQ(above.verticalClearance(below, 0.5), referenceVerticalClearance(above, below, 0.5));
+    }
+}
+
+TEST_F(Engraving_ShapeTests, VerticalDistances_FollowChanges)
+{
+    // [GIVEN] Two shapes, one above the other
+    Shape above(Shape::Type::Composite);
+    above.add(RectF(0.0, 0.0, 2.0, 1.0));
+    Shape below(Shape::Type::Composite);
+    below.add(RectF(0.0, 3.0, 2.0, 1.0));
+
+    EXPECT_DOUBLE_EQ(above.verticalClearance(below), 2.0);
+
+    // [WHEN] They are changed in every possible way
+    // [THEN] The distances follow
+    below.translateY(-1.0);
+    EXPECT_DOUBLE_EQ(above.verticalClearance(below), 1.0);
+
+    below.for_each([](ShapeElement& r) { r.translate(0.0, 0.5); });
+    EXPECT_DOUBLE_EQ(above.verticalClearance(below), 1.5);
+
+    above.add(RectF(1.0, 0.0, 2.0, 2.0));
+    EXPECT_DOUBLE_EQ(above.verticalClearance(below), 0.5);
+    EXPECT_DOUBLE_EQ(above.minVerticalDistance(below), -0.5);
+
+    above.remove_if([](const ShapeElement& r) { return r.height() > 1.5; });
+    EXPECT_DOUBLE_EQ(above.verticalClearance(below), 1.5);
+
+    const Shape moved = above.translated(PointF(10.0, 0.0));
+    EXPECT_DOUBLE_EQ(moved.verticalClearance(below), DBL_MAX);
+    EXPECT_DOUBLE_EQ(moved.verticalClearance(below.translated(PointF(10.0, 0.0))), 1.5);
+}
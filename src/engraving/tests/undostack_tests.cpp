@@ -0,0 +1,184 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/undo.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String ALL_ELEMENTS_DATA_DIR("all_elements_data/");
+
+class Engraving_UndoStackTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"layout_elements.mscx");
+    }
+
+    void TearDown() override
+    {
+        delete m_score;
+        m_score = nullptr;
+    }
+
+    static double stretchOf(int step)
+    {
+        return 1.0 + step / 1000.0;
+    }
+
+    double userStretch() const
+    {
+        return m_score->firstMeasure()->getProperty(Pid::USER_STRETCH).toDouble();
+    }
+
+    void changeUserStretch(int step)
+    {
+        m_score->startCmd();
+        m_score->firstMeasure()->undoChangeProperty(Pid::USER_STRETCH, stretchOf(step));
+        m_score->endCmd();
+    }
+
+    MasterScore* m_score = nullptr;
+};
+
+TEST_F(Engraving_UndoStackTests, Compact_CoalescesPropertyChanges)
+{
+    ASSERT_TRUE(m_score);
+
+    // [GIVEN] One undo step changing the same property several times
+    const double originalStretch = userStretch();
+
+    m_score->startCmd();
+    for (int step = 1; step <= 10; ++step) {
+        m_score->firstMeasure()->undoChangeProperty(Pid::USER_STRETCH, stretchOf(step));
+    }
+    m_score->endCmd();
+
+    UndoStack* undoStack = m_score->undoStack();
+    UndoMacro* macro = undoStack->last();
+    ASSERT_TRUE(macro);
+
+    size_t changeCount = 0;
+    for (const UndoCommand* cmd : macro->commands()) {
+        changeCount += cmd->type() == CommandType::ChangeProperty ? 1 : 0;
+    }
+    EXPECT_EQ(changeCount, 10);
+
+    // [WHEN] Compact it
+    const size_t usageBefore = macro->memoryUsage();
+    macro->compact();
+
+    // [THEN] Only the first change is left, and it takes less memory
+    changeCount = 0;
+    for (const UndoCommand* cmd : macro->commands()) {
+        changeCount += cmd->type() == CommandType::ChangeProperty ? 1 : 0;
+    }
+    EXPECT_EQ(changeCount, 1);
+    EXPECT_TRUE(macro->compacted());
+    EXPECT_LT(macro->memoryUsage(), usageBefore);
+
+    // [THEN] Undo and redo still give the original and the last values
+    m_score->undoRedo(/*undo*/ true, nullptr);
+    EXPECT_DOUBLE_EQ(userStretch(), originalStretch);
+
+    m_score->undoRedo(/*undo*/ false, nullptr);
+    EXPECT_DOUBLE_EQ(userStretch(), stretchOf(10));
+}
+
+TEST_F(Engraving_UndoStackTests, MemoryBudget_KeepsRecentSteps)
+{
+    ASSERT_TRUE(m_score);
+
+    UndoStack* undoStack = m_score->undoStack();
+    const size_t startIdx = undoStack->getCurIdx();
+
+    // [GIVEN] A tiny memory budget
+    undoStack->setMemoryBudget(1);
+
+    // [WHEN] Many steps are done
+    constexpr int STEP_COUNT = 500;
+    for (int step = 1; step <= STEP_COUNT; ++step) {
+        changeUserStretch(step);
+    }
+
+    // [THEN] The old steps are gone, but the index keeps counting all of them
+    EXPECT_EQ(undoStack->getCurIdx(), startIdx + STEP_COUNT);
+
+    const std::vector<UndoStack::MacroStatistic> statistics = undoStack->statistics();
+    EXPECT_LT(statistics.size(), size_t(STEP_COUNT));
+    EXPECT_FALSE(statistics.empty());
+
+    size_t usage = 0;
+    for (const UndoStack::MacroStatistic& stat : statistics) {
+        EXPECT_GT(stat.commandCount, 0);
+        usage += stat.memoryUsage;
+    }
+    EXPECT_EQ(usage, undoStack->memoryUsage());
+
+    // [THEN] The recent steps can be undone one by one
+    for (int step = STEP_COUNT; step > STEP_COUNT - 100; --step) {
+        ASSERT_TRUE(undoStack->canUndo());
+        EXPECT_DOUBLE_EQ(userStretch(), stretchOf(step));
+        m_score->undoRedo(/*undo*/ true, nullptr);
+    }
+    EXPECT_DOUBLE_EQ(userStretch(), stretchOf(STEP_COUNT - 100));
+}
+
+TEST_F(Engraving_UndoStackTests, MergeCommands_CompactedStart_Refused)
+{
+    ASSERT_TRUE(m_score);
+
+    UndoStack* undoStack = m_score->undoStack();
+    undoStack->setMemoryBudget(1);
+
+    // [GIVEN] An edit longer than the steps kept by the memory budget
+    const size_t editStartIdx = undoStack->getCurIdx();
+
+    constexpr int STEP_COUNT = 500;
+    for (int step = 1; step <= STEP_COUNT; ++step) {
+        changeUserStretch(step);
+    }
+
+    const size_t macroCount = undoStack->statistics().size();
+
+    // [WHEN] The steps of the edit are merged
+    undoStack->mergeCommands(editStartIdx);
+
+    // [THEN] Nothing is merged, the older steps are not taken in
+    EXPECT_EQ(undoStack->statistics().size(), macroCount);
+    EXPECT_EQ(undoStack->getCurIdx(), editStartIdx + STEP_COUNT);
+
+    // [WHEN] The last steps are merged
+    undoStack->mergeCommands(undoStack->getCurIdx() - 3);
+
+    // [THEN] They are undone at once
+    EXPECT_EQ(undoStack->statistics().size(), macroCount - 2);
+    m_score->undoRedo(/*undo*/ true, nullptr);
+    EXPECT_DOUBLE_EQ(userStretch(), stretchOf(STEP_COUNT - 3));
+}
@@ -62,6 +62,10 @@ public:
     // synthesizers
     virtual AudioInputParams defaultAudioInputParams() const = 0;
 
+    //! NOTE The number of synth instances a FluidSynth track spreads its MIDI channels between,
+    //! so that the channels of busy tracks are rendered in parallel. 1 means disabled
+    virtual size_t fluidSynthInstanceCount() const = 0;
+
     virtual io::paths_t soundFontDirectories() const = 0;
     virtual io::paths_t userSoundFontDirectories() const = 0;
     virtual void setUserSoundFontDirectories(const io::paths_t& paths) = 0;
@@ -21,6 +21,8 @@
  */
 #include "audioconfiguration.h"
 
+#include <thread>
+
 //TODO: remove with global clearing of Q_OS_*** defines
 #include <QtGlobal>
 
@@ -177,6 +179,19 @@ AudioInputParams AudioConfiguration::defaultAudioInputParams() const
     return result;
 }
 
+size_t AudioConfiguration::fluidSynthInstanceCount() const
+{
+    // The tracks are already processed in parallel, so leave some cores for them
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    if (threadCount >= 8) {
+        return 4;
+    }
+    if (threadCount >= 4) {
+        return 2;
+    }
+    return 1;
+}
+
 SoundFontPaths AudioConfiguration::soundFontDirectories() const
 {
     SoundFontPaths paths = userSoundFontDirectories();
@@ -59,5 +59,5 @@ bool AudioSanitizer::isWorkerThread()
 {
     std::thread::id id = std::this_thread::get_id();
 
-    return TaskScheduler::instance()->containsThread(id) || id == s_as_workerThreadID;
+    return TaskScheduler::instance(ThreadPriority::Realtime)->containsThread(id) || id == s_as_workerThreadID;
 }
@@ -34,6 +34,9 @@ using namespace muse::audio;
 
 std::thread::id AudioThread::ID;
 
+// the calls from every other thread, which fit in the rings between two iterations of the loop
+static constexpr size_t CALL_QUEUE_CAPACITY = 1024;
+
 AudioThread::~AudioThread()
 {
     if (m_running) {
@@ -79,6 +82,9 @@ void AudioThread::main()
 
     AudioThread::ID = std::this_thread::get_id();
 
+    //! NOTE The worker must not lock or allocate to receive the calls
+    async::enableRingQueue(CALL_QUEUE_CAPACITY);
+
     if (m_onStart) {
         m_onStart();
     }
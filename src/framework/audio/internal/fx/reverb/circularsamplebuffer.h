@@ -100,6 +100,14 @@ public:
         return m_buffer[(m_positionIndex + offset) & m_bufferSizeMask];
     }
 
+    /// pointer to the sample at the offset, numContiguous samples follow it before the buffer wraps around
+    const SampleT* readPointer(int offset, int& numContiguous) const
+    {
+        int index = (m_positionIndex + offset) & m_bufferSizeMask;
+        numContiguous = m_allocatedSize - index;
+        return &m_buffer[index];
+    }
+
     /// change the 0 position by n
     void advance(int n)
     {
@@ -22,6 +22,7 @@
 
 #include "reverbprocessor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <complex>
@@ -54,12 +55,19 @@ public:
 
     void setSize(int32_t numChannels, int32_t samples)
     {
+        // called for every block, the memory is kept as long as it is large enough
+        if (numChannels == num_channels && samples <= allocated_samples) {
+            num_samples = samples;
+            return;
+        }
+
         for (int ch = 0; ch < num_channels; ch++) {
             dealloc(ch);
         }
 
         num_channels = numChannels;
         num_samples = samples;
+        allocated_samples = samples;
         data.resize(num_channels);
         for (int ch = 0; ch < num_channels; ch++) {
             alloc(ch, num_samples);
@@ -112,6 +120,7 @@ public:
 private:
     int32_t num_channels{ 0 };
     int32_t num_samples{ 0 };
+    int32_t allocated_samples{ 0 };
     std::vector<float*> data;
 
     void alloc(int32_t channel, int32_t samples)
@@ -196,6 +205,20 @@ static inline float _sqrt_sign(float x)
     return std::copysign(std::sqrt(std::abs(x)), x);
 }
 
+// -120 dB
+static constexpr float SILENCE_THRESHOLD = 1e-6f;
+
+static bool isSilent(const float* buffer, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (std::abs(buffer[i]) > SILENCE_THRESHOLD) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 struct ReverbProcessor::impl
 {
     // members requiring alignment first
@@ -332,11 +355,39 @@ void ReverbProcessor::setActive(bool active)
 
 void ReverbProcessor::process(float* buffer, unsigned int sampleCount)
 {
-    if (m_processor._blockSize != static_cast<int>(sampleCount)) {
-        setFormat(m_processor._audioChannelsCount, m_processor._sampleRate, sampleCount);
+    // a larger block is done in pieces, so that the state of the reverb is kept whatever the block size is
+    const int32_t maxBlockSize = m_processor._blockSize;
+    const audioch_t audioChannelsCount = m_processor._audioChannelsCount;
+
+    for (int32_t done = 0; done < static_cast<int32_t>(sampleCount);) {
+        const int32_t count = std::min(static_cast<int32_t>(sampleCount) - done, maxBlockSize);
+        processBlock(buffer + done * audioChannelsCount, count);
+        done += count;
+    }
+}
+
+void ReverbProcessor::processBlock(float* buffer, int32_t sampleCount)
+{
+    const size_t bufferSize = static_cast<size_t>(sampleCount) * m_processor._audioChannelsCount;
+
+    if (isSilent(buffer, bufferSize)) {
+        m_silentInputSamples += sampleCount;
+    } else {
+        m_silentInputSamples = 0;
+        m_tailBypassed = false;
+    }
+
+    if (m_tailBypassed) {
+        // nothing is left of the tail, the input is below the threshold anyway.
+        // The modulation keeps running, so that the next notes sound as without the bypass
+        vo::constantMultiply(buffer, d->dry_gain_smooth.getTargetValue(), buffer, static_cast<int32_t>(bufferSize));
+        for (int32_t i = 0; i < sampleCount; ++i) {
+            tickModulation(m_delays);
+        }
+        return;
     }
 
-    for (samples_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+    for (int32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
         size_t offset = sampleIndex * m_processor._audioChannelsCount;
 
         for (audioch_t audioChannelIndex = 0; audioChannelIndex < m_processor._audioChannelsCount; ++audioChannelIndex) {
@@ -355,13 +406,52 @@ void ReverbProcessor::process(float* buffer, unsigned int sampleCount)
         break;
     }
 
-    for (samples_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
+    for (int32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex) {
         size_t offset = sampleIndex * m_processor._audioChannelsCount;
 
         for (audioch_t audioChannelIndex = 0; audioChannelIndex < m_processor._audioChannelsCount; ++audioChannelIndex) {
             buffer[offset + audioChannelIndex] = m_signalBuffers[audioChannelIndex][sampleIndex];
         }
     }
+
+    updateTailBypass(buffer, bufferSize, sampleCount);
+}
+
+void ReverbProcessor::updateTailBypass(const float* buffer, size_t bufferSize, int32_t sampleCount)
+{
+    if (m_silentInputSamples == 0 || !isSilent(buffer, bufferSize)) {
+        m_silentOutputSamples = 0;
+        return;
+    }
+
+    m_silentOutputSamples += sampleCount;
+
+    if (m_silentInputSamples < m_tailSamples || m_silentOutputSamples < m_tailSamples) {
+        return;
+    }
+
+    // a gain ramp would be cut by the reset
+    if (!d->dry_gain_smooth.isAtTargetValue() || !d->late_gain_smooth.isAtTargetValue()
+        || !d->er_gain_smooth.isAtTargetValue()) {
+        return;
+    }
+
+    reset();
+    m_tailBypassed = true;
+}
+
+void ReverbProcessor::calculateTailLength()
+{
+    const int* delayTimes = _delayTimesForN(m_delays);
+    const double scale = getParameter(LateRoomScale) * m_processor._sampleRate / 44100.;
+
+    // the longest way of an input sample to the output: the pre-delay, the early reflections,
+    // a trip through the longest delay line and the velvet noise
+    const double preDelay = getParameter(PreDelayMs) * 0.001 * m_processor._sampleRate;
+    const double earlyReflections = 0.15 * m_processor._sampleRate;
+    const double velvetNoise = 0.05 * m_processor._sampleRate;
+
+    m_tailSamples = static_cast<uint64_t>(preDelay + earlyReflections + delayTimes[m_delays - 1] * scale + velvetNoise);
 }
 
 void ReverbProcessor::getParameterInfo(int32_t index, ParameterInfo& info)
@@ -427,6 +517,8 @@ void ReverbProcessor::calculateTailParams()
         d->ag_filter_x4[x].cf.b1[y] = ag_cf.b1;
         d->ag_filter_x4[x].cf.a1[y] = ag_cf.a1;
     }
+
+    calculateTailLength();
 }
 
 void ReverbProcessor::calculateModParams()
@@ -521,6 +613,7 @@ void ReverbProcessor::setParameter(int32_t index, float newValue)
     case Params::PreDelayMs: {
         int smp = int(newValue * 0.001 * m_processor._sampleRate + 0.5);
         d->pre_delay.setDelaySamples(smp);
+        calculateTailLength();
         break;
     }
     }
@@ -636,6 +729,32 @@ void ReverbProcessor::reset()
     d->er_gain_smooth.setToTarget();
 }
 
+inline void ReverbProcessor::tickModulation(int numLines)
+{
+    if (d->modCounter++ < d->modStep) {
+        return;
+    }
+
+    d->modCounter = 0;
+
+    int modType = int(getParameter(Params::ModType));
+    switch (modType) {
+    case 0: // phase distributed sine waves
+        d->modDelay[0].setModOffset(d->sinLfo.getNextMainValue());
+        for (int i = 1; i < numLines; ++i) {
+            d->modDelay[i].setModOffset(d->sinLfo.getTapValue(i));
+        }
+        break;
+    case 1: {
+        auto offset = d->sinLfo.getNextMainValue();
+        for (int i = 0; i < numLines; ++i) {
+            d->modDelay[i].setModOffset(offset);
+        }
+        break;
+    }
+    }
+}
+
 template<int num_lines>
 void ReverbProcessor::_processLines(float** signalPtr, int32_t numSamples)
 {
@@ -697,26 +816,7 @@ void ReverbProcessor::_processLines(float** signalPtr, int32_t numSamples)
         // feedback loop
         for (int cnt = 0; cnt < numSamples; ++cnt) {
             // update delay modulation offsets
-            if (d->modCounter++ >= d->modStep) {
-                d->modCounter = 0;
-
-                int modType = int(getParameter(Params::ModType));
-                switch (modType) {
-                case 0: // phase distributed sine waves
-                    d->modDelay[0].setModOffset(d->sinLfo.getNextMainValue());
-                    for (int i = 1; i < num_lines; ++i) {
-                        d->modDelay[i].setModOffset(d->sinLfo.getTapValue(i));
-                    }
-                    break;
-                case 1: {
-                    auto offset = d->sinLfo.getNextMainValue();
-                    for (int i = 0; i < num_lines; ++i) {
-                        d->modDelay[i].setModOffset(offset);
-                    }
-                    break;
-                }
-                }
-            }
+            tickModulation(num_lines);
 
             // delay line outputs / decay filters
             float mat_in[num_lines];
@@ -97,6 +97,11 @@ private:
 
     bool setFormat(audioch_t audioChannelsCount, double sampleRate, int32_t maximumBlockSize);
 
+    void processBlock(float* buffer, int32_t sampleCount);
+
+    //! NOTE Once the input has been silent and the tail has died away, the reverb is bypassed until the next signal
+    void updateTailBypass(const float* buffer, size_t bufferSize, int32_t sampleCount);
+
     void deleteSignalBuffers();
 
     void reset();
@@ -128,7 +133,10 @@ private:
     void _processLines(float** signalPtr, int32_t numSamples);
     static constexpr int max_num_delays = 24;
 
+    void tickModulation(int numLines);
+
     void calculateTailParams();
+    void calculateTailLength();
     void calculateModParams();
 
     struct impl;
@@ -140,6 +148,11 @@ private:
 
     int m_delays = 16;
 
+    uint64_t m_tailSamples = 0;
+    uint64_t m_silentInputSamples = 0;
+    uint64_t m_silentOutputSamples = 0;
+    bool m_tailBypassed = false;
+
     AudioFxParams m_params;
     async::Channel<audio::AudioFxParams> m_paramsChanged;
 
@@ -23,6 +23,7 @@
 #ifndef MUSE_AUDIO_SPARSEFIRFILTER_H
 #define MUSE_AUDIO_SPARSEFIRFILTER_H
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -55,9 +56,19 @@ public:
 
         m_buffer.writeBlock(0, n, signal_in);
 
-        m_buffer.readBlockWithGain(-m_impulses[0].offset, n, signal_out, m_impulses[0].gainFact);
-        for (size_t i = 1; i < m_impulses.size(); ++i) {
-            m_buffer.readAddBlockWithGain(-m_impulses[i].offset, n, signal_out, m_impulses[i].gainFact);
+        // all the taps are summed in one pass, over the runs where none of them wraps around the buffer
+        const int32_t numTaps = static_cast<int32_t>(m_impulses.size());
+        int done = 0;
+        while (done < n) {
+            int count = n - done;
+            for (int32_t i = 0; i < numTaps; ++i) {
+                int numContiguous = 0;
+                m_taps[i] = m_buffer.readPointer(done - m_impulses[i].offset, numContiguous);
+                count = std::min(count, numContiguous);
+            }
+
+            vo::multiplyAndSum(m_taps.data(), m_gains.data(), numTaps, signal_out + done, count);
+            done += count;
         }
 
         m_buffer.advance(n);
@@ -79,6 +90,8 @@ public:
     void clearImpulses()
     {
         m_impulses.clear();
+        m_gains.clear();
+        m_taps.clear();
     }
 
     void appendImpulse(int offset, float value)
@@ -86,6 +99,8 @@ public:
         assert(offset >= 0 && offset <= m_maxAllowedOffset);
 
         m_impulses.push_back({ offset, value });
+        m_gains.push_back(value);
+        m_taps.push_back(nullptr);
         m_buffer.setSize(offset + 1);
     }
 
@@ -97,6 +112,8 @@ private:
     };
 
     std::vector<Impulse> m_impulses;
+    std::vector<float> m_gains;
+    std::vector<const float*> m_taps;
 
     int m_blockSize = 0;
     int m_maxAllowedOffset = 0;
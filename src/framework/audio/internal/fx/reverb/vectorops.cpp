@@ -0,0 +1,151 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "vectorops.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MUSE_AUDIO_VO_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VO_TARGET_AVX2
+#else
+#define VO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace muse::audio::fx::vo {
+static constexpr int32_t BLOCK = 8;
+
+static void multiplyAndSumScalar(const float* const* srcs, const float* gains, int32_t numSrcs, float* dst, int32_t n)
+{
+    int32_t i = 0;
+
+    // the sums of a few samples are kept together, so that the compiler can vectorise them
+    for (; i + BLOCK <= n; i += BLOCK) {
+        float sum[BLOCK];
+        for (int32_t k = 0; k < BLOCK; ++k) {
+            sum[k] = srcs[0][i + k] * gains[0];
+        }
+
+        for (int32_t s = 1; s < numSrcs; ++s) {
+            const float* src = srcs[s] + i;
+            const float gain = gains[s];
+            for (int32_t k = 0; k < BLOCK; ++k) {
+                sum[k] += src[k] * gain;
+            }
+        }
+
+        for (int32_t k = 0; k < BLOCK; ++k) {
+            dst[i + k] = sum[k];
+        }
+    }
+
+    for (; i < n; ++i) {
+        float sum = srcs[0][i] * gains[0];
+        for (int32_t s = 1; s < numSrcs; ++s) {
+            sum += srcs[s][i] * gains[s];
+        }
+        dst[i] = sum;
+    }
+}
+
+#ifdef MUSE_AUDIO_VO_AVX2
+static bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // the OS must save the ymm registers
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// no FMA, to get the same sums as without AVX2
+VO_TARGET_AVX2 static void multiplyAndSumAvx2(const float* const* srcs, const float* gains, int32_t numSrcs, float* dst, int32_t n)
+{
+    int32_t i = 0;
+
+    for (; i + 2 * BLOCK <= n; i += 2 * BLOCK) {
+        __m256 gain = _mm256_set1_ps(gains[0]);
+        __m256 sum0 = _mm256_mul_ps(_mm256_loadu_ps(srcs[0] + i), gain);
+        __m256 sum1 = _mm256_mul_ps(_mm256_loadu_ps(srcs[0] + i + BLOCK), gain);
+
+        for (int32_t s = 1; s < numSrcs; ++s) {
+            gain = _mm256_set1_ps(gains[s]);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(srcs[s] + i), gain));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(srcs[s] + i + BLOCK), gain));
+        }
+
+        _mm256_storeu_ps(dst + i, sum0);
+        _mm256_storeu_ps(dst + i + BLOCK, sum1);
+    }
+
+    for (; i + BLOCK <= n; i += BLOCK) {
+        __m256 sum = _mm256_mul_ps(_mm256_loadu_ps(srcs[0] + i), _mm256_set1_ps(gains[0]));
+        for (int32_t s = 1; s < numSrcs; ++s) {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(srcs[s] + i), _mm256_set1_ps(gains[s])));
+        }
+        _mm256_storeu_ps(dst + i, sum);
+    }
+
+    for (; i < n; ++i) {
+        float sum = srcs[0][i] * gains[0];
+        for (int32_t s = 1; s < numSrcs; ++s) {
+            sum += srcs[s][i] * gains[s];
+        }
+        dst[i] = sum;
+    }
+}
+#endif
+
+using MultiplyAndSumFunc = void (*)(const float* const*, const float*, int32_t, float*, int32_t);
+
+static MultiplyAndSumFunc resolveMultiplyAndSum()
+{
+#ifdef MUSE_AUDIO_VO_AVX2
+    if (cpuHasAvx2()) {
+        return multiplyAndSumAvx2;
+    }
+#endif
+    return multiplyAndSumScalar;
+}
+
+void multiplyAndSum(const float* const* srcs, const float* gains, int32_t numSrcs, float* dst, int32_t n)
+{
+    static const MultiplyAndSumFunc func = resolveMultiplyAndSum();
+    func(srcs, gains, numSrcs, dst, n);
+}
+}
@@ -25,7 +25,9 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 //
 // This header is provided for convenience, to easily wrap vector operations around
@@ -90,6 +92,10 @@ void setToZero(T* dst, int32_t n)
 {
     std::fill(dst, dst + n, 0.f);
 }
+
+//! dst[i] = srcs[0][i] * gains[0] + ... + srcs[numSrcs - 1][i] * gains[numSrcs - 1]
+//! The sum is done in the order of the sources, with AVX2 where the CPU has it
+void multiplyAndSum(const float* const* srcs, const float* gains, int32_t numSrcs, float* dst, int32_t n);
 } // namespace vo
 }
 
@@ -22,8 +22,13 @@
 
 #include "fluidsynth.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include <fluidsynth.h>
 
+#include "concurrency/taskscheduler.h"
+
 #include "sfcachedloader.h"
 #include "audioerrors.h"
 #include "audiotypes.h"
@@ -39,6 +44,12 @@ using namespace muse::mpe;
 static constexpr double FLUID_GLOBAL_VOLUME_GAIN = 4.8;
 static constexpr int DEFAULT_MIDI_VOLUME = 100;
 static constexpr msecs_t MIN_NOTE_LENGTH = 10;
+static constexpr int POLYPHONY = 512;
+
+static constexpr size_t MIDI_CHANNELS_COUNT = 16;
+
+// below this number of voices rendering the synths one after another is cheaper
+static constexpr int MIN_VOICE_COUNT_FOR_MULTITHREADING = 64;
 
 /// @note
 ///  Fluid does not support MONO, so they start counting audio channels from 1, which means "1 pair of audio channels"
@@ -46,13 +57,45 @@ static constexpr msecs_t MIN_NOTE_LENGTH = 10;
 static constexpr unsigned int FLUID_AUDIO_CHANNELS_PAIR = 1;
 static constexpr unsigned int FLUID_AUDIO_CHANNELS_COUNT = FLUID_AUDIO_CHANNELS_PAIR * 2;
 
+//! NOTE The MIDI channels are spread between the synths, so that they can be rendered in parallel.
+//! A channel lives on one synth only: exclusive classes, legato and portamento work as with a single synth
 struct muse::audio::synth::Fluid {
     fluid_settings_t* settings = nullptr;
-    fluid_synth_t* synth = nullptr;
+    std::vector<fluid_synth_t*> synths;
+
+    fluid_synth_t* synth() const
+    {
+        return synths.empty() ? nullptr : synths.front();
+    }
+
+    fluid_synth_t* channelSynth(midi::channel_t channel) const
+    {
+        return synths[channel % synths.size()];
+    }
+
+    void deleteSynths()
+    {
+        for (fluid_synth_t* synth : synths) {
+            delete_fluid_synth(synth);
+        }
+        synths.clear();
+    }
+
+    template<typename Func>
+    int forEachSynth(Func func) const
+    {
+        int ret = FLUID_OK;
+        for (fluid_synth_t* synth : synths) {
+            if (func(synth) != FLUID_OK) {
+                ret = FLUID_FAILED;
+            }
+        }
+        return ret;
+    }
 
     ~Fluid()
     {
-        delete_fluid_synth(synth);
+        deleteSynths();
         delete_fluid_settings(settings);
     }
 };
@@ -67,7 +110,7 @@ FluidSynth::FluidSynth(const AudioSourceParams& params)
 
 bool FluidSynth::isValid() const
 {
-    return m_fluid->synth != nullptr;
+    return m_fluid->synth() != nullptr;
 }
 
 Ret FluidSynth::init()
@@ -114,7 +157,10 @@ Ret FluidSynth::init()
     fluid_settings_setint(m_fluid->settings, "synth.threadsafe-api", 0);
     fluid_settings_setint(m_fluid->settings, "synth.midi-channels", 16);
     fluid_settings_setint(m_fluid->settings, "synth.dynamic-sample-loading", 1);
-    fluid_settings_setint(m_fluid->settings, "synth.polyphony", 512);
+
+    fluid_settings_setint(m_fluid->settings, "synth.polyphony", POLYPHONY);
+
+    m_synthCount = std::clamp(configuration()->fluidSynthInstanceCount(), size_t(1), MIDI_CHANNELS_COUNT);
 
     if (m_sampleRate > 0) {
         fluid_settings_setnum(m_fluid->settings, "synth.sample-rate", static_cast<double>(m_sampleRate));
@@ -139,12 +185,22 @@ Ret FluidSynth::init()
 
 void FluidSynth::createFluidInstance()
 {
-    m_fluid->synth = new_fluid_synth(m_fluid->settings);
+    for (size_t i = 0; i < m_synthCount; ++i) {
+        fluid_synth_t* synth = new_fluid_synth(m_fluid->settings);
+        if (!synth) {
+            break;
+        }
+
+        fluid_sfloader_t* sfloader = new_fluid_sfloader(loadSoundFont, delete_fluid_sfloader);
+
+        fluid_sfloader_set_data(sfloader, m_fluid->settings);
+        fluid_synth_add_sfloader(synth, sfloader);
 
-    fluid_sfloader_t* sfloader = new_fluid_sfloader(loadSoundFont, delete_fluid_sfloader);
+        m_fluid->synths.push_back(synth);
+    }
 
-    fluid_sfloader_set_data(sfloader, m_fluid->settings);
-    fluid_synth_add_sfloader(m_fluid->synth, sfloader);
+    m_synthBuffers.resize(m_fluid->synths.size());
+    m_synthsToRender.reserve(m_fluid->synths.size());
 }
 
 bool FluidSynth::handleEvent(const midi::Event& event)
@@ -152,11 +208,11 @@ bool FluidSynth::handleEvent(const midi::Event& event)
     int ret = FLUID_OK;
     switch (event.opcode()) {
     case Event::Opcode::NoteOn: {
-        ret = fluid_synth_noteon(m_fluid->synth, event.channel(), event.note(), event.velocity());
+        ret = fluid_synth_noteon(m_fluid->channelSynth(event.channel()), event.channel(), event.note(), event.velocity());
         m_tuning.add(event.note(), event.pitchTuningCents());
     } break;
     case Event::Opcode::NoteOff: {
-        ret = fluid_synth_noteoff(m_fluid->synth, event.channel(), event.note());
+        ret = fluid_synth_noteoff(m_fluid->channelSynth(event.channel()), event.channel(), event.note());
         m_tuning.add(event.note(), event.pitchTuningCents());
     } break;
     case Event::Opcode::ControlChange: {
@@ -167,10 +223,10 @@ bool FluidSynth::handleEvent(const midi::Event& event)
         }
     } break;
     case Event::Opcode::ProgramChange: {
-        fluid_synth_program_change(m_fluid->synth, event.channel(), event.program());
+        fluid_synth_program_change(m_fluid->channelSynth(event.channel()), event.channel(), event.program());
     } break;
     case Event::Opcode::PitchBend: {
-        ret = fluid_synth_pitch_bend(m_fluid->synth, event.channel(), event.data());
+        ret = fluid_synth_pitch_bend(m_fluid->channelSynth(event.channel()), event.channel(), event.data());
     } break;
     default: {
         LOGD() << "not supported event type: " << event.opcodeString();
@@ -194,9 +250,7 @@ void FluidSynth::setSampleRate(unsigned int sampleRate)
         fluid_settings_setnum(m_fluid->settings, "synth.sample-rate", static_cast<double>(m_sampleRate));
     }
 
-    if (m_fluid->synth) {
-        delete_fluid_synth(m_fluid->synth);
-    }
+    m_fluid->deleteSynths();
 
     createFluidInstance();
     addSoundFonts(std::vector<io::path_t>(m_sfontPaths.cbegin(), m_sfontPaths.cend()));
@@ -208,13 +262,17 @@ void FluidSynth::setSampleRate(unsigned int sampleRate)
 
 Ret FluidSynth::addSoundFonts(const std::vector<io::path_t>& sfonts)
 {
-    IF_ASSERT_FAILED(m_fluid->synth) {
+    IF_ASSERT_FAILED(m_fluid->synth()) {
         return make_ret(Err::SynthNotInited);
     }
 
     bool ok = true;
     for (const io::path_t& sfont : sfonts) {
-        if (fluid_synth_sfload(m_fluid->synth, sfont.c_str(), 0) == FLUID_FAILED) {
+        int ret = m_fluid->forEachSynth([&sfont](fluid_synth_t* synth) {
+            return fluid_synth_sfload(synth, sfont.c_str(), 0) == FLUID_FAILED ? FLUID_FAILED : FLUID_OK;
+        });
+
+        if (ret == FLUID_FAILED) {
             LOGE() << "failed load soundfont: " << sfont;
             ok = false;
             continue;
@@ -244,22 +302,40 @@ AudioSourceType FluidSynth::type() const
 
 void FluidSynth::setupSound(const PlaybackSetupData& setupData)
 {
-    IF_ASSERT_FAILED(m_fluid->synth) {
+    IF_ASSERT_FAILED(m_fluid->synth()) {
         return;
     }
 
-    fluid_synth_activate_key_tuning(m_fluid->synth, 0, 0, "standard", NULL, true);
+    m_fluid->forEachSynth([](fluid_synth_t* synth) {
+        return fluid_synth_activate_key_tuning(synth, 0, 0, "standard", NULL, true);
+    });
+
+    // selecting a program loads its samples, which is left to the preloading.
+    // The previous references are released at the end, so that the presets still in use stay loaded
+    std::vector<SoundFontCache::PresetsRefPtr> previousPresetRefs;
+    previousPresetRefs.swap(m_presetRefs);
+
+    m_presetsLoaded = false;
+    m_pendingPrograms.clear();
+    m_deferredEvents.clear();
 
     auto setupChannel = [this](const midi::channel_t channelIdx, const midi::Program& program) {
-        fluid_synth_set_interp_method(m_fluid->synth, channelIdx, FLUID_INTERP_DEFAULT);
-        fluid_synth_pitch_wheel_sens(m_fluid->synth, channelIdx, 24);
-        fluid_synth_bank_select(m_fluid->synth, channelIdx, program.bank);
-        fluid_synth_program_change(m_fluid->synth, channelIdx, program.program);
-        fluid_synth_cc(m_fluid->synth, channelIdx, 7, DEFAULT_MIDI_VOLUME);
-        fluid_synth_cc(m_fluid->synth, channelIdx, 74, 0);
-        fluid_synth_set_portamento_mode(m_fluid->synth, channelIdx, FLUID_CHANNEL_PORTAMENTO_MODE_EACH_NOTE);
-        fluid_synth_set_legato_mode(m_fluid->synth, channelIdx, FLUID_CHANNEL_LEGATO_MODE_RETRIGGER);
-        fluid_synth_activate_tuning(m_fluid->synth, channelIdx, 0, 0, 0);
+        if (!m_presetsLoaded) {
+            m_pendingPrograms[channelIdx] = program;
+        }
+
+        fluid_synth_t* synth = m_fluid->channelSynth(channelIdx);
+        fluid_synth_set_interp_method(synth, channelIdx, FLUID_INTERP_DEFAULT);
+        fluid_synth_pitch_wheel_sens(synth, channelIdx, 24);
+        fluid_synth_bank_select(synth, channelIdx, program.bank);
+        if (m_presetsLoaded) {
+            fluid_synth_program_change(synth, channelIdx, program.program);
+        }
+        fluid_synth_cc(synth, channelIdx, 7, DEFAULT_MIDI_VOLUME);
+        fluid_synth_cc(synth, channelIdx, 74, 0);
+        fluid_synth_set_portamento_mode(synth, channelIdx, FLUID_CHANNEL_PORTAMENTO_MODE_EACH_NOTE);
+        fluid_synth_set_legato_mode(synth, channelIdx, FLUID_CHANNEL_LEGATO_MODE_RETRIGGER);
+        fluid_synth_activate_tuning(synth, channelIdx, 0, 0, 0);
     };
 
     m_sequencer.channelAdded().onReceive(this, setupChannel);
@@ -271,6 +347,82 @@ void FluidSynth::setupSound(const PlaybackSetupData& setupData)
             setupChannel(channelMapping.first, channelMapping.second);
         }
     }
+
+    preloadPresets();
+    applyPendingPrograms();
+}
+
+void FluidSynth::preloadPresets()
+{
+    std::set<Preset> presets;
+    for (const midi::Program& program : m_sequencer.channels().programs()) {
+        presets.insert({ program.bank, program.program });
+    }
+
+    if (presets.empty()) {
+        return;
+    }
+
+    for (const io::path_t& path : m_sfontPaths) {
+        m_presetRefs.push_back(SoundFontCache::instance()->preloadPresets(path.toStdString(), presets));
+    }
+}
+
+void FluidSynth::applyPendingPrograms()
+{
+    if (m_presetsLoaded) {
+        return;
+    }
+
+    for (const SoundFontCache::PresetsRefPtr& ref : m_presetRefs) {
+        if (!ref->isLoaded()) {
+            return;
+        }
+    }
+
+    m_presetsLoaded = true;
+
+    for (const auto& pair : m_pendingPrograms) {
+        const midi::channel_t channelIdx = pair.first;
+        const midi::Program& program = pair.second;
+
+        fluid_synth_t* synth = m_fluid->channelSynth(channelIdx);
+        fluid_synth_bank_select(synth, channelIdx, program.bank);
+        fluid_synth_program_change(synth, channelIdx, program.program);
+    }
+
+    m_pendingPrograms.clear();
+}
+
+//! NOTE The notes that have ended while waiting for the preloading are not played at all
+void FluidSynth::handleDeferredEvents()
+{
+    std::vector<bool> isEnded(m_deferredEvents.size(), false);
+    std::map<std::pair<midi::channel_t, int>, size_t> noteOns;
+
+    for (size_t i = 0; i < m_deferredEvents.size(); ++i) {
+        const midi::Event& event = m_deferredEvents.at(i);
+        const std::pair<midi::channel_t, int> key { event.channel(), event.note() };
+
+        if (event.opcode() == Event::Opcode::NoteOn) {
+            noteOns[key] = i;
+        } else if (event.opcode() == Event::Opcode::NoteOff) {
+            auto it = noteOns.find(key);
+            if (it != noteOns.end()) {
+                isEnded[it->second] = true;
+                isEnded[i] = true;
+                noteOns.erase(it);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_deferredEvents.size(); ++i) {
+        if (!isEnded[i]) {
+            handleEvent(m_deferredEvents.at(i));
+        }
+    }
+
+    m_deferredEvents.clear();
 }
 
 void FluidSynth::setupEvents(const mpe::PlaybackData& playbackData)
@@ -280,23 +432,29 @@ void FluidSynth::setupEvents(const mpe::PlaybackData& playbackData)
 
 void FluidSynth::revokePlayingNotes()
 {
-    IF_ASSERT_FAILED(m_fluid->synth) {
+    IF_ASSERT_FAILED(m_fluid->synth()) {
         return;
     }
 
-    fluid_synth_all_notes_off(m_fluid->synth, -1);
+    m_deferredEvents.clear();
+
+    m_fluid->forEachSynth([](fluid_synth_t* synth) {
+        return fluid_synth_all_notes_off(synth, -1);
+    });
 }
 
 void FluidSynth::flushSound()
 {
-    IF_ASSERT_FAILED(m_fluid->synth) {
+    IF_ASSERT_FAILED(m_fluid->synth()) {
         return;
     }
 
     revokePlayingNotes();
 
-    fluid_synth_all_sounds_off(m_fluid->synth, -1);
-    fluid_synth_cc(m_fluid->synth, -1, 121, 127);
+    m_fluid->forEachSynth([](fluid_synth_t* synth) {
+        fluid_synth_all_sounds_off(synth, -1);
+        return fluid_synth_cc(synth, -1, 121, 127);
+    });
 }
 
 bool FluidSynth::isActive() const
@@ -338,27 +496,110 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
     msecs_t nextMsecs = samplesToMsecs(samplesPerChannel, m_sampleRate);
     FluidSequencer::EventSequence sequence = m_sequencer.eventsToBePlayed(nextMsecs);
 
-    if (!sequence.empty()) {
+    applyPendingPrograms();
+
+    // selecting the programs before their samples are preloaded would load the samples here, on the audio thread:
+    // the events wait for the preloading instead
+    if (!m_presetsLoaded) {
+        for (const FluidSequencer::EventType& event : sequence) {
+            m_deferredEvents.push_back(std::get<midi::Event>(event));
+        }
+
+        sequence.clear();
+    }
+
+    const bool hasDeferredEvents = m_presetsLoaded && !m_deferredEvents.empty();
+
+    if (!sequence.empty() || hasDeferredEvents) {
         m_tuning.reset();
     }
 
+    if (hasDeferredEvents) {
+        handleDeferredEvents();
+    }
+
     for (const FluidSequencer::EventType& event : sequence) {
         handleEvent(std::get<midi::Event>(event));
     }
 
-    fluid_synth_tune_notes(m_fluid->synth, 0, 0, m_tuning.size(), m_tuning.keys.data(), m_tuning.pitches.data(), true);
-
-    int result = fluid_synth_write_float(m_fluid->synth, samplesPerChannel,
-                                         buffer, 0, FLUID_AUDIO_CHANNELS_COUNT,
-                                         buffer, 1, FLUID_AUDIO_CHANNELS_COUNT);
+    m_fluid->forEachSynth([this](fluid_synth_t* synth) {
+        return fluid_synth_tune_notes(synth, 0, 0, m_tuning.size(), m_tuning.keys.data(), m_tuning.pitches.data(), true);
+    });
 
-    if (result != FLUID_OK) {
+    if (!renderSynths(buffer, samplesPerChannel)) {
         return 0;
     }
 
     return samplesPerChannel;
 }
 
+bool FluidSynth::renderSynths(float* buffer, samples_t samplesPerChannel)
+{
+    auto render = [samplesPerChannel](fluid_synth_t* synth, float* out) {
+        return fluid_synth_write_float(synth, samplesPerChannel,
+                                       out, 0, FLUID_AUDIO_CHANNELS_COUNT,
+                                       out, 1, FLUID_AUDIO_CHANNELS_COUNT) == FLUID_OK;
+    };
+
+    // the first synth renders straight into the buffer, the other ones only when they sound
+    m_synthsToRender.clear();
+    int voiceCount = fluid_synth_get_active_voice_count(m_fluid->synths[0]);
+
+    for (size_t i = 1; i < m_fluid->synths.size(); ++i) {
+        int synthVoiceCount = fluid_synth_get_active_voice_count(m_fluid->synths[i]);
+        if (synthVoiceCount > 0) {
+            m_synthsToRender.push_back(i);
+            voiceCount += synthVoiceCount;
+        }
+    }
+
+    if (m_synthsToRender.empty()) {
+        return render(m_fluid->synths[0], buffer);
+    }
+
+    const size_t bufferSize = samplesPerChannel * FLUID_AUDIO_CHANNELS_COUNT;
+    for (size_t idx : m_synthsToRender) {
+        m_synthBuffers[idx].resize(bufferSize);
+    }
+
+    std::atomic<bool> ok = true;
+
+    if (voiceCount >= MIN_VOICE_COUNT_FOR_MULTITHREADING) {
+        // the track is usually one of the tasks of the mixer already: the group nests into it,
+        // and while this thread waits for the other synths, it helps with the queued tasks
+        TaskGroup group(TaskScheduler::instance(ThreadPriority::Realtime));
+        for (size_t idx : m_synthsToRender) {
+            group.run([this, &render, &ok, idx]() {
+                if (!render(m_fluid->synths[idx], m_synthBuffers[idx].data())) {
+                    ok = false;
+                }
+            });
+        }
+
+        if (!render(m_fluid->synths[0], buffer)) {
+            ok = false;
+        }
+
+        group.wait();
+    } else {
+        ok = render(m_fluid->synths[0], buffer);
+        for (size_t idx : m_synthsToRender) {
+            if (!render(m_fluid->synths[idx], m_synthBuffers[idx].data())) {
+                ok = false;
+            }
+        }
+    }
+
+    for (size_t idx : m_synthsToRender) {
+        const float* synthBuffer = m_synthBuffers[idx].data();
+        for (size_t s = 0; s < bufferSize; ++s) {
+            buffer[s] += synthBuffer[s];
+        }
+    }
+
+    return ok;
+}
+
 async::Channel<unsigned int> FluidSynth::audioChannelsCountChanged() const
 {
     return m_streamsCountChanged;
@@ -380,7 +621,7 @@ int FluidSynth::setExpressionLevel(int level)
     midi::channel_t lastChannelIdx = m_sequencer.channels().lastIndex();
 
     for (midi::channel_t i = 0; i < lastChannelIdx; ++i) {
-        fluid_synth_cc(m_fluid->synth, i, muse::midi::EXPRESSION_CONTROLLER, level);
+        fluid_synth_cc(m_fluid->channelSynth(i), i, muse::midi::EXPRESSION_CONTROLLER, level);
     }
 
     return FLUID_OK;
@@ -389,11 +630,12 @@ int FluidSynth::setExpressionLevel(int level)
 int FluidSynth::setControllerValue(const midi::Event& event)
 {
     int currentValue = 0;
-    fluid_synth_get_cc(m_fluid->synth, event.channel(), event.index(), &currentValue);
+    fluid_synth_t* synth = m_fluid->channelSynth(event.channel());
+    fluid_synth_get_cc(synth, event.channel(), event.index(), &currentValue);
 
     if (event.data() == static_cast<uint32_t>(currentValue)) {
         return FLUID_OK;
     }
 
-    return fluid_synth_cc(m_fluid->synth, event.channel(), event.index(),  event.data());
+    return fluid_synth_cc(synth, event.channel(), event.index(), event.data());
 }
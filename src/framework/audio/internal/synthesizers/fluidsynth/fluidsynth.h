@@ -31,13 +31,16 @@
 #include "midi/imidioutport.h"
 
 #include "../../abstractsynthesizer.h"
+#include "iaudioconfiguration.h"
 #include "fluidsequencer.h"
+#include "sfcachedloader.h"
 
 namespace muse::audio::synth {
 struct Fluid;
 class FluidSynth : public AbstractSynthesizer
 {
     Inject<midi::IMidiOutPort> midiOutPort;
+    Inject<IAudioConfiguration> configuration;
 
 public:
     FluidSynth(const audio::AudioSourceParams& params);
@@ -97,6 +100,12 @@ private:
     Ret init();
     void createFluidInstance();
 
+    bool renderSynths(float* buffer, samples_t samplesPerChannel);
+
+    void preloadPresets();
+    void applyPendingPrograms();
+    void handleDeferredEvents();
+
     bool handleEvent(const midi::Event& event);
 
     void toggleExpressionController();
@@ -113,6 +122,16 @@ private:
     std::optional<midi::Program> m_preset;
 
     KeyTuning m_tuning;
+
+    size_t m_synthCount = 1;
+    std::vector<size_t> m_synthsToRender;
+    std::vector<std::vector<float> > m_synthBuffers;
+
+    // the programs are selected once their samples are preloaded, the events wait for it
+    std::vector<SoundFontCache::PresetsRefPtr> m_presetRefs;
+    std::map<midi::channel_t, midi::Program> m_pendingPrograms;
+    std::vector<midi::Event> m_deferredEvents;
+    bool m_presetsLoaded = true;
 };
 
 using FluidSynthPtr = std::shared_ptr<FluidSynth>;
@@ -0,0 +1,510 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sfcachedloader.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "concurrency/taskscheduler.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::audio::synth;
+
+// ============================
+// SoundFontFile
+// ============================
+
+std::shared_ptr<SoundFontFile> SoundFontFile::map(const std::string& path)
+{
+    std::shared_ptr<SoundFontFile> file(new SoundFontFile());
+
+#ifdef WIN32
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring wpath(len > 0 ? len : 0, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wpath.data(), len);
+
+    HANDLE fileHandle = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    file->m_fileHandle = fileHandle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+        return nullptr;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        return nullptr;
+    }
+    file->m_mappingHandle = mappingHandle;
+
+    void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        return nullptr;
+    }
+
+    file->m_data = static_cast<const char*>(data);
+    file->m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    file->m_data = static_cast<const char*>(data);
+    file->m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return file;
+}
+
+SoundFontFile::~SoundFontFile()
+{
+#ifdef WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle) {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle) {
+        CloseHandle(m_fileHandle);
+    }
+#else
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+}
+
+const char* SoundFontFile::data() const
+{
+    return m_data;
+}
+
+size_t SoundFontFile::size() const
+{
+    return m_size;
+}
+
+// ============================
+// File callbacks
+// ============================
+
+//! NOTE Every file opened by Fluid gets its own position in the shared mapping,
+//! so that the sound fonts can be read from several threads at once
+struct SoundFontStream {
+    std::shared_ptr<SoundFontFile> file;
+    fluid_long_long_t pos = 0;
+};
+
+static void* openSoundFont(const char* filename)
+{
+    std::shared_ptr<SoundFontFile> file = SoundFontCache::instance()->file(filename);
+    if (!file) {
+        return nullptr;
+    }
+
+    return new SoundFontStream { file, 0 };
+}
+
+static int readSoundFont(void* buf, fluid_long_long_t count, void* handle)
+{
+    SoundFontStream* stream = static_cast<SoundFontStream*>(handle);
+
+    if (count < 0 || stream->pos < 0 || stream->pos + count > static_cast<fluid_long_long_t>(stream->file->size())) {
+        return FLUID_FAILED;
+    }
+
+    std::memcpy(buf, stream->file->data() + stream->pos, static_cast<size_t>(count));
+    stream->pos += count;
+
+    return FLUID_OK;
+}
+
+static int seekSoundFont(void* handle, fluid_long_long_t offset, int origin)
+{
+    SoundFontStream* stream = static_cast<SoundFontStream*>(handle);
+
+    fluid_long_long_t pos = offset;
+    switch (origin) {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        pos += stream->pos;
+        break;
+    case SEEK_END:
+        pos += static_cast<fluid_long_long_t>(stream->file->size());
+        break;
+    default:
+        return FLUID_FAILED;
+    }
+
+    if (pos < 0 || pos > static_cast<fluid_long_long_t>(stream->file->size())) {
+        return FLUID_FAILED;
+    }
+
+    stream->pos = pos;
+    return FLUID_OK;
+}
+
+static int closeSoundFont(void* handle)
+{
+    delete static_cast<SoundFontStream*>(handle);
+    return FLUID_OK;
+}
+
+static fluid_long_long_t tellSoundFont(void* handle)
+{
+    return static_cast<SoundFontStream*>(handle)->pos;
+}
+
+static int deleteSharedSoundFont(fluid_sfont_t* /*sfont*/)
+{
+    //!Note Prevent removal of sound-fonts by Fluid instances,
+    //!     instead the actual removal of cached sound-fonts will happen in SoundFontCache.
+    //!     However, we still need to provide "some" callback for Fluid's API
+
+    return FLUID_OK;
+}
+
+static fluid_file_callbacks_t FILE_CALLBACKS {
+    openSoundFont,
+    readSoundFont,
+    seekSoundFont,
+    closeSoundFont,
+    tellSoundFont
+};
+
+// ============================
+// SoundFontCache
+// ============================
+
+static bool s_cacheDestroyed = false;
+
+SoundFontCache* SoundFontCache::instance()
+{
+    static SoundFontCache s;
+    return &s;
+}
+
+bool SoundFontCache::isDestroyed()
+{
+    return s_cacheDestroyed;
+}
+
+SoundFontCache::~SoundFontCache()
+{
+    s_cacheDestroyed = true;
+
+    for (auto& pair : m_preloads) {
+        deleteSoundFont(pair.second.soundFont);
+    }
+
+    for (auto& pair : m_soundFonts) {
+        deleteSoundFont(pair.second);
+    }
+
+    if (m_preloadSettings) {
+        delete_fluid_settings(m_preloadSettings);
+    }
+}
+
+fluid_sfont_t* SoundFontCache::createSoundFont(fluid_settings_t* settings, const std::string& path)
+{
+    fluid_defsfont_t* defsfont = new_fluid_defsfont(settings);
+    if (!defsfont) {
+        return nullptr;
+    }
+
+    fluid_sfont_t* result = new_fluid_sfont(fluid_defsfont_sfont_get_name,
+                                            fluid_defsfont_sfont_get_preset,
+                                            fluid_defsfont_sfont_iteration_start,
+                                            fluid_defsfont_sfont_iteration_next,
+                                            deleteSharedSoundFont);
+
+    if (!result) {
+        delete_fluid_defsfont(defsfont);
+        return nullptr;
+    }
+
+    fluid_sfont_set_data(result, defsfont);
+    defsfont->sfont = result;
+    defsfont->fcbs = &FILE_CALLBACKS;
+
+    if (fluid_defsfont_load(defsfont, &FILE_CALLBACKS, path.c_str()) == FLUID_FAILED) {
+        deleteSoundFont(result);
+        return nullptr;
+    }
+
+    return result;
+}
+
+void SoundFontCache::deleteSoundFont(fluid_sfont_t* sfont)
+{
+    if (!sfont) {
+        return;
+    }
+
+    fluid_defsfont_t* defsFont = static_cast<fluid_defsfont_t*>(fluid_sfont_get_data(sfont));
+    if (delete_fluid_defsfont(defsFont) != FLUID_OK) {
+        return;
+    }
+
+    delete_fluid_sfont(sfont);
+}
+
+std::shared_ptr<SoundFontFile> SoundFontCache::file(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::shared_ptr<SoundFontFile>& file = m_files[path];
+    if (!file) {
+        file = SoundFontFile::map(path);
+        if (!file) {
+            LOGE() << "Unable to map sound font file: " << path;
+        }
+    }
+
+    return file;
+}
+
+fluid_sfont_t* SoundFontCache::loadSoundFont(fluid_settings_t* settings, const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_soundFonts.find(path);
+        if (it != m_soundFonts.end()) {
+            return it->second;
+        }
+    }
+
+    fluid_sfont_t* sfont = createSoundFont(settings, path);
+    if (!sfont) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // another synth may have loaded it in the meantime
+    fluid_sfont_t*& cached = m_soundFonts[path];
+    if (cached) {
+        deleteSoundFont(sfont);
+        return cached;
+    }
+
+    cached = sfont;
+    return sfont;
+}
+
+SoundFontCache::PresetsRefPtr SoundFontCache::preloadPresets(const std::string& path, const std::set<Preset>& presets)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<Preset, int>& refs = m_presetRefs[path];
+        for (const Preset& preset : presets) {
+            refs[preset]++;
+        }
+
+        m_syncCounts[path]++;
+    }
+
+    PresetsRefPtr ref = std::make_shared<PresetsRef>();
+    ref->path = path;
+    ref->presets = presets;
+    ref->loaded = TaskScheduler::instance(ThreadPriority::Background)->submit([this, path]() {
+        syncPinnedPresets(path);
+    }).share();
+
+    return ref;
+}
+
+//! NOTE Unpinning is cheap, it is done right away. If a sync of the sound font is running or waiting,
+//! it is left to it instead, not to wait for a preload
+void SoundFontCache::releasePresets(const std::string& path, const std::set<Preset>& presets)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<Preset, int>& refs = m_presetRefs[path];
+        for (const Preset& preset : presets) {
+            auto it = refs.find(preset);
+            if (it != refs.end() && --it->second <= 0) {
+                refs.erase(it);
+            }
+        }
+
+        int& syncCount = m_syncCounts[path];
+        if (syncCount > 0) {
+            m_outdatedPaths.insert(path);
+            return;
+        }
+
+        syncCount++;
+    }
+
+    syncPinnedPresets(path);
+}
+
+//! NOTE Brings the pinned presets of the sound font in line with the references,
+//! again if they have been released meanwhile
+void SoundFontCache::syncPinnedPresets(const std::string& path)
+{
+    std::lock_guard<std::mutex> preloadLock(m_preloadMutex);
+
+    for (;;) {
+        std::set<Preset> wanted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_outdatedPaths.erase(path);
+
+            for (const auto& pair : m_presetRefs[path]) {
+                wanted.insert(pair.first);
+            }
+        }
+
+        pinPresets(path, wanted);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_outdatedPaths.find(path) == m_outdatedPaths.end()) {
+            m_syncCounts[path]--;
+            return;
+        }
+    }
+}
+
+//! NOTE The presets are pinned in a private instance of the sound font, nothing is played with it:
+//! its samples go to the Fluid sample cache, which is shared by all the instances of the same file,
+//! so selecting these presets in the synths later on just takes the loaded samples from the cache
+void SoundFontCache::pinPresets(const std::string& path, const std::set<Preset>& wanted)
+{
+    Preload& preload = m_preloads[path];
+
+    if (!preload.soundFont) {
+        if (wanted.empty()) {
+            return;
+        }
+
+        if (!m_preloadSettings) {
+            m_preloadSettings = new_fluid_settings();
+            fluid_settings_setint(m_preloadSettings, "synth.dynamic-sample-loading", 1);
+            fluid_settings_setint(m_preloadSettings, "synth.lock-memory", 0);
+        }
+
+        preload.soundFont = createSoundFont(m_preloadSettings, path);
+        if (!preload.soundFont) {
+            LOGE() << "Unable to preload sound font: " << path;
+            return;
+        }
+    }
+
+    for (auto it = preload.pinned.begin(); it != preload.pinned.end();) {
+        if (wanted.find(*it) != wanted.end()) {
+            ++it;
+            continue;
+        }
+
+        fluid_preset_t* preset = fluid_sfont_get_preset(preload.soundFont, it->first, it->second);
+        fluid_preset_notify(preset, FLUID_PRESET_UNPIN, -1);
+        it = preload.pinned.erase(it);
+    }
+
+    for (const Preset& p : wanted) {
+        if (preload.pinned.find(p) != preload.pinned.end()) {
+            continue;
+        }
+
+        fluid_preset_t* preset = fluid_sfont_get_preset(preload.soundFont, p.first, p.second);
+        if (!preset) {
+            continue;
+        }
+
+        if (fluid_preset_notify(preset, FLUID_PRESET_PIN, -1) == FLUID_OK) {
+            preload.pinned.insert(p);
+        }
+    }
+}
+
+// ============================
+// PresetsRef
+// ============================
+
+SoundFontCache::PresetsRef::~PresetsRef()
+{
+    // the synths may outlive the cache at exit, its sound fonts are deleted with it
+    if (SoundFontCache::isDestroyed()) {
+        return;
+    }
+
+    SoundFontCache::instance()->releasePresets(path, presets);
+}
+
+bool SoundFontCache::PresetsRef::isLoaded() const
+{
+    return !loaded.valid() || loaded.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// ============================
+// Loader
+// ============================
+
+fluid_sfont_t* muse::audio::synth::loadSoundFont(fluid_sfloader_t* loader, const char* filename)
+{
+    fluid_settings_t* settings = static_cast<fluid_settings_t*>(fluid_sfloader_get_data(loader));
+    return SoundFontCache::instance()->loadSoundFont(settings, filename);
+}
+
+const fluid_file_callbacks_t* muse::audio::synth::soundFontFileCallbacks()
+{
+    return &FILE_CALLBACKS;
+}
@@ -19,149 +19,110 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
-
 #ifndef MUSE_AUDIO_SFCACHEDLOADER_H
 #define MUSE_AUDIO_SFCACHEDLOADER_H
 
-#include <cstdio>
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
 
 #include <sfloader/fluid_sfont.h>
 #include <sfloader/fluid_defsfont.h>
 
 namespace muse::audio::synth {
-struct SoundFontData
+//! NOTE A sound font file mapped into memory, read-only.
+//! The pages are read by the system when they are accessed for the first time,
+//! so mapping even a big sound font is cheap and the memory is shared by all readers
+class SoundFontFile
 {
-    fluid_sfont_t* soundFontPtr = nullptr;
-    std::FILE* fileStream = nullptr;
-};
-
-struct SoundFontCache : public std::map<std::string, SoundFontData> {
-    static SoundFontCache* instance()
-    {
-        static SoundFontCache s;
-        return &s;
-    }
-
-private:
-    SoundFontCache() = default;
-    ~SoundFontCache()
-    {
-        for (const auto& pair : *this) {
-            fluid_defsfont_t* defsFont = static_cast<fluid_defsfont_t*>(fluid_sfont_get_data(pair.second.soundFontPtr));
-
-            if (delete_fluid_defsfont(defsFont) != FLUID_OK) {
-                continue;
-            }
-
-            delete_fluid_sfont(pair.second.soundFontPtr);
-
-            if (pair.second.fileStream) {
-                std::fclose(pair.second.fileStream);
-            }
-        }
-    }
-};
+public:
+    ~SoundFontFile();
 
-void* openSoundFont(const char* filename)
-{
-    auto search = SoundFontCache::instance()->find(filename);
+    static std::shared_ptr<SoundFontFile> map(const std::string& path);
 
-    if (search != SoundFontCache::instance()->cend()
-        && search->second.fileStream) {
-        return search->second.fileStream;
-    }
+    const char* data() const;
+    size_t size() const;
 
-    std::FILE* stream = std::fopen(filename, "r");
+private:
+    SoundFontFile() = default;
 
-    SoundFontData sfData;
-    sfData.fileStream = stream;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
 
-    SoundFontCache::instance()->emplace(filename, std::move(sfData));
+#ifdef WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
 
-    return stream;
-}
+using Preset = std::pair<int, int>; // bank, program
 
-int readSoundFont(void* buf, fluid_long_long_t count, void* handle)
+//! NOTE The sound fonts loaded by the Fluid instances. A sound font is loaded once
+//! and shared by all the synths, its file is mapped into memory.
+//! With dynamic sample loading, the samples of a preset are loaded when the preset
+//! is selected on a channel. Preloading does it in the background instead, for
+//! the presets a score is going to use, so that selecting them is cheap
+class SoundFontCache
 {
-    return static_cast<int>(std::fread(buf, count, 1, static_cast<std::FILE*>(handle)));
-}
+public:
+    static SoundFontCache* instance();
+    static bool isDestroyed();
 
-int seekSoundFont(void* handle, fluid_long_long_t offset, int origin)
-{
-    return std::fseek(static_cast<std::FILE*>(handle), offset, origin);
-}
+    fluid_sfont_t* loadSoundFont(fluid_settings_t* settings, const std::string& path);
+    std::shared_ptr<SoundFontFile> file(const std::string& path);
 
-int closeSoundFont(void* /*handle*/)
-{
-    //!Note Prevent closing of sound-font files by Fluid instances,
-    //!     instead the actual closing of cached sound-font files will happen in SoundFontCache.
-    //!     However, we still need to provide "some" callback for Fluid's API
+    //! NOTE Keeps the samples of the presets loaded while the reference lives
+    struct PresetsRef {
+        ~PresetsRef();
 
-    return FLUID_OK;
-}
+        bool isLoaded() const;
 
-fluid_long_long_t tellSoundFont(void* handle)
-{
-    return std::ftell(static_cast<std::FILE*>(handle));
-}
+        std::string path;
+        std::set<Preset> presets;
+        std::shared_future<void> loaded;
+    };
 
-int deleteSoundFont(fluid_sfont_t* /*sfont*/)
-{
-    //!Note Prevent removal of sound-fonts by Fluid instances,
-    //!     instead the actual removal of cached sound-fonts will happen in SoundFontCache.
-    //!     However, we still need to provide "some" callback for Fluid's API
+    using PresetsRefPtr = std::shared_ptr<PresetsRef>;
 
-    return FLUID_OK;
-}
+    PresetsRefPtr preloadPresets(const std::string& path, const std::set<Preset>& presets);
 
-static fluid_file_callbacks_t FILE_CALLBACKS {
-    openSoundFont,
-    readSoundFont,
-    seekSoundFont,
-    closeSoundFont,
-    tellSoundFont
+private:
+    SoundFontCache() = default;
+    ~SoundFontCache();
+
+    struct Preload {
+        fluid_sfont_t* soundFont = nullptr;
+        std::set<Preset> pinned;
+    };
+
+    void releasePresets(const std::string& path, const std::set<Preset>& presets);
+    void syncPinnedPresets(const std::string& path);
+    void pinPresets(const std::string& path, const std::set<Preset>& wanted);
+
+    static fluid_sfont_t* createSoundFont(fluid_settings_t* settings, const std::string& path);
+    static void deleteSoundFont(fluid_sfont_t* sfont);
+
+    std::map<std::string, fluid_sfont_t*> m_soundFonts;
+    std::map<std::string, std::shared_ptr<SoundFontFile> > m_files;
+    std::map<std::string, std::map<Preset, int> > m_presetRefs;
+    std::map<std::string, int> m_syncCounts;
+    std::set<std::string> m_outdatedPaths;
+    std::mutex m_mutex;
+
+    std::map<std::string, Preload> m_preloads;
+    fluid_settings_t* m_preloadSettings = nullptr;
+    std::mutex m_preloadMutex;
 };
 
-fluid_sfont_t* loadSoundFont(fluid_sfloader_t* loader, const char* filename)
-{
-    auto search = SoundFontCache::instance()->find(filename);
-    if (search != SoundFontCache::instance()->cend()) {
-        return search->second.soundFontPtr;
-    }
-
-    fluid_defsfont_t* defsfont = nullptr;
-    fluid_sfont_t* result = nullptr;
+fluid_sfont_t* loadSoundFont(fluid_sfloader_t* loader, const char* filename);
 
-    defsfont = new_fluid_defsfont(static_cast<fluid_settings_t*>(fluid_sfloader_get_data(loader)));
-
-    if (!defsfont) {
-        return nullptr;
-    }
-
-    result = new_fluid_sfont(fluid_defsfont_sfont_get_name,
-                             fluid_defsfont_sfont_get_preset,
-                             fluid_defsfont_sfont_iteration_start,
-                             fluid_defsfont_sfont_iteration_next,
-                             deleteSoundFont);
-
-    if (!result) {
-        return result;
-    }
-
-    fluid_sfont_set_data(result, defsfont);
-    defsfont->sfont = result;
-    defsfont->fcbs = &FILE_CALLBACKS;
-
-    if (fluid_defsfont_load(defsfont, &FILE_CALLBACKS, filename) == FLUID_FAILED) {
-        fluid_defsfont_sfont_delete(result);
-        return nullptr;
-    }
-
-    SoundFontData& sfData = SoundFontCache::instance()->operator[](filename);
-    sfData.soundFontPtr = result;
-
-    return result;
-}
+//! NOTE The callbacks Fluid reads the sound font files with, from their mappings
+const fluid_file_callbacks_t* soundFontFileCallbacks();
 }
 
 #endif // MUSE_AUDIO_SFCACHEDLOADER_H
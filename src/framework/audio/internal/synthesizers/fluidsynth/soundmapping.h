@@ -22,6 +22,8 @@
 
 #ifndef MUSE_AUDIO_SOUNDMAPPING_H
 #define MUSE_AUDIO_SOUNDMAPPING_H
+#include <set>
+
 
 #include "global/async/channel.h"
 #include "mpe/events.h"
@@ -1086,6 +1088,21 @@ struct ChannelMap {
         return static_cast<midi::channel_t>(result);
     }
 
+    //! NOTE All the programs the channels may be set to, including the ones not resolved yet
+    std::set<midi::Program> programs() const
+    {
+        if (m_programOverride.has_value()) {
+            return { m_programOverride.value() };
+        }
+
+        std::set<midi::Program> result(m_standardPrograms.cbegin(), m_standardPrograms.cend());
+        for (const auto& pair : m_articulationMapping) {
+            result.insert(pair.second);
+        }
+
+        return result;
+    }
+
     bool contains(const mpe::voice_layer_idx_t voiceIdx, const mpe::ArticulationType key) const
     {
         VoiceMappings& mapping = m_data[voiceIdx];
@@ -23,6 +23,7 @@
 #include "eventaudiosource.h"
 
 #include "internal/audiosanitizer.h"
+#include "internal/worker/audioengine.h"
 
 #include "log.h"
 
@@ -31,13 +32,34 @@ using namespace muse::audio;
 using namespace muse::audio::synth;
 using namespace muse::mpe;
 
+static msecs_t offStreamDuration(const PlaybackEventsMap& events)
+{
+    msecs_t duration = 0;
+
+    for (const auto& pair : events) {
+        for (const PlaybackEvent& event : pair.second) {
+            if (!std::holds_alternative<NoteEvent>(event)) {
+                continue;
+            }
+
+            const ArrangementContext& arrangementCtx = std::get<NoteEvent>(event).arrangementCtx();
+            duration = std::max<msecs_t>(duration, arrangementCtx.actualTimestamp + arrangementCtx.actualDuration);
+        }
+    }
+
+    return duration > 0 ? duration + TrackFreezeCache::RELEASE_TIME : 0;
+}
+
 EventAudioSource::EventAudioSource(const TrackId trackId, const mpe::PlaybackData& playbackData,
                                    OnOffStreamEventsReceived onOffStreamReceived)
     : m_trackId(trackId), m_playbackData(playbackData)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
-    m_playbackData.offStream.onReceive(this, [onOffStreamReceived, trackId](const PlaybackEventsMap&, const PlaybackParamMap&) {
+    m_playbackData.offStream.onReceive(this, [this, onOffStreamReceived, trackId](const PlaybackEventsMap& events,
+                                                                                  const PlaybackParamMap&) {
+        //! NOTE No events flush the sound
+        m_offStreamTimeLeft = offStreamDuration(events);
         onOffStreamReceived(trackId);
     });
 
@@ -46,6 +68,11 @@ EventAudioSource::EventAudioSource(const TrackId trackId, const mpe::PlaybackDat
         m_playbackData.originEvents = events;
         m_playbackData.dynamicLevelMap = dynamics;
         m_playbackData.paramMap = params;
+
+        //! NOTE The render goes on without storing, the notes of the old events may still be heard
+        m_freezeCache.setEvents(events, dynamics, params);
+        m_planIsValid = false;
+        m_freezeFromNextChunk = false;
     });
 }
 
@@ -74,6 +101,9 @@ void EventAudioSource::setIsActive(const bool active)
         return;
     }
 
+    stopFreezing();
+    m_freezeCache.reserveChunks();
+
     m_synth->setIsActive(active);
     m_synth->flushSound();
 }
@@ -82,6 +112,8 @@ void EventAudioSource::setSampleRate(unsigned int sampleRate)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
+    stopFreezing();
+
     m_sampleRate = sampleRate;
 
     if (!m_synth) {
@@ -89,6 +121,7 @@ void EventAudioSource::setSampleRate(unsigned int sampleRate)
     }
 
     m_synth->setSampleRate(sampleRate);
+    updateFreezeFormat();
 }
 
 unsigned int EventAudioSource::audioChannelsCount() const
@@ -121,7 +154,27 @@ samples_t EventAudioSource::process(float* buffer, samples_t samplesPerChannel)
         return 0;
     }
 
-    return m_synth->process(buffer, samplesPerChannel);
+    //! NOTE The synth plays the off-stream events (the notes played at input) only when it processes,
+    //! so it plays live, without storing, while they may be heard
+    if (m_offStreamTimeLeft > 0 && m_sampleRate > 0) {
+        m_offStreamTimeLeft -= static_cast<msecs_t>(samplesPerChannel * 1000000 / m_sampleRate);
+        stopFreezing();
+        return m_synth->process(buffer, samplesPerChannel);
+    }
+
+    if (!canFreeze(samplesPerChannel)) {
+        stopFreezing();
+        return m_synth->process(buffer, samplesPerChannel);
+    }
+
+    // the frames of the cache are counted in blocks
+    if (samplesPerChannel != m_blockSize) {
+        stopFreezing();
+        m_freezeCache.clear();
+        m_blockSize = samplesPerChannel;
+    }
+
+    return processFrozen(buffer, samplesPerChannel);
 }
 
 void EventAudioSource::seek(const msecs_t newPositionMsecs)
@@ -132,6 +185,9 @@ void EventAudioSource::seek(const msecs_t newPositionMsecs)
         return;
     }
 
+    stopFreezing();
+    m_freezeCache.reserveChunks();
+
     m_synth->setPlaybackPosition(newPositionMsecs);
     m_synth->revokePlayingNotes();
 }
@@ -147,6 +203,8 @@ void EventAudioSource::applyInputParams(const AudioInputParams& requiredParams)
         return;
     }
 
+    stopFreezing();
+
     SynthCtx ctx = currentSynthCtx();
 
     m_synth = synthResolver()->resolveSynth(m_trackId, requiredParams, m_playbackData.setupData);
@@ -168,6 +226,8 @@ void EventAudioSource::applyInputParams(const AudioInputParams& requiredParams)
     }
 
     m_params = m_synth->params();
+    updateFreezeFormat();
+
     m_paramsChanges.send(m_params);
 }
 
@@ -202,3 +262,180 @@ void EventAudioSource::setupSource()
     m_synth->setSampleRate(m_sampleRate);
     m_synth->setup(m_playbackData);
 }
+
+bool EventAudioSource::canFreeze(samples_t samplesPerChannel) const
+{
+    //! NOTE Only the output of FluidSynth depends on nothing but the events. MuseSampler renders differently offline
+    //! and keeps its own state, as the VST instruments do
+    if (m_synth->type() != AudioSourceType::Fluid || !m_synth->isActive()) {
+        return false;
+    }
+
+    return m_sampleRate > 0 && samplesPerChannel > 0 && TrackFreezeCache::CHUNK_SIZE % samplesPerChannel == 0;
+}
+
+samples_t EventAudioSource::processFrozen(float* buffer, samples_t samplesPerChannel)
+{
+    if (!m_positionIsValid) {
+        m_position = std::max<msecs_t>(m_synth->playbackPosition(), 0) / frameMsecs(samplesPerChannel) * samplesPerChannel;
+        m_positionIsValid = true;
+    }
+
+    //! NOTE Offline the render may allocate, so all the chunks get their buffers
+    if (m_position % TrackFreezeCache::CHUNK_SIZE == 0 && !isRealtime()) {
+        m_freezeCache.reserveChunks();
+    }
+
+    if (m_isRendering) {
+        return renderBlock(buffer, samplesPerChannel);
+    }
+
+    if (!m_planIsValid) {
+        m_nextMissingFrame = m_freezeCache.nextMissingFrame(m_position);
+        m_renderStart = m_nextMissingFrame != TrackFreezeCache::NO_FRAME
+                        ? m_freezeCache.renderStartFor(m_nextMissingFrame)
+                        : TrackFreezeCache::NO_FRAME;
+        m_planIsValid = true;
+    }
+
+    if (m_position + samplesPerChannel <= m_nextMissingFrame && m_position != m_renderStart) {
+        if (m_freezeCache.read(m_position, buffer, samplesPerChannel)) {
+            m_position += samplesPerChannel;
+            return samplesPerChannel;
+        }
+    }
+
+    startRender(samplesPerChannel);
+
+    return renderBlock(buffer, samplesPerChannel);
+}
+
+samples_t EventAudioSource::renderBlock(float* buffer, samples_t samplesPerChannel)
+{
+    const samples_t rendered = m_synth->process(buffer, samplesPerChannel);
+
+    if (rendered == samplesPerChannel) {
+        m_freezeCache.write(m_position, buffer, samplesPerChannel);
+    } else {
+        m_freezeCache.endRender();
+    }
+
+    m_position += samplesPerChannel;
+
+    if (m_position % TrackFreezeCache::CHUNK_SIZE != 0) {
+        return rendered;
+    }
+
+    // the render has started between the chunk boundaries
+    if (m_freezeFromNextChunk) {
+        m_freezeFromNextChunk = false;
+        m_freezeCache.beginRender(m_position);
+    }
+
+    // the cache takes over, if the synth is not needed again before the next missing chunk
+    const samples_t nextMissingFrame = m_freezeCache.nextMissingFrame(m_position);
+    if (nextMissingFrame == m_position) {
+        return rendered;
+    }
+
+    const samples_t renderStart = nextMissingFrame != TrackFreezeCache::NO_FRAME
+                                  ? m_freezeCache.renderStartFor(nextMissingFrame)
+                                  : TrackFreezeCache::NO_FRAME;
+
+    if (renderStart > m_position) {
+        m_synth->flushSound();
+        m_freezeCache.endRender();
+        m_isRendering = false;
+
+        m_nextMissingFrame = nextMissingFrame;
+        m_renderStart = renderStart;
+        m_planIsValid = true;
+    }
+
+    return rendered;
+}
+
+void EventAudioSource::startRender(samples_t samplesPerChannel)
+{
+    constexpr samples_t CHUNK_SIZE = TrackFreezeCache::CHUNK_SIZE;
+
+    m_synth->flushSound();
+
+    m_isRendering = true;
+    m_planIsValid = false;
+
+    //! NOTE Starting the notes heard at the position again means rendering from an earlier chunk
+    //! in one block. There is no time for it in realtime: the synth plays from the position,
+    //! as after a seek, and the cache stores the audio from a chunk boundary on,
+    //! once the notes it has not started are no longer heard
+    if (isRealtime()) {
+        m_synth->setPlaybackPosition(frameMsecs(m_position));
+
+        if (m_position % CHUNK_SIZE == 0) {
+            m_freezeCache.beginRender(m_position);
+        } else {
+            m_freezeCache.endRender();
+            m_freezeFromNextChunk = true;
+        }
+
+        return;
+    }
+
+    const samples_t from = std::min(m_renderStart, m_position / CHUNK_SIZE * CHUNK_SIZE);
+
+    m_synth->setPlaybackPosition(frameMsecs(from));
+    m_freezeCache.beginRender(from);
+
+    // the notes heard at the position are started again
+    m_renderBuffer.resize(samplesPerChannel * m_synth->audioChannelsCount());
+
+    for (samples_t frame = from; frame < m_position; frame += samplesPerChannel) {
+        if (m_synth->process(m_renderBuffer.data(), samplesPerChannel) == samplesPerChannel) {
+            m_freezeCache.write(frame, m_renderBuffer.data(), samplesPerChannel);
+        } else {
+            m_freezeCache.endRender();
+        }
+    }
+}
+
+void EventAudioSource::stopFreezing()
+{
+    // the synth has stayed where the cache took over
+    if (m_positionIsValid && !m_isRendering && m_synth) {
+        m_synth->setPlaybackPosition(frameMsecs(m_position));
+    }
+
+    m_freezeCache.endRender();
+
+    m_positionIsValid = false;
+    m_isRendering = false;
+    m_planIsValid = false;
+    m_freezeFromNextChunk = false;
+}
+
+void EventAudioSource::updateFreezeFormat()
+{
+    if (!m_synth) {
+        return;
+    }
+
+    m_freezeCache.setFormat(m_params, static_cast<unsigned int>(m_sampleRate), m_synth->audioChannelsCount());
+    m_freezeCache.setEvents(m_playbackData.originEvents, m_playbackData.dynamicLevelMap, m_playbackData.paramMap);
+    m_planIsValid = false;
+}
+
+bool EventAudioSource::isRealtime() const
+{
+    return AudioEngine::instance()->mode() != RenderMode::OfflineMode;
+}
+
+msecs_t EventAudioSource::frameMsecs(samples_t frame) const
+{
+    if (m_blockSize == 0 || m_sampleRate == 0) {
+        return 0;
+    }
+
+    // as the synthesizers count the time
+    const msecs_t blockMsecs = static_cast<msecs_t>(m_blockSize * 1000000 / m_sampleRate);
+    return static_cast<msecs_t>(frame / m_blockSize) * blockMsecs;
+}
@@ -30,10 +30,12 @@
 #include "audiotypes.h"
 #include "isynthresolver.h"
 #include "track.h"
+#include "trackfreezecache.h"
 
 namespace muse::audio {
 class EventAudioSource : public ITrackAudioInput, public async::Asyncable
 {
+public:
     Inject<synth::ISynthResolver> synthResolver;
 
 public:
@@ -73,6 +75,15 @@ private:
     SynthCtx currentSynthCtx() const;
     void restoreSynthCtx(SynthCtx&& ctx);
 
+    bool canFreeze(samples_t samplesPerChannel) const;
+    samples_t processFrozen(float* buffer, samples_t samplesPerChannel);
+    samples_t renderBlock(float* buffer, samples_t samplesPerChannel);
+    void startRender(samples_t samplesPerChannel);
+    void stopFreezing();
+    void updateFreezeFormat();
+    bool isRealtime() const;
+    msecs_t frameMsecs(samples_t frame) const;
+
     TrackId m_trackId = -1;
     mpe::PlaybackData m_playbackData;
     synth::ISynthesizerPtr m_synth = nullptr;
@@ -80,6 +91,18 @@ private:
     async::Channel<AudioInputParams> m_paramsChanges;
 
     samples_t m_sampleRate = 0;
+
+    TrackFreezeCache m_freezeCache;
+    samples_t m_blockSize = 0;
+    samples_t m_position = 0;
+    bool m_positionIsValid = false;
+    bool m_isRendering = false;
+    bool m_planIsValid = false;
+    bool m_freezeFromNextChunk = false;
+    samples_t m_nextMissingFrame = 0;
+    samples_t m_renderStart = 0;
+    msecs_t m_offStreamTimeLeft = 0;
+    std::vector<float> m_renderBuffer;
 };
 }
 
@@ -157,15 +157,14 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
         return 0;
     }
 
-    TracksData tracksData;
-    processTrackChannels(outBufferSize, samplesPerChannel, tracksData);
+    processTrackChannels(outBufferSize, samplesPerChannel);
 
     prepareAuxBuffers(outBufferSize);
 
     samples_t masterChannelSampleCount = 0;
 
-    for (auto& pair : tracksData) {
-        const std::vector<float>& trackBuffer = pair.second;
+    for (size_t i = 0; i < m_channelsToProcess.size(); ++i) {
+        const std::vector<float>& trackBuffer = m_channelBuffers[i];
 
         bool outBufferIsSilent = false;
         mixOutputFromChannel(outBuffer, trackBuffer.data(), samplesPerChannel, outBufferIsSilent);
@@ -177,7 +176,7 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
             continue;
         }
 
-        const AuxSendsParams& auxSends = m_trackChannels.at(pair.first)->outputParams().auxSends;
+        const AuxSendsParams& auxSends = m_channelsToProcess[i]->outputParams().auxSends;
         writeTrackToAuxBuffers(trackBuffer.data(), auxSends, samplesPerChannel);
     }
 
@@ -198,45 +197,40 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
     return masterChannelSampleCount;
 }
 
-void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData)
+void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel)
 {
-    auto processChannel = [outBufferSize, samplesPerChannel](MixerChannelPtr channel) -> std::vector<float> {
-        thread_local std::vector<float> buffer(outBufferSize, 0.f);
-        thread_local std::vector<float> silent_buffer(outBufferSize, 0.f);
+    bool filterTracks = m_isIdle && !m_tracksToProcessWhenIdle.empty();
 
-        buffer = silent_buffer;
+    m_channelsToProcess.clear();
 
-        if (channel) {
-            channel->process(buffer.data(), samplesPerChannel);
+    for (const auto& pair : m_trackChannels) {
+        if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
+            continue;
         }
 
-        return buffer;
-    };
-
-    bool filterTracks = m_isIdle && !m_tracksToProcessWhenIdle.empty();
+        m_channelsToProcess.push_back(pair.second);
+    }
 
-    if (useMultithreading()) {
-        std::map<TrackId, std::future<std::vector<float> > > futures;
+    if (m_channelBuffers.size() < m_channelsToProcess.size()) {
+        m_channelBuffers.resize(m_channelsToProcess.size());
+    }
 
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
+    auto processChannel = [this, outBufferSize, samplesPerChannel](size_t i) {
+        std::vector<float>& buffer = m_channelBuffers[i];
+        buffer.resize(outBufferSize);
+        std::fill(buffer.begin(), buffer.end(), 0.f);
 
-            std::future<std::vector<float> > future = TaskScheduler::instance()->submit(processChannel, pair.second);
-            futures.emplace(pair.first, std::move(future));
+        const MixerChannelPtr& channel = m_channelsToProcess[i];
+        if (channel) {
+            channel->process(buffer.data(), samplesPerChannel);
         }
+    };
 
-        for (auto& pair : futures) {
-            outTracksData.emplace(pair.first, pair.second.get());
-        }
+    if (useMultithreading()) {
+        TaskScheduler::instance(ThreadPriority::Realtime)->parallelFor(0, m_channelsToProcess.size(), processChannel);
     } else {
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
-
-            outTracksData.emplace(pair.first, processChannel(pair.second));
+        for (size_t i = 0; i < m_channelsToProcess.size(); ++i) {
+            processChannel(i);
         }
     }
 }
@@ -74,9 +74,7 @@ public:
     void setIsActive(bool arg) override;
 
 private:
-    using TracksData = std::map<TrackId, std::vector<float> >;
-
-    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData);
+    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel);
     void mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsigned int samplesCount, bool& outBufferIsSilent);
     void prepareAuxBuffers(size_t outBufferSize);
     void writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParams& auxSends, samples_t samplesPerChannel);
@@ -99,6 +97,10 @@ private:
     std::map<TrackId, MixerChannelPtr> m_trackChannels = {};
     std::unordered_set<TrackId> m_tracksToProcessWhenIdle;
 
+    //! NOTE The buffers are kept from block to block, so that the audio thread does not allocate
+    std::vector<MixerChannelPtr> m_channelsToProcess;
+    std::vector<std::vector<float> > m_channelBuffers;
+
     struct AuxChannelInfo {
         MixerChannelPtr channel;
         std::vector<float> buffer;
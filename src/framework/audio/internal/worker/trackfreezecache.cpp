@@ -0,0 +1,537 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "trackfreezecache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::mpe;
+
+//! NOTE The sequencers count the time in whole microseconds per block, so the events are played
+//! slightly later than their timestamps. This is well below it
+static constexpr double MAX_TIMING_DRIFT = 0.001;
+
+static std::atomic<size_t> s_totalMemoryUsage = 0;
+static std::atomic<size_t> s_totalSpareMemoryUsage = 0;
+
+static uint64_t hashCombine(uint64_t seed, uint64_t value)
+{
+    // splitmix64
+    uint64_t h = seed + 0x9e3779b97f4a7c15ull + value;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+static uint64_t hashDouble(uint64_t seed, double value)
+{
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return hashCombine(seed, bits);
+}
+
+static uint64_t hashString(uint64_t seed, const std::string& str)
+{
+    return hashCombine(seed, std::hash<std::string> {}(str));
+}
+
+template<typename Curve>
+static uint64_t hashCurve(uint64_t seed, const Curve& curve)
+{
+    for (const auto& point : curve) {
+        seed = hashCombine(seed, static_cast<uint64_t>(point.first));
+        seed = hashCombine(seed, static_cast<uint64_t>(point.second));
+    }
+
+    return seed;
+}
+
+static uint64_t hashNote(const NoteEvent& note)
+{
+    const ArrangementContext& arrangement = note.arrangementCtx();
+    uint64_t h = hashCombine(0, static_cast<uint64_t>(arrangement.actualTimestamp));
+    h = hashCombine(h, static_cast<uint64_t>(arrangement.actualDuration));
+    h = hashCombine(h, static_cast<uint64_t>(arrangement.nominalTimestamp));
+    h = hashCombine(h, static_cast<uint64_t>(arrangement.nominalDuration));
+    h = hashCombine(h, static_cast<uint64_t>(arrangement.voiceLayerIndex));
+    h = hashCombine(h, static_cast<uint64_t>(arrangement.staffLayerIndex));
+    h = hashDouble(h, arrangement.bps);
+
+    const PitchContext& pitch = note.pitchCtx();
+    h = hashCombine(h, static_cast<uint64_t>(pitch.nominalPitchLevel));
+    h = hashCurve(h, pitch.pitchCurve);
+
+    const ExpressionContext& expression = note.expressionCtx();
+    h = hashCombine(h, static_cast<uint64_t>(expression.nominalDynamicLevel));
+    h = hashCurve(h, expression.expressionCurve);
+
+    // the articulations are not ordered
+    uint64_t articulations = 0;
+    for (const auto& pair : expression.articulations) {
+        const ArticulationAppliedData& data = pair.second;
+        uint64_t a = hashCombine(0, static_cast<uint64_t>(pair.first));
+        a = hashCombine(a, static_cast<uint64_t>(data.meta.timestamp));
+        a = hashCombine(a, static_cast<uint64_t>(data.meta.overallDuration));
+        a = hashCombine(a, static_cast<uint64_t>(data.occupiedFrom));
+        a = hashCombine(a, static_cast<uint64_t>(data.occupiedTo));
+        articulations += a;
+    }
+
+    return hashCombine(h, articulations);
+}
+
+static uint64_t hashParams(const PlaybackParamList& params)
+{
+    uint64_t h = 0;
+    for (const PlaybackParam& param : params) {
+        h = hashString(h, param.code.toStdString());
+        h = hashString(h, param.val.toString());
+        h = hashCombine(h, static_cast<uint64_t>(param.staffLayerIndex));
+    }
+
+    return h;
+}
+
+TrackFreezeCache::~TrackFreezeCache()
+{
+    clear();
+    releaseSpareBuffers();
+}
+
+void TrackFreezeCache::setFormat(const AudioInputParams& params, unsigned int sampleRate, unsigned int audioChannelsCount)
+{
+    if (m_params == params && m_sampleRate == sampleRate && m_audioChannelsCount == audioChannelsCount) {
+        return;
+    }
+
+    clear();
+
+    // the buffers are of the size of a chunk of the old format
+    releaseSpareBuffers();
+    m_pendingChunk.clear();
+
+    m_params = params;
+    m_sampleRate = sampleRate;
+    m_audioChannelsCount = audioChannelsCount;
+}
+
+void TrackFreezeCache::setEvents(const PlaybackEventsMap& events, const DynamicLevelMap& dynamics, const PlaybackParamMap& params)
+{
+    // what is being rendered has changed in the meantime
+    endRender();
+
+    m_noteSpans.clear();
+
+    struct KeyedSpan {
+        NoteSpan span;
+        uint64_t key = 0;
+    };
+
+    std::vector<KeyedSpan> spans;
+    samples_t endFrame = 0;
+
+    for (const auto& pair : events) {
+        for (const PlaybackEvent& event : pair.second) {
+            if (!std::holds_alternative<NoteEvent>(event)) {
+                continue;
+            }
+
+            const NoteEvent& note = std::get<NoteEvent>(event);
+            const ArrangementContext& arrangement = note.arrangementCtx();
+
+            NoteSpan span;
+            span.from = frameAt(arrangement.actualTimestamp);
+            span.to = releaseFrameAt(arrangement.actualTimestamp + arrangement.actualDuration);
+
+            m_noteSpans.push_back(span);
+            spans.push_back({ span, hashNote(note) });
+            endFrame = std::max(endFrame, span.to);
+        }
+    }
+
+    // after the last note nothing is heard, whatever the dynamics are
+    const size_t chunkCount = m_sampleRate > 0 && !spans.empty() ? endFrame / CHUNK_SIZE + 1 : 0;
+    std::vector<uint64_t> keys(chunkCount, 0);
+
+    auto addToChunks = [&keys, chunkCount](samples_t from, samples_t to, uint64_t key) {
+        const size_t lastChunk = std::min<size_t>(to / CHUNK_SIZE, chunkCount - 1);
+        for (size_t idx = from / CHUNK_SIZE; idx <= lastChunk; ++idx) {
+            keys[idx] = hashCombine(keys[idx], key);
+        }
+    };
+
+    if (chunkCount > 0) {
+        for (const KeyedSpan& keyed : spans) {
+            addToChunks(keyed.span.from, keyed.span.to, keyed.key);
+        }
+
+        // a dynamic or a param applies until the next one
+        for (auto it = dynamics.cbegin(); it != dynamics.cend(); ++it) {
+            auto next = std::next(it);
+            const samples_t to = next != dynamics.cend() ? releaseFrameAt(next->first) : endFrame;
+            addToChunks(frameAt(it->first), to, hashCombine(static_cast<uint64_t>(it->first), static_cast<uint64_t>(it->second)));
+        }
+
+        for (auto it = params.cbegin(); it != params.cend(); ++it) {
+            auto next = std::next(it);
+            const samples_t to = next != params.cend() ? releaseFrameAt(next->first) : endFrame;
+            addToChunks(frameAt(it->first), to, hashCombine(static_cast<uint64_t>(it->first), hashParams(it->second)));
+        }
+    }
+
+    std::sort(m_noteSpans.begin(), m_noteSpans.end(), [](const NoteSpan& s1, const NoteSpan& s2) {
+        return s1.from < s2.from;
+    });
+
+    m_chunkKeys = std::move(keys);
+
+    for (size_t idx = 0; idx < m_chunks.size(); ++idx) {
+        Chunk& chunk = m_chunks[idx];
+        if (chunk.isStored && chunk.key != chunkKey(idx)) {
+            dropChunk(chunk);
+        }
+    }
+
+    reserveChunks();
+}
+
+void TrackFreezeCache::clear()
+{
+    endRender();
+
+    //! NOTE The list of the chunks is kept, so that the render does not have to allocate it again
+    for (Chunk& chunk : m_chunks) {
+        dropChunk(chunk);
+    }
+}
+
+void TrackFreezeCache::reserveChunks()
+{
+    const size_t chunkSamples = CHUNK_SIZE * m_audioChannelsCount;
+    if (m_sampleRate == 0 || chunkSamples == 0) {
+        return;
+    }
+
+    if (m_chunks.size() < m_chunkKeys.size()) {
+        m_chunks.resize(m_chunkKeys.size());
+    }
+
+    m_pendingChunk.resize(chunkSamples);
+    m_spareBuffers.reserve(SPARE_CHUNK_COUNT);
+
+    size_t missingCount = 0;
+    for (size_t idx = 0; idx < m_chunkKeys.size() && missingCount < SPARE_CHUNK_COUNT; ++idx) {
+        if (!isChunkCached(idx)) {
+            ++missingCount;
+        }
+    }
+
+    const size_t bytes = chunkSamples * sizeof(float);
+    while (m_spareBuffers.size() < missingCount) {
+        if (s_totalMemoryUsage + s_totalSpareMemoryUsage + bytes > MAX_MEMORY_BYTES) {
+            break;
+        }
+
+        m_spareBuffers.emplace_back(chunkSamples);
+        m_spareMemoryUsage += bytes;
+        s_totalSpareMemoryUsage += bytes;
+    }
+}
+
+bool TrackFreezeCache::isCached(samples_t position, samples_t samplesPerChannel) const
+{
+    if (samplesPerChannel == 0) {
+        return true;
+    }
+
+    const size_t lastChunk = (position + samplesPerChannel - 1) / CHUNK_SIZE;
+    for (size_t idx = position / CHUNK_SIZE; idx <= lastChunk; ++idx) {
+        if (!isChunkCached(idx)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TrackFreezeCache::read(samples_t position, float* buffer, samples_t samplesPerChannel)
+{
+    if (!isCached(position, samplesPerChannel)) {
+        return false;
+    }
+
+    samples_t done = 0;
+    while (done < samplesPerChannel) {
+        const size_t idx = (position + done) / CHUNK_SIZE;
+        const samples_t offset = (position + done) % CHUNK_SIZE;
+        const samples_t count = std::min(samplesPerChannel - done, CHUNK_SIZE - offset);
+
+        float* out = buffer + done * m_audioChannelsCount;
+        const size_t size = count * m_audioChannelsCount;
+
+        if (idx >= m_chunks.size() || m_chunks[idx].isSilent || !m_chunks[idx].isStored) {
+            std::fill(out, out + size, 0.f);
+        } else {
+            const float* in = m_chunks[idx].samples.data() + offset * m_audioChannelsCount;
+            std::copy(in, in + size, out);
+        }
+
+        if (offset + count == CHUNK_SIZE) {
+            m_statistic.chunksRead++;
+        }
+
+        done += count;
+    }
+
+    return true;
+}
+
+samples_t TrackFreezeCache::nextMissingFrame(samples_t position) const
+{
+    for (size_t idx = position / CHUNK_SIZE; idx < m_chunkKeys.size(); ++idx) {
+        if (!isChunkCached(idx)) {
+            return std::max(idx * CHUNK_SIZE, position);
+        }
+    }
+
+    return NO_FRAME;
+}
+
+samples_t TrackFreezeCache::renderStartFor(samples_t position) const
+{
+    samples_t start = position;
+
+    for (const NoteSpan& span : m_noteSpans) {
+        if (span.from >= position) {
+            break;
+        }
+
+        if (span.to > position) {
+            start = std::min(start, span.from);
+        }
+    }
+
+    return start / CHUNK_SIZE * CHUNK_SIZE;
+}
+
+samples_t TrackFreezeCache::settledFrameFor(samples_t renderStart) const
+{
+    samples_t settled = renderStart;
+
+    for (const NoteSpan& span : m_noteSpans) {
+        if (span.from >= renderStart) {
+            break;
+        }
+
+        settled = std::max(settled, span.to);
+    }
+
+    return settled;
+}
+
+void TrackFreezeCache::beginRender(samples_t position)
+{
+    if (m_sampleRate == 0 || m_audioChannelsCount == 0 || position % CHUNK_SIZE != 0) {
+        endRender();
+        return;
+    }
+
+    // not reserved yet
+    if (m_pendingChunk.size() != CHUNK_SIZE * m_audioChannelsCount) {
+        endRender();
+        return;
+    }
+
+    m_isRendering = true;
+    m_settledFrame = settledFrameFor(position);
+    m_writePosition = position;
+}
+
+void TrackFreezeCache::endRender()
+{
+    m_isRendering = false;
+    m_settledFrame = NO_FRAME;
+}
+
+void TrackFreezeCache::write(samples_t position, const float* buffer, samples_t samplesPerChannel)
+{
+    if (!m_isRendering) {
+        return;
+    }
+
+    if (position != m_writePosition) {
+        endRender();
+        return;
+    }
+
+    samples_t done = 0;
+    while (done < samplesPerChannel) {
+        const size_t idx = m_writePosition / CHUNK_SIZE;
+        const samples_t offset = m_writePosition % CHUNK_SIZE;
+        const samples_t count = std::min(samplesPerChannel - done, CHUNK_SIZE - offset);
+
+        const float* in = buffer + done * m_audioChannelsCount;
+        std::copy(in, in + count * m_audioChannelsCount, m_pendingChunk.data() + offset * m_audioChannelsCount);
+
+        done += count;
+        m_writePosition += count;
+
+        if (offset + count == CHUNK_SIZE && idx * CHUNK_SIZE >= m_settledFrame && !isChunkCached(idx)) {
+            storeChunk(idx, m_pendingChunk.data());
+        }
+    }
+}
+
+bool TrackFreezeCache::isRendering() const
+{
+    return m_isRendering;
+}
+
+samples_t TrackFreezeCache::settledFrame() const
+{
+    return m_isRendering ? m_settledFrame : NO_FRAME;
+}
+
+size_t TrackFreezeCache::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+size_t TrackFreezeCache::totalMemoryUsage()
+{
+    return s_totalMemoryUsage;
+}
+
+const TrackFreezeCache::Statistic& TrackFreezeCache::statistic() const
+{
+    return m_statistic;
+}
+
+samples_t TrackFreezeCache::frameAt(msecs_t usecs) const
+{
+    if (usecs <= 0) {
+        return 0;
+    }
+
+    return static_cast<samples_t>(usecs) * m_sampleRate / 1000000;
+}
+
+samples_t TrackFreezeCache::releaseFrameAt(msecs_t usecs) const
+{
+    const msecs_t drift = static_cast<msecs_t>(std::max<msecs_t>(usecs, 0) * MAX_TIMING_DRIFT);
+    return frameAt(usecs + drift + RELEASE_TIME);
+}
+
+uint64_t TrackFreezeCache::chunkKey(size_t chunkIdx) const
+{
+    return chunkIdx < m_chunkKeys.size() ? m_chunkKeys[chunkIdx] : 0;
+}
+
+bool TrackFreezeCache::isChunkCached(size_t chunkIdx) const
+{
+    if (m_sampleRate == 0) {
+        return false;
+    }
+
+    // nothing is heard there
+    if (chunkIdx >= m_chunkKeys.size()) {
+        return true;
+    }
+
+    if (chunkIdx >= m_chunks.size()) {
+        return false;
+    }
+
+    const Chunk& chunk = m_chunks[chunkIdx];
+    return chunk.isStored && chunk.key == m_chunkKeys[chunkIdx];
+}
+
+void TrackFreezeCache::storeChunk(size_t chunkIdx, const float* samples)
+{
+    const size_t size = CHUNK_SIZE * m_audioChannelsCount;
+    const bool isSilent = std::all_of(samples, samples + size, [](float sample) {
+        return sample == 0.f;
+    });
+
+    if (chunkIdx >= m_chunks.size()) {
+        return;
+    }
+
+    Chunk& chunk = m_chunks[chunkIdx];
+    dropChunk(chunk);
+
+    // no buffer reserved for it
+    if (!isSilent && m_spareBuffers.empty()) {
+        return;
+    }
+
+    chunk.key = chunkKey(chunkIdx);
+    chunk.isStored = true;
+    chunk.isSilent = isSilent;
+
+    if (!isSilent) {
+        chunk.samples = std::move(m_spareBuffers.back());
+        m_spareBuffers.pop_back();
+        std::copy(samples, samples + size, chunk.samples.begin());
+
+        const size_t bytes = size * sizeof(float);
+        m_spareMemoryUsage -= bytes;
+        s_totalSpareMemoryUsage -= bytes;
+        m_memoryUsage += bytes;
+        s_totalMemoryUsage += bytes;
+    }
+
+    m_statistic.chunksStored++;
+}
+
+void TrackFreezeCache::dropChunk(Chunk& chunk)
+{
+    const size_t bytes = chunk.samples.size() * sizeof(float);
+    m_memoryUsage -= bytes;
+    s_totalMemoryUsage -= bytes;
+
+    //! NOTE The buffer is kept for the next chunk, if the spare ones have room for it
+    if (!chunk.samples.empty() && m_spareBuffers.size() < m_spareBuffers.capacity()) {
+        m_spareBuffers.push_back(std::move(chunk.samples));
+        m_spareMemoryUsage += bytes;
+        s_totalSpareMemoryUsage += bytes;
+    }
+
+    chunk.samples.clear();
+    chunk.samples.shrink_to_fit();
+    chunk.isStored = false;
+    chunk.isSilent = false;
+}
+
+void TrackFreezeCache::releaseSpareBuffers()
+{
+    s_totalSpareMemoryUsage -= m_spareMemoryUsage;
+    m_spareMemoryUsage = 0;
+
+    m_spareBuffers.clear();
+    m_spareBuffers.shrink_to_fit();
+}
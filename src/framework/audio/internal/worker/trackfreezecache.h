@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_TRACKFREEZECACHE_H
+#define MUSE_AUDIO_TRACKFREEZECACHE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mpe/events.h"
+
+#include "audiotypes.h"
+
+namespace muse::audio {
+//! NOTE Keeps the audio rendered by the synthesizer of a track ("freezes" it), so that the parts
+//! of the track which have not changed are played and exported again without the synthesizer.
+//! The audio is kept in chunks of frames. A chunk is keyed by a hash of the events heard in it,
+//! so an edit drops only the chunks around the edited events
+class TrackFreezeCache
+{
+public:
+    static constexpr samples_t CHUNK_SIZE = 8192;
+    static constexpr samples_t NO_FRAME = std::numeric_limits<samples_t>::max();
+
+    //! NOTE How long a note may still be heard after its end
+    static constexpr msecs_t RELEASE_TIME = 2000000;
+
+    //! NOTE For all the tracks together
+    static constexpr size_t MAX_MEMORY_BYTES = size_t(1024) * 1024 * 1024;
+
+    //! NOTE The render does not allocate: a chunk is stored into a buffer allocated ahead by reserveChunks()
+    static constexpr size_t SPARE_CHUNK_COUNT = 64;
+
+    struct Statistic {
+        size_t chunksRead = 0;
+        size_t chunksStored = 0;
+    };
+
+    TrackFreezeCache() = default;
+    ~TrackFreezeCache();
+
+    TrackFreezeCache(const TrackFreezeCache&) = delete;
+    TrackFreezeCache& operator=(const TrackFreezeCache&) = delete;
+
+    //! NOTE The cache is cleared when any of them changes
+    void setFormat(const AudioInputParams& params, unsigned int sampleRate, unsigned int audioChannelsCount);
+
+    //! NOTE The chunks whose events have changed are dropped
+    void setEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelMap& dynamics, const mpe::PlaybackParamMap& params);
+
+    void clear();
+
+    //! NOTE Allocates the chunk list and the buffers for the next missing chunks. Called outside the render,
+    //! which stores only the chunks it has buffers for; the other ones are left for a later render
+    void reserveChunks();
+
+    bool isCached(samples_t position, samples_t samplesPerChannel) const;
+
+    //! NOTE Copies the frames, if all of them are cached
+    bool read(samples_t position, float* buffer, samples_t samplesPerChannel);
+
+    //! NOTE The start of the first chunk at or after the position which is not cached
+    samples_t nextMissingFrame(samples_t position) const;
+
+    //! NOTE The chunk boundary from which a render sounds at the position as a render from the start:
+    //! every note still heard at the position is started again
+    samples_t renderStartFor(samples_t position) const;
+
+    //! NOTE The frames written after the render has started at the chunk boundary are stored,
+    //! from the moment the notes started before the render are no longer heard
+    void beginRender(samples_t position);
+    void endRender();
+    void write(samples_t position, const float* buffer, samples_t samplesPerChannel);
+
+    bool isRendering() const;
+
+    //! NOTE NO_FRAME if nothing of the current render is stored
+    samples_t settledFrame() const;
+
+    size_t memoryUsage() const;
+    static size_t totalMemoryUsage();
+
+    const Statistic& statistic() const;
+
+private:
+    struct NoteSpan {
+        samples_t from = 0;
+        samples_t to = 0;
+    };
+
+    struct Chunk {
+        uint64_t key = 0;
+        bool isStored = false;
+        bool isSilent = false;
+        std::vector<float> samples;
+    };
+
+    samples_t frameAt(msecs_t usecs) const;
+    samples_t releaseFrameAt(msecs_t usecs) const;
+    samples_t settledFrameFor(samples_t renderStart) const;
+
+    uint64_t chunkKey(size_t chunkIdx) const;
+    bool isChunkCached(size_t chunkIdx) const;
+    void storeChunk(size_t chunkIdx, const float* samples);
+    void dropChunk(Chunk& chunk);
+    void releaseSpareBuffers();
+
+    AudioInputParams m_params;
+    unsigned int m_sampleRate = 0;
+    unsigned int m_audioChannelsCount = 0;
+
+    std::vector<NoteSpan> m_noteSpans;
+    std::vector<uint64_t> m_chunkKeys;
+    std::vector<Chunk> m_chunks;
+    size_t m_memoryUsage = 0;
+
+    std::vector<std::vector<float> > m_spareBuffers;
+    size_t m_spareMemoryUsage = 0;
+
+    bool m_isRendering = false;
+    samples_t m_settledFrame = NO_FRAME;
+    samples_t m_writePosition = 0;
+    std::vector<float> m_pendingChunk;
+
+    Statistic m_statistic;
+};
+}
+
+#endif // MUSE_AUDIO_TRACKFREEZECACHE_H
@@ -0,0 +1,293 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "internal/audiosanitizer.h"
+#include "internal/worker/eventaudiosource.h"
+
+#include "mocks/synthresolvermock.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::synth;
+using namespace muse::mpe;
+
+static constexpr unsigned int SAMPLE_RATE = 44100;
+static constexpr audioch_t CHANNELS = 2;
+static constexpr samples_t BLOCK_SIZE = 512;
+static constexpr samples_t CHUNK_SIZE = TrackFreezeCache::CHUNK_SIZE;
+
+namespace muse::audio {
+class Audio_EventAudioSourceTest : public ::testing::Test
+{
+public:
+    struct Note {
+        double secs = 0.0;
+        double durationSecs = 0.0;
+        pitch_level_t pitch = 60;
+    };
+
+    //! NOTE Counts the time as the synthesizers do, in whole microseconds per block.
+    //! A note is heard a little after its end, then there is silence
+    class FakeSynth : public ISynthesizer
+    {
+    public:
+        float sample(samples_t frameIdx, audioch_t channel) const
+        {
+            for (const Note& note : m_notes) {
+                if (frameIdx >= frame(note.secs) && frameIdx < frame(note.secs + note.durationSecs + 0.5)) {
+                    return static_cast<float>(note.pitch + frameIdx % 1000 + channel) / 10000.f;
+                }
+            }
+
+            return 0.f;
+        }
+
+        std::string name() const override { return "fake"; }
+        AudioSourceType type() const override { return AudioSourceType::Fluid; }
+        bool isValid() const override { return true; }
+
+        void setup(const mpe::PlaybackData&) override {}
+
+        const AudioInputParams& params() const override { return m_params; }
+        async::Channel<AudioInputParams> paramsChanged() const override { return m_paramsChanged; }
+
+        msecs_t playbackPosition() const override { return m_position; }
+        void setPlaybackPosition(const msecs_t newPosition) override { m_position = newPosition; }
+
+        void revokePlayingNotes() override {}
+        void flushSound() override {}
+
+        bool isActive() const override { return m_isActive; }
+        void setIsActive(bool arg) override { m_isActive = arg; }
+
+        void setSampleRate(unsigned int) override {}
+        unsigned int audioChannelsCount() const override { return CHANNELS; }
+        async::Channel<unsigned int> audioChannelsCountChanged() const override { return m_audioChannelsCountChanged; }
+
+        samples_t process(float* buffer, samples_t samplesPerChannel) override
+        {
+            const samples_t frameIdx = static_cast<samples_t>(m_position / blockMsecs()) * samplesPerChannel;
+
+            for (samples_t i = 0; i < samplesPerChannel; ++i) {
+                for (audioch_t ch = 0; ch < CHANNELS; ++ch) {
+                    buffer[i * CHANNELS + ch] = sample(frameIdx + i, ch);
+                }
+            }
+
+            m_position += blockMsecs();
+            m_processedBlocks++;
+
+            return samplesPerChannel;
+        }
+
+        AudioInputParams m_params;
+        async::Channel<AudioInputParams> m_paramsChanged;
+        async::Channel<unsigned int> m_audioChannelsCountChanged;
+        msecs_t m_position = 0;
+        bool m_isActive = false;
+        std::vector<Note> m_notes;
+        size_t m_processedBlocks = 0;
+    };
+
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_synth = std::make_shared<FakeSynth>();
+        m_synth->m_params.resourceMeta.id = "GeneralUser GS";
+        m_synth->m_params.resourceMeta.vendor = "Fluid";
+        m_synth->m_params.resourceMeta.type = AudioResourceType::FluidSoundfont;
+
+        m_resolver = std::make_shared<NiceMock<SynthResolverMock> >();
+        ON_CALL(*m_resolver, resolveSynth(_, _, _)).WillByDefault(Return(m_synth));
+
+        //! [GIVEN] Two short notes, with silence between them
+        setNotes({ { 0.0, 0.2 }, { 6.0, 0.2 } });
+
+        m_source = std::make_shared<EventAudioSource>(1, m_playbackData, [](const TrackId) {});
+        m_source->synthResolver.set(m_resolver);
+        m_source->applyInputParams(m_synth->m_params);
+        m_source->setSampleRate(SAMPLE_RATE);
+        m_source->setIsActive(true);
+    }
+
+    void TearDown() override
+    {
+        m_source.reset();
+    }
+
+    static samples_t frame(double secs)
+    {
+        return static_cast<samples_t>(secs * SAMPLE_RATE) / BLOCK_SIZE * BLOCK_SIZE;
+    }
+
+    static msecs_t blockMsecs()
+    {
+        return static_cast<msecs_t>(BLOCK_SIZE * 1000000 / SAMPLE_RATE);
+    }
+
+    void setNotes(const std::vector<Note>& notes)
+    {
+        PlaybackEventsMap events;
+        for (const Note& note : notes) {
+            const timestamp_t timestamp = static_cast<timestamp_t>(note.secs * 1000000);
+            const duration_t duration = static_cast<duration_t>(note.durationSecs * 1000000);
+            events[timestamp].emplace_back(NoteEvent(timestamp, duration, 0, 0, note.pitch,
+                                                     mpe::dynamicLevelFromType(DynamicType::Natural), ArticulationMap(), 2.0));
+        }
+
+        m_synth->m_notes = notes;
+
+        if (m_source) {
+            m_playbackData.mainStream.send(events, {}, {});
+        } else {
+            m_playbackData.originEvents = events;
+        }
+    }
+
+    void seek(samples_t frameIdx)
+    {
+        m_source->seek(static_cast<msecs_t>(frameIdx / BLOCK_SIZE) * blockMsecs());
+        m_frame = frameIdx;
+    }
+
+    //! NOTE Plays block by block, returns how many blocks the synthesizer has rendered meanwhile
+    size_t play(samples_t to)
+    {
+        const size_t processedBefore = m_synth->m_processedBlocks;
+
+        std::vector<float> block(BLOCK_SIZE * CHANNELS);
+        for (; m_frame < to; m_frame += BLOCK_SIZE) {
+            const size_t processedBeforeBlock = m_synth->m_processedBlocks;
+            EXPECT_EQ(m_source->process(block.data(), BLOCK_SIZE), BLOCK_SIZE);
+
+            //! NOTE In realtime a block never takes more than a block of the synthesizer
+            EXPECT_LE(m_synth->m_processedBlocks - processedBeforeBlock, 1);
+
+            for (samples_t i = 0; i < BLOCK_SIZE; ++i) {
+                if (block[i * CHANNELS] != m_synth->sample(m_frame + i, 0)) {
+                    ADD_FAILURE() << "unexpected audio at the frame " << m_frame + i;
+                    return m_synth->m_processedBlocks - processedBefore;
+                }
+            }
+        }
+
+        return m_synth->m_processedBlocks - processedBefore;
+    }
+
+    std::shared_ptr<FakeSynth> m_synth;
+    std::shared_ptr<NiceMock<SynthResolverMock> > m_resolver;
+    mpe::PlaybackData m_playbackData;
+    std::shared_ptr<EventAudioSource> m_source;
+    samples_t m_frame = 0;
+};
+}
+
+TEST_F(Audio_EventAudioSourceTest, Process_PlayedAgain_CacheTakesOver)
+{
+    //! [GIVEN] The track is played once
+    EXPECT_GT(play(frame(10.0)), 0);
+
+    //! [WHEN] It is played again
+    seek(0);
+
+    //! [THEN] The synthesizer is not used anymore, the audio is the same
+    EXPECT_EQ(play(frame(10.0)), 0);
+}
+
+TEST_F(Audio_EventAudioSourceTest, Edit_OnlyItsChunksRenderedAgain)
+{
+    play(frame(10.0));
+
+    //! [WHEN] The second note is changed
+    setNotes({ { 0.0, 0.2 }, { 6.0, 0.2, 62 } });
+
+    //! [THEN] The synthesizer renders only where it is heard
+    seek(0);
+    EXPECT_EQ(play(frame(5.0)), 0);
+
+    const size_t rendered = play(frame(10.0));
+    EXPECT_GT(rendered, 0);
+    EXPECT_LT(rendered, (frame(10.0) - frame(5.0)) / BLOCK_SIZE);
+
+    //! [THEN] After that, the cache takes over again
+    seek(0);
+    EXPECT_EQ(play(frame(10.0)), 0);
+}
+
+TEST_F(Audio_EventAudioSourceTest, Seek_IntoNote_NoCatchUp_StoredOnceSettled)
+{
+    //! [GIVEN] A long note, and a short one after it
+    setNotes({ { 0.0, 4.0 }, { 9.0, 0.2 } });
+
+    //! [WHEN] It is played from the middle of the long note, between the chunk boundaries
+    const samples_t seekFrame = frame(2.0) + BLOCK_SIZE;
+    ASSERT_NE(seekFrame % CHUNK_SIZE, 0);
+    seek(seekFrame);
+
+    //! [THEN] The synthesizer plays from the position, a block at a time
+    EXPECT_EQ(play(frame(10.0)), (frame(10.0) - seekFrame) / BLOCK_SIZE);
+
+    //! [WHEN] It is played again from there
+    seek(seekFrame);
+
+    //! [THEN] Nothing is cached while the long note, not started by the synthesizer, may be heard
+    const double settledSecs = 4.0 * 1.001 + TrackFreezeCache::RELEASE_TIME / 1000000.0;
+    EXPECT_EQ(play(frame(settledSecs)), (frame(settledSecs) - seekFrame) / BLOCK_SIZE);
+
+    //! [THEN] The cache takes over from the next chunk boundary
+    const samples_t settledChunkEnd = (frame(settledSecs) / CHUNK_SIZE + 1) * CHUNK_SIZE;
+    EXPECT_EQ(play(settledChunkEnd), (settledChunkEnd - frame(settledSecs)) / BLOCK_SIZE);
+    EXPECT_EQ(play(frame(8.5)), 0);
+}
+
+TEST_F(Audio_EventAudioSourceTest, OffStream_OverCachedChunk_SynthPlaysLive)
+{
+    //! [GIVEN] The track is played once, and again up to a cached chunk
+    play(frame(10.0));
+    seek(0);
+    EXPECT_EQ(play(frame(1.0)), 0);
+
+    //! [WHEN] A note is played at input
+    PlaybackEventsMap offStreamEvents;
+    offStreamEvents[0].emplace_back(NoteEvent(0, 300000, 0, 0, 64, mpe::dynamicLevelFromType(DynamicType::Natural),
+                                              ArticulationMap(), 2.0));
+    m_playbackData.offStream.send(offStreamEvents, {});
+
+    //! [THEN] The synthesizer plays live while the note may be heard, the audio of the track is the same
+    const msecs_t offStreamMsecs = 300000 + TrackFreezeCache::RELEASE_TIME;
+    const size_t offStreamBlocks = static_cast<size_t>((offStreamMsecs + blockMsecs() - 1) / blockMsecs());
+    EXPECT_EQ(play(m_frame + static_cast<samples_t>(offStreamBlocks) * BLOCK_SIZE), offStreamBlocks);
+
+    //! [THEN] After that, the cache takes over again
+    EXPECT_EQ(play(frame(10.0)), 0);
+}
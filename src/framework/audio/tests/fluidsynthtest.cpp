@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "global/modularity/ioc.h"
+#include "concurrency/taskscheduler.h"
+
+#include "internal/audiosanitizer.h"
+#include "internal/synthesizers/fluidsynth/fluidsynth.h"
+
+#include "mocks/audioconfigurationmock.h"
+#include "mocks/midioutportmock.h"
+
+#include "log.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::synth;
+using namespace muse::mpe;
+
+static constexpr unsigned int SAMPLE_RATE = 44100;
+static constexpr samples_t RENDER_STEP = 512;
+static constexpr unsigned int TRACK_COUNT = 2;
+static constexpr double RENDER_SECS = 30.0;
+
+class Audio_FluidSynthTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_configuration = std::make_shared<NiceMock<AudioConfigurationMock> >();
+        m_midiOutPort = std::make_shared<NiceMock<midi::MidiOutPortMock> >();
+
+        modularity::globalIoc()->registerExport<IAudioConfiguration>("utests", m_configuration);
+        modularity::globalIoc()->registerExport<midi::IMidiOutPort>("utests", m_midiOutPort);
+    }
+
+    void TearDown() override
+    {
+        modularity::globalIoc()->unregister<IAudioConfiguration>("utests");
+        modularity::globalIoc()->unregister<midi::IMidiOutPort>("utests");
+    }
+
+    //! NOTE A chord of 8 notes on every beat, in every voice: the voices are on different channels,
+    //! so the voices sound on all the synths of the track
+    static mpe::PlaybackData makeDenseChords(double secs)
+    {
+        constexpr double BPS = 2.0;
+        constexpr duration_t BEAT = 500000;
+
+        mpe::PlaybackData data;
+        data.setupData = PlaybackSetupData(SoundId::Piano, SoundCategory::Keyboards);
+
+        for (timestamp_t timestamp = 0; timestamp < static_cast<timestamp_t>(secs * 1000000); timestamp += BEAT) {
+            for (voice_layer_idx_t voice = 0; voice < 4; ++voice) {
+                for (octave_t octave = 2; octave < 6; ++octave) {
+                    for (PitchClass pitchClass : { PitchClass::C, PitchClass::G }) {
+                        data.originEvents[timestamp].emplace_back(NoteEvent(timestamp, BEAT * 2, voice, 0, pitchLevel(pitchClass, octave),
+                                                                            dynamicLevelFromType(DynamicType::ff),
+                                                                            ArticulationMap(), BPS));
+                    }
+                }
+            }
+        }
+
+        return data;
+    }
+
+    //! NOTE Renders the tracks block by block in parallel, as the mixer does, returns the time in ms
+    double renderOffline(size_t synthInstanceCount, const io::path_t& soundFont)
+    {
+        ON_CALL(*m_configuration, fluidSynthInstanceCount()).WillByDefault(Return(synthInstanceCount));
+
+        const mpe::PlaybackData data = makeDenseChords(RENDER_SECS);
+
+        std::vector<FluidSynthPtr> synths;
+        for (unsigned int i = 0; i < TRACK_COUNT; ++i) {
+            FluidSynthPtr synth = std::make_shared<FluidSynth>(AudioSourceParams());
+            synth->setSampleRate(SAMPLE_RATE);
+            synth->addSoundFonts({ soundFont });
+            synth->setup(data);
+            synth->setPlaybackPosition(0);
+            synth->setIsActive(true);
+            synths.push_back(synth);
+        }
+
+        std::vector<std::vector<float> > buffers(TRACK_COUNT, std::vector<float>(RENDER_STEP * synths.front()->audioChannelsCount()));
+        const size_t blockCount = static_cast<size_t>(RENDER_SECS * SAMPLE_RATE) / RENDER_STEP;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t block = 0; block < blockCount; ++block) {
+            TaskScheduler::instance(ThreadPriority::Realtime)->parallelFor(0, synths.size(), [&](size_t i) {
+                synths[i]->process(buffers[i].data(), RENDER_STEP);
+            });
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::shared_ptr<NiceMock<AudioConfigurationMock> > m_configuration;
+    std::shared_ptr<NiceMock<midi::MidiOutPortMock> > m_midiOutPort;
+};
+
+//! NOTE Not a test, run it by hand with a General MIDI soundfont:
+//! MUSE_TEST_SOUNDFONT=/path/to/MS_Basic.sf3 muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=*FluidSynth*Benchmark*
+TEST_F(Audio_FluidSynthTest, DISABLED_Benchmark_OfflineRender)
+{
+    const char* soundFont = std::getenv("MUSE_TEST_SOUNDFONT");
+    if (!soundFont) {
+        GTEST_SKIP() << "MUSE_TEST_SOUNDFONT is not set";
+    }
+
+    //! NOTE The busy tracks render their synths in a group nested into the parallel tracks
+    const double singleSynthMs = renderOffline(1, soundFont);
+    const double severalSynthsMs = renderOffline(4, soundFont);
+
+    const double renderMs = RENDER_SECS * 1000.0;
+    LOGI() << TRACK_COUNT << " tracks, 1 synth per track: " << singleSynthMs << " ms, " << renderMs / singleSynthMs << "x realtime";
+    LOGI() << TRACK_COUNT << " tracks, 4 synths per track: " << severalSynthsMs << " ms, " << renderMs / severalSynthsMs << "x realtime";
+    LOGI() << "speed-up: " << singleSynthMs / severalSynthsMs << "x";
+}
+
+//! NOTE Not a test, run it by hand with a General MIDI soundfont:
+//! MUSE_TEST_SOUNDFONT=/path/to/MS_Basic.sf3 muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=*FluidSynth*Benchmark*
+TEST_F(Audio_FluidSynthTest, DISABLED_Benchmark_PlaybackStart)
+{
+    const char* soundFont = std::getenv("MUSE_TEST_SOUNDFONT");
+    if (!soundFont) {
+        GTEST_SKIP() << "MUSE_TEST_SOUNDFONT is not set";
+    }
+
+    ON_CALL(*m_configuration, fluidSynthInstanceCount()).WillByDefault(Return(1));
+
+    const mpe::PlaybackData data = makeDenseChords(RENDER_SECS);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto msecsSince = [](std::chrono::steady_clock::time_point from) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count();
+    };
+
+    FluidSynthPtr synth = std::make_shared<FluidSynth>(AudioSourceParams());
+    synth->setSampleRate(SAMPLE_RATE);
+    synth->addSoundFonts({ soundFont });
+    synth->setup(data);
+    synth->setPlaybackPosition(0);
+    synth->setIsActive(true);
+
+    const double setupMs = msecsSince(start);
+
+    //! NOTE The blocks are played in realtime, as the audio driver asks for them, until the first one with sound.
+    //! The samples are preloaded meanwhile, none of the blocks should take longer than the driver gives it
+    const std::chrono::duration<double, std::milli> blockDuration(RENDER_STEP * 1000.0 / SAMPLE_RATE);
+    const size_t blockCount = static_cast<size_t>(RENDER_SECS * SAMPLE_RATE) / RENDER_STEP;
+
+    std::vector<float> buffer(RENDER_STEP * synth->audioChannelsCount());
+    double longestBlockMs = 0.0;
+    double firstSoundMs = -1.0;
+
+    for (size_t block = 0; block < blockCount && firstSoundMs < 0.0; ++block) {
+        const auto blockStart = std::chrono::steady_clock::now();
+        synth->process(buffer.data(), RENDER_STEP);
+        longestBlockMs = std::max(longestBlockMs, msecsSince(blockStart));
+
+        if (std::any_of(buffer.begin(), buffer.end(), [](float sample) { return sample != 0.f; })) {
+            firstSoundMs = msecsSince(start);
+        }
+
+        std::this_thread::sleep_until(blockStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockDuration));
+    }
+
+    LOGI() << "setup: " << setupMs << " ms, first sound: " << firstSoundMs << " ms";
+    LOGI() << "longest block: " << longestBlockMs << " ms, a block lasts " << blockDuration.count() << " ms";
+}
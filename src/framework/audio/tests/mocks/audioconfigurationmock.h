@@ -55,6 +55,8 @@ public:
     // synthesizers
     MOCK_METHOD(AudioInputParams, defaultAudioInputParams, (), (const, override));
 
+    MOCK_METHOD(size_t, fluidSynthInstanceCount, (), (const, override));
+
     MOCK_METHOD(io::paths_t, soundFontDirectories, (), (const, override));
     MOCK_METHOD(io::paths_t, userSoundFontDirectories, (), (const, override));
     MOCK_METHOD(void, setUserSoundFontDirectories, (const io::paths_t&), (override));
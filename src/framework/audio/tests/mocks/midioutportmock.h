@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_AUDIO_MIDIOUTPORTMOCK_H
+#define MUSE_AUDIO_MIDIOUTPORTMOCK_H
+
+#include <gmock/gmock.h>
+
+#include "midi/imidioutport.h"
+
+namespace muse::midi {
+class MidiOutPortMock : public IMidiOutPort
+{
+public:
+    MOCK_METHOD(MidiDeviceList, availableDevices, (), (const, override));
+    MOCK_METHOD(async::Notification, availableDevicesChanged, (), (const, override));
+
+    MOCK_METHOD(Ret, connect, (const MidiDeviceID&), (override));
+    MOCK_METHOD(void, disconnect, (), (override));
+    MOCK_METHOD(bool, isConnected, (), (const, override));
+    MOCK_METHOD(MidiDeviceID, deviceID, (), (const, override));
+    MOCK_METHOD(async::Notification, deviceChanged, (), (const, override));
+
+    MOCK_METHOD(bool, supportsMIDI20Output, (), (const, override));
+
+    MOCK_METHOD(Ret, sendEvent, (const Event&), (override));
+};
+}
+
+#endif // MUSE_AUDIO_MIDIOUTPORTMOCK_H
@@ -0,0 +1,211 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "internal/fx/reverb/reverbprocessor.h"
+#include "internal/fx/reverb/vectorops.h"
+
+#include "log.h"
+
+using namespace muse::audio;
+using namespace muse::audio::fx;
+
+static constexpr unsigned int SAMPLE_RATE = 44100;
+static constexpr audioch_t CHANNELS = 2;
+
+namespace muse::audio {
+class Audio_ReverbProcessorTest : public ::testing::Test
+{
+public:
+    //! NOTE Stereo notes of noteSec seconds, each followed by restSec seconds of silence
+    static std::vector<float> makeSignal(double seconds, double noteSec, double restSec)
+    {
+        const size_t frames = static_cast<size_t>(seconds * SAMPLE_RATE);
+        const size_t period = static_cast<size_t>((noteSec + restSec) * SAMPLE_RATE);
+        const size_t note = static_cast<size_t>(noteSec * SAMPLE_RATE);
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+
+        std::vector<float> signal(frames * CHANNELS, 0.f);
+        for (size_t i = 0; i < frames; ++i) {
+            if (i % period >= note) {
+                continue;
+            }
+
+            const float value = 0.3f * std::sin(0.05f * i) + noise(random);
+            signal[i * CHANNELS] = value;
+            signal[i * CHANNELS + 1] = value;
+        }
+
+        return signal;
+    }
+
+    static std::vector<float> render(std::vector<float> signal, unsigned int blockSize)
+    {
+        ReverbProcessor reverb(AudioFxParams(), CHANNELS);
+        reverb.setSampleRate(SAMPLE_RATE);
+
+        const size_t frames = signal.size() / CHANNELS;
+        for (size_t frame = 0; frame < frames; frame += blockSize) {
+            const unsigned int count = static_cast<unsigned int>(std::min<size_t>(blockSize, frames - frame));
+            reverb.process(signal.data() + frame * CHANNELS, count);
+        }
+
+        return signal;
+    }
+
+    static float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float result = 0.f;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+            result = std::max(result, std::abs(a[i] - b[i]));
+        }
+
+        return result;
+    }
+
+    static float peak(const float* begin, const float* end)
+    {
+        float result = 0.f;
+        for (const float* it = begin; it != end; ++it) {
+            result = std::max(result, std::abs(*it));
+        }
+
+        return result;
+    }
+};
+}
+
+TEST_F(Audio_ReverbProcessorTest, Process_SameOutputForAnyBlockSize)
+{
+    //! [GIVEN] A few notes with short rests
+    const std::vector<float> signal = makeSignal(6.0, 1.0, 0.5);
+
+    //! [WHEN] The notes are rendered with blocks of different sizes
+    const std::vector<float> output = render(signal, 512);
+    const std::vector<float> smallBlocks = render(signal, 100);
+    const std::vector<float> largeBlocks = render(signal, 4096);
+
+    //! [THEN] The reverb is not reset by the change of the block size
+    ASSERT_EQ(output.size(), signal.size());
+    EXPECT_GT(peak(output.data(), output.data() + output.size()), 0.01f);
+    EXPECT_EQ(output, smallBlocks);
+    EXPECT_EQ(output, largeBlocks);
+}
+
+TEST_F(Audio_ReverbProcessorTest, Process_TailBypassedAfterSilence)
+{
+    //! [GIVEN] A note, followed by a rest much longer than the reverb time
+    const double noteSec = 0.5;
+    const double restSec = 15.0;
+    const std::vector<float> signal = makeSignal(2 * (noteSec + restSec), noteSec, restSec);
+
+    //! [WHEN] It is rendered
+    const std::vector<float> output = render(signal, 512);
+
+    //! [THEN] The end of the rests is silent
+    const size_t restEnd = static_cast<size_t>((noteSec + restSec) * SAMPLE_RATE) * CHANNELS;
+    const size_t lastSecond = static_cast<size_t>((noteSec + restSec - 1.0) * SAMPLE_RATE) * CHANNELS;
+    EXPECT_EQ(peak(output.data() + lastSecond, output.data() + restEnd), 0.f);
+    EXPECT_EQ(peak(output.data() + output.size() - SAMPLE_RATE * CHANNELS, output.data() + output.size()), 0.f);
+
+    //! [THEN] The next note sounds as without the bypass, which is invisible at a different block size
+    const std::vector<float> otherBlocks = render(signal, 300);
+    EXPECT_GT(peak(output.data() + restEnd, output.data() + output.size()), 0.01f);
+    EXPECT_LT(maxDifference(output, otherBlocks), 1e-5f);
+}
+
+TEST_F(Audio_ReverbProcessorTest, MultiplyAndSum_SameAsSeparateSums)
+{
+    constexpr int32_t SOURCES = 15;
+    constexpr int32_t MAX_SIZE = 67;
+
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> value(-1.f, 1.f);
+
+    std::vector<std::vector<float> > sources(SOURCES, std::vector<float>(MAX_SIZE));
+    std::vector<const float*> sourcePtrs;
+    std::vector<float> gains;
+    for (std::vector<float>& source : sources) {
+        for (float& sample : source) {
+            sample = value(random);
+        }
+        sourcePtrs.push_back(source.data());
+        gains.push_back(value(random));
+    }
+
+    for (int32_t size = 0; size <= MAX_SIZE; ++size) {
+        //! [GIVEN] The sum done one source after the other
+        std::vector<float> expected(size);
+        vo::constantMultiply(sourcePtrs[0], gains[0], expected.data(), size);
+        for (int32_t i = 1; i < SOURCES; ++i) {
+            vo::constantMultiplyAndAdd(sourcePtrs[i], gains[i], expected.data(), size);
+        }
+
+        //! [WHEN] It is done in one pass, with AVX2 if there is
+        std::vector<float> sum(size);
+        vo::multiplyAndSum(sourcePtrs.data(), gains.data(), SOURCES, sum.data(), size);
+
+        //! [THEN] The results are exactly the same
+        EXPECT_EQ(sum, expected);
+    }
+}
+
+//! NOTE The master bus reverb over the offline render of a 10 minutes score. Disabled by default,
+//! run it with --gtest_also_run_disabled_tests --gtest_filter=*ReverbProcessorTest.DISABLED_*
+TEST_F(Audio_ReverbProcessorTest, DISABLED_Benchmark_OfflineRender)
+{
+    constexpr unsigned int RENDER_STEP = 512;
+
+    struct Case {
+        const char* name = nullptr;
+        double noteSec = 0.0;
+        double restSec = 0.0;
+    };
+
+    const Case cases[] = {
+        { "dense", 4.0, 4.0 },
+        { "sparse", 4.0, 16.0 },
+    };
+
+    for (const Case& c : cases) {
+        std::vector<float> signal = makeSignal(600.0, c.noteSec, c.restSec);
+
+        ReverbProcessor reverb(AudioFxParams(), CHANNELS);
+        reverb.setSampleRate(SAMPLE_RATE);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame + RENDER_STEP <= signal.size() / CHANNELS; frame += RENDER_STEP) {
+            reverb.process(signal.data() + frame * CHANNELS, RENDER_STEP);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        LOGI() << "reverb, 10 min " << c.name << ": " << ms << " ms, " << 600000.0 / ms << "x realtime";
+    }
+}
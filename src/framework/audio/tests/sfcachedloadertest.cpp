@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "internal/synthesizers/fluidsynth/sfcachedloader.h"
+
+using namespace muse;
+using namespace muse::audio::synth;
+
+static constexpr size_t FILE_SIZE = 1000;
+
+class Audio_SfCachedLoaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_path = (std::filesystem::temp_directory_path() / (std::string("sfcachedloadertest_") + info->name() + ".sf2")).string();
+
+        for (size_t i = 0; i < FILE_SIZE; ++i) {
+            m_bytes.push_back(static_cast<char>(i % 251));
+        }
+
+        writeFile(m_path, m_bytes);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(m_path);
+    }
+
+    static void writeFile(const std::string& path, const std::vector<char>& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::string m_path;
+    std::vector<char> m_bytes;
+};
+
+TEST_F(Audio_SfCachedLoaderTest, Map_File_AllBytes)
+{
+    //! [WHEN] The file is mapped
+    std::shared_ptr<SoundFontFile> file = SoundFontFile::map(m_path);
+
+    //! [THEN] All its bytes are there
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file->size(), FILE_SIZE);
+    EXPECT_EQ(std::vector<char>(file->data(), file->data() + file->size()), m_bytes);
+}
+
+TEST_F(Audio_SfCachedLoaderTest, Map_MissingOrEmptyFile_Null)
+{
+    //! [GIVEN] An empty file
+    const std::string emptyPath = m_path + ".empty";
+    writeFile(emptyPath, {});
+
+    //! [THEN] Neither a missing file, nor an empty one can be mapped
+    EXPECT_FALSE(SoundFontFile::map(m_path + ".missing"));
+    EXPECT_FALSE(SoundFontFile::map(emptyPath));
+
+    std::filesystem::remove(emptyPath);
+}
+
+TEST_F(Audio_SfCachedLoaderTest, FileCallbacks_ReadSeekTell)
+{
+    const fluid_file_callbacks_t* callbacks = soundFontFileCallbacks();
+
+    //! [GIVEN] The file is opened as Fluid does
+    void* handle = callbacks->fopen(m_path.c_str());
+    ASSERT_TRUE(handle);
+
+    //! [THEN] It is read from the start
+    char buf[10] = {};
+    EXPECT_EQ(callbacks->fread(buf, 10, handle), FLUID_OK);
+    EXPECT_EQ(std::vector<char>(buf, buf + 10), std::vector<char>(m_bytes.begin(), m_bytes.begin() + 10));
+    EXPECT_EQ(callbacks->ftell(handle), 10);
+
+    //! [WHEN] It is seeked from the current position, and from the end
+    EXPECT_EQ(callbacks->fseek(handle, 5, SEEK_CUR), FLUID_OK);
+    EXPECT_EQ(callbacks->ftell(handle), 15);
+
+    EXPECT_EQ(callbacks->fseek(handle, -4, SEEK_END), FLUID_OK);
+    EXPECT_EQ(callbacks->ftell(handle), static_cast<fluid_long_long_t>(FILE_SIZE - 4));
+
+    //! [THEN] The last bytes are read, the position is at the end
+    EXPECT_EQ(callbacks->fread(buf, 4, handle), FLUID_OK);
+    EXPECT_EQ(std::vector<char>(buf, buf + 4), std::vector<char>(m_bytes.end() - 4, m_bytes.end()));
+    EXPECT_EQ(callbacks->ftell(handle), static_cast<fluid_long_long_t>(FILE_SIZE));
+
+    //! [THEN] Reading past the end, and seeking out of the file fail, the position stays
+    EXPECT_EQ(callbacks->fread(buf, 1, handle), FLUID_FAILED);
+    EXPECT_EQ(callbacks->fseek(handle, 1, SEEK_END), FLUID_FAILED);
+    EXPECT_EQ(callbacks->fseek(handle, -1, SEEK_SET), FLUID_FAILED);
+    EXPECT_EQ(callbacks->fseek(handle, 0, SEEK_END + 1), FLUID_FAILED);
+    EXPECT_EQ(callbacks->ftell(handle), static_cast<fluid_long_long_t>(FILE_SIZE));
+
+    EXPECT_EQ(callbacks->fclose(handle), FLUID_OK);
+}
+
+TEST_F(Audio_SfCachedLoaderTest, FileCallbacks_SeveralStreams_OwnPositions)
+{
+    const fluid_file_callbacks_t* callbacks = soundFontFileCallbacks();
+
+    //! [GIVEN] The file is opened twice, as by two threads
+    void* first = callbacks->fopen(m_path.c_str());
+    void* second = callbacks->fopen(m_path.c_str());
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+
+    //! [WHEN] One of them is seeked
+    EXPECT_EQ(callbacks->fseek(first, 500, SEEK_SET), FLUID_OK);
+
+    //! [THEN] The other one still reads from the start
+    char buf = 0;
+    EXPECT_EQ(callbacks->fread(&buf, 1, second), FLUID_OK);
+    EXPECT_EQ(buf, m_bytes.at(0));
+
+    EXPECT_EQ(callbacks->fread(&buf, 1, first), FLUID_OK);
+    EXPECT_EQ(buf, m_bytes.at(500));
+
+    callbacks->fclose(first);
+    callbacks->fclose(second);
+
+    //! [THEN] A missing file is not opened
+    EXPECT_FALSE(callbacks->fopen((m_path + ".missing").c_str()));
+}
@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "internal/worker/trackfreezecache.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::mpe;
+
+static constexpr unsigned int SAMPLE_RATE = 44100;
+static constexpr audioch_t CHANNELS = 2;
+static constexpr samples_t BLOCK_SIZE = 512;
+static constexpr samples_t CHUNK_SIZE = TrackFreezeCache::CHUNK_SIZE;
+
+namespace muse::audio {
+class Audio_TrackFreezeCacheTest : public ::testing::Test
+{
+public:
+    struct Note {
+        double secs = 0.0;
+        double durationSecs = 0.0;
+        pitch_level_t pitch = 0;
+    };
+
+protected:
+    void SetUp() override
+    {
+        m_params.resourceMeta.id = "GeneralUser GS";
+        m_params.resourceMeta.type = AudioResourceType::FluidSoundfont;
+
+        m_cache.setFormat(m_params, SAMPLE_RATE, CHANNELS);
+    }
+
+    static msecs_t usecs(double secs)
+    {
+        return static_cast<msecs_t>(secs * 1000000);
+    }
+
+    static samples_t frame(double secs)
+    {
+        return static_cast<samples_t>(secs * SAMPLE_RATE);
+    }
+
+    void setNotes(const std::vector<Note>& notes)
+    {
+        m_notes = notes;
+
+        PlaybackEventsMap events;
+        for (const Note& note : notes) {
+            events[usecs(note.secs)].emplace_back(NoteEvent(usecs(note.secs), usecs(note.durationSecs), 0, 0, note.pitch,
+                                                            mpe::dynamicLevelFromType(DynamicType::Natural), ArticulationMap(), 2.0));
+        }
+
+        m_cache.setEvents(events, {}, {});
+    }
+
+    //! NOTE What the synthesizer would render: a signal while the notes are heard, silence between them
+    float sample(samples_t frameIdx, audioch_t channel) const
+    {
+        for (const Note& note : m_notes) {
+            if (frameIdx >= frame(note.secs) && frameIdx < frame(note.secs + note.durationSecs + 0.5)) {
+                return static_cast<float>(note.pitch + frameIdx % 1000 + channel) / 10000.f;
+            }
+        }
+
+        return 0.f;
+    }
+
+    void render(samples_t from, samples_t to)
+    {
+        m_cache.beginRender(from);
+
+        std::vector<float> block(BLOCK_SIZE * CHANNELS);
+        for (samples_t position = from; position < to; position += BLOCK_SIZE) {
+            for (samples_t i = 0; i < BLOCK_SIZE; ++i) {
+                for (audioch_t ch = 0; ch < CHANNELS; ++ch) {
+                    block[i * CHANNELS + ch] = sample(position + i, ch);
+                }
+            }
+
+            m_cache.write(position, block.data(), BLOCK_SIZE);
+        }
+
+        m_cache.endRender();
+    }
+
+    bool readsAsRendered(samples_t from, samples_t to)
+    {
+        std::vector<float> block(BLOCK_SIZE * CHANNELS);
+        for (samples_t position = from; position < to; position += BLOCK_SIZE) {
+            if (!m_cache.read(position, block.data(), BLOCK_SIZE)) {
+                return false;
+            }
+
+            for (samples_t i = 0; i < BLOCK_SIZE; ++i) {
+                for (audioch_t ch = 0; ch < CHANNELS; ++ch) {
+                    if (block[i * CHANNELS + ch] != sample(position + i, ch)) {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    AudioInputParams m_params;
+    TrackFreezeCache m_cache;
+    std::vector<Note> m_notes;
+};
+}
+
+TEST_F(Audio_TrackFreezeCacheTest, Read_AfterRender_SameAudio)
+{
+    //! [GIVEN] Three notes, with rests between them
+    setNotes({ { 0.0, 0.5, 60 }, { 3.0, 0.5, 62 }, { 6.0, 0.5, 64 } });
+
+    //! [GIVEN] Nothing is cached yet
+    EXPECT_EQ(m_cache.nextMissingFrame(0), 0);
+    EXPECT_FALSE(m_cache.isCached(0, BLOCK_SIZE));
+
+    //! [WHEN] The track is rendered
+    render(0, frame(10.0));
+
+    //! [THEN] It is read back as rendered, after the last note too
+    EXPECT_EQ(m_cache.nextMissingFrame(0), TrackFreezeCache::NO_FRAME);
+    EXPECT_TRUE(readsAsRendered(0, frame(20.0)));
+
+    //! [THEN] The silent chunks take no memory
+    const size_t chunkBytes = CHUNK_SIZE * CHANNELS * sizeof(float);
+    EXPECT_GT(m_cache.memoryUsage(), 0);
+    EXPECT_LT(m_cache.memoryUsage(), m_cache.statistic().chunksStored * chunkBytes);
+    EXPECT_EQ(TrackFreezeCache::totalMemoryUsage(), m_cache.memoryUsage());
+
+    m_cache.clear();
+    EXPECT_EQ(TrackFreezeCache::totalMemoryUsage(), 0);
+}
+
+TEST_F(Audio_TrackFreezeCacheTest, SetEvents_EditDropsOnlyItsChunks)
+{
+    setNotes({ { 0.0, 0.5, 60 }, { 3.0, 0.5, 62 }, { 6.0, 0.5, 64 } });
+    render(0, frame(10.0));
+
+    //! [WHEN] The second note is changed
+    setNotes({ { 0.0, 0.5, 60 }, { 3.0, 0.5, 63 }, { 6.0, 0.5, 64 } });
+
+    //! [THEN] Only the chunks where it is heard are missing
+    const samples_t editStart = frame(3.0) / CHUNK_SIZE * CHUNK_SIZE;
+    EXPECT_EQ(m_cache.nextMissingFrame(0), editStart);
+    EXPECT_TRUE(readsAsRendered(0, editStart));
+    EXPECT_TRUE(m_cache.isCached(frame(6.0), frame(10.0) - frame(6.0)));
+
+    //! [THEN] Nothing heard there was started before
+    EXPECT_EQ(m_cache.renderStartFor(editStart), editStart);
+
+    //! [WHEN] They are rendered again
+    const size_t storedBefore = m_cache.statistic().chunksStored;
+    render(editStart, frame(6.0));
+
+    //! [THEN] The whole track is cached, only the missing chunks were stored
+    EXPECT_EQ(m_cache.nextMissingFrame(0), TrackFreezeCache::NO_FRAME);
+    EXPECT_TRUE(readsAsRendered(0, frame(10.0)));
+    EXPECT_LT(m_cache.statistic().chunksStored - storedBefore, frame(3.0) / CHUNK_SIZE);
+}
+
+TEST_F(Audio_TrackFreezeCacheTest, Write_NotesStartedBeforeRender_NotStoredUntilSettled)
+{
+    //! [GIVEN] A long note, with a short one over it
+    setNotes({ { 0.0, 4.0, 48 }, { 1.0, 0.5, 60 }, { 8.0, 0.5, 64 } });
+    render(0, frame(12.0));
+
+    //! [WHEN] The short note is changed
+    setNotes({ { 0.0, 4.0, 48 }, { 1.0, 0.5, 62 }, { 8.0, 0.5, 64 } });
+
+    //! [THEN] The render starts with the long note
+    const samples_t editStart = frame(1.0) / CHUNK_SIZE * CHUNK_SIZE;
+    ASSERT_EQ(m_cache.nextMissingFrame(0), editStart);
+    EXPECT_EQ(m_cache.renderStartFor(editStart), 0);
+
+    //! [WHEN] It is rendered from the edit, without the long note
+    m_cache.beginRender(editStart);
+    const samples_t settledFrame = m_cache.settledFrame();
+    m_cache.endRender();
+    render(editStart, frame(12.0));
+
+    //! [THEN] Nothing is stored until the long note is not heard anymore
+    EXPECT_GT(settledFrame, frame(4.0));
+    EXPECT_EQ(m_cache.nextMissingFrame(0), editStart);
+    EXPECT_FALSE(m_cache.isCached(editStart, frame(3.0) - editStart));
+
+    //! [WHEN] It is rendered from the start of the long note
+    render(0, frame(12.0));
+
+    //! [THEN] The whole track is cached
+    EXPECT_EQ(m_cache.nextMissingFrame(0), TrackFreezeCache::NO_FRAME);
+}
+
+TEST_F(Audio_TrackFreezeCacheTest, SetFormat_Changed_CacheCleared)
+{
+    setNotes({ { 0.0, 0.5, 60 }, { 3.0, 0.5, 62 } });
+    render(0, frame(6.0));
+
+    //! [WHEN] The format is the same
+    m_cache.setFormat(m_params, SAMPLE_RATE, CHANNELS);
+
+    //! [THEN] The audio is kept
+    EXPECT_EQ(m_cache.nextMissingFrame(0), TrackFreezeCache::NO_FRAME);
+
+    //! [WHEN] The sample rate changes
+    m_cache.setFormat(m_params, 48000, CHANNELS);
+    setNotes(m_notes);
+
+    //! [THEN] Everything has to be rendered again
+    EXPECT_EQ(m_cache.memoryUsage(), 0);
+    EXPECT_EQ(m_cache.nextMissingFrame(0), 0);
+}
+
+TEST_F(Audio_TrackFreezeCacheTest, Write_NoSpareBuffer_LeftForLaterRender)
+{
+    //! [GIVEN] A track which is heard all the time, longer than the spare buffers
+    std::vector<Note> notes;
+    for (int i = 0; i < 30; ++i) {
+        notes.push_back({ static_cast<double>(i), 1.0, static_cast<pitch_level_t>(60 + i % 12) });
+    }
+
+    setNotes(notes);
+
+    const samples_t spareFrames = TrackFreezeCache::SPARE_CHUNK_COUNT * CHUNK_SIZE;
+    ASSERT_LT(spareFrames, frame(30.0));
+
+    //! [WHEN] It is rendered
+    render(0, frame(30.0));
+
+    //! [THEN] Only the chunks with a buffer reserved for them are stored
+    const size_t chunkBytes = CHUNK_SIZE * CHANNELS * sizeof(float);
+    EXPECT_EQ(m_cache.memoryUsage(), TrackFreezeCache::SPARE_CHUNK_COUNT * chunkBytes);
+    EXPECT_EQ(m_cache.nextMissingFrame(0), spareFrames);
+    EXPECT_TRUE(readsAsRendered(0, spareFrames));
+
+    //! [WHEN] The buffers are reserved again, and the rest is rendered
+    m_cache.reserveChunks();
+    render(0, frame(30.0));
+
+    //! [THEN] The next chunks are stored
+    EXPECT_EQ(m_cache.nextMissingFrame(0), 2 * spareFrames);
+    EXPECT_TRUE(readsAsRendered(0, 2 * spareFrames));
+}
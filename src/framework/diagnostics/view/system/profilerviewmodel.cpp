@@ -22,9 +22,11 @@
 #include "profilerviewmodel.h"
 
 #include "global/profiler.h"
+#include "global/allocator.h"
 
 #include "log.h"
 
+using namespace muse;
 using namespace muse::diagnostics;
 using namespace muse::profiler;
 
@@ -90,6 +92,36 @@ void ProfilerViewModel::reload()
         m_allList.append(item);
     }
 
+    group = "Object allocators";
+    uint64_t totalUsed = 0;
+    uint64_t totalBytes = 0;
+    for (const ObjectAllocator::Info& info : AllocatorsRegister::instance()->stateInfoList()) {
+        if (info.blockCount == 0) {
+            continue;
+        }
+
+        Item item;
+        item.group = group;
+        item.data = QString("%1 %2: used: %3, free: %4 (cached: %5), blocks: %6, bytes: %7")
+                    .arg(QString::fromStdString(info.module))
+                    .arg(QString::fromStdString(info.name))
+                    .arg(info.usedChunks())
+                    .arg(info.freeChunks)
+                    .arg(info.cachedChunks)
+                    .arg(info.blockCount)
+                    .arg(info.allocatedBytes());
+
+        m_allList.append(item);
+
+        totalUsed += info.usedChunks();
+        totalBytes += info.allocatedBytes();
+    }
+
+    Item total;
+    total.group = group;
+    total.data = QString("Total: used: %1, bytes: %2").arg(totalUsed).arg(totalBytes);
+    m_allList.append(total);
+
     find(m_searchText);
 }
 
@@ -21,8 +21,11 @@
  */
 #include "allocator.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <numeric>
+#include <set>
 #include <sstream>
 
 #include "stringutils.h"
@@ -30,9 +33,12 @@
 
 using namespace muse;
 
-int ObjectAllocator::s_used = 0;
+std::atomic<int> ObjectAllocator::s_used = 0;
+std::atomic<bool> ObjectAllocator::s_threadCacheEnabled = true;
 size_t ObjectAllocator::DEFAULT_BLOCK_SIZE(1024 * 256); // 256 kB
 
+static std::atomic<size_t> s_nextAllocatorId = 0;
+
 static inline size_t align(size_t n)
 {
     return (n + sizeof(intptr_t) - 1) & ~(sizeof(intptr_t) - 1);
@@ -55,8 +61,18 @@ void ObjectAllocator::unused()
 #endif
 }
 
+bool ObjectAllocator::threadCacheEnabled()
+{
+    return s_threadCacheEnabled.load(std::memory_order_relaxed);
+}
+
+void ObjectAllocator::setThreadCacheEnabled(bool enabled)
+{
+    s_threadCacheEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 ObjectAllocator::ObjectAllocator(const char* module, const char* name, destroyer_t dtor)
-    : m_module(module), m_name(name), m_dtor(dtor)
+    : m_module(module), m_name(name), m_id(s_nextAllocatorId.fetch_add(1)), m_dtor(dtor)
 {
     AllocatorsRegister::instance()->reg(this);
 }
@@ -80,6 +96,66 @@ void* ObjectAllocator::alloc(size_t size)
 {
     size = align(size);
 
+    if (threadCacheEnabled()) {
+        ThreadCache::List& list = threadCacheList();
+        if (!list.head) {
+            refillThreadCache(list, size);
+        }
+
+        Chunk* chunk = list.head;
+        list.head = chunk->next;
+        --list.count;
+
+        m_cachedCount.fetch_sub(1, std::memory_order_relaxed);
+        m_statistic.totalAllocatedCount.fetch_add(1, std::memory_order_relaxed);
+
+        return chunk;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Chunk* chunk = takeChunk(size);
+
+    m_statistic.totalAllocatedCount.fetch_add(1, std::memory_order_relaxed);
+
+    return chunk;
+}
+
+void ObjectAllocator::free(void* ptr)
+{
+    Chunk* chunk = reinterpret_cast<Chunk*>(ptr);
+
+    if (threadCacheEnabled()) {
+        ThreadCache::List& list = threadCacheList();
+        chunk->next = list.head;
+        list.head = chunk;
+        ++list.count;
+
+        m_cachedCount.fetch_add(1, std::memory_order_relaxed);
+        m_statistic.totalFreeCount.fetch_add(1, std::memory_order_relaxed);
+
+        //! NOTE Keep a batch for the next allocations, give back the rest
+        if (list.count > 2 * THREAD_CACHE_BATCH) {
+            releaseThreadCache(list, list.count - THREAD_CACHE_BATCH);
+        }
+
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The freed chunk's next pointer points to the
+    // current allocation pointer:
+    chunk->next = m_free;
+
+    // And the allocation pointer is now set
+    // to the returned (free) chunk:
+    m_free = chunk;
+
+    m_statistic.totalFreeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+ObjectAllocator::Chunk* ObjectAllocator::takeChunk(size_t size)
+{
     if (!m_chunkSize) {
         m_chunkSize = size;
     }
@@ -102,26 +178,103 @@ void* ObjectAllocator::alloc(size_t size)
     // this will cause allocation of a new block on the next request:
     m_free = m_free->next;
 
-    m_statistic.totalAllocatedCount++;
-
     return freeChunk;
 }
 
-void ObjectAllocator::free(void* chunk)
+ObjectAllocator::ThreadCache::~ThreadCache()
 {
-    // The freed chunk's next pointer points to the
-    // current allocation pointer:
-    reinterpret_cast<Chunk*>(chunk)->next = m_free;
+    releaseThreadCaches(*this);
+}
 
-    // And the allocation pointer is now set
-    // to the returned (free) chunk:
-    m_free = reinterpret_cast<Chunk*>(chunk);
+void ObjectAllocator::releaseThreadCaches(ThreadCache& cache)
+{
+    AllocatorsRegister* r = AllocatorsRegister::instance();
+    std::lock_guard<std::mutex> lock(r->m_mutex);
+
+    for (ThreadCache::List& list : cache.lists) {
+        if (!list.head) {
+            continue;
+        }
+
+        //! NOTE The allocator may have been destroyed already at the application exit
+        if (std::find(r->m_allocators.cbegin(), r->m_allocators.cend(), list.owner) != r->m_allocators.cend()) {
+            list.owner->releaseThreadCache(list, list.count);
+        }
+    }
+}
+
+ObjectAllocator::ThreadCache::List& ObjectAllocator::threadCacheList()
+{
+    static thread_local ThreadCache cache;
+
+    if (cache.lists.size() <= m_id) {
+        cache.lists.resize(m_id + 1);
+    }
+
+    ThreadCache::List& list = cache.lists[m_id];
+    list.owner = this;
+    return list;
+}
+
+void ObjectAllocator::refillThreadCache(ThreadCache::List& list, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // takes at most one new block
+    Chunk* first = takeChunk(size);
+    Chunk* last = first;
+    size_t count = 1;
+    while (count < THREAD_CACHE_BATCH && m_free) {
+        last->next = m_free;
+        last = m_free;
+        m_free = m_free->next;
+        ++count;
+    }
+
+    last->next = list.head;
+    list.head = first;
+    list.count += count;
 
-    m_statistic.totalFreeCount++;
+    m_cachedCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+void ObjectAllocator::releaseThreadCache(ThreadCache::List& list, size_t count)
+{
+    if (count == 0 || !list.head) {
+        return;
+    }
+
+    count = std::min(count, list.count);
+
+    Chunk* first = list.head;
+    Chunk* last = first;
+    for (size_t i = 1; i < count; ++i) {
+        last = last->next;
+    }
+
+    list.head = last->next;
+    list.count -= count;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        last->next = m_free;
+        m_free = first;
+    }
+
+    m_cachedCount.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void ObjectAllocator::flushThreadCache()
+{
+    ThreadCache::List& list = threadCacheList();
+    releaseThreadCache(list, list.count);
 }
 
 void ObjectAllocator::cleanup()
 {
+    flushThreadCache();
+
+    //! NOTE Not locked: the destructors may delete other objects of this class
     if (m_blocks.empty()) {
         return;
     }
@@ -162,6 +315,81 @@ void ObjectAllocator::cleanup()
     m_free = m_blocks.front().begin;
 }
 
+size_t ObjectAllocator::trim()
+{
+    flushThreadCache();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_blocks.empty()) {
+        return 0;
+    }
+
+    // block indices, sorted by address, to find the block of a chunk
+    std::vector<size_t> order(m_blocks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return m_blocks.at(a).begin < m_blocks.at(b).begin;
+    });
+
+    auto blockIndex = [this, &order](const Chunk* chunk) {
+        auto it = std::upper_bound(order.cbegin(), order.cend(), chunk, [this](const Chunk* c, size_t bi) {
+            return c < m_blocks.at(bi).begin;
+        });
+        assert(it != order.cbegin());
+        return *(--it);
+    };
+
+    std::vector<size_t> freeCounts(m_blocks.size(), 0);
+    for (const Chunk* free = m_free; free; free = free->next) {
+        ++freeCounts[blockIndex(free)];
+    }
+
+    std::vector<bool> releasing(m_blocks.size(), false);
+    bool hasReleasing = false;
+    for (size_t bi = 0; bi < m_blocks.size(); ++bi) {
+        if (freeCounts[bi] == m_blocks.at(bi).chunkCount) {
+            releasing[bi] = true;
+            hasReleasing = true;
+        }
+    }
+
+    if (!hasReleasing) {
+        return 0;
+    }
+
+    // unlink the chunks of the released blocks from the free list
+    Chunk* head = nullptr;
+    Chunk** tail = &head;
+    for (Chunk* free = m_free; free;) {
+        Chunk* next = free->next;
+        if (!releasing[blockIndex(free)]) {
+            *tail = free;
+            tail = &free->next;
+        }
+        free = next;
+    }
+    *tail = nullptr;
+    m_free = head;
+
+    size_t releasedBytes = 0;
+    std::vector<Block> blocks;
+    blocks.reserve(m_blocks.size());
+    for (size_t bi = 0; bi < m_blocks.size(); ++bi) {
+        const Block& b = m_blocks.at(bi);
+        if (releasing[bi]) {
+            releasedBytes += b.chunkCount * b.chunkSize;
+            std::free(b.begin);
+        } else {
+            blocks.push_back(b);
+        }
+    }
+
+    m_blocks = std::move(blocks);
+
+    return releasedBytes;
+}
+
 ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize) const
 {
     size_t blockSize = std::max(DEFAULT_BLOCK_SIZE, chunkSize);
@@ -196,6 +424,8 @@ void* ObjectAllocator::not_supported(const char* info)
 
 ObjectAllocator::Info ObjectAllocator::stateInfo() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     Info info;
     info.module = m_module;
     info.name = m_name;
@@ -214,6 +444,9 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
         free = free->next;
     }
 
+    info.cachedChunks = m_cachedCount.load(std::memory_order_relaxed);
+    info.freeChunks += info.cachedChunks;
+
     return info;
 }
 
@@ -222,16 +455,19 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
 // ============================================
 void AllocatorsRegister::reg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.push_back(a);
 }
 
 void AllocatorsRegister::unreg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.remove(a);
 }
 
 void AllocatorsRegister::cleanupAll(const std::string& module)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     for (ObjectAllocator* a : m_allocators) {
         if (a->module() == module) {
             a->cleanup();
@@ -239,12 +475,37 @@ void AllocatorsRegister::cleanupAll(const std::string& module)
     }
 }
 
+size_t AllocatorsRegister::trimAll(const std::string& module)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t releasedBytes = 0;
+    for (ObjectAllocator* a : m_allocators) {
+        if (a->module() == module) {
+            releasedBytes += a->trim();
+        }
+    }
+    return releasedBytes;
+}
+
+std::vector<ObjectAllocator::Info> AllocatorsRegister::stateInfoList() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<ObjectAllocator::Info> list;
+    list.reserve(m_allocators.size());
+    for (const ObjectAllocator* a : m_allocators) {
+        list.push_back(a->stateInfo());
+    }
+    return list;
+}
+
 #define FORMAT(str, width) muse::strings::leftJustified(str, width)
 #define TITLE(str) FORMAT(std::string(str), 20)
 #define VALUE(val) FORMAT(std::to_string(val), 20)
 
 void AllocatorsRegister::printStatistic(const std::string& title)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     std::stringstream stream;
     stream << "\n\n";
     stream << title << "\n";
@@ -279,6 +540,8 @@ void AllocatorsRegister::printStatistic(const std::string& title)
 
 void AllocatorsRegister::printState(const std::string& title)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     std::stringstream stream;
     stream << "\n\n";
     stream << title << "\n";
@@ -22,9 +22,11 @@
 #ifndef MUSE_GLOBAL_ALLOCATOR_H
 #define MUSE_GLOBAL_ALLOCATOR_H
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <list>
+#include <mutex>
 #include <string>
 
 namespace muse {
@@ -59,6 +61,10 @@ public: \
     } \
 private:
 
+//! NOTE Pool of fixed size chunks for objects of one class.
+//! The allocator is thread-safe: every thread takes chunks from its own cache,
+//! which is refilled from (and returned to) the shared free list in batches,
+//! so the shared lock is taken only once per THREAD_CACHE_BATCH allocations.
 class ObjectAllocator
 {
 public:
@@ -69,14 +75,23 @@ public:
     ~ObjectAllocator();
 
     static size_t DEFAULT_BLOCK_SIZE;
+    static constexpr size_t THREAD_CACHE_BATCH = 32;
 
     const char* module() const;
     const char* name() const;
 
     void* alloc(size_t size);
     void free(void* ptr);
+
+    //! NOTE Destroys all the objects which are still alive.
+    //! Chunks cached by other threads are considered as alive, so it must only be called
+    //! when the objects of this class are not used by other threads
     void cleanup();
 
+    //! NOTE Gives the blocks which contain no alive objects back to the system,
+    //! returns the number of released bytes
+    size_t trim();
+
     template<class T>
     static void destroyer(void* ptr)
     {
@@ -93,7 +108,8 @@ public:
         size_t chunkSize = 0;
         size_t blockCount = 0;
         size_t totalChunks = 0;
-        size_t freeChunks = 0;
+        size_t freeChunks = 0;   // including cached ones
+        size_t cachedChunks = 0; // in the thread caches
 
         uint64_t totalAllocatedCount = 0;
         uint64_t totalFreeCount = 0;
@@ -104,11 +120,15 @@ public:
 
     Info stateInfo() const;
 
-    static bool enabled() { return s_used; }
+    static bool enabled() { return s_used.load(std::memory_order_relaxed) > 0; }
     static void used();
     static void unused();
 
-    static int s_used;
+    static std::atomic<int> s_used;
+
+    static bool threadCacheEnabled();
+    static void setThreadCacheEnabled(bool enabled);
+
 private:
 
     struct Chunk {
@@ -128,19 +148,44 @@ private:
         size_t chunkSize = 0;
     };
 
+    struct ThreadCache {
+        struct List {
+            ObjectAllocator* owner = nullptr;
+            Chunk* head = nullptr;
+            size_t count = 0;
+        };
+
+        ~ThreadCache();
+
+        std::vector<List> lists; // by allocator id
+    };
+
     Block allocateBlock(size_t chunkSize) const;
 
+    Chunk* takeChunk(size_t size);
+    ThreadCache::List& threadCacheList();
+    void refillThreadCache(ThreadCache::List& list, size_t size);
+    void releaseThreadCache(ThreadCache::List& list, size_t count);
+    void flushThreadCache();
+    static void releaseThreadCaches(ThreadCache& cache);
+
+    static std::atomic<bool> s_threadCacheEnabled;
+
     const char* m_module = nullptr;
     const char* m_name = nullptr;
+    const size_t m_id = 0;
     size_t m_chunkSize = 0;
     destroyer_t m_dtor = nullptr;
+
+    mutable std::mutex m_mutex;
     Chunk* m_free = nullptr;
     std::vector<Block> m_blocks;
+    std::atomic<size_t> m_cachedCount = 0;
 
     struct Statistic
     {
-        uint64_t totalAllocatedCount = 0;
-        uint64_t totalFreeCount = 0;
+        std::atomic<uint64_t> totalAllocatedCount = 0;
+        std::atomic<uint64_t> totalFreeCount = 0;
     };
 
     Statistic m_statistic;
@@ -152,19 +197,27 @@ public:
 
     static AllocatorsRegister* instance()
     {
-        static AllocatorsRegister r;
-        return &r;
+        //! NOTE Never destroyed: the thread caches are given back
+        //! at thread exit, which may happen after the static destructors
+        static AllocatorsRegister* r = new AllocatorsRegister();
+        return r;
     }
 
     void reg(ObjectAllocator* a);
     void unreg(ObjectAllocator* a);
 
     void cleanupAll(const std::string& module);
+    size_t trimAll(const std::string& module);
+
+    std::vector<ObjectAllocator::Info> stateInfoList() const;
 
     void printStatistic(const std::string& title);
     void printState(const std::string& title);
 
 private:
+    friend class ObjectAllocator;
+
+    mutable std::mutex m_mutex;
     std::list<ObjectAllocator*> m_allocators;
 };
 }
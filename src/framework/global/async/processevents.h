@@ -34,6 +34,11 @@ inline void onMainThreadInvoke(const std::function<void(const std::function<void
 {
     kors::async::onMainThreadInvoke(f);
 }
+
+inline void enableRingQueue(size_t capacity)
+{
+    kors::async::enableRingQueue(capacity);
+}
 }
 
 #endif // MUSE_ASYNC_PROCESSEVENTS_H
@@ -0,0 +1,143 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_GLOBAL_TASK_H
+#define MUSE_GLOBAL_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace muse {
+//! NOTE Move-only `void()` callable with small buffer storage.
+//! Unlike std::function, functors up to INLINE_SIZE bytes (e.g. a lambda
+//! capturing a few pointers, or a std::packaged_task) are stored in place,
+//! so scheduling them does not touch the heap.
+class Task
+{
+public:
+    static constexpr size_t INLINE_SIZE = 6 * sizeof(void*);
+
+    Task() = default;
+
+    template<typename FuncT, typename = std::enable_if_t<!std::is_same_v<std::decay_t<FuncT>, Task> > >
+    Task(FuncT&& func)
+    {
+        using Functor = std::decay_t<FuncT>;
+
+        if constexpr (isInline<Functor>()) {
+            new (m_storage) Functor(std::forward<FuncT>(func));
+            m_ops = &inlineOps<Functor>;
+        } else {
+            *reinterpret_cast<Functor**>(m_storage) = new Functor(std::forward<FuncT>(func));
+            m_ops = &heapOps<Functor>;
+        }
+    }
+
+    Task(Task&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        reset();
+    }
+
+    explicit operator bool() const
+    {
+        return m_ops != nullptr;
+    }
+
+    void operator()()
+    {
+        m_ops->invoke(m_storage);
+    }
+
+    void reset()
+    {
+        if (m_ops) {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    template<typename Functor>
+    static constexpr bool isInline()
+    {
+        return sizeof(Functor) <= INLINE_SIZE
+               && alignof(Functor) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible_v<Functor>;
+    }
+
+private:
+    struct Ops {
+        void (* invoke)(void* storage);
+        void (* move)(void* dst, void* src);
+        void (* destroy)(void* storage);
+    };
+
+    template<typename Functor>
+    static constexpr Ops inlineOps = {
+        [](void* storage) { (*static_cast<Functor*>(storage))(); },
+        [](void* dst, void* src) {
+            new (dst) Functor(std::move(*static_cast<Functor*>(src)));
+            static_cast<Functor*>(src)->~Functor();
+        },
+        [](void* storage) { static_cast<Functor*>(storage)->~Functor(); }
+    };
+
+    template<typename Functor>
+    static constexpr Ops heapOps = {
+        [](void* storage) { (**static_cast<Functor**>(storage))(); },
+        [](void* dst, void* src) { *static_cast<Functor**>(dst) = *static_cast<Functor**>(src); },
+        [](void* storage) { delete *static_cast<Functor**>(storage); }
+    };
+
+    void moveFrom(Task& other)
+    {
+        m_ops = other.m_ops;
+        if (m_ops) {
+            m_ops->move(m_storage, other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];
+    const Ops* m_ops = nullptr;
+};
+}
+
+#endif // MUSE_GLOBAL_TASK_H
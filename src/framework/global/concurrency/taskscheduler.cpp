@@ -0,0 +1,398 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "taskscheduler.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "log.h"
+
+using namespace muse;
+
+//! NOTE The worker the current thread belongs to, if any
+static thread_local TaskScheduler* s_currentScheduler = nullptr;
+static thread_local size_t s_currentWorkerIdx = 0;
+
+static void applyThreadPriority(ThreadPriority priority)
+{
+    if (priority == ThreadPriority::Normal) {
+        return;
+    }
+
+#ifdef WIN32
+    int winPriority = priority == ThreadPriority::Realtime ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_BELOW_NORMAL;
+    if (!SetThreadPriority(GetCurrentThread(), winPriority)) {
+        LOGW() << "Unable to set thread priority";
+    }
+#elif defined(__APPLE__)
+    qos_class_t qos = priority == ThreadPriority::Realtime ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_UTILITY;
+    if (pthread_set_qos_class_self_np(qos, 0) != 0) {
+        LOGW() << "Unable to set thread QoS class";
+    }
+#else
+    int policy = SCHED_OTHER;
+    sched_param param {};
+
+    if (priority == ThreadPriority::Realtime) {
+        policy = SCHED_FIFO;
+        param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    } else {
+#ifdef SCHED_IDLE
+        policy = SCHED_IDLE;
+#else
+        return;
+#endif
+    }
+
+    //! NOTE Realtime scheduling usually requires privileges, so a failure is expected
+    //! on desktop systems and the thread keeps the default policy
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+        LOGD() << "Unable to change thread scheduling policy";
+    }
+#endif
+}
+
+#ifdef MUSE_TASKSCHEDULER_PTHREAD_MUTEX
+TaskScheduler::QueueMutex::QueueMutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+#endif
+    pthread_mutex_init(&m_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+TaskScheduler::QueueMutex::~QueueMutex()
+{
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void TaskScheduler::QueueMutex::lock()
+{
+    pthread_mutex_lock(&m_mutex);
+}
+
+void TaskScheduler::QueueMutex::unlock()
+{
+    pthread_mutex_unlock(&m_mutex);
+}
+
+#else
+//! NOTE Windows boosts the threads which starve while holding a lock
+TaskScheduler::QueueMutex::QueueMutex() = default;
+TaskScheduler::QueueMutex::~QueueMutex() = default;
+
+void TaskScheduler::QueueMutex::lock()
+{
+    m_mutex.lock();
+}
+
+void TaskScheduler::QueueMutex::unlock()
+{
+    m_mutex.unlock();
+}
+
+#endif
+
+TaskScheduler* TaskScheduler::instance(ThreadPriority priority)
+{
+    switch (priority) {
+    case ThreadPriority::Realtime: {
+        static TaskScheduler s(0, ThreadPriority::Realtime);
+        return &s;
+    }
+    case ThreadPriority::Background: {
+        static TaskScheduler s(0, ThreadPriority::Background);
+        return &s;
+    }
+    case ThreadPriority::Normal:
+        break;
+    }
+
+    static TaskScheduler s;
+    return &s;
+}
+
+TaskScheduler::TaskScheduler(const thread_pool_size_t desiredThreadCount, ThreadPriority priority)
+    : m_threadPoolSize(vaildateThreadPoolCapacity(desiredThreadCount)),
+    m_priority(priority),
+    m_queues(std::make_unique<WorkerQueue[]>(m_threadPoolSize)),
+    m_threadPool(std::make_unique<std::thread[]>(m_threadPoolSize))
+{
+    setupThreads();
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    waitForAllTasksComplete();
+    terminateThreads();
+}
+
+thread_pool_size_t TaskScheduler::threadPoolSize() const
+{
+    return m_threadPoolSize;
+}
+
+ThreadPriority TaskScheduler::priority() const
+{
+    return m_priority;
+}
+
+void TaskScheduler::waitForAllTasksComplete()
+{
+    std::unique_lock<std::mutex> lock(m_finishedMutex);
+    m_taskFinishedCv.wait(lock, [this] { return m_unfinishedTaskCount.load() == 0; });
+}
+
+bool TaskScheduler::runPendingTask()
+{
+    if (m_queuedTaskCount.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Task task;
+    const bool isOwnWorker = s_currentScheduler == this;
+
+    if (isOwnWorker && popTask(s_currentWorkerIdx, task)) {
+        runTask(task);
+        return true;
+    }
+
+    if (stealTask(isOwnWorker ? s_currentWorkerIdx : 0, task)) {
+        runTask(task);
+        return true;
+    }
+
+    return false;
+}
+
+const std::set<std::thread::id>& TaskScheduler::threadIdSet() const
+{
+    return m_threadIdSet;
+}
+
+bool TaskScheduler::containsThread(const std::thread::id& id) const
+{
+    return m_threadIdSet.find(id) != m_threadIdSet.cend();
+}
+
+thread_pool_size_t TaskScheduler::vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount)
+{
+    thread_pool_size_t maxCapacity = std::thread::hardware_concurrency();
+
+    if (maxCapacity <= 1) {
+        return 1;
+    }
+
+    thread_pool_size_t optimalCapacity = maxCapacity / 2;
+
+    if (desiredThreadCount <= 0) {
+        return optimalCapacity;
+    }
+
+    return desiredThreadCount;
+}
+
+void TaskScheduler::setupThreads()
+{
+    m_isActive = true;
+    for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
+        m_threadPool[i] = std::thread(&TaskScheduler::th_workerLoop, this, static_cast<size_t>(i));
+        m_threadIdSet.insert(m_threadPool[i].get_id());
+    }
+}
+
+void TaskScheduler::terminateThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_isActive = false;
+    }
+
+    m_newTaskAvailableCv.notify_all();
+    for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
+        m_threadPool[i].join();
+    }
+}
+
+void TaskScheduler::pushTask(Task&& task)
+{
+    size_t queueIdx = 0;
+    if (s_currentScheduler == this) {
+        queueIdx = s_currentWorkerIdx;
+    } else {
+        queueIdx = m_nextQueueIdx.fetch_add(1, std::memory_order_relaxed) % m_threadPoolSize;
+    }
+
+    m_unfinishedTaskCount.fetch_add(1);
+    m_queuedTaskCount.fetch_add(1);
+
+    WorkerQueue& queue = m_queues[queueIdx];
+    queue.lock.lock();
+    queue.tasks.push_back(std::move(task));
+    queue.lock.unlock();
+
+    //! NOTE Both counters are sequentially consistent: either the sleeping worker
+    //! sees the new task, or we see the worker and wake it up
+    if (m_sleepingWorkerCount.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_newTaskAvailableCv.notify_one();
+    }
+
+    // the same for the threads waiting for a group
+    if (m_waitingHelperCount.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_helperMutex);
+        m_helperCv.notify_all();
+    }
+}
+
+bool TaskScheduler::popTask(size_t queueIdx, Task& task)
+{
+    WorkerQueue& queue = m_queues[queueIdx];
+    queue.lock.lock();
+
+    if (queue.tasks.empty()) {
+        queue.lock.unlock();
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queue.lock.unlock();
+
+    m_queuedTaskCount.fetch_sub(1);
+    return true;
+}
+
+bool TaskScheduler::stealTask(size_t thiefIdx, Task& task)
+{
+    for (size_t i = 1; i <= m_threadPoolSize; ++i) {
+        WorkerQueue& queue = m_queues[(thiefIdx + i) % m_threadPoolSize];
+        queue.lock.lock();
+
+        if (queue.tasks.empty()) {
+            queue.lock.unlock();
+            continue;
+        }
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queue.lock.unlock();
+
+        m_queuedTaskCount.fetch_sub(1);
+        return true;
+    }
+
+    return false;
+}
+
+void TaskScheduler::runTask(Task& task)
+{
+    // a task taken while waiting inside a parallelFor body is not part of that body
+    const size_t parallelForDepth = s_parallelForDepth;
+    s_parallelForDepth = 0;
+
+    task();
+    task.reset();
+
+    s_parallelForDepth = parallelForDepth;
+
+    if (m_unfinishedTaskCount.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        m_taskFinishedCv.notify_all();
+    }
+}
+
+void TaskScheduler::th_workerLoop(size_t workerIdx)
+{
+    s_currentScheduler = this;
+    s_currentWorkerIdx = workerIdx;
+
+    applyThreadPriority(m_priority);
+
+    Task task;
+
+    while (m_isActive) {
+        if (popTask(workerIdx, task) || stealTask(workerIdx, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkerCount.fetch_add(1);
+        m_newTaskAvailableCv.wait(lock, [this] { return m_queuedTaskCount.load() > 0 || !m_isActive; });
+        m_sleepingWorkerCount.fetch_sub(1);
+    }
+}
+
+// ============================
+// TaskGroup
+// ============================
+
+TaskGroup::TaskGroup(TaskScheduler* scheduler)
+    : m_scheduler(scheduler)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void TaskGroup::wait()
+{
+    while (m_pendingCount.load(std::memory_order_acquire) > 0) {
+        if (m_scheduler->runPendingTask()) {
+            continue;
+        }
+
+        //! NOTE Nothing left to help with: the remaining tasks of the group are being
+        //! executed right now. They may push new ones though, so a new task wakes us up too
+        std::unique_lock<std::mutex> lock(m_scheduler->m_helperMutex);
+        m_scheduler->m_waitingHelperCount.fetch_add(1);
+        m_scheduler->m_helperCv.wait(lock, [this] {
+            return m_pendingCount.load() == 0 || m_scheduler->m_queuedTaskCount.load() > 0;
+        });
+        m_scheduler->m_waitingHelperCount.fetch_sub(1);
+    }
+}
+
+void TaskGroup::onTaskFinished()
+{
+    //! NOTE The group may be destroyed as soon as the counter reaches zero
+    TaskScheduler* scheduler = m_scheduler;
+
+    if (m_pendingCount.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(scheduler->m_helperMutex);
+        scheduler->m_helperCv.notify_all();
+    }
+}
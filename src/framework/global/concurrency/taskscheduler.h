@@ -23,183 +23,258 @@
 #ifndef MUSE_GLOBAL_TASKCHEDULER_H
 #define MUSE_GLOBAL_TASKCHEDULER_H
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <deque>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <atomic>
-#include <queue>
+#include <set>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
-#include "log.h"
+#if !defined(WIN32)
+#include <pthread.h>
+#define MUSE_TASKSCHEDULER_PTHREAD_MUTEX
+#endif
+
+#include "task.h"
 
 namespace muse {
 typedef std::invoke_result_t<decltype(std::thread::hardware_concurrency)> thread_pool_size_t;
 
+enum class ThreadPriority {
+    Realtime,   // audio rendering, must not be preempted by ordinary work
+    Normal,
+    Background  // long-running jobs which must not disturb the UI or the audio
+};
+
+//! NOTE Work-stealing thread pool.
+//! Every worker owns a task deque: tasks pushed from a worker go to its own deque
+//! and are taken back in LIFO order, idle workers steal from the other end of
+//! the deques of their neighbours. Tasks pushed from other threads are
+//! distributed between the deques round-robin, so there is no global queue lock.
 class TaskScheduler
 {
 public:
 
     //!Note Would be moved into globalmodule.cpp for better lifetime control
-    static TaskScheduler* instance()
-    {
-        static TaskScheduler s;
-        return &s;
-    }
+    static TaskScheduler* instance(ThreadPriority priority = ThreadPriority::Normal);
 
-    explicit TaskScheduler(const thread_pool_size_t desiredThreadCount = 0)
-        : m_threadPoolSize(vaildateThreadPoolCapacity(desiredThreadCount)),
-        m_threadPool(std::make_unique<std::thread[]>(vaildateThreadPoolCapacity(desiredThreadCount)))
-    {
-        setupThreads();
-    }
+    explicit TaskScheduler(const thread_pool_size_t desiredThreadCount = 0, ThreadPriority priority = ThreadPriority::Normal);
+    ~TaskScheduler();
 
-    ~TaskScheduler()
-    {
-        waitForAllTasksComplete();
-        terminateThreads();
-    }
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
 
-    thread_pool_size_t threadPoolSize() const
-    {
-        return m_threadPoolSize;
-    }
+    thread_pool_size_t threadPoolSize() const;
+    ThreadPriority priority() const;
 
     template<typename FuncT, typename ... ArgsT>
     void push(FuncT&& task, ArgsT&&... args)
     {
-        std::function<void()> taskFunctor = std::bind(std::forward<FuncT>(task), std::forward<ArgsT>(args)...);
-        {
-            const std::lock_guard lock(m_mutex);
-            m_taskQueue.push(taskFunctor);
+        if constexpr (sizeof...(ArgsT) == 0) {
+            pushTask(Task(std::forward<FuncT>(task)));
+        } else {
+            pushTask(Task([func = std::forward<FuncT>(task), argsTuple = std::make_tuple(std::forward<ArgsT>(args)...)]() mutable {
+                std::apply(func, argsTuple);
+            }));
         }
-        m_newTaskAvailableCv.notify_one();
     }
 
     template<typename FuncT, typename ... ArgsT, typename ReturnT = std::invoke_result_t<std::decay_t<FuncT>, std::decay_t<ArgsT>...> >
     std::future<ReturnT> submit(FuncT&& task, ArgsT&&... args)
     {
-        std::function<ReturnT()> taskFunctor = std::bind(std::forward<FuncT>(task), std::forward<ArgsT>(args)...);
-        std::shared_ptr<std::promise<ReturnT> > promise = std::make_shared<std::promise<ReturnT> >();
-        push([taskFunctor, promise] {
-            try {
-                if constexpr (std::is_void_v<ReturnT>) {
-                    std::invoke(taskFunctor);
-                    promise->set_value();
-                } else {
-                    promise->set_value(std::invoke(taskFunctor));
-                }
-            } catch (...) {
-                try {
-                    promise->set_exception(std::current_exception());
-                } catch (...) {
-                    LOGE() << "Unable to schedule a task";
-                }
-            }
+        std::packaged_task<ReturnT()> packagedTask(
+            [func = std::forward<FuncT>(task), argsTuple = std::make_tuple(std::forward<ArgsT>(args)...)]() mutable -> ReturnT {
+            return std::apply(func, argsTuple);
         });
 
-        return promise->get_future();
-    }
+        std::future<ReturnT> future = packagedTask.get_future();
+        pushTask(Task(std::move(packagedTask)));
 
-    void waitForAllTasksComplete()
-    {
-        m_isWaitingForAllTasksDone = true;
-        std::unique_lock<std::mutex> tasks_lock(m_mutex);
-        m_taskFinishedCv.wait(tasks_lock, [this] { return m_taskQueue.empty(); });
-        m_isWaitingForAllTasksDone = false;
+        return future;
     }
 
-    const std::set<std::thread::id>& threadIdSet() const
-    {
-        static std::set<std::thread::id> result;
+    //! NOTE Runs func(i) for every i in [begin, end), splitting the range into chunks
+    //! of at least grainSize indices. The calling thread takes part in the work
+    //! and the call returns when all the chunks are done.
+    template<typename FuncT>
+    void parallelFor(size_t begin, size_t end, FuncT&& func, size_t grainSize = 1);
 
-        if (result.empty()) {
-            for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-                result.insert(m_threadPool[i].get_id());
-            }
-        }
+    //! NOTE Whether the calling thread runs the body of a parallelFor.
+    //! Work that is already split between the threads should not be split again
+    static bool isInParallelFor();
 
-        return result;
-    }
+    void waitForAllTasksComplete();
 
-    bool containsThread(const std::thread::id& id) const
-    {
-        const auto& idSet = threadIdSet();
-        return idSet.find(id) != idSet.cend();
-    }
+    //! NOTE Executes one queued task on the calling thread, if there is any.
+    //! Used by waiting threads to help instead of blocking.
+    bool runPendingTask();
+
+    const std::set<std::thread::id>& threadIdSet() const;
+    bool containsThread(const std::thread::id& id) const;
 
 private:
-    void setupThreads()
+    //! NOTE Marks the calling thread as running a parallelFor body while it exists.
+    //! Only the chunks of the body are marked: a task run while waiting for them is not
+    class ParallelForScope
     {
-        m_isActive = true;
-        for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-            m_threadPool[i] = std::thread(&TaskScheduler::th_workerLoop, this);
-        }
-    }
+    public:
+        ParallelForScope() { ++s_parallelForDepth; }
+        ~ParallelForScope() { --s_parallelForDepth; }
+    };
 
-    void terminateThreads()
-    {
-        m_isActive = false;
-        m_newTaskAvailableCv.notify_all();
-        for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-            m_threadPool[i].join();
-        }
-    }
+    static inline thread_local size_t s_parallelForDepth = 0;
 
-    thread_pool_size_t vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount)
+    //! NOTE The realtime workers must not spin on a lock held by a thread they preempt,
+    //! so the holder inherits the priority of the waiting thread where the OS supports it
+    class QueueMutex
     {
-        thread_pool_size_t maxCapacity = std::thread::hardware_concurrency();
+    public:
+        QueueMutex();
+        ~QueueMutex();
 
-        if (maxCapacity <= 1) {
-            return 1;
-        }
+        QueueMutex(const QueueMutex&) = delete;
+        QueueMutex& operator=(const QueueMutex&) = delete;
 
-        thread_pool_size_t optimalCapacity = maxCapacity / 2;
+        void lock();
+        void unlock();
 
-        if (desiredThreadCount <= 0) {
-            return optimalCapacity;
-        }
+    private:
+#ifdef MUSE_TASKSCHEDULER_PTHREAD_MUTEX
+        pthread_mutex_t m_mutex;
+#else
+        std::mutex m_mutex;
+#endif
+    };
 
-        return desiredThreadCount;
-    }
+    struct WorkerQueue {
+        QueueMutex lock;
+        std::deque<Task> tasks;
+    };
 
-    void th_workerLoop()
-    {
-        while (m_isActive) {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_newTaskAvailableCv.wait(lock, [this] { return !m_taskQueue.empty() || !m_isActive; });
-
-            if (!m_isActive) {
-                return;
-            }
+    static thread_pool_size_t vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount);
 
-            std::function<void()> task = m_taskQueue.front();
-            m_taskQueue.pop();
+    void setupThreads();
+    void terminateThreads();
 
-            lock.unlock();
+    void pushTask(Task&& task);
+    bool popTask(size_t queueIdx, Task& task);
+    bool stealTask(size_t thiefIdx, Task& task);
+    void runTask(Task& task);
 
-            task();
-
-            if (m_isWaitingForAllTasksDone) {
-                m_taskFinishedCv.notify_one();
-            }
-        }
-    }
+    void th_workerLoop(size_t workerIdx);
 
     std::atomic<bool> m_isActive = false;
-    std::atomic<bool> m_isWaitingForAllTasksDone = false;
 
-    mutable std::mutex m_mutex;
+    std::atomic<size_t> m_queuedTaskCount = 0;
+    std::atomic<size_t> m_unfinishedTaskCount = 0;
+    std::atomic<size_t> m_sleepingWorkerCount = 0;
+    std::atomic<size_t> m_nextQueueIdx = 0;
+
+    std::mutex m_sleepMutex;
     std::condition_variable m_newTaskAvailableCv;
+
+    std::mutex m_finishedMutex;
     std::condition_variable m_taskFinishedCv;
-    std::queue<std::function<void()> > m_taskQueue;
+
+    //! NOTE Threads waiting for a TaskGroup are woken up when the group is done
+    //! or when there is a new task they can help with
+    friend class TaskGroup;
+    std::atomic<size_t> m_waitingHelperCount = 0;
+    std::mutex m_helperMutex;
+    std::condition_variable m_helperCv;
 
     thread_pool_size_t m_threadPoolSize = 0;
+    ThreadPriority m_priority = ThreadPriority::Normal;
+    std::unique_ptr<WorkerQueue[]> m_queues = nullptr;
     std::unique_ptr<std::thread[]> m_threadPool = nullptr;
+    std::set<std::thread::id> m_threadIdSet;
 };
+
+//! NOTE Fork/join primitive: tasks started with run() are executed by the scheduler,
+//! wait() returns when all of them are done. While waiting, the calling thread
+//! executes queued tasks itself, so groups can be nested inside worker tasks.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler* scheduler = TaskScheduler::instance());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename FuncT>
+    void run(FuncT&& func)
+    {
+        m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+        m_scheduler->push([this, func = std::forward<FuncT>(func)]() mutable {
+            func();
+            onTaskFinished();
+        });
+    }
+
+    void wait();
+
+private:
+    void onTaskFinished();
+
+    TaskScheduler* m_scheduler = nullptr;
+    std::atomic<size_t> m_pendingCount = 0;
+};
+
+template<typename FuncT>
+void TaskScheduler::parallelFor(size_t begin, size_t end, FuncT&& func, size_t grainSize)
+{
+    if (begin >= end) {
+        return;
+    }
+
+    const size_t count = end - begin;
+    const size_t maxChunkCount = static_cast<size_t>(m_threadPoolSize) + 1; // + the calling thread
+    const size_t chunkSize = std::max(std::max(grainSize, size_t(1)), (count + maxChunkCount - 1) / maxChunkCount);
+
+    if (chunkSize >= count) {
+        ParallelForScope scope;
+        for (size_t i = begin; i < end; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    TaskGroup group(this);
+
+    size_t chunkBegin = begin + chunkSize; // the first chunk is done by the calling thread
+    while (chunkBegin < end) {
+        const size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+        group.run([&func, chunkBegin, chunkEnd]() {
+            ParallelForScope chunkScope;
+            for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+                func(i);
+            }
+        });
+        chunkBegin = chunkEnd;
+    }
+
+    {
+        ParallelForScope scope;
+        for (size_t i = begin; i < begin + chunkSize; ++i) {
+            func(i);
+        }
+    }
+
+    group.wait();
+}
+
+inline bool TaskScheduler::isInParallelFor()
+{
+    return s_parallelForDepth > 0;
+}
 }
 
 #endif // MUSE_GLOBAL_TASKCHEDULER_H
@@ -204,6 +204,11 @@ void GlobalModule::onPreInit(const IApplication::RunMode& mode)
     Profiler* profiler = Profiler::instance();
     profiler->setup(profOpt, new MyPrinter());
 
+    if (!m_traceOutputPath.empty()) {
+        TraceRecorder::instance()->start();
+        LOGI() << "trace recording started, output: " << m_traceOutputPath;
+    }
+
     //! --- Setup Invoker ---
 
     Invoker::setup();
@@ -238,6 +243,14 @@ void GlobalModule::onInit(const IApplication::RunMode&)
 void GlobalModule::onDeinit()
 {
     invokeQueuedCalls();
+
+    if (!m_traceOutputPath.empty()) {
+        using namespace muse::profiler;
+        TraceRecorder::instance()->stop();
+        if (!TraceRecorder::instance()->save(m_traceOutputPath.toStdString())) {
+            LOGE() << "failed to write trace: " << m_traceOutputPath;
+        }
+    }
 }
 
 void GlobalModule::invokeQueuedCalls()
@@ -249,3 +262,8 @@ void GlobalModule::setLoggerLevel(const muse::logger::Level& level)
 {
     m_loggerLevel = level;
 }
+
+void GlobalModule::setTraceOutputPath(const io::path_t& path)
+{
+    m_traceOutputPath = path;
+}
@@ -54,12 +54,14 @@ public:
     static void invokeQueuedCalls();
 
     void setLoggerLevel(const muse::logger::Level& level);
+    void setTraceOutputPath(const io::path_t& path);
 
 private:
     std::shared_ptr<GlobalConfiguration> m_configuration;
     std::shared_ptr<SystemInfo> m_systemInfo;
 
     std::optional<muse::logger::Level> m_loggerLevel;
+    io::path_t m_traceOutputPath;
 
     static std::shared_ptr<Invoker> s_asyncInvoker;
 };
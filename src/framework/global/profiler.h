@@ -26,6 +26,7 @@
 
 namespace muse::profiler {
 using Profiler = kors::profiler::Profiler;
+using TraceRecorder = kors::profiler::TraceRecorder;
 }
 
 #endif // MU_PROFILER_H
@@ -21,6 +21,8 @@
  */
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "allocator.h"
 
 #include "log.h"
@@ -196,3 +198,70 @@ TEST_F(Global_AllocatorTests, Many_NewCleanup)
     EXPECT_EQ(info.totalChunks, 12); // DEFAULT_BLOCK_SIZE * 3
     EXPECT_EQ(info.freeChunks, 12);
 }
+
+TEST_F(Global_AllocatorTests, Many_NewDeleteTrim)
+{
+    //! GIVEN the default size of the allocator block is less than the size of all items
+    size_t itemSize = sizeof(Item13);
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = itemSize * 4;  // bytes
+
+    //! DO Create Items (more then one block size)
+    std::vector<ItemBase*> items;
+    for (size_t i = 0; i < 10; ++i) {
+        items.push_back(new Item13(static_cast<uint8_t>(i)));
+    }
+
+    //! DO Destroy all but the last Item
+    for (size_t i = 0; i < items.size() - 1; ++i) {
+        delete items.at(i);
+    }
+
+    //! DO Give the free blocks back
+    size_t releasedBytes = Item13::allocator().trim();
+
+    //! CHECK Only the block of the alive Item is left
+    ObjectAllocator::Info info = Item13::allocator().stateInfo();
+    EXPECT_EQ(info.blockCount, 1);
+    EXPECT_EQ(info.usedChunks(), 1);
+    EXPECT_EQ(releasedBytes, info.chunkSize * 8);
+
+    //! DO Destroy the last Item
+    delete items.back();
+    Item13::allocator().trim();
+
+    //! CHECK
+    info = Item13::allocator().stateInfo();
+    EXPECT_EQ(info.blockCount, 0);
+    EXPECT_EQ(info.totalChunks, 0);
+}
+
+TEST_F(Global_AllocatorTests, Many_NewDeleteConcurrent)
+{
+    //! GIVEN the default size of the allocator block is less than the size of all items
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = sizeof(Item8) * 64;  // bytes
+
+    //! DO Create and destroy Items from several threads at the same time
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            std::vector<ItemBase*> items;
+            for (int i = 0; i < 256; ++i) {
+                items.push_back(new Item8(static_cast<uint8_t>(i)));
+            }
+
+            for (ItemBase* item : items) {
+                EXPECT_TRUE(item->alive());
+                delete item;
+            }
+        });
+    }
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    //! CHECK All the chunks are free, the thread caches are given back
+    ObjectAllocator::Info info = Item8::allocator().stateInfo();
+    EXPECT_EQ(info.usedChunks(), 0);
+    EXPECT_EQ(info.cachedChunks, 0);
+}
@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "async/asyncable.h"
+#include "async/channel.h"
+#include "async/processevents.h"
+#include "thirdparty/kors_async/async/internal/queuedinvoker.h"
+
+#include "log.h"
+
+using namespace muse;
+
+class Global_Async_QueueTests : public ::testing::Test
+{
+public:
+};
+
+namespace {
+struct Message {
+    int sender = 0;
+    int index = 0;
+    std::vector<int> payload;
+};
+}
+
+TEST_F(Global_Async_QueueTests, RingQueue_KeepsOrderUnderLoad)
+{
+    // [GIVEN] A receiver thread with small rings, so that they overflow now and then
+    constexpr int SENDER_COUNT = 2;
+    constexpr int MESSAGE_COUNT = 20000;
+    constexpr size_t RING_CAPACITY = 64;
+    constexpr size_t PAYLOAD_SIZE = 256;
+
+    async::Channel<Message> channel;
+
+    std::atomic<bool> receiverReady = false;
+    std::atomic<bool> sendersDone = false;
+
+    std::vector<int> received(SENDER_COUNT, 0);
+    bool inOrder = true;
+    bool payloadIntact = true;
+    std::chrono::nanoseconds worstDrainTime { 0 };
+
+    std::thread receiver([&]() {
+        async::enableRingQueue(RING_CAPACITY);
+
+        async::Asyncable asyncable;
+        channel.onReceive(&asyncable, [&](const Message& msg) {
+            inOrder = inOrder && msg.index == received[msg.sender];
+            payloadIntact = payloadIntact && msg.payload.size() == PAYLOAD_SIZE && msg.payload.back() == msg.index;
+            received[msg.sender]++;
+        });
+
+        receiverReady = true;
+
+        auto allReceived = [&]() {
+            for (int count : received) {
+                if (count < MESSAGE_COUNT) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        while (!allReceived()) {
+            auto start = std::chrono::steady_clock::now();
+            async::processEvents();
+            worstDrainTime = std::max(worstDrainTime, std::chrono::steady_clock::now() - start);
+
+            if (sendersDone && !allReceived()) {
+                std::this_thread::yield();
+            }
+        }
+
+        channel.resetOnReceive(&asyncable);
+    });
+
+    while (!receiverReady) {
+        std::this_thread::yield();
+    }
+
+    // [WHEN] Several threads send a lot of messages with a payload, in bursts, as heavy editing does
+    std::vector<std::thread> senders;
+    for (int s = 0; s < SENDER_COUNT; ++s) {
+        senders.emplace_back([&channel, s]() {
+            for (int i = 0; i < MESSAGE_COUNT; ++i) {
+                Message msg;
+                msg.sender = s;
+                msg.index = i;
+                msg.payload.assign(PAYLOAD_SIZE, i);
+                channel.send(std::move(msg));
+
+                if (i % 1000 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        });
+    }
+
+    for (std::thread& sender : senders) {
+        sender.join();
+    }
+    sendersDone = true;
+
+    receiver.join();
+
+    // [THEN] Every message of every sender is received once, in order, with its payload
+    for (int count : received) {
+        EXPECT_EQ(count, MESSAGE_COUNT);
+    }
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(payloadIntact);
+
+    LOGI() << "worst drain time: " << std::chrono::duration_cast<std::chrono::microseconds>(worstDrainTime).count() << " us";
+}
+
+TEST_F(Global_Async_QueueTests, RingQueue_ExitedSendersReleased)
+{
+    // [GIVEN] A receiver thread with rings
+    constexpr int SENDER_COUNT = 50;
+    constexpr int MESSAGE_COUNT = 10;
+
+    async::Channel<int> channel;
+
+    std::atomic<bool> receiverReady = false;
+    std::atomic<bool> sendersDone = false;
+    std::atomic<int> received = 0;
+    size_t ringCount = 0;
+
+    std::thread receiver([&]() {
+        async::enableRingQueue(16);
+
+        async::Asyncable asyncable;
+        channel.onReceive(&asyncable, [&](int) {
+            received++;
+        });
+
+        receiverReady = true;
+
+        while (!sendersDone || received < SENDER_COUNT * MESSAGE_COUNT) {
+            async::processEvents();
+            std::this_thread::yield();
+        }
+
+        // the rings of the exited senders are released once they are processed
+        async::processEvents();
+        ringCount = kors::async::QueuedInvoker::instance()->ringCount();
+
+        channel.resetOnReceive(&asyncable);
+    });
+
+    while (!receiverReady) {
+        std::this_thread::yield();
+    }
+
+    // [WHEN] Short-lived threads send a few messages each, one after another
+    for (int s = 0; s < SENDER_COUNT; ++s) {
+        std::thread sender([&channel]() {
+            for (int i = 0; i < MESSAGE_COUNT; ++i) {
+                channel.send(i);
+            }
+        });
+        sender.join();
+    }
+    sendersDone = true;
+
+    receiver.join();
+
+    // [THEN] Every message is received, and no ring is left behind
+    EXPECT_EQ(received.load(), SENDER_COUNT * MESSAGE_COUNT);
+    EXPECT_EQ(ringCount, 0);
+}
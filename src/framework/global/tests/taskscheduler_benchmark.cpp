@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+
+#include "concurrency/taskscheduler.h"
+
+#include "log.h"
+
+using namespace muse;
+
+//! NOTE Micro-benchmarks of the task scheduler. They are disabled by default,
+//! run them with --gtest_also_run_disabled_tests --gtest_filter=*TaskSchedulerBenchmark*
+
+namespace {
+//! NOTE The previous scheduler design: a single mutex-protected queue of std::function
+class GlobalQueuePool
+{
+public:
+    explicit GlobalQueuePool(size_t threadCount)
+    {
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~GlobalQueuePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isActive = false;
+        }
+        m_cv.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    void push(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push(std::move(task));
+            m_unfinished++;
+        }
+        m_cv.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCv.wait(lock, [this]() { return m_unfinished == 0; });
+    }
+
+private:
+    void workerLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this]() { return !m_queue.empty() || !m_isActive; });
+            if (!m_isActive) {
+                return;
+            }
+
+            std::function<void()> task = std::move(m_queue.front());
+            m_queue.pop();
+            lock.unlock();
+            task();
+            lock.lock();
+
+            if (--m_unfinished == 0) {
+                m_doneCv.notify_all();
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_doneCv;
+    std::queue<std::function<void()> > m_queue;
+    size_t m_unfinished = 0;
+    bool m_isActive = true;
+    std::vector<std::thread> m_threads;
+};
+
+template<typename Func>
+double measureMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+constexpr size_t THREAD_COUNT = 4;
+constexpr size_t TASK_COUNT = 200000;
+
+//! NOTE Roughly the work of processing one short audio block
+void doSomeWork(std::atomic<uint64_t>& sink)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 64; ++i) {
+        value += static_cast<uint64_t>(i) * 2654435761u;
+    }
+    sink.fetch_add(value, std::memory_order_relaxed);
+}
+}
+
+class Global_Concurrency_TaskSchedulerBenchmark : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_Concurrency_TaskSchedulerBenchmark, DISABLED_PushThroughput)
+{
+    std::atomic<uint64_t> sink = 0;
+
+    double globalQueueMs = 0;
+    {
+        GlobalQueuePool pool(THREAD_COUNT);
+        globalQueueMs = measureMs([&]() {
+            for (size_t i = 0; i < TASK_COUNT; ++i) {
+                pool.push([&sink]() { doSomeWork(sink); });
+            }
+            pool.wait();
+        });
+    }
+
+    double workStealingMs = 0;
+    {
+        TaskScheduler scheduler(THREAD_COUNT);
+        workStealingMs = measureMs([&]() {
+            for (size_t i = 0; i < TASK_COUNT; ++i) {
+                scheduler.push([&sink]() { doSomeWork(sink); });
+            }
+            scheduler.waitForAllTasksComplete();
+        });
+    }
+
+    LOGI() << "push " << TASK_COUNT << " tasks: global queue " << globalQueueMs << " ms, "
+           << "work stealing " << workStealingMs << " ms";
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerBenchmark, DISABLED_SubmitVsTaskGroup)
+{
+    //! NOTE Simulates the mixer: a few dozen channels per block, many blocks
+    constexpr size_t BLOCK_COUNT = 5000;
+    constexpr size_t CHANNEL_COUNT = 32;
+
+    std::atomic<uint64_t> sink = 0;
+    TaskScheduler scheduler(THREAD_COUNT);
+
+    double futuresMs = measureMs([&]() {
+        std::vector<std::future<void> > futures;
+        for (size_t block = 0; block < BLOCK_COUNT; ++block) {
+            futures.clear();
+            for (size_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+                futures.push_back(scheduler.submit([&sink]() { doSomeWork(sink); }));
+            }
+            for (std::future<void>& future : futures) {
+                future.get();
+            }
+        }
+    });
+
+    double parallelForMs = measureMs([&]() {
+        for (size_t block = 0; block < BLOCK_COUNT; ++block) {
+            scheduler.parallelFor(0, CHANNEL_COUNT, [&sink](size_t) { doSomeWork(sink); });
+        }
+    });
+
+    LOGI() << BLOCK_COUNT << " blocks of " << CHANNEL_COUNT << " channels: submit/future " << futuresMs << " ms, "
+           << "parallelFor " << parallelForMs << " ms";
+}
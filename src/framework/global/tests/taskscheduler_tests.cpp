@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "concurrency/taskscheduler.h"
+
+using namespace muse;
+
+class Global_Concurrency_TaskSchedulerTests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, TaskInlineAndHeapStorage)
+{
+    // [GIVEN] A small functor and a functor which does not fit the inline buffer
+    int counter = 0;
+    std::array<char, Task::INLINE_SIZE * 2> big {};
+    big[0] = 1;
+
+    auto smallFunc = [&counter]() { counter += 1; };
+    auto largeFunc = [&counter, big]() { counter += 10 * big[0]; };
+
+    EXPECT_TRUE(Task::isInline<decltype(smallFunc)>());
+    EXPECT_FALSE(Task::isInline<decltype(largeFunc)>());
+
+    Task small(smallFunc);
+    Task large(largeFunc);
+
+    // [WHEN] The tasks are moved around and executed
+    Task movedSmall = std::move(small);
+    Task movedLarge;
+    movedLarge = std::move(large);
+
+    movedSmall();
+    movedLarge();
+
+    // [THEN] Both have been executed once and the moved-from tasks are empty
+    EXPECT_EQ(counter, 11);
+    EXPECT_FALSE(static_cast<bool>(small));
+    EXPECT_FALSE(static_cast<bool>(large));
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, PushAndWait)
+{
+    // [GIVEN] A scheduler
+    TaskScheduler scheduler(4);
+
+    // [WHEN] Many tasks are pushed, with and without arguments
+    std::atomic<int> sum = 0;
+    for (int i = 0; i < 1000; ++i) {
+        scheduler.push([&sum]() { sum += 1; });
+        scheduler.push([&sum](int value) { sum += value; }, 2);
+    }
+
+    scheduler.waitForAllTasksComplete();
+
+    // [THEN] All of them have been executed
+    EXPECT_EQ(sum.load(), 3000);
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, Submit)
+{
+    // [GIVEN] A scheduler
+    TaskScheduler scheduler(2);
+
+    // [WHEN] Tasks with a result are submitted
+    std::future<int> result = scheduler.submit([](int a, int b) { return a * b; }, 6, 7);
+    std::future<void> voidResult = scheduler.submit([]() {});
+    std::future<int> failed = scheduler.submit([]() -> int { throw std::runtime_error("error"); });
+
+    // [THEN] The results and the exceptions are delivered through the futures
+    EXPECT_EQ(result.get(), 42);
+    voidResult.get();
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor)
+{
+    // [GIVEN] A scheduler and a range of values
+    TaskScheduler scheduler(4);
+    std::vector<int> values(10000, 0);
+
+    // [WHEN] Every element is processed in parallel
+    scheduler.parallelFor(0, values.size(), [&values](size_t i) {
+        values[i] = static_cast<int>(i) * 2;
+    }, 16);
+
+    // [THEN] Every index has been visited exactly once
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<int>(i) * 2);
+    }
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor_BodyKnowsItIsInParallelFor)
+{
+    // [GIVEN] A scheduler
+    TaskScheduler scheduler(4);
+    EXPECT_FALSE(TaskScheduler::isInParallelFor());
+
+    // [WHEN] A range is processed in parallel
+    std::atomic<int> outsideCount = 0;
+    scheduler.parallelFor(0, 64, [&outsideCount](size_t) {
+        if (!TaskScheduler::isInParallelFor()) {
+            outsideCount++;
+        }
+    });
+
+    // [THEN] Every call, on the workers and on the calling thread, is marked
+    EXPECT_EQ(outsideCount.load(), 0);
+
+    // [THEN] Other tasks and the calling thread are not marked afterwards
+    EXPECT_FALSE(TaskScheduler::isInParallelFor());
+    EXPECT_FALSE(scheduler.submit([]() { return TaskScheduler::isInParallelFor(); }).get());
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor_TasksRunWhileWaiting_NotInParallelFor)
+{
+    // [GIVEN] A scheduler
+    TaskScheduler scheduler(2);
+
+    // [WHEN] The bodies of a parallelFor wait for groups of their own, helping with the queued tasks meanwhile
+    std::atomic<int> taskCount = 0;
+    std::atomic<int> markedTaskCount = 0;
+    std::atomic<int> unmarkedBodyCount = 0;
+
+    scheduler.parallelFor(0, 8, [&](size_t) {
+        TaskGroup group(&scheduler);
+        for (int i = 0; i < 16; ++i) {
+            group.run([&taskCount, &markedTaskCount]() {
+                taskCount++;
+                if (TaskScheduler::isInParallelFor()) {
+                    markedTaskCount++;
+                }
+            });
+        }
+        group.wait();
+
+        if (!TaskScheduler::isInParallelFor()) {
+            unmarkedBodyCount++;
+        }
+    });
+
+    // [THEN] The tasks are not marked, whichever thread has run them
+    EXPECT_EQ(taskCount.load(), 8 * 16);
+    EXPECT_EQ(markedTaskCount.load(), 0);
+
+    // [THEN] The bodies are still marked after waiting
+    EXPECT_EQ(unmarkedBodyCount.load(), 0);
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, NestedTaskGroups)
+{
+    // [GIVEN] A scheduler with fewer threads than there are nested groups
+    TaskScheduler scheduler(2);
+    std::atomic<int> leafCount = 0;
+
+    // [WHEN] Every task of a group waits for its own group of subtasks
+    TaskGroup outer(&scheduler);
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&scheduler, &leafCount]() {
+            TaskGroup inner(&scheduler);
+            for (int j = 0; j < 8; ++j) {
+                inner.run([&leafCount]() { leafCount++; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    // [THEN] There is no deadlock and all the subtasks have been executed
+    EXPECT_EQ(leafCount.load(), 64);
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ThreadPriorityInstances)
+{
+    // [GIVEN] The shared schedulers of the different priority classes
+    TaskScheduler* realtime = TaskScheduler::instance(ThreadPriority::Realtime);
+    TaskScheduler* normal = TaskScheduler::instance();
+
+    // [THEN] They are separate pools with their own threads
+    EXPECT_NE(realtime, normal);
+    EXPECT_EQ(realtime->priority(), ThreadPriority::Realtime);
+    EXPECT_EQ(normal->priority(), ThreadPriority::Normal);
+
+    // [WHEN] A task runs on the realtime pool
+    std::thread::id workerId = realtime->submit([]() { return std::this_thread::get_id(); }).get();
+
+    // [THEN] It is executed by one of the pool threads
+    EXPECT_TRUE(realtime->containsThread(workerId));
+    EXPECT_FALSE(normal->containsThread(workerId));
+}
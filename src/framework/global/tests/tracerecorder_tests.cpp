@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+
+using namespace muse;
+using namespace muse::profiler;
+
+class Global_TraceRecorderTests : public ::testing::Test
+{
+public:
+    void TearDown() override
+    {
+        TraceRecorder::instance()->stop();
+        TraceRecorder::instance()->clear();
+    }
+
+    static size_t count(const std::string& str, const std::string& what)
+    {
+        size_t n = 0;
+        for (size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + what.size())) {
+            ++n;
+        }
+        return n;
+    }
+};
+
+TEST_F(Global_TraceRecorderTests, Export_RecordedEvents)
+{
+    static const std::string blockName("block");
+
+    //! [GIVEN] Recording is started
+    TraceRecorder* recorder = TraceRecorder::instance();
+    recorder->start();
+    ASSERT_TRUE(TraceRecorder::isRecording());
+
+    //! [WHEN] A block and a counter are recorded, the counter from an if without braces
+    recorder->begin(blockName);
+    bool isCounted = true;
+    if (isCounted)
+        TRACE_COUNTER("test/counter", 42);
+    else
+        isCounted = true;
+    recorder->end(blockName);
+
+    //! [WHEN] And one more block after the recording is stopped
+    recorder->stop();
+    recorder->begin(blockName);
+    recorder->end(blockName);
+
+    //! [THEN] Only the events recorded before stop are exported
+    std::string json = recorder->toChromeJson();
+    EXPECT_EQ(count(json, "\"ph\":\"B\""), 1);
+    EXPECT_EQ(count(json, "\"ph\":\"E\""), 1);
+    EXPECT_EQ(count(json, "\"name\":\"block\""), 1);
+    EXPECT_NE(json.find("\"name\":\"test/counter\",\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"value\":42}"), std::string::npos);
+}
+
+TEST_F(Global_TraceRecorderTests, Export_WhileThreadsWrite)
+{
+    static const std::string blockName("worker");
+
+    TraceRecorder* recorder = TraceRecorder::instance();
+    recorder->start(1024);
+
+    //! [GIVEN] Threads that keep writing, wrapping around their small rings
+    std::atomic<bool> running = true;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([recorder, &running]() {
+            while (running.load()) {
+                recorder->begin(blockName);
+                recorder->counter(blockName, 1);
+                recorder->end(blockName);
+            }
+        });
+    }
+
+    //! [WHEN] The timeline is exported meanwhile
+    //! [THEN] Every export is complete, the blocks are balanced
+    for (int i = 0; i < 20; ++i) {
+        std::string json = recorder->toChromeJson();
+        ASSERT_EQ(json.substr(json.size() - 3), "]}\n");
+        EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+    }
+
+    //! [THEN] The recording goes on after the export
+    EXPECT_TRUE(TraceRecorder::isRecording());
+
+    //! [WHEN] Recording is stopped while the threads still write
+    recorder->stop();
+
+    //! [THEN] Nothing is written anymore
+    const size_t eventCount = count(recorder->toChromeJson(), "\"ph\"");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(count(recorder->toChromeJson(), "\"ph\""), eventCount);
+
+    running = false;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_F(Global_TraceRecorderTests, Memory_AllocatedAsRingFills)
+{
+    static const std::string blockName("short");
+
+    TraceRecorder* recorder = TraceRecorder::instance();
+    recorder->start(TraceRecorder::DEFAULT_EVENTS_PER_THREAD);
+
+    const size_t usageBefore = recorder->memoryUsage();
+
+    //! [WHEN] A short-lived thread writes a few events
+    std::thread thread([recorder]() {
+        for (int i = 0; i < 10; ++i) {
+            recorder->begin(blockName);
+            recorder->end(blockName);
+        }
+    });
+    thread.join();
+
+    //! [THEN] It takes one block, not the whole ring
+    const size_t usage = recorder->memoryUsage() - usageBefore;
+    EXPECT_GT(usage, 0);
+    EXPECT_LT(usage, TraceRecorder::DEFAULT_EVENTS_PER_THREAD * sizeof(int64_t));
+
+    //! [WHEN] The recording is cleared
+    recorder->clear();
+
+    //! [THEN] The blocks are released
+    EXPECT_LT(recorder->memoryUsage(), usageBefore + usage);
+}
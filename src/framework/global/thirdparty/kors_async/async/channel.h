@@ -25,6 +25,7 @@ SOFTWARE.
 #define KORS_ASYNC_CHANNEL_H
 
 #include <memory>
+#include <type_traits>
 #include "internal/abstractinvoker.h"
 
 namespace kors::async {
@@ -54,6 +55,14 @@ public:
         ptr()->invoke(Receive, nd);
     }
 
+    template<size_t N = sizeof...(T), std::enable_if_t<(N > 0), int> = 0>
+    void send(T&&... d)
+    {
+        NotifyData nd;
+        nd.setArg<T...>(0, std::move(d)...);
+        ptr()->invoke(Receive, nd);
+    }
+
     template<typename Func>
     void onReceive(const Asyncable* receiver, Func f, Asyncable::AsyncMode mode = Asyncable::AsyncMode::AsyncSetOnce)
     {
@@ -99,7 +108,7 @@ private:
         Call f;
         ReceiveCall(Call _f)
             : f(_f) {}
-        void received(const NotifyData& d) { std::apply(f, d.args<Arg...>()); }
+        void received(const NotifyData& d) { std::apply(f, d.argsRef<Arg...>()); }
     };
 
     struct IClose {
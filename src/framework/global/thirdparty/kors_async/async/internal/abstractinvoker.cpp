@@ -100,6 +100,11 @@ void AbstractInvoker::onMainThreadInvoke(const std::function<void(const std::fun
     QueuedInvoker::instance()->onMainThreadInvoke(f);
 }
 
+void AbstractInvoker::enableRingQueue(size_t capacity)
+{
+    QueuedInvoker::instance()->enableRingQueue(capacity);
+}
+
 bool AbstractInvoker::isConnected() const
 {
     for (auto it = m_callbacks.cbegin(); it != m_callbacks.cend(); ++it) {
@@ -213,13 +218,14 @@ void AbstractInvoker::disconnectAsync(Asyncable* receiver)
 void AbstractInvoker::addQInvoker(QInvoker* qi)
 {
     std::lock_guard<std::mutex> lock(m_qInvokersMutex);
-    m_qInvokers.push_back(qi);
+    qi->it = m_qInvokers.insert(m_qInvokers.end(), qi);
 }
 
 void AbstractInvoker::removeQInvoker(QInvoker* qi)
 {
+    //! NOTE There may be a lot of queued calls, so don't search
     std::lock_guard<std::mutex> lock(m_qInvokersMutex);
-    m_qInvokers.remove(qi);
+    m_qInvokers.erase(qi->it);
 }
 
 bool AbstractInvoker::containsReceiver(Asyncable* receiver) const
@@ -32,6 +32,7 @@ SOFTWARE.
 #include <mutex>
 #include <thread>
 #include <functional>
+#include <type_traits>
 
 #include "../asyncable.h"
 
@@ -48,6 +49,13 @@ public:
         m_args.insert(m_args.begin() + i, std::shared_ptr<IArg>(p));
     }
 
+    template<typename ... T, std::enable_if_t<(sizeof...(T) > 0), int> = 0>
+    void setArg(int i, T&&... val)
+    {
+        IArg* p = new Arg<T...>(std::move(val)...);
+        m_args.insert(m_args.begin() + i, std::shared_ptr<IArg>(p));
+    }
+
     template<typename T>
     T arg(int i = 0) const
     {
@@ -70,6 +78,19 @@ public:
         return d->val;
     }
 
+    //! NOTE Without a copy of the values: the same data is passed to all the receivers
+    template<typename ... T>
+    const std::tuple<T...>& argsRef(int i = 0) const
+    {
+        IArg* p = m_args.at(i).get();
+        if (!p) {
+            static const std::tuple<T...> empty {};
+            return empty;
+        }
+        Arg<T...>* d = reinterpret_cast<Arg<T...>*>(p);
+        return d->val;
+    }
+
     struct IArg {
         virtual ~IArg() = default;
     };
@@ -79,6 +100,9 @@ public:
         std::tuple<T...> val;
         Arg(const T&... v)
             : IArg(), val(v ...) {}
+        template<size_t N = sizeof...(T), std::enable_if_t<(N > 0), int> = 0>
+        Arg(T&&... v)
+            : IArg(), val(std::move(v)...) {}
     };
 
 private:
@@ -98,6 +122,7 @@ public:
 
     static void processEvents();
     static void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
+    static void enableRingQueue(size_t capacity);
 
 protected:
     explicit AbstractInvoker();
@@ -130,6 +155,7 @@ protected:
         int type = -1;
         CallBack call;
         NotifyData data;
+        std::list<QInvoker*>::iterator it;
 
         QInvoker(AbstractInvoker* i, int t, CallBack c, NotifyData d)
             : invoker(i), type(t), call(c), data(d)
@@ -23,15 +23,126 @@ SOFTWARE.
 */
 #include "queuedinvoker.h"
 
+#include <algorithm>
+
 using namespace kors::async;
 
+// ============================
+// Ring
+// ============================
+
+//! NOTE The positions only grow, the slot of a position is position % capacity
+QueuedInvoker::Ring::Ring(size_t capacity)
+    : m_slots(capacity)
+{
+}
+
+void QueuedInvoker::Ring::push(Functor&& f)
+{
+    if (!m_overflowed.load(std::memory_order_acquire)) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) < m_slots.size()) {
+            m_slots[tail % m_slots.size()] = std::move(f);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_overflow.push(std::move(f));
+    m_overflowed.store(true, std::memory_order_release);
+}
+
+bool QueuedInvoker::Ring::pop(Functor& f, size_t end)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head >= end) {
+        return false;
+    }
+
+    Functor& slot = m_slots[head % m_slots.size()];
+    f = std::move(slot);
+    slot = nullptr;
+
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t QueuedInvoker::Ring::tail() const
+{
+    return m_tail.load(std::memory_order_acquire);
+}
+
+void QueuedInvoker::Ring::process()
+{
+    Functor f;
+
+    //! NOTE Only the calls queued so far are processed,
+    //! the ones they queue in turn wait for the next round
+    if (!m_overflowed.load(std::memory_order_acquire)) {
+        const size_t end = tail();
+        while (pop(f, end)) {
+            if (f) {
+                f();
+            }
+        }
+        return;
+    }
+
+    //! NOTE The calls in the ring are older than the ones in the overflow:
+    //! the sender doesn't use the ring while the overflow is not empty
+    Queue overflow;
+    size_t end = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        end = tail();
+        overflow.swap(m_overflow);
+        m_overflowed.store(false, std::memory_order_release);
+    }
+
+    while (pop(f, end)) {
+        if (f) {
+            f();
+        }
+    }
+
+    while (!overflow.empty()) {
+        const auto& of = overflow.front();
+        if (of) {
+            of();
+        }
+        overflow.pop();
+    }
+}
+
+void QueuedInvoker::Ring::retire()
+{
+    m_retired.store(true, std::memory_order_release);
+}
+
+bool QueuedInvoker::Ring::isRetired() const
+{
+    return m_retired.load(std::memory_order_acquire);
+}
+
+bool QueuedInvoker::Ring::isEmpty() const
+{
+    return m_head.load(std::memory_order_relaxed) == tail() && !m_overflowed.load(std::memory_order_acquire);
+}
+
+// ============================
+// QueuedInvoker
+// ============================
+
+thread_local QueuedInvoker::RingQueue* QueuedInvoker::s_ringQueue = nullptr;
+
 QueuedInvoker* QueuedInvoker::instance()
 {
     static QueuedInvoker i;
     return &i;
 }
 
-void QueuedInvoker::invoke(const std::thread::id& callbackTh, const Functor& f, bool isAlwaysQueued)
+void QueuedInvoker::invoke(const std::thread::id& callbackTh, Functor f, bool isAlwaysQueued)
 {
     if (m_onMainThreadInvoke) {
         if (callbackTh == m_mainThreadID) {
@@ -39,18 +150,214 @@ void QueuedInvoker::invoke(const std::thread::id& callbackTh, const Functor& f,
         }
     }
 
+    if (Ring* r = ring(callbackTh)) {
+        r->push(std::move(f));
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    // the receiver may have enabled its rings in the meantime
+    if (Ring* r = ring(callbackTh)) {
+        r->push(std::move(f));
+        return;
+    }
+
+    m_queues[callbackTh].push(std::move(f));
+}
+
+QueuedInvoker::Ring* QueuedInvoker::ring(const std::thread::id& th)
+{
+    //! NOTE The rings of the current thread to the receivers, cached, so that sending
+    //! doesn't lock. The cache is dropped when one more receiver enables its rings
+    struct Cache {
+        size_t version = 0;
+        std::map<std::thread::id, Ring*> rings;
+    };
+
+    //! NOTE All the rings of the current thread, they are retired when it exits
+    struct OwnRings {
+        std::vector<Ring*> rings;
+
+        ~OwnRings() { QueuedInvoker::instance()->retireSenderRings(rings); }
+    };
+
+    static thread_local Cache cache;
+    static thread_local OwnRings ownRings;
+
+    const size_t version = m_ringQueuesVersion.load(std::memory_order_acquire);
+    if (cache.version != version) {
+        cache.rings.clear();
+        cache.version = version;
+    }
+
+    auto it = cache.rings.find(th);
+    if (it != cache.rings.end()) {
+        return it->second;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    Ring* r = nullptr;
+
+    auto queueIt = m_ringQueues.find(th);
+    if (queueIt != m_ringQueues.end()) {
+        RingQueue* queue = queueIt->second.get();
+        const std::thread::id sender = std::this_thread::get_id();
+
+        // the cache may have been dropped, the ring to this receiver is still there
+        Ring*& senderRing = queue->senderRings[sender];
+        if (!senderRing) {
+            queue->ownedRings.push_back(std::make_unique<Ring>(queue->capacity));
+
+            senderRing = queue->ownedRings.back().get();
+            senderRing->queue = queue;
+            senderRing->sender = sender;
+            senderRing->next = queue->rings.load(std::memory_order_relaxed);
+            queue->rings.store(senderRing, std::memory_order_release);
+
+            ownRings.rings.push_back(senderRing);
+        }
+
+        r = senderRing;
+    }
+
+    cache.rings[th] = r;
+    return r;
+}
+
+void QueuedInvoker::retireSenderRings(const std::vector<Ring*>& rings)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    //! NOTE A new thread may get the same id, it gets new rings
+    for (Ring* r : rings) {
+        r->queue->senderRings.erase(r->sender);
+        r->retire();
+    }
+}
+
+void QueuedInvoker::releaseRetiredRings(RingQueue* queue)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    //! NOTE The rings are only added at the front, under the lock,
+    //! and only the receiver removes them, so the links are stable here
+    Ring* prev = nullptr;
+    Ring* r = queue->rings.load(std::memory_order_acquire);
+    while (r) {
+        Ring* next = r->next;
+
+        if (r->isRetired() && r->isEmpty()) {
+            if (prev) {
+                prev->next = next;
+            } else {
+                queue->rings.store(next, std::memory_order_release);
+            }
+
+            auto it = std::find_if(queue->ownedRings.begin(), queue->ownedRings.end(), [r](const std::unique_ptr<Ring>& owned) {
+                return owned.get() == r;
+            });
+            queue->ownedRings.erase(it);
+        } else {
+            prev = r;
+        }
+
+        r = next;
+    }
+}
+
+void QueuedInvoker::enableRingQueue(size_t capacity)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    const std::thread::id th = std::this_thread::get_id();
+
+    std::unique_ptr<RingQueue>& queue = m_ringQueues[th];
+    if (queue) {
+        return;
+    }
+
+    queue = std::make_unique<RingQueue>();
+    queue->capacity = capacity > 0 ? capacity : 1;
+
+    auto n = m_queues.extract(th);
+    if (!n.empty()) {
+        queue->pending = std::move(n.mapped());
+    }
+
+    s_ringQueue = queue.get();
+    m_ringQueuesVersion.fetch_add(1, std::memory_order_acq_rel);
+
+    //! NOTE The id of the thread may be reused by a new thread, which doesn't expect the rings
+    struct Guard {
+        ~Guard() { QueuedInvoker::instance()->disableRingQueue(); }
+    };
+
+    static thread_local Guard guard;
+    (void)guard;
+}
+
+void QueuedInvoker::disableRingQueue()
+{
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    m_queues[callbackTh].push(f);
+
+    auto it = m_ringQueues.find(std::this_thread::get_id());
+    if (it == m_ringQueues.end()) {
+        return;
+    }
+
+    m_retiredRingQueues.push_back(std::move(it->second));
+    m_ringQueues.erase(it);
+
+    s_ringQueue = nullptr;
+    m_ringQueuesVersion.fetch_add(1, std::memory_order_acq_rel);
+}
+
+size_t QueuedInvoker::ringCount() const
+{
+    size_t count = 0;
+    if (RingQueue* queue = s_ringQueue) {
+        for (Ring* r = queue->rings.load(std::memory_order_acquire); r; r = r->next) {
+            ++count;
+        }
+    }
+    return count;
 }
 
 void QueuedInvoker::processEvents()
 {
+    if (RingQueue* queue = s_ringQueue) {
+        Queue pending;
+        pending.swap(queue->pending);
+        while (!pending.empty()) {
+            const auto& f = pending.front();
+            if (f) {
+                f();
+            }
+            pending.pop();
+        }
+
+        bool hasRetired = false;
+        for (Ring* r = queue->rings.load(std::memory_order_acquire); r; r = r->next) {
+            // checked first: once retired, the ring gets nothing more after this round
+            hasRetired |= r->isRetired();
+            r->process();
+        }
+
+        if (hasRetired) {
+            releaseRetiredRings(queue);
+        }
+
+        return;
+    }
+
     Queue q;
     {
         std::lock_guard<std::recursive_mutex> lock(m_mutex);
         auto n = m_queues.extract(std::this_thread::get_id());
         if (!n.empty()) {
-            q = n.mapped();
+            q = std::move(n.mapped());
         }
     }
     while (!q.empty()) {
@@ -24,11 +24,14 @@ SOFTWARE.
 #ifndef KORS_ASYNC_QUEUEDINVOKER_H
 #define KORS_ASYNC_QUEUEDINVOKER_H
 
+#include <atomic>
 #include <functional>
 #include <queue>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace kors::async {
 class QueuedInvoker
@@ -39,19 +42,83 @@ public:
 
     using Functor = std::function<void ()>;
 
-    void invoke(const std::thread::id& th, const Functor& f, bool isAlwaysQueued = false);
+    void invoke(const std::thread::id& th, Functor f, bool isAlwaysQueued = false);
     void processEvents();
     void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
 
+    //! NOTE Calls queued to the current thread go through lock-free rings from now on,
+    //! one single-producer/single-consumer ring per sending thread, with preallocated slots.
+    //! Sending and processing don't lock or allocate, unless a ring is full
+    void enableRingQueue(size_t capacity);
+
+    //! NOTE The number of sender rings of the current thread, for diagnostics
+    size_t ringCount() const;
+
 private:
 
     QueuedInvoker() = default;
 
     using Queue = std::queue<Functor>;
 
+    struct RingQueue;
+
+    class Ring
+    {
+    public:
+        explicit Ring(size_t capacity);
+
+        void push(Functor&& f);
+        bool pop(Functor& f, size_t end);
+        size_t tail() const;
+
+        void process();
+
+        //! NOTE The sender has exited, the ring is released once it is processed
+        void retire();
+        bool isRetired() const;
+        bool isEmpty() const;
+
+        Ring* next = nullptr; // the next ring of the same receiver
+        RingQueue* queue = nullptr;
+        std::thread::id sender;
+
+    private:
+        std::vector<Functor> m_slots;
+
+        alignas(64) std::atomic<size_t> m_head = 0; // written by the receiver
+        alignas(64) std::atomic<size_t> m_tail = 0; // written by the sender
+
+        // the calls which didn't fit into the ring: while there are some,
+        // the next calls go here too, to keep the order
+        std::mutex m_overflowMutex;
+        Queue m_overflow;
+        std::atomic<bool> m_overflowed = false;
+
+        std::atomic<bool> m_retired = false;
+    };
+
+    struct RingQueue {
+        size_t capacity = 0;
+        std::atomic<Ring*> rings = nullptr;
+        std::vector<std::unique_ptr<Ring> > ownedRings;
+        std::map<std::thread::id, Ring*> senderRings;
+        Queue pending; // queued before the rings were enabled
+    };
+
+    Ring* ring(const std::thread::id& th);
+    void retireSenderRings(const std::vector<Ring*>& rings);
+    void releaseRetiredRings(RingQueue* queue);
+    void disableRingQueue();
+
+    static thread_local RingQueue* s_ringQueue; // of the current thread, if it is enabled
+
     std::recursive_mutex m_mutex;
     std::map<std::thread::id, Queue > m_queues;
 
+    std::map<std::thread::id, std::unique_ptr<RingQueue> > m_ringQueues;
+    std::vector<std::unique_ptr<RingQueue> > m_retiredRingQueues; // senders may still refer to their rings
+    std::atomic<size_t> m_ringQueuesVersion = 0;
+
     std::function<void(const std::function<void()>&, bool)> m_onMainThreadInvoke;
     std::thread::id m_mainThreadID;
 };
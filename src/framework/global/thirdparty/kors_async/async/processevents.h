@@ -36,6 +36,12 @@ inline void onMainThreadInvoke(const std::function<void(const std::function<void
 {
     AbstractInvoker::onMainThreadInvoke(f);
 }
+
+//! NOTE Calls to the current thread go through lock-free rings instead of the shared queue
+inline void enableRingQueue(size_t capacity)
+{
+    AbstractInvoker::enableRingQueue(capacity);
+}
 }
 
 #endif // KORS_ASYNC_PROCESSEVENTS_H
@@ -2,4 +2,6 @@
 set(KORS_PROFILER_SRC
     ${CMAKE_CURRENT_LIST_DIR}/profiler.cpp
     ${CMAKE_CURRENT_LIST_DIR}/profiler.h
+    ${CMAKE_CURRENT_LIST_DIR}/tracerecorder.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/tracerecorder.h
 )
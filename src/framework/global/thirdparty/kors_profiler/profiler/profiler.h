@@ -37,6 +37,7 @@ SOFTWARE.
 #include <atomic>
 
 #include "funcinfo.h"
+#include "tracerecorder.h"
 
 // #define KORS_PROFILER_ENABLED
 
@@ -66,6 +67,16 @@ SOFTWARE.
     { kors::profiler::Profiler::instance()->stepTime(tag, info); }
 #endif
 
+#ifndef TRACE_COUNTER
+#define TRACE_COUNTER(name, value) \
+    do { \
+        if (kors::profiler::TraceRecorder::isRecording()) { \
+            static const std::string __counter_name(name); \
+            kors::profiler::TraceRecorder::instance()->counter(__counter_name, static_cast<int64_t>(value)); \
+        } \
+    } while (0)
+#endif
+
 #ifndef PROFILER_CLEAR
 #define PROFILER_CLEAR kors::profiler::Profiler::instance()->clear();
 #endif
@@ -78,6 +89,7 @@ SOFTWARE.
 
 #define TRACEFUNC
 #define TRACEFUNC_C(info)
+#define TRACE_COUNTER(name, value)
 #define BEGIN_STEP_TIME
 #define STEP_TIME
 #define PROFILER_CLEAR
@@ -248,10 +260,19 @@ struct FuncMarker
         if (Profiler::m_options.funcsTimeEnabled) {
             timer = Profiler::instance()->beginFunc(fn);
         }
+
+        if (TraceRecorder::isRecording()) {
+            traced = true;
+            TraceRecorder::instance()->begin(fn);
+        }
     }
 
     ~FuncMarker()
     {
+        if (traced) {
+            TraceRecorder::instance()->end(func);
+        }
+
         if (Profiler::m_options.funcsTimeEnabled) {
             Profiler::instance()->endFunc(timer, func);
         }
@@ -259,6 +280,7 @@ struct FuncMarker
 
     Profiler::FuncTimer* timer = nullptr;
     const std::string& func;
+    bool traced = false;
 };
 }
 
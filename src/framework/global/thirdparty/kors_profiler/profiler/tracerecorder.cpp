@@ -0,0 +1,339 @@
+/*
+MIT License
+
+Copyright (c) 2020 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "tracerecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define KORS_TRACE_USE_TSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define KORS_TRACE_USE_TSC
+#endif
+
+using namespace kors::profiler;
+
+std::atomic<bool> TraceRecorder::s_recording = false;
+
+TraceRecorder* TraceRecorder::instance()
+{
+    //! NOTE Never destroyed: threads may still write while the statics are destroyed
+    static TraceRecorder* r = new TraceRecorder();
+    return r;
+}
+
+uint64_t TraceRecorder::ticks()
+{
+#ifdef KORS_TRACE_USE_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void TraceRecorder::start(size_t eventsPerThread)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (s_recording.load()) {
+        return;
+    }
+
+    m_eventsPerThread = eventsPerThread < 2 ? 2 : eventsPerThread;
+    m_mainThread = std::this_thread::get_id();
+
+    for (std::unique_ptr<ThreadBuffer>& buf : m_buffers) {
+        resetBuffer(*buf);
+    }
+
+    m_startTime = std::chrono::steady_clock::now();
+    m_startTicks = ticks();
+
+    s_recording.store(true);
+}
+
+void TraceRecorder::stop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    pauseWriters();
+}
+
+void TraceRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool wasRecording = pauseWriters();
+
+    for (std::unique_ptr<ThreadBuffer>& buf : m_buffers) {
+        resetBuffer(*buf);
+    }
+
+    resumeWriters(wasRecording);
+}
+
+//! NOTE Must be called with the mutex locked and the writers paused
+void TraceRecorder::resetBuffer(ThreadBuffer& buf) const
+{
+    buf.blockSize = std::min(m_eventsPerThread, EVENTS_PER_BLOCK);
+    buf.capacity = (m_eventsPerThread + buf.blockSize - 1) / buf.blockSize * buf.blockSize;
+    buf.blocks.clear();
+    buf.blocks.resize(buf.capacity / buf.blockSize);
+    buf.written = 0;
+}
+
+//! NOTE A writer marks its buffer busy before it checks the recording flag,
+//! so once the flag is cleared and no buffer is busy, nobody writes anymore
+bool TraceRecorder::pauseWriters() const
+{
+    bool wasRecording = s_recording.exchange(false);
+
+    for (const std::unique_ptr<ThreadBuffer>& buf : m_buffers) {
+        while (buf->busy.load()) {
+            std::this_thread::yield();
+        }
+    }
+
+    return wasRecording;
+}
+
+void TraceRecorder::resumeWriters(bool wasRecording) const
+{
+    if (wasRecording) {
+        s_recording.store(true);
+    }
+}
+
+void TraceRecorder::begin(const std::string& name)
+{
+    push(EventType::Begin, name, 0);
+}
+
+void TraceRecorder::end(const std::string& name)
+{
+    push(EventType::End, name, 0);
+}
+
+void TraceRecorder::counter(const std::string& name, int64_t value)
+{
+    push(EventType::Counter, name, value);
+}
+
+void TraceRecorder::push(EventType type, const std::string& name, int64_t value)
+{
+    ThreadBuffer* buf = threadBuffer();
+
+    buf->busy.store(true);
+    if (!s_recording.load()) {
+        buf->busy.store(false, std::memory_order_release);
+        return;
+    }
+
+    // only this thread writes to the buffer
+    const size_t idx = static_cast<size_t>(buf->written % buf->capacity);
+    std::unique_ptr<Event[]>& block = buf->blocks[idx / buf->blockSize];
+    if (!block) {
+        block = std::make_unique<Event[]>(buf->blockSize);
+    }
+
+    Event& e = block[idx % buf->blockSize];
+    e.name = &name;
+    e.ticks = ticks();
+    e.value = value;
+    e.type = type;
+
+    ++buf->written;
+
+    buf->busy.store(false, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::threadBuffer()
+{
+    static thread_local ThreadBuffer* t_buffer = nullptr;
+    if (t_buffer) {
+        return t_buffer;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto buf = std::make_unique<ThreadBuffer>();
+    buf->tid = static_cast<uint32_t>(m_buffers.size() + 1);
+    buf->thread = std::this_thread::get_id();
+    resetBuffer(*buf);
+
+    t_buffer = buf.get();
+    m_buffers.push_back(std::move(buf));
+
+    return t_buffer;
+}
+
+size_t TraceRecorder::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool wasRecording = pauseWriters();
+
+    size_t usage = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buf : m_buffers) {
+        usage += sizeof(ThreadBuffer) + buf->blocks.size() * sizeof(std::unique_ptr<Event[]>);
+        for (const std::unique_ptr<Event[]>& block : buf->blocks) {
+            if (block) {
+                usage += buf->blockSize * sizeof(Event);
+            }
+        }
+    }
+
+    resumeWriters(wasRecording);
+
+    return usage;
+}
+
+static void writeJsonString(std::stringstream& stream, const std::string& str)
+{
+    stream << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"': stream << "\\\""; break;
+        case '\\': stream << "\\\\"; break;
+        case '\n': stream << "\\n"; break;
+        case '\t': stream << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                stream << ' ';
+            } else {
+                stream << c;
+            }
+        }
+    }
+    stream << '"';
+}
+
+std::string TraceRecorder::toChromeJson() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool wasRecording = pauseWriters();
+
+    //! NOTE Calibrate the ticks (TSC) to microseconds over the whole recording
+    const uint64_t nowTicks = ticks();
+    const double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_startTime).count();
+    const double ticksPerUs = (nowTicks > m_startTicks && elapsedUs > 0.0)
+                              ? static_cast<double>(nowTicks - m_startTicks) / elapsedUs : 1.0;
+
+    auto toUs = [this, ticksPerUs](uint64_t t) {
+        return t > m_startTicks ? static_cast<double>(t - m_startTicks) / ticksPerUs : 0.0;
+    };
+
+    std::stringstream stream;
+    stream.setf(std::ios::fixed);
+    stream.precision(3);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto beginEvent = [&stream, &first]() {
+        if (!first) {
+            stream << ",\n";
+        }
+        first = false;
+    };
+
+    for (const std::unique_ptr<ThreadBuffer>& buf : m_buffers) {
+        const uint32_t tid = buf->tid;
+
+        beginEvent();
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+        writeJsonString(stream, buf->thread == m_mainThread ? std::string("Main thread") : "Thread " + std::to_string(tid));
+        stream << "}}";
+
+        const uint64_t written = buf->written;
+        const uint64_t from = written > buf->capacity ? written - buf->capacity : 0;
+
+        // the ring may start in the middle of a block, skip unmatched ends
+        double lastUs = 0.0;
+        std::vector<const std::string*> openBlocks;
+
+        for (uint64_t i = from; i < written; ++i) {
+            const size_t idx = static_cast<size_t>(i % buf->capacity);
+            const Event& e = buf->blocks[idx / buf->blockSize][idx % buf->blockSize];
+            const double us = toUs(e.ticks);
+            lastUs = us;
+
+            switch (e.type) {
+            case EventType::Begin:
+                openBlocks.push_back(e.name);
+                beginEvent();
+                stream << "{\"name\":";
+                writeJsonString(stream, *e.name);
+                stream << ",\"ph\":\"B\",\"ts\":" << us << ",\"pid\":1,\"tid\":" << tid << "}";
+                break;
+            case EventType::End:
+                if (openBlocks.empty()) {
+                    break;
+                }
+                openBlocks.pop_back();
+                beginEvent();
+                stream << "{\"ph\":\"E\",\"ts\":" << us << ",\"pid\":1,\"tid\":" << tid << "}";
+                break;
+            case EventType::Counter:
+                beginEvent();
+                stream << "{\"name\":";
+                writeJsonString(stream, *e.name);
+                stream << ",\"ph\":\"C\",\"ts\":" << us << ",\"pid\":1,\"tid\":" << tid
+                       << ",\"args\":{\"value\":" << e.value << "}}";
+                break;
+            }
+        }
+
+        // close the blocks which are still running
+        while (!openBlocks.empty()) {
+            openBlocks.pop_back();
+            beginEvent();
+            stream << "{\"ph\":\"E\",\"ts\":" << lastUs << ",\"pid\":1,\"tid\":" << tid << "}";
+        }
+    }
+
+    stream << "]}\n";
+
+    resumeWriters(wasRecording);
+
+    return stream.str();
+}
+
+bool TraceRecorder::save(const std::string& filePath) const
+{
+    std::string content = toChromeJson();
+
+    FILE* pFile = fopen(filePath.c_str(), "w");
+    if (!pFile) {
+        return false;
+    }
+    size_t count = fwrite(content.c_str(), sizeof(char), content.size(), pFile);
+    fclose(pFile);
+
+    return count == content.size();
+}
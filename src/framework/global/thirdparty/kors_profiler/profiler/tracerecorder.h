@@ -0,0 +1,118 @@
+/*
+MIT License
+
+Copyright (c) 2020 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef KORS_TRACERECORDER_H
+#define KORS_TRACERECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kors::profiler {
+//! NOTE Records a timeline of begin/end and counter events.
+//! Every thread writes to its own ring buffer without locks, so the oldest
+//! events are overwritten when the buffer is full. The ring is allocated in blocks
+//! as it fills, so threads that write little take little memory.
+//! Names are not copied, they must live until the export (static strings of the TRACEFUNC macro).
+//! stop(), clear() and the export pause the writers and wait for them to leave their buffers,
+//! so they may be called while recording (events pushed meanwhile are dropped).
+//! The timeline can be exported in the Chrome trace event format
+//! (chrome://tracing, https://ui.perfetto.dev)
+class TraceRecorder
+{
+public:
+
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 18;
+    static constexpr size_t EVENTS_PER_BLOCK = 1 << 12;
+
+    static TraceRecorder* instance();
+
+    static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+    //! NOTE Starting drops the events of a previous recording
+    void start(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    void stop();
+    void clear();
+
+    void begin(const std::string& name);
+    void end(const std::string& name);
+    void counter(const std::string& name, int64_t value);
+
+    std::string toChromeJson() const;
+    bool save(const std::string& filePath) const;
+
+    size_t memoryUsage() const;
+
+private:
+    TraceRecorder() = default;
+
+    enum class EventType : uint8_t {
+        Begin,
+        End,
+        Counter
+    };
+
+    struct Event {
+        const std::string* name = nullptr;
+        uint64_t ticks = 0;
+        int64_t value = 0;
+        EventType type = EventType::Begin;
+    };
+
+    struct ThreadBuffer {
+        uint32_t tid = 0;
+        std::thread::id thread;
+        size_t capacity = 0;
+        size_t blockSize = 0;
+        std::vector<std::unique_ptr<Event[]> > blocks;
+        uint64_t written = 0;
+        std::atomic<bool> busy = false; // the owner thread is writing
+    };
+
+    static uint64_t ticks();
+
+    void push(EventType type, const std::string& name, int64_t value);
+    ThreadBuffer* threadBuffer();
+
+    void resetBuffer(ThreadBuffer& buf) const;
+    bool pauseWriters() const;
+    void resumeWriters(bool wasRecording) const;
+
+    static std::atomic<bool> s_recording;
+
+    mutable std::mutex m_mutex; // registration of threads, stop, clear and export only
+    std::vector<std::unique_ptr<ThreadBuffer> > m_buffers;
+    size_t m_eventsPerThread = DEFAULT_EVENTS_PER_THREAD;
+    std::thread::id m_mainThread;
+
+    uint64_t m_startTicks = 0;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+}
+
+#endif // KORS_TRACERECORDER_H
@@ -101,6 +101,11 @@ AudioInputParams AudioConfigurationStub::defaultAudioInputParams() const
     return {};
 }
 
+size_t AudioConfigurationStub::fluidSynthInstanceCount() const
+{
+    return 1;
+}
+
 io::paths_t AudioConfigurationStub::soundFontDirectories() const
 {
     return {};
@@ -53,6 +53,8 @@ public:
     // synthesizers
     AudioInputParams defaultAudioInputParams() const override;
 
+    size_t fluidSynthInstanceCount() const override;
+
     io::paths_t soundFontDirectories() const override;
     io::paths_t userSoundFontDirectories() const override;
     void setUserSoundFontDirectories(const io::paths_t& paths) override;
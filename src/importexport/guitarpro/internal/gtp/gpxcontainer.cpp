@@ -0,0 +1,274 @@
+#include "gpxcontainer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "log.h"
+
+using namespace muse;
+
+namespace mu::iex::guitarpro {
+static constexpr size_t HEADER_SIZE = 4;
+static constexpr size_t SECTOR_SIZE = 0x1000;
+
+// the layout of a file entry sector of BCFS
+static constexpr int FILE_ENTRY = 2;
+static constexpr size_t FILE_NAME_OFFSET = 0x04;
+static constexpr size_t FILE_NAME_MAX_LENGTH = 127;
+static constexpr size_t FILE_SIZE_OFFSET = 0x8C;
+static constexpr size_t FILE_BLOCKS_OFFSET = 0x94;
+
+static int readInt(const uint8_t* data)
+{
+    return static_cast<int>(static_cast<uint32_t>(data[0])
+                            | (static_cast<uint32_t>(data[1]) << 8)
+                            | (static_cast<uint32_t>(data[2]) << 16)
+                            | (static_cast<uint32_t>(data[3]) << 24));
+}
+
+static constexpr std::array<uint8_t, 256> makeReversedBytes()
+{
+    std::array<uint8_t, 256> values {};
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint8_t b = static_cast<uint8_t>(i);
+        b = static_cast<uint8_t>(((b & 0xF0) >> 4) | ((b & 0x0F) << 4));
+        b = static_cast<uint8_t>(((b & 0xCC) >> 2) | ((b & 0x33) << 2));
+        b = static_cast<uint8_t>(((b & 0xAA) >> 1) | ((b & 0x55) << 1));
+        values[i] = b;
+    }
+    return values;
+}
+
+static constexpr std::array<uint8_t, 256> REVERSED_BYTES = makeReversedBytes();
+
+//---------------------------------------------------------
+//   BitReader
+//    Reads the bits of the bytes from the most significant one,
+//    64 bits at a time. Past the end of the data it reads zeros
+//---------------------------------------------------------
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : m_data(data), m_end(data + size), m_bitSize(size * 8) {}
+
+    size_t position() const { return m_position; }
+    bool atEnd() const { return m_position >= m_bitSize; }
+
+    void skip(size_t bits)
+    {
+        while (bits > 0) {
+            const int n = static_cast<int>(std::min<size_t>(bits, 32));
+            read(n);
+            bits -= n;
+        }
+    }
+
+    //! NOTE The first bit read is the highest one of the result
+    uint32_t read(int bits)
+    {
+        if (bits == 0) {
+            return 0;
+        }
+
+        if (m_count < bits) {
+            refill();
+        }
+
+        const uint32_t value = static_cast<uint32_t>(m_window >> (64 - bits));
+        m_window <<= bits;
+        m_count -= bits;
+        m_position += bits;
+
+        return value;
+    }
+
+    //! NOTE The first bit read is the lowest one of the result, at most 16 bits
+    uint32_t readReversed(int bits)
+    {
+        const uint32_t value = read(bits);
+        const uint32_t reversed = (static_cast<uint32_t>(REVERSED_BYTES[value & 0xff]) << 8) | REVERSED_BYTES[(value >> 8) & 0xff];
+        return reversed >> (16 - bits);
+    }
+
+private:
+    void refill()
+    {
+        while (m_count <= 56) {
+            if (m_data < m_end) {
+                m_window |= static_cast<uint64_t>(*m_data++) << (56 - m_count);
+            }
+            // zeros past the end
+            m_count += 8;
+        }
+    }
+
+    const uint8_t* m_data = nullptr;
+    const uint8_t* m_end = nullptr;
+    const size_t m_bitSize = 0;
+
+    uint64_t m_window = 0; // the next bits, from the highest one
+    int m_count = 0;
+    size_t m_position = 0;
+};
+
+int GPXContainer::header(const ByteArray& data)
+{
+    if (data.size() < HEADER_SIZE) {
+        return 0;
+    }
+
+    return readInt(data.constData());
+}
+
+//---------------------------------------------------------
+//   decompress
+//    A sequence of chunks, each starts with a flag bit:
+//    1 - a copy of the output: 4 bits of word size, then the offset back and the length
+//    0 - up to 3 literal bytes: 2 bits of count, then the bytes
+//---------------------------------------------------------
+
+ByteArray GPXContainer::decompress(const ByteArray& bcfz)
+{
+    TRACEFUNC;
+
+    if (bcfz.size() < 2 * HEADER_SIZE) {
+        return ByteArray();
+    }
+
+    // the expected size of the output follows the header
+    const size_t length = static_cast<size_t>(std::max(readInt(bcfz.constData() + HEADER_SIZE), 0));
+
+    std::vector<uint8_t> out;
+    out.reserve(length);
+
+    BitReader reader(bcfz.constData(), bcfz.size());
+    reader.skip(2 * HEADER_SIZE * 8);
+
+    //! NOTE The position in the input is compared with the size of the output, like Guitar Pro does.
+    //! Past the end of the input only zeros are read, which produce nothing, so the loop stops there
+    while (reader.position() / 8 < length && !reader.atEnd()) {
+        if (reader.read(1)) {
+            const int bits = static_cast<int>(reader.read(4));
+            const size_t offset = reader.readReversed(bits);
+            const size_t size = reader.readReversed(bits);
+
+            if (offset > out.size()) {
+                LOGE() << "corrupted BCFZ, offset: " << offset << ", decompressed: " << out.size();
+                break;
+            }
+
+            // never overlaps: at most offset bytes are copied
+            const size_t count = std::min(size, offset);
+            const size_t from = out.size() - offset;
+            const size_t to = out.size();
+            out.resize(to + count);
+            std::memcpy(out.data() + to, out.data() + from, count);
+        } else {
+            const int count = static_cast<int>(reader.readReversed(2));
+            for (int i = 0; i < count; ++i) {
+                out.push_back(static_cast<uint8_t>(reader.read(8)));
+            }
+        }
+    }
+
+    return ByteArray(out.data(), out.size());
+}
+
+//---------------------------------------------------------
+//   readFile
+//    The sectors follow the header. A file entry sector holds the name,
+//    the size and the list of the sectors of the file, ended with 0
+//---------------------------------------------------------
+
+ByteArray GPXContainer::readFile(const ByteArray& bcfs, const std::string& name)
+{
+    TRACEFUNC;
+
+    if (bcfs.size() < HEADER_SIZE) {
+        return ByteArray();
+    }
+
+    const uint8_t* data = bcfs.constData() + HEADER_SIZE;
+    const size_t size = bcfs.size() - HEADER_SIZE;
+
+    auto intAt = [data, size](size_t offset) -> int {
+        return offset + 4 <= size ? readInt(data + offset) : 0;
+    };
+
+    size_t offset = 0;
+    while ((offset += SECTOR_SIZE) + 3 < size) {
+        if (intAt(offset) != FILE_ENTRY) {
+            continue;
+        }
+
+        const size_t entry = offset;
+        const size_t fileSize = static_cast<size_t>(std::max(intAt(entry + FILE_SIZE_OFFSET), 0));
+
+        // the sectors of the file, the scan goes on after the last of them
+        std::vector<size_t> blocks;
+        for (size_t i = 0;; ++i) {
+            const size_t blockIdx = entry + FILE_BLOCKS_OFFSET + 4 * i;
+            const int block = blockIdx + 4 <= size ? intAt(blockIdx) : 0;
+            if (block <= 0) {
+                break;
+            }
+
+            blocks.push_back(static_cast<size_t>(block) * SECTOR_SIZE);
+            offset = blocks.back();
+        }
+
+        const size_t nameIdx = entry + FILE_NAME_OFFSET;
+        const size_t maxNameLength = nameIdx < size ? std::min(FILE_NAME_MAX_LENGTH, size - nameIdx) : 0;
+        const char* namePtr = reinterpret_cast<const char*>(data + nameIdx);
+        const std::string entryName(namePtr, strnlen(namePtr, maxNameLength));
+        if (entryName != name) {
+            continue;
+        }
+
+        // the available bytes of every sector, the last ones may be cut by the end of the data
+        size_t available = 0;
+        bool contiguous = true;
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            available += blocks[i] < size ? std::min(SECTOR_SIZE, size - blocks[i]) : 0;
+            if (i > 0 && blocks[i] != blocks[i - 1] + SECTOR_SIZE) {
+                contiguous = false;
+            }
+        }
+
+        if (available < fileSize) {
+            LOGE() << "truncated BCFS file: " << name;
+            return ByteArray();
+        }
+
+        if (fileSize == 0) {
+            return ByteArray();
+        }
+
+        if (contiguous) {
+            return ByteArray::fromRawData(data + blocks.front(), fileSize);
+        }
+
+        ByteArray file;
+        file.resize(fileSize);
+        uint8_t* dst = file.data();
+        size_t copied = 0;
+        for (size_t block : blocks) {
+            if (copied == fileSize || block >= size) {
+                break;
+            }
+
+            const size_t count = std::min({ SECTOR_SIZE, size - block, fileSize - copied });
+            std::memcpy(dst + copied, data + block, count);
+            copied += count;
+        }
+
+        return file;
+    }
+
+    return ByteArray();
+}
+} // namespace mu::iex::guitarpro
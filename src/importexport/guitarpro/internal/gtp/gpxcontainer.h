@@ -0,0 +1,30 @@
+#ifndef MU_IMPORTEXPORT_GPXCONTAINER_H
+#define MU_IMPORTEXPORT_GPXCONTAINER_H
+
+#include <string>
+
+#include "types/bytearray.h"
+
+namespace mu::iex::guitarpro {
+//! NOTE The container of the Guitar Pro 6 files (.gpx):
+//! a BCFS file system of 4 KB sectors, usually compressed into BCFZ
+class GPXContainer
+{
+public:
+    // the four bytes of the header, read as a little endian integer
+    static constexpr int HEADER_BCFS = 1397113666;
+    static constexpr int HEADER_BCFZ = 1514554178;
+
+    static int header(const muse::ByteArray& data);
+
+    //! NOTE BCFZ -> BCFS, the result starts with the BCFS header
+    static muse::ByteArray decompress(const muse::ByteArray& bcfz);
+
+    //! NOTE The content of the first file with the name, empty if there is none.
+    //! A file which lies in consecutive sectors is not copied, the result then refers to bcfs
+    //! and is only valid while bcfs is alive and unchanged
+    static muse::ByteArray readFile(const muse::ByteArray& bcfs, const std::string& name);
+};
+} // namespace mu::iex::guitarpro
+
+#endif // MU_IMPORTEXPORT_GPXCONTAINER_H
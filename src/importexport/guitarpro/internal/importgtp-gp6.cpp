@@ -28,6 +28,7 @@
 
 #include "gtp/gp6dombuilder.h"
 #include "gtp/gpconverter.h"
+#include "gtp/gpxcontainer.h"
 
 #include "engraving/dom/factory.h"
 #include "engraving/dom/arpeggio.h"
@@ -240,105 +241,6 @@ std::unique_ptr<IGPDomBuilder> GuitarPro6::createGPDomBuilder() const
     return std::make_unique<GP6DomBuilder>();
 }
 
-//---------------------------------------------------------
-//   readBit
-//---------------------------------------------------------
-
-int GuitarPro6::readBit(ByteArray* buffer)
-{
-    // calculate the byte index by dividing the position in bits by the bits per byte
-    size_t byteIndex = position / BITS_IN_BYTE;
-
-    // calculate our offset so we know how much to bit shift
-    int byteOffset = ((BITS_IN_BYTE - 1) - (position % BITS_IN_BYTE));
-
-    // calculate the bit which we want to read
-    char byte = (byteIndex < buffer->size()) ? (*buffer)[byteIndex] : char(0);
-    int bit = (((byte & 0xff) >> byteOffset) & 0x01);
-
-    // increment our current position so we know this bit has been read
-    position++;
-    return bit;         // return the bit we calculated
-}
-
-//---------------------------------------------------------
-//   readBits
-//---------------------------------------------------------
-
-int GuitarPro6::readBits(ByteArray* buffer, int bitsToRead)
-{
-    int bits = 0;
-    for (int i = (bitsToRead - 1); i >= 0; i--) {
-        bits |= (readBit(buffer) << i);
-    }
-    return bits;
-}
-
-//---------------------------------------------------------
-//   readBitsReversed
-//---------------------------------------------------------
-
-int GuitarPro6::readBitsReversed(ByteArray* buffer, int bitsToRead)
-{
-    int bits = 0;
-    for (int i = 0; i < bitsToRead; i++) {
-        bits |= readBit(buffer) << i;
-    }
-    return bits;
-}
-
-//---------------------------------------------------------
-//   getBytes
-//---------------------------------------------------------
-
-ByteArray GuitarPro6::getBytes(ByteArray* buffer, int offset, int length)
-{
-    ByteArray newBytes;
-    // compute new bytes from our buffer and return byte array
-    for (int i = 0; i < length; i++) {
-        if (static_cast<int>(buffer->size()) > offset + i) {
-            newBytes.insert(i, ((*buffer)[offset + i]));
-        }
-    }
-    return newBytes;
-}
-
-//---------------------------------------------------------
-//   readInteger
-//---------------------------------------------------------
-
-int GuitarPro6::readInteger(ByteArray* buffer, int offset)
-{
-    // assign four bytes and take them from the buffer
-    char bytes[4];
-    bytes[0] = (*buffer)[offset + 0];
-    bytes[1] = (*buffer)[offset + 1];
-    bytes[2] = (*buffer)[offset + 2];
-    bytes[3] = (*buffer)[offset + 3];
-    // increment positioning so we keep track of where we are
-    position += sizeof(int) * BITS_IN_BYTE;
-    // bit shift in order to compute our integer value and return
-    return ((bytes[3] & 0xff) << 24) | ((bytes[2] & 0xff) << 16) | ((bytes[1] & 0xff) << 8) | (bytes[0] & 0xff);
-}
-
-//---------------------------------------------------------
-//   readString
-//---------------------------------------------------------
-
-ByteArray GuitarPro6::readString(ByteArray* buffer, int offset, int length)
-{
-    ByteArray filename;
-    // compute the string by iterating through the buffer
-    for (int i = 0; i < length; i++) {
-        int charValue = (((*buffer)[offset + i]) & 0xff);
-        if (charValue == 0) {
-            break;
-        }
-        filename.push_back((char)charValue);
-    }
-    return filename;
-}
-
 //---------------------------------------------------------
 //   unhandledNode
 //---------------------------------------------------------
@@ -382,87 +284,23 @@ void GuitarPro6::readGpif(ByteArray* data)
     scoreBuilder.convertGP();
 }
 
-//---------------------------------------------------------
-//   parseFile
-//---------------------------------------------------------
-
-void GuitarPro6::parseFile(const char* filename, ByteArray* data)
-{
-    // test to check if we are dealing with the score
-    if (!strcmp(filename, "score.gpif")) {
-        readGpif(data);
-    }
-}
-
 //---------------------------------------------------------
 //   readGPX
 //---------------------------------------------------------
 
-void GuitarPro6::readGPX(ByteArray* buffer)
+void GuitarPro6::readGPX(const ByteArray& buffer)
 {
-    // start by reading the file header. It will tell us if the byte array is compressed.
-    int fileHeader = readInteger(buffer, 0);
-
-    if (fileHeader == GPX_HEADER_COMPRESSED) {
-        // this is  a compressed file.
-        int length             = readInteger(buffer, position / BITS_IN_BYTE);
-        ByteArray bcfsBuffer;
-        bcfsBuffer.reserve(length);
-        int positionCounter    = 0;
-        while ((position / BITS_IN_BYTE) < length) {
-            // read the bit indicating compression information
-            int flag = readBits(buffer, 1);
-
-            if (flag) {
-                int bits = readBits(buffer, 4);
-                int offs = readBitsReversed(buffer, bits);
-                int size = readBitsReversed(buffer, bits);
-
-                int pos = (static_cast<int>(bcfsBuffer.size()) - offs);
-                for (int i = 0; i < (size > offs ? offs : size); i++) {
-                    bcfsBuffer.insert(positionCounter, bcfsBuffer[pos + i]);
-                    positionCounter++;
-                }
-            } else {
-                int size = readBitsReversed(buffer, 2);
-                for (int i = 0; i < size; i++) {
-                    bcfsBuffer.insert(positionCounter, readBits(buffer, 8));
-                    positionCounter++;
-                }
-            }
-        }
-        // recurse on the decompressed file stored as a byte array
-        readGPX(&bcfsBuffer);
-    } else if (fileHeader == GPX_HEADER_UNCOMPRESSED) {
-        // this is an uncompressed file - strip the header off
-        *buffer = buffer->right(buffer->size() - sizeof(int));
-        size_t sectorSize = 0x1000;
-        int offset        = 0;
-        while ((offset = (offset + static_cast<int>(sectorSize))) + 3 < static_cast<int>(buffer->size())) {
-            int newInt = readInteger(buffer, offset);
-            if (newInt == 2) {
-                int indexFileName = (offset + 4);
-                int indexFileSize = (offset + 0x8C);
-                int indexOfBlock  = (offset + 0x94);
+    // the header tells if the file system is compressed
+    const ByteArray bcfs = GPXContainer::header(buffer) == GPXContainer::HEADER_BCFZ ? GPXContainer::decompress(buffer) : buffer;
+    if (GPXContainer::header(bcfs) != GPXContainer::HEADER_BCFS) {
+        LOGE() << "unknown GPX header";
+        return;
+    }
 
-                // create a byte array and put information about files found in it
-                int block             = 0;
-                int blockCount        = 0;
-                ByteArray* fileBytes = new ByteArray();
-                while ((block = (readInteger(buffer, (indexOfBlock + (4 * (blockCount++)))))) != 0) {
-                    fileBytes->push_back(getBytes(buffer, (offset = (block * static_cast<int>(sectorSize))), static_cast<int>(sectorSize)));
-                }
-                // get file information and read the file
-                size_t fileSize = readInteger(buffer, indexFileSize);
-                if (fileBytes->size() >= fileSize) {
-                    ByteArray filenameBytes = readString(buffer, indexFileName, 127);
-                    const char* filename = filenameBytes.constChar();
-                    ByteArray data = getBytes(fileBytes, 0, static_cast<int>(fileSize));
-                    parseFile(filename, &data);
-                }
-                delete fileBytes;
-            }
-        }
+    // refers to bcfs, which outlives the reading
+    ByteArray data = GPXContainer::readFile(bcfs, "score.gpif");
+    if (!data.empty()) {
+        readGpif(&data);
     }
 }
 
@@ -477,7 +315,7 @@ bool GuitarPro6::read(IODevice* io)
     // decompress and read files contained within GPX file
     ByteArray ba = io->readAll();
 
-    readGPX(&ba);
+    readGPX(ba);
 
     return true;
 }
@@ -500,13 +500,6 @@ public:
 
 class GuitarPro6 : public GuitarPro
 {
-    // an integer stored in the header indicating that the file is not compressed (BCFS).
-    const int GPX_HEADER_UNCOMPRESSED = 1397113666;
-    // an integer stored in the header indicating that the file is not compressed (BCFZ).
-    const int GPX_HEADER_COMPRESSED = 1514554178;
-    int position = 0;
-    // a constant storing the amount of bits per byte
-    const int BITS_IN_BYTE = 8;
     // contains all the information about notes that will go in the parts
     struct GPPartInfo {
         muse::XmlDomNode masterBars;
@@ -517,15 +510,7 @@ class GuitarPro6 : public GuitarPro
         muse::XmlDomNode rhythms;
     };
 
-    void parseFile(const char* filename, muse::ByteArray* data);
-
-    int readBit(muse::ByteArray* buffer);
-    muse::ByteArray getBytes(muse::ByteArray* buffer, int offset, int length);
-    void readGPX(muse::ByteArray* buffer);
-    int readInteger(muse::ByteArray* buffer, int offset);
-    muse::ByteArray readString(muse::ByteArray* buffer, int offset, int length);
-    int readBits(muse::ByteArray* buffer, int bitsToRead);
-    int readBitsReversed(muse::ByteArray* buffer, int bitsToRead);
+    void readGPX(const muse::ByteArray& buffer);
     int findNumMeasures(GPPartInfo* partInfo);
     void readMasterTracks(muse::XmlDomNode* masterTrack);
     void readDrumNote(Note* note, int element, int variation);
@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "io/dir.h"
+#include "io/file.h"
+
+#include "importexport/guitarpro/internal/gtp/gpxcontainer.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace mu::iex::guitarpro;
+
+static const io::path_t GPX_DIR = io::path_t(iex_guitarpro_tests_DATA_ROOT) + "/data";
+
+class GuitarPro_GPXContainerTests : public ::testing::Test
+{
+protected:
+    static std::vector<ByteArray> readGpxFiles()
+    {
+        RetVal<io::paths_t> paths = io::Dir::scanFiles(GPX_DIR, { "*.gpx" }, io::ScanMode::FilesInCurrentDir);
+        EXPECT_TRUE(paths.ret);
+
+        std::vector<ByteArray> files;
+        for (const io::path_t& path : paths.val) {
+            ByteArray data;
+            EXPECT_TRUE(io::File::readFile(path, data));
+            files.push_back(data);
+        }
+
+        return files;
+    }
+
+    //! NOTE The decoder as it was, one bit at a time
+    static ByteArray decompressBitByBit(const ByteArray& bcfz)
+    {
+        size_t position = 32;
+        auto readBit = [&]() {
+            const size_t byteIndex = position / 8;
+            const uint8_t byte = byteIndex < bcfz.size() ? bcfz.constData()[byteIndex] : 0;
+            return (byte >> (7 - position++ % 8)) & 0x01;
+        };
+        auto readBits = [&](int count) {
+            int bits = 0;
+            for (int i = count - 1; i >= 0; --i) {
+                bits |= readBit() << i;
+            }
+            return bits;
+        };
+        auto readBitsReversed = [&](int count) {
+            int bits = 0;
+            for (int i = 0; i < count; ++i) {
+                bits |= readBit() << i;
+            }
+            return bits;
+        };
+
+        const uint8_t* data = bcfz.constData();
+        const size_t length = data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24);
+        position += 32;
+
+        std::vector<uint8_t> out;
+        while (position / 8 < length) {
+            if (readBits(1)) {
+                const int bits = readBits(4);
+                const int offset = readBitsReversed(bits);
+                const int size = readBitsReversed(bits);
+                const size_t pos = out.size() - offset;
+                for (int i = 0; i < std::min(size, offset); ++i) {
+                    out.push_back(out[pos + i]);
+                }
+            } else {
+                const int size = readBitsReversed(2);
+                for (int i = 0; i < size; ++i) {
+                    out.push_back(static_cast<uint8_t>(readBits(8)));
+                }
+            }
+        }
+
+        return ByteArray(out.data(), out.size());
+    }
+};
+
+TEST_F(GuitarPro_GPXContainerTests, Decompress_SameAsBitByBit)
+{
+    const std::vector<ByteArray> files = readGpxFiles();
+    ASSERT_FALSE(files.empty());
+
+    for (const ByteArray& gpx : files) {
+        //! [GIVEN] A compressed Guitar Pro 6 file
+        ASSERT_EQ(GPXContainer::header(gpx), GPXContainer::HEADER_BCFZ);
+
+        //! [WHEN] It is decompressed
+        const ByteArray bcfs = GPXContainer::decompress(gpx);
+
+        //! [THEN] The file system is the same as the one of the original decoder
+        EXPECT_EQ(GPXContainer::header(bcfs), GPXContainer::HEADER_BCFS);
+        EXPECT_EQ(bcfs, decompressBitByBit(gpx));
+
+        //! [THEN] The score is in it
+        const ByteArray gpif = GPXContainer::readFile(bcfs, "score.gpif");
+        ASSERT_FALSE(gpif.empty());
+        EXPECT_EQ(gpif.at(0), '<');
+
+        EXPECT_TRUE(GPXContainer::readFile(bcfs, "no-such-file").empty());
+    }
+}
+
+TEST_F(GuitarPro_GPXContainerTests, Truncated_NoCrash)
+{
+    const std::vector<ByteArray> files = readGpxFiles();
+    ASSERT_FALSE(files.empty());
+
+    //! [GIVEN] A file cut in the middle
+    const ByteArray& gpx = files.front();
+    const ByteArray truncated = gpx.left(gpx.size() / 2);
+
+    //! [THEN] What is there is decompressed
+    EXPECT_EQ(GPXContainer::header(GPXContainer::decompress(truncated)), GPXContainer::HEADER_BCFS);
+
+    //! [GIVEN] The BCFS cut one byte before the end of the score
+    //! NOTE Where the score ends depends on the file, the shortest BCFS that still holds it is searched
+    const ByteArray bcfs = GPXContainer::decompress(gpx);
+    const ByteArray score = GPXContainer::readFile(bcfs, "score.gpif");
+    ASSERT_FALSE(score.empty());
+
+    size_t notHolding = 0;
+    size_t holding = bcfs.size();
+    while (holding - notHolding > 1) {
+        const size_t middle = (notHolding + holding) / 2;
+        if (GPXContainer::readFile(bcfs.left(middle), "score.gpif") == score) {
+            holding = middle;
+        } else {
+            notHolding = middle;
+        }
+    }
+
+    //! [THEN] The score is not read partly
+    const ByteArray cutBcfs = bcfs.left(holding - 1);
+    EXPECT_TRUE(GPXContainer::readFile(cutBcfs, "score.gpif").empty());
+
+    EXPECT_EQ(GPXContainer::header(ByteArray()), 0);
+    EXPECT_TRUE(GPXContainer::decompress(ByteArray()).empty());
+}
+
+TEST_F(GuitarPro_GPXContainerTests, Throughput)
+{
+    const std::vector<ByteArray> files = readGpxFiles();
+    ASSERT_FALSE(files.empty());
+
+    constexpr int REPEAT = 10;
+
+    size_t compressedSize = 0;
+    size_t decompressedSize = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEAT; ++i) {
+        for (const ByteArray& gpx : files) {
+            const ByteArray bcfs = GPXContainer::decompress(gpx);
+            const ByteArray gpif = GPXContainer::readFile(bcfs, "score.gpif");
+            EXPECT_FALSE(gpif.empty());
+
+            compressedSize += gpx.size();
+            decompressedSize += bcfs.size();
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double mb = 1024.0 * 1024.0;
+    LOGI() << "BCFZ: " << files.size() << " files x " << REPEAT << ", "
+           << compressedSize / mb / seconds << " MB/s in, " << decompressedSize / mb / seconds << " MB/s out";
+}
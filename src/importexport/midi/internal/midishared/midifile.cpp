@@ -22,6 +22,8 @@
 
 #include "midifile.h"
 
+#include <algorithm>
+
 #include "containers.h"
 
 #include "engraving/dom/part.h"
@@ -92,11 +94,15 @@ MidiFile::MidiFile()
 bool MidiFile::write(QIODevice* out)
 {
     fp = out;
+    _writeBuffer.clear();
     write("MThd", 4);
     writeLong(6);                   // header len
     writeShort(_format);            // format
     writeShort(static_cast<int>(_tracks.size()));
     writeShort(_division);
+    if (flush()) {
+        return true;
+    }
     for (const auto& t: _tracks) {
         if (writeTrack(t)) {
             return true;
@@ -105,6 +111,24 @@ bool MidiFile::write(QIODevice* out)
     return false;
 }
 
+//---------------------------------------------------------
+//   flush
+//    write the encoded chunk to the device in one go
+//    returns true on error
+//---------------------------------------------------------
+
+bool MidiFile::flush()
+{
+    const qint64 len = _writeBuffer.size();
+    const qint64 rv = fp->write(_writeBuffer.constData(), len);
+    _writeBuffer.clear();
+    if (rv == len) {
+        return false;
+    }
+    LOGD("write midifile failed: %s", fp->errorString().toLatin1().data());
+    return true;
+}
+
 //---------------------------------------------------------
 //   write
 //---------------------------------------------------------
@@ -174,17 +198,24 @@ void MidiFile::writeEvent(const MidiEvent& event)
 
 //---------------------------------------------------------
 //   writeTrack
+//    the track chunk is encoded into memory, so that its
+//    length is known without seeking back in the device
+//    returns true on error
 //---------------------------------------------------------
 
 bool MidiFile::writeTrack(const MidiTrack& t)
 {
+    const MidiTrack::EventList& events = t.events();
+
+    // most channel events take 3 bytes plus a 1 byte delta time
+    _writeBuffer.reserve(static_cast<int>(events.size() * 4 + 16));
+
     write("MTrk", 4);
-    qint64 lenpos = fp->pos();
     writeLong(0);                   // dummy len
 
     status   = -1;
     int tick = 0;
-    for (auto i : t.events()) {
+    for (const auto& i : events) {
         int ntick = i.first;
         putvl(ntick - tick);        // write tick delta
         //
@@ -206,11 +237,15 @@ bool MidiFile::writeTrack(const MidiTrack& t)
     put(0xff);          // Meta
     put(0x2f);          // EOT
     putvl(0);           // len 0
-    qint64 endpos = fp->pos();
-    fp->seek(lenpos);
-    writeLong(endpos - lenpos - 4); // tracklen
-    fp->seek(endpos);
-    return false;
+
+    const int trackLen = static_cast<int>(_writeBuffer.size()) - 8;
+    char* lenData = _writeBuffer.data() + 4;
+    lenData[0] = static_cast<char>(trackLen >> 24);
+    lenData[1] = static_cast<char>(trackLen >> 16);
+    lenData[2] = static_cast<char>(trackLen >> 8);
+    lenData[3] = static_cast<char>(trackLen);
+
+    return flush();
 }
 
 //---------------------------------------------------------
@@ -396,14 +431,9 @@ void MidiFile::read(void* p, qint64 len)
 //   write
 //---------------------------------------------------------
 
-bool MidiFile::write(const void* p, qint64 len)
+void MidiFile::write(const void* p, qint64 len)
 {
-    qint64 rv = fp->write((char*)p, len);
-    if (rv == len) {
-        return false;
-    }
-    LOGD("write midifile failed: %s", fp->errorString().toLatin1().data());
-    return true;
+    _writeBuffer.append(static_cast<const char*>(p), static_cast<int>(len));
 }
 
 //---------------------------------------------------------
@@ -428,8 +458,8 @@ int MidiFile::readShort()
 
 void MidiFile::writeShort(int i)
 {
-    fp->putChar(i >> 8);
-    fp->putChar(i);
+    put(i >> 8);
+    put(i);
 }
 
 //---------------------------------------------------------
@@ -455,10 +485,10 @@ int MidiFile::readLong()
 
 void MidiFile::writeLong(int i)
 {
-    fp->putChar(i >> 24);
-    fp->putChar(i >> 16);
-    fp->putChar(i >> 8);
-    fp->putChar(i);
+    put(i >> 24);
+    put(i >> 16);
+    put(i >> 8);
+    put(i);
 }
 
 /*---------------------------------------------------------
@@ -488,20 +518,13 @@ int MidiFile::getvl()
 
 void MidiFile::putvl(unsigned val)
 {
-    unsigned long buf = val & 0x7f;
+    uchar buf[5];
+    int pos = sizeof(buf) - 1;
+    buf[pos] = val & 0x7f;
     while ((val >>= 7) > 0) {
-        buf <<= 8;
-        buf |= 0x80;
-        buf += (val & 0x7f);
-    }
-    for (;;) {
-        put(buf);
-        if (buf & 0x80) {
-            buf >>= 8;
-        } else {
-            break;
-        }
+        buf[--pos] = 0x80 | (val & 0x7f);
     }
+    write(buf + pos, sizeof(buf) - pos);
 }
 
 //---------------------------------------------------------
@@ -525,7 +548,42 @@ MidiTrack::~MidiTrack()
 
 void MidiTrack::insert(int tick, const MidiEvent& event)
 {
-    _events.insert({ tick, event });
+    if (!_events.empty() && tick < _events.back().first) {
+        _sorted = false;
+    }
+    _events.emplace_back(tick, event);
+}
+
+//---------------------------------------------------------
+//   events
+//---------------------------------------------------------
+
+const MidiTrack::EventList& MidiTrack::events() const
+{
+    sortEvents();
+    return _events;
+}
+
+MidiTrack::EventList& MidiTrack::events()
+{
+    sortEvents();
+    return _events;
+}
+
+//---------------------------------------------------------
+//   sortEvents
+//---------------------------------------------------------
+
+void MidiTrack::sortEvents() const
+{
+    if (_sorted) {
+        return;
+    }
+
+    std::stable_sort(_events.begin(), _events.end(), [](const auto& e1, const auto& e2) {
+        return e1.first < e2.first;
+    });
+    _sorted = true;
 }
 
 //---------------------------------------------------------
@@ -699,7 +757,11 @@ void MidiTrack::setOutChannel(int n)
 
 void MidiTrack::mergeNoteOnOffAndFindMidiType(MidiType* mt)
 {
-    std::multimap<int, MidiEvent> el;
+    sortEvents();
+
+    // events are visited in tick order, so el stays sorted
+    EventList el;
+    el.reserve(_events.size());
 
     int hbank = 0xff;
     int lbank = 0xff;
@@ -845,7 +907,7 @@ void MidiTrack::mergeNoteOnOffAndFindMidiType(MidiType* mt)
                     }
                 }
             }
-            el.insert(std::pair<int, MidiEvent>(i->first, ev));
+            el.emplace_back(i->first, ev);
             ev.setType(ME_INVALID);
             continue;
         }
@@ -879,10 +941,10 @@ void MidiTrack::mergeNoteOnOffAndFindMidiType(MidiType* mt)
             LOGD("-no note-off for note at %d", tick);
             note.setLen(1);
         }
-        el.insert(std::pair<int, MidiEvent>(tick, note));
+        el.emplace_back(tick, note);
         ev.setType(ME_INVALID);
     }
-    _events = el;
+    _events = std::move(el);
 }
 
 //---------------------------------------------------------
@@ -921,8 +983,11 @@ void MidiFile::separateChannel()
         //!       Let's get the actual track data again
         MidiTrack& actualMidiTrack = _tracks[i];
 
-        // extract all different channel events from current track to inserted tracks
-        for (auto ie = actualMidiTrack.events().begin(); ie != actualMidiTrack.events().end();) {
+        // extract all different channel events from current track to inserted tracks,
+        // compacting the remaining events in place
+        MidiTrack::EventList& events = actualMidiTrack.events();
+        auto kept = events.begin();
+        for (auto ie = events.begin(); ie != events.end(); ++ie) {
             const MidiEvent& e = ie->second;
             if (e.isChannelEvent()) {
                 int ch  = e.channel();
@@ -930,12 +995,15 @@ void MidiFile::separateChannel()
                 MidiTrack& t = _tracks[i + idx];
                 if (&t != &actualMidiTrack) {
                     t.insert(ie->first, e);
-                    ie = actualMidiTrack.events().erase(ie);
                     continue;
                 }
             }
-            ++ie;
+            if (kept != ie) {
+                *kept = *ie;
+            }
+            ++kept;
         }
+        events.erase(kept, events.end());
         i += nn - 1;
     }
 }
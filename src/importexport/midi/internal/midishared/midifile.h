@@ -24,6 +24,7 @@
 #define MIDISHARED_MIDIFILE_H
 
 #include <vector>
+#include <QByteArray>
 #include <QIODevice>
 
 #include "../midishared/midievent.h"
@@ -45,18 +46,29 @@ class MidiFile;
 
 class MidiTrack
 {
-    std::multimap<int, MidiEvent> _events;
+public:
+    //! NOTE Events are kept in a flat array, ordered by tick.
+    //! Events with the same tick keep their insertion order.
+    using EventList = std::vector<std::pair<int, MidiEvent> >;
+
+private:
+    // Events are appended by insert() and sorted on first access,
+    // so that filling a track does not allocate a node per event
+    mutable EventList _events;
+    mutable bool _sorted = true;
     int _outChannel;
     int _outPort;
     bool _drumTrack;
 
+    void sortEvents() const;
+
 public:
     MidiTrack();
     ~MidiTrack();
 
     bool empty() const;
-    const std::multimap<int, MidiEvent>& events() const { return _events; }
-    std::multimap<int, MidiEvent>& events() { return _events; }
+    const EventList& events() const;
+    EventList& events();
 
     int outChannel() const { return _outChannel; }
     void setOutChannel(int n);
@@ -89,17 +101,21 @@ class MidiFile
     int click;                   ///< current tick position in file
     qint64 curPos;               ///< current file byte position
 
+    // values used during write()
+    QByteArray _writeBuffer;     ///< chunk being encoded, see flush()
+
     void writeEvent(const MidiEvent& event);
 
 protected:
     // write
-    bool write(const void*, qint64);
+    void write(const void*, qint64);
     void writeShort(int);
     void writeLong(int);
     bool writeTrack(const MidiTrack&);
     void putvl(unsigned);
-    void put(unsigned char c) { write(&c, 1); }
+    void put(unsigned char c) { _writeBuffer.append(static_cast<char>(c)); }
     void writeStatus(int type, int channel);
+    bool flush();
 
     // read
     void read(void*, qint64);
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QBuffer>
+#include <QDir>
+
+#include "testing/qtestsuite.h"
+#include "testbase.h"
+
+#include "engraving/dom/masterscore.h"
+#include "importexport/midi/internal/midiexport/exportmidi.h"
+
+static const QString MIDIRENDERER_DATA_DIR("midirenderer_data/");
+
+using namespace mu::engraving;
+using namespace mu::iex::midi;
+
+//---------------------------------------------------------
+//   TestMidiExportBenchmark
+//    MIDI export throughput on the midi renderer test scores
+//---------------------------------------------------------
+
+class TestMidiExportBenchmark : public QObject, public MTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void exportScore_data();
+    void exportScore();
+};
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestMidiExportBenchmark::initTestCase()
+{
+    setRootDir(QString(ENGRAVING_TESTS_DATA_ROOT));
+}
+
+//---------------------------------------------------------
+//   exportScore_data
+//---------------------------------------------------------
+
+void TestMidiExportBenchmark::exportScore_data()
+{
+    QTest::addColumn<QString>("file");
+
+    const QDir dir(root + "/" + MIDIRENDERER_DATA_DIR);
+    for (const QString& file : dir.entryList({ "*.mscx" }, QDir::Files, QDir::Name)) {
+        QTest::newRow(file.toUtf8().constData()) << file;
+    }
+}
+
+//---------------------------------------------------------
+//   exportScore
+//    render the score and write it into memory, so that only
+//    the rendering and the SMF encoding are measured
+//---------------------------------------------------------
+
+void TestMidiExportBenchmark::exportScore()
+{
+    QFETCH(QString, file);
+
+    MasterScore* score = readScore(MIDIRENDERER_DATA_DIR + file);
+    QVERIFY(score);
+
+    QByteArray data;
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+
+        ExportMidi exporter(score);
+        QVERIFY(exporter.write(&buffer, true, true));
+    }
+
+    QVERIFY(data.startsWith("MThd"));
+
+    delete score;
+}
+
+QTEST_MAIN(TestMidiExportBenchmark)
+
+#include "midiexport_benchmark.moc"
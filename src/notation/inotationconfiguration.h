@@ -158,6 +158,11 @@ public:
     virtual int notePlayDurationMilliseconds() const = 0;
     virtual void setNotePlayDurationMilliseconds(int durationMs) = 0;
 
+    //! NOTE 0 means no limit
+    virtual int undoHistoryMemoryLimitMb() const = 0;
+    virtual void setUndoHistoryMemoryLimitMb(int limitMb) = 0;
+    virtual muse::async::Notification undoHistoryMemoryLimitMbChanged() const = 0;
+
     virtual void setTemplateModeEnabled(std::optional<bool> enabled) = 0;
     virtual void setTestModeEnabled(std::optional<bool> enabled) = 0;
 
@@ -24,6 +24,8 @@
 
 #include <memory>
 
+#include "async/channel.h"
+
 #include "notationtypes.h"
 
 #include "draw/painter.h"
@@ -46,6 +48,15 @@ public:
     virtual muse::SizeF pageSizeInch(const Options& opt) const = 0;
 
     virtual void paintView(muse::draw::Painter* painter, const muse::RectF& frameRect, bool isPrinting) = 0;
+
+    //! NOTE paintView() is the score, which views may cache, plus the interaction overlay
+    //! (shadow note, grips, lasso, drop targets...), which changes much more often
+    virtual void paintViewScore(muse::draw::Painter* painter, const muse::RectF& frameRect, bool isPrinting) = 0;
+    virtual void paintViewOverlay(muse::draw::Painter* painter) = 0;
+
+    //! NOTE The logical rect to repaint after Score::update(), an invalid rect means the whole score
+    virtual muse::async::Channel<muse::RectF> scoreAreaChanged() const = 0;
+
     virtual void paintPdf(muse::draw::Painter* painter, const Options& opt) = 0;
     virtual void paintPrint(muse::draw::Painter* painter, const Options& opt) = 0;
     virtual void paintPng(muse::draw::Painter* painter, const Options& opt) = 0;
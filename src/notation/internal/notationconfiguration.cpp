@@ -74,6 +74,7 @@ static const Settings::Key COLOR_NOTES_OUTSIDE_OF_USABLE_PITCH_RANGE(module_name
 static const Settings::Key WARN_GUITAR_BENDS(module_name, "score/note/warnGuitarBends");
 static const Settings::Key REALTIME_DELAY(module_name, "io/midi/realtimeDelay");
 static const Settings::Key NOTE_DEFAULT_PLAY_DURATION(module_name, "score/note/defaultPlayDuration");
+static const Settings::Key UNDO_HISTORY_MEMORY_LIMIT(module_name, "score/undo/memoryLimitMb");
 
 static const Settings::Key FIRST_SCORE_ORDER_LIST_KEY(module_name, "application/paths/scoreOrderList1");
 static const Settings::Key SECOND_SCORE_ORDER_LIST_KEY(module_name, "application/paths/scoreOrderList2");
@@ -189,6 +190,10 @@ void NotationConfiguration::init()
     settings()->setDefaultValue(WARN_GUITAR_BENDS, Val(true));
     settings()->setDefaultValue(REALTIME_DELAY, Val(750));
     settings()->setDefaultValue(NOTE_DEFAULT_PLAY_DURATION, Val(500));
+    settings()->setDefaultValue(UNDO_HISTORY_MEMORY_LIMIT, Val(512));
+    settings()->valueChanged(UNDO_HISTORY_MEMORY_LIMIT).onReceive(nullptr, [this](const Val&) {
+        m_undoHistoryMemoryLimitMbChanged.notify();
+    });
 
     settings()->setDefaultValue(FIRST_SCORE_ORDER_LIST_KEY,
                                 Val(globalConfiguration()->appDataPath().toStdString() + "instruments/orders.xml"));
@@ -701,6 +706,21 @@ void NotationConfiguration::setNotePlayDurationMilliseconds(int durationMs)
     settings()->setSharedValue(NOTE_DEFAULT_PLAY_DURATION, Val(durationMs));
 }
 
+int NotationConfiguration::undoHistoryMemoryLimitMb() const
+{
+    return settings()->value(UNDO_HISTORY_MEMORY_LIMIT).toInt();
+}
+
+void NotationConfiguration::setUndoHistoryMemoryLimitMb(int limitMb)
+{
+    settings()->setSharedValue(UNDO_HISTORY_MEMORY_LIMIT, Val(limitMb));
+}
+
+Notification NotationConfiguration::undoHistoryMemoryLimitMbChanged() const
+{
+    return m_undoHistoryMemoryLimitMbChanged;
+}
+
 void NotationConfiguration::setTemplateModeEnabled(std::optional<bool> enabled)
 {
     mu::engraving::MScore::saveTemplateMode = enabled ? enabled.value() : false;
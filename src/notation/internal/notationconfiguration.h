@@ -163,6 +163,10 @@ public:
     int notePlayDurationMilliseconds() const override;
     void setNotePlayDurationMilliseconds(int durationMs) override;
 
+    int undoHistoryMemoryLimitMb() const override;
+    void setUndoHistoryMemoryLimitMb(int limitMb) override;
+    muse::async::Notification undoHistoryMemoryLimitMbChanged() const override;
+
     void setTemplateModeEnabled(std::optional<bool> enabled) override;
     void setTestModeEnabled(std::optional<bool> enabled) override;
 
@@ -223,6 +227,7 @@ private:
     muse::async::Notification m_isLimitCanvasScrollAreaChanged;
     muse::async::Notification m_isPlayRepeatsChanged;
     muse::async::Notification m_isPlayChordSymbolsChanged;
+    muse::async::Notification m_undoHistoryMemoryLimitMbChanged;
     muse::ValCh<int> m_pianoKeyboardNumberOfKeys;
 
     int m_styleDialogLastPageIndex = 0;
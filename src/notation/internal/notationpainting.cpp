@@ -35,9 +35,61 @@ using namespace mu::notation;
 using namespace mu::engraving;
 using namespace muse::draw;
 
+NotationPainting::ScoreUpdateListener::ScoreUpdateListener(NotationPainting* painting)
+    : m_painting(painting)
+{
+}
+
+NotationPainting::ScoreUpdateListener::~ScoreUpdateListener()
+{
+    setScore(nullptr);
+}
+
+void NotationPainting::ScoreUpdateListener::setScore(Score* score)
+{
+    if (m_score == score) {
+        return;
+    }
+
+    if (m_score) {
+        m_score->removeViewer(this);
+    }
+
+    m_score = score;
+
+    if (m_score) {
+        m_score->addViewer(this);
+    }
+}
+
+void NotationPainting::ScoreUpdateListener::removeScore()
+{
+    //! NOTE The score is being deleted
+    m_score = nullptr;
+}
+
+void NotationPainting::ScoreUpdateListener::dataChanged(const RectF& rect)
+{
+    m_painting->m_scoreAreaChanged.send(rect);
+}
+
+void NotationPainting::ScoreUpdateListener::updateAll()
+{
+    m_painting->m_scoreAreaChanged.send(RectF());
+}
+
+void NotationPainting::ScoreUpdateListener::drawBackground(Painter* painter, const RectF& rect) const
+{
+    //! NOTE Same as when the score has no viewers
+    painter->fillRect(rect, m_painting->engravingConfiguration()->noteBackgroundColor());
+}
+
 NotationPainting::NotationPainting(Notation* notation)
-    : m_notation(notation)
+    : m_notation(notation), m_scoreUpdateListener(this)
 {
+    m_notation->scoreInited().onNotify(this, [this]() {
+        m_scoreUpdateListener.setScore(score());
+    });
 }
 
 mu::engraving::Score* NotationPainting::score() const
@@ -113,6 +165,15 @@ bool NotationPainting::isPaintPageBorder() const
 void NotationPainting::doPaint(Painter* painter, const Options& opt)
 {
     TRACEFUNC;
+    paintScore(painter, opt);
+
+    if (!opt.isPrinting) {
+        paintViewOverlay(painter);
+    }
+}
+
+void NotationPainting::paintScore(Painter* painter, const Options& opt)
+{
     if (!score()) {
         return;
     }
@@ -124,10 +185,6 @@ void NotationPainting::doPaint(Painter* painter, const Options& opt)
     };
 
     scoreRenderer()->paintScore(painter, score(), myopt);
-
-    if (!myopt.isPrinting) {
-        static_cast<NotationInteraction*>(m_notation->interaction().get())->paint(painter);
-    }
 }
 
 void NotationPainting::paintPageSheet(Painter* painter, const Page* page, const RectF& pageRect, bool printPageBackground) const
@@ -178,7 +235,7 @@ void NotationPainting::paintPageSheet(Painter* painter, const Page* page, const
     }
 }
 
-void NotationPainting::paintView(Painter* painter, const RectF& frameRect, bool isPrinting)
+NotationPainting::Options NotationPainting::viewOptions(const RectF& frameRect, bool isPrinting) const
 {
     Options opt;
     opt.isSetViewport = false;
@@ -186,7 +243,31 @@ void NotationPainting::paintView(Painter* painter, const RectF& frameRect, bool
     opt.frameRect = frameRect;
     opt.deviceDpi = uiConfiguration()->logicalDpi();
     opt.isPrinting = isPrinting;
-    doPaint(painter, opt);
+    return opt;
+}
+
+void NotationPainting::paintView(Painter* painter, const RectF& frameRect, bool isPrinting)
+{
+    doPaint(painter, viewOptions(frameRect, isPrinting));
+}
+
+void NotationPainting::paintViewScore(Painter* painter, const RectF& frameRect, bool isPrinting)
+{
+    paintScore(painter, viewOptions(frameRect, isPrinting));
+}
+
+void NotationPainting::paintViewOverlay(Painter* painter)
+{
+    if (!score()) {
+        return;
+    }
+
+    static_cast<NotationInteraction*>(m_notation->interaction().get())->paint(painter);
+}
+
+muse::async::Channel<RectF> NotationPainting::scoreAreaChanged() const
+{
+    return m_scoreAreaChanged;
 }
 
 void NotationPainting::paintPdf(Painter* painter, const Options& opt)
@@ -24,10 +24,12 @@
 
 #include "../inotationpainting.h"
 
+#include "async/asyncable.h"
 #include "modularity/ioc.h"
 #include "../inotationconfiguration.h"
 #include "engraving/iengravingconfiguration.h"
 #include "engraving/rendering/iscorerenderer.h"
+#include "engraving/dom/mscoreview.h"
 #include "ui/iuiconfiguration.h"
 
 namespace mu::engraving {
@@ -37,7 +39,7 @@ class Page;
 
 namespace mu::notation {
 class Notation;
-class NotationPainting : public INotationPainting
+class NotationPainting : public INotationPainting, public muse::async::Asyncable
 {
     INJECT(INotationConfiguration, configuration)
     INJECT(engraving::IEngravingConfiguration, engravingConfiguration)
@@ -56,15 +58,41 @@ public:
     muse::SizeF pageSizeInch(const Options& opt) const override;
 
     void paintView(muse::draw::Painter* painter, const muse::RectF& frameRect, bool isPrinting) override;
+    void paintViewScore(muse::draw::Painter* painter, const muse::RectF& frameRect, bool isPrinting) override;
+    void paintViewOverlay(muse::draw::Painter* painter) override;
+    muse::async::Channel<muse::RectF> scoreAreaChanged() const override;
+
     void paintPdf(muse::draw::Painter* painter, const Options& opt) override;
     void paintPrint(muse::draw::Painter* painter, const Options& opt) override;
     void paintPng(muse::draw::Painter* painter, const Options& opt) override;
 
 private:
+    //! NOTE Receives the refresh rects of Score::update()
+    class ScoreUpdateListener : public engraving::MuseScoreView
+    {
+    public:
+        ScoreUpdateListener(NotationPainting* painting);
+        ~ScoreUpdateListener() override;
+
+        void setScore(engraving::Score* score) override;
+        void removeScore() override;
+
+        void dataChanged(const muse::RectF& rect) override;
+        void updateAll() override;
+        void drawBackground(muse::draw::Painter* painter, const muse::RectF& rect) const override;
+        const muse::Rect geometry() const override { return muse::Rect(); }
+
+    private:
+        NotationPainting* m_painting = nullptr;
+    };
+
     mu::engraving::Score* score() const;
 
+    Options viewOptions(const muse::RectF& frameRect, bool isPrinting) const;
+
     bool isPaintPageBorder() const;
     void doPaint(muse::draw::Painter* painter, const Options& opt);
+    void paintScore(muse::draw::Painter* painter, const Options& opt);
     void paintPageBorder(muse::draw::Painter* painter, const mu::engraving::Page* page) const;
     void paintPageSheet(muse::draw::Painter* painter, const engraving::Page* page, const muse::RectF& pageRect,
                         bool printPageBackground) const;
@@ -72,6 +100,9 @@ private:
     Notation* m_notation = nullptr;
 
     muse::async::Notification m_viewModeChanged;
+
+    ScoreUpdateListener m_scoreUpdateListener;
+    muse::async::Channel<muse::RectF> m_scoreAreaChanged;
 };
 }
 
@@ -38,6 +38,7 @@
 #include "engraving/dom/stafftext.h"
 #include "engraving/dom/tempo.h"
 #include "engraving/dom/tempotext.h"
+#include "engraving/dom/undo.h"
 #include "engraving/dom/utils.h"
 
 #include "notationerrors.h"
@@ -53,6 +54,10 @@ using namespace muse::async;
 
 static constexpr int PLAYBACK_TAIL_SECS = 3;
 
+// the playback model renders the changes of the score in slices, between the events of the UI
+static constexpr std::chrono::milliseconds PLAYBACK_MODEL_UPDATE_SLICE(8);
+static constexpr int PLAYBACK_MODEL_UPDATE_COMMAND_WAIT_INTERVAL = 50;
+
 NotationPlayback::NotationPlayback(IGetScore* getScore,
                                    muse::async::Notification notationChanged)
     : m_getScore(getScore), m_notationChanged(notationChanged)
@@ -60,6 +65,9 @@ NotationPlayback::NotationPlayback(IGetScore* getScore,
     m_notationChanged.onNotify(this, [this]() {
         updateLoopBoundaries();
     });
+
+    m_playbackModelUpdateTimer.setSingleShot(true);
+    QObject::connect(&m_playbackModelUpdateTimer, &QTimer::timeout, [this]() { processPlaybackModelUpdate(); });
 }
 
 mu::engraving::Score* NotationPlayback::score() const
@@ -75,9 +83,14 @@ void NotationPlayback::init()
 
     m_playbackModel.setPlayRepeats(configuration()->isPlayRepeatsEnabled());
     m_playbackModel.setPlayChordSymbols(configuration()->isPlayChordSymbolsEnabled());
+    m_playbackModel.setDeferredUpdateEnabled(true);
 
     m_playbackModel.load(score());
 
+    m_playbackModel.pendingUpdateAdded().onNotify(this, [this]() {
+        m_playbackModelUpdateTimer.start(0);
+    });
+
     updateTotalPlayTime();
     m_playbackModel.dataChanged().onNotify(this, [this]() {
         updateTotalPlayTime();
@@ -104,6 +117,22 @@ void NotationPlayback::init()
     });
 }
 
+void NotationPlayback::processPlaybackModelUpdate()
+{
+    if (m_playbackModel.processPendingUpdate(PLAYBACK_MODEL_UPDATE_SLICE)) {
+        return;
+    }
+
+    //! NOTE The model waits for the end of the command in progress
+    const bool isCommandActive = score() && score()->undoStack()->active();
+    m_playbackModelUpdateTimer.start(isCommandActive ? PLAYBACK_MODEL_UPDATE_COMMAND_WAIT_INTERVAL : 0);
+}
+
+engraving::PlaybackModel& NotationPlayback::playbackModel() const
+{
+    return m_playbackModel;
+}
+
 const engraving::InstrumentTrackId& NotationPlayback::metronomeTrackId() const
 {
     return m_playbackModel.metronomeTrackId();
@@ -24,6 +24,8 @@
 
 #include <memory>
 
+#include <QTimer>
+
 #include "modularity/ioc.h"
 #include "async/asyncable.h"
 #include "engraving/playback/playbackmodel.h"
@@ -40,6 +42,7 @@ class Score;
 namespace mu::notation {
 class NotationPlayback : public INotationPlayback, public muse::async::Asyncable
 {
+public:
     INJECT(INotationConfiguration, configuration)
 
 public:
@@ -86,6 +89,9 @@ public:
     bool hasSoundFlags() override;
     bool hasSoundFlags(const engraving::InstrumentTrackIdSet& trackIdSet) override;
 
+    //! NOTE The changes of the score are rendered from a timer of the main thread, see PlaybackModel::processPendingUpdate
+    engraving::PlaybackModel& playbackModel() const;
+
 private:
     engraving::Score* score() const;
 
@@ -94,6 +100,7 @@ private:
     muse::RectF loopBoundaryRectByTick(LoopBoundaryType boundaryType, int tick) const;
     void updateLoopBoundaries();
     void updateTotalPlayTime();
+    void processPlaybackModelUpdate();
 
     bool doAddSoundFlag(mu::engraving::StaffText* staffText);
 
@@ -114,6 +121,7 @@ private:
     mutable Tempo m_currentTempo;
 
     mutable engraving::PlaybackModel m_playbackModel;
+    QTimer m_playbackModelUpdateTimer;
 };
 }
 
@@ -33,6 +33,13 @@ using namespace muse::async;
 NotationUndoStack::NotationUndoStack(IGetScore* getScore, Notification notationChanged)
     : m_getScore(getScore), m_notationChanged(notationChanged)
 {
+    m_getScore->scoreInited().onNotify(this, [this]() {
+        updateMemoryBudget();
+    });
+
+    configuration()->undoHistoryMemoryLimitMbChanged().onNotify(this, [this]() {
+        updateMemoryBudget();
+    });
 }
 
 bool NotationUndoStack::canUndo() const
@@ -191,6 +198,15 @@ mu::engraving::UndoStack* NotationUndoStack::undoStack() const
     return score() ? score()->undoStack() : nullptr;
 }
 
+void NotationUndoStack::updateMemoryBudget()
+{
+    if (!undoStack()) {
+        return;
+    }
+
+    undoStack()->setMemoryBudget(static_cast<size_t>(std::max(configuration()->undoHistoryMemoryLimitMb(), 0)) * 1024 * 1024);
+}
+
 void NotationUndoStack::notifyAboutNotationChanged()
 {
     m_notationChanged.notify();
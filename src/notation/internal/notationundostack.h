@@ -23,7 +23,10 @@
 #ifndef MU_NOTATION_UNDOSTACK
 #define MU_NOTATION_UNDOSTACK
 
+#include "async/asyncable.h"
+#include "modularity/ioc.h"
 #include "inotationundostack.h"
+#include "inotationconfiguration.h"
 #include "igetscore.h"
 
 namespace mu::engraving {
@@ -34,8 +37,10 @@ class EditData;
 }
 
 namespace mu::notation {
-class NotationUndoStack : public INotationUndoStack
+class NotationUndoStack : public INotationUndoStack, public muse::async::Asyncable
 {
+    INJECT(INotationConfiguration, configuration)
+
 public:
     NotationUndoStack(IGetScore* getScore, muse::async::Notification notationChanged);
 
@@ -61,6 +66,8 @@ public:
     muse::async::Channel<ChangesRange> changesChannel() const override;
 
 private:
+    void updateMemoryBudget();
+
     void notifyAboutNotationChanged();
     void notifyAboutStateChanged();
     void notifyAboutUndo();
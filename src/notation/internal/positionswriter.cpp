@@ -70,11 +70,21 @@ static void writeEventPosition(deprecated::XmlWriter& writer, const std::string&
 
 static void writeMeasureEvents(deprecated::XmlWriter& writer, Measure* m, int offset, const QHash<void*, int>& segments)
 {
+    std::vector<mu::engraving::Segment*> chordRestSegments;
+    std::vector<int> ticks;
+
     for (mu::engraving::Segment* s = m->first(mu::engraving::SegmentType::ChordRest); s;
          s = s->next(mu::engraving::SegmentType::ChordRest)) {
-        int tick = s->tick().ticks() + offset;
-        int id = segments[(void*)s];
-        int time = lrint(m->score()->repeatList().utick2utime(tick) * 1000);
+        chordRestSegments.push_back(s);
+        ticks.push_back(s->tick().ticks() + offset);
+    }
+
+    std::vector<double> times;
+    m->score()->repeatList().utick2utime(ticks, times);
+
+    for (size_t i = 0; i < chordRestSegments.size(); ++i) {
+        int id = segments[(void*)chordRestSegments[i]];
+        int time = lrint(times[i] * 1000);
 
         writeEventPosition(writer, std::to_string(id), time);
     }
@@ -148,6 +148,10 @@ public:
     MOCK_METHOD(int, notePlayDurationMilliseconds, (), (const, override));
     MOCK_METHOD(void, setNotePlayDurationMilliseconds, (int), (override));
 
+    MOCK_METHOD(int, undoHistoryMemoryLimitMb, (), (const, override));
+    MOCK_METHOD(void, setUndoHistoryMemoryLimitMb, (int), (override));
+    MOCK_METHOD(muse::async::Notification, undoHistoryMemoryLimitMbChanged, (), (const, override));
+
     MOCK_METHOD(void, setTemplateModeEnabled, (std::optional<bool>), (override));
     MOCK_METHOD(void, setTestModeEnabled, (std::optional<bool>), (override));
 
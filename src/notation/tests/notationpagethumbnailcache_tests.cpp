@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <QCoreApplication>
+#include <QImage>
+
+#include "async/asyncable.h"
+#include "async/processevents.h"
+#include "draw/painter.h"
+#include "draw/internal/qimagepainterprovider.h"
+
+#include "notation/view/notationpagethumbnailcache.h"
+
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::draw;
+
+static constexpr double PAGE_WIDTH = 2000;
+static constexpr double PAGE_HEIGHT = 3000;
+static constexpr double PAGE_SPACING = 500;
+static constexpr double SCALE = 0.1;
+
+class Notation_PageThumbnailCacheTests : public ::testing::Test, public async::Asyncable
+{
+protected:
+    void SetUp() override
+    {
+        for (int i = 0; i < 3; ++i) {
+            addPage();
+        }
+    }
+
+    void addPage()
+    {
+        const int i = static_cast<int>(m_pages.size());
+
+        NotationPageThumbnailCache::PageInfo page;
+        page.rect = RectF(i * (PAGE_WIDTH + PAGE_SPACING), 0, PAGE_WIDTH, PAGE_HEIGHT);
+        page.tickFrom = i * 1920;
+        page.tickTo = (i + 1) * 1920;
+        page.systemCount = 2;
+        m_pages.push_back(page);
+    }
+
+    void update(NotationPageThumbnailCache& cache)
+    {
+        update(cache, RectF(0, 0, m_pages.size() * (PAGE_WIDTH + PAGE_SPACING), PAGE_HEIGHT));
+    }
+
+    void update(NotationPageThumbnailCache& cache, const RectF& visibleRect)
+    {
+        cache.update([this](Painter* painter, const RectF& logicRect) {
+            m_paintedRects.push_back(logicRect);
+            painter->fillRect(logicRect, Color::WHITE);
+            painter->fillRect(m_noteRect, Color::BLACK);
+        }, visibleRect);
+    }
+
+    //! NOTE The rasters come back through the queue of the main thread
+    static bool waitForRasters(const NotationPageThumbnailCache& cache)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!cache.isUpToDate() && std::chrono::steady_clock::now() < deadline) {
+            QCoreApplication::processEvents();
+            async::processEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return cache.isUpToDate();
+    }
+
+    //! NOTE Paints the overview, all the pages at the scale of the thumbnails
+    QImage paintOverview(const NotationPageThumbnailCache& cache)
+    {
+        const int width = static_cast<int>((3 * PAGE_WIDTH + 2 * PAGE_SPACING) * SCALE);
+        const int height = static_cast<int>(PAGE_HEIGHT * SCALE);
+        auto pixmap = std::make_shared<Pixmap>(width, height);
+
+        Painter painter(QImagePainterProvider::make(pixmap), "overview");
+        painter.fillRect(RectF(0, 0, width, height), Color::BLUE);
+
+        Transform matrix;
+        matrix.scale(SCALE, SCALE);
+        painter.setWorldTransform(matrix);
+
+        cache.paint(&painter, matrix.inverted().map(RectF(0, 0, width, height)));
+        painter.endDraw();
+
+        return Pixmap::toQImage(*pixmap);
+    }
+
+    std::vector<NotationPageThumbnailCache::PageInfo> m_pages;
+    RectF m_noteRect = RectF(2500 + 1000, 1000, 200, 200);
+    std::vector<RectF> m_paintedRects;
+};
+
+TEST_F(Notation_PageThumbnailCacheTests, Pages_RasterisedInBackground)
+{
+    NotationPageThumbnailCache cache(SCALE);
+
+    //! [GIVEN] Nothing is rasterised yet
+    cache.setPages(m_pages);
+    EXPECT_FALSE(cache.isUpToDate());
+    EXPECT_EQ(cache.thumbnailCount(), 0u);
+
+    //! [WHEN] The pages are recorded
+    update(cache);
+
+    //! [THEN] Every page is painted once, inside its own rect
+    ASSERT_EQ(m_paintedRects.size(), 3u);
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        EXPECT_EQ(m_paintedRects.at(i), m_pages.at(i).rect);
+    }
+
+    //! [THEN] The thumbnails arrive
+    ASSERT_TRUE(waitForRasters(cache));
+    EXPECT_EQ(cache.statistic().records, 3u);
+    EXPECT_EQ(cache.statistic().rasters, 3u);
+    EXPECT_EQ(cache.thumbnailCount(), 3u);
+
+    //! [THEN] The overview shows the pages and the note
+    QImage image = paintOverview(cache);
+    EXPECT_EQ(image.pixelColor(30, 30), QColor(Qt::white));
+    EXPECT_EQ(image.pixelColor(360, 110), QColor(Qt::black));
+    EXPECT_EQ(image.pixelColor(225, 30), QColor(Qt::blue));
+}
+
+TEST_F(Notation_PageThumbnailCacheTests, SetPages_RecordsOnlyChangedPages)
+{
+    NotationPageThumbnailCache cache(SCALE);
+    cache.setPages(m_pages);
+    update(cache);
+    ASSERT_TRUE(waitForRasters(cache));
+
+    cache.resetStatistic();
+    m_paintedRects.clear();
+
+    //! [GIVEN] The same pages
+    cache.setPages(m_pages);
+    update(cache);
+
+    //! [THEN] Nothing is painted
+    EXPECT_TRUE(cache.isUpToDate());
+    EXPECT_TRUE(m_paintedRects.empty());
+
+    //! [WHEN] The last page gets a measure more
+    m_pages.back().tickTo += 1920;
+    cache.setPages(m_pages);
+    update(cache);
+
+    //! [THEN] Only the last page is painted again
+    ASSERT_EQ(m_paintedRects.size(), 1u);
+    EXPECT_EQ(m_paintedRects.front(), m_pages.back().rect);
+
+    ASSERT_TRUE(waitForRasters(cache));
+    EXPECT_EQ(cache.statistic().records, 1u);
+    EXPECT_EQ(cache.statistic().rasters, 1u);
+}
+
+TEST_F(Notation_PageThumbnailCacheTests, Invalidate_Ticks_RecordsOnlyTheirPages)
+{
+    NotationPageThumbnailCache cache(SCALE);
+    cache.setPages(m_pages);
+    update(cache);
+    ASSERT_TRUE(waitForRasters(cache));
+
+    cache.resetStatistic();
+    m_paintedRects.clear();
+
+    //! [GIVEN] The note is moved down
+    m_noteRect.translate(0, 1000);
+
+    //! [WHEN] Its ticks are invalidated
+    cache.invalidate(2000, 2100);
+    update(cache);
+
+    //! [THEN] Only the page of the note is painted again
+    ASSERT_EQ(m_paintedRects.size(), 1u);
+    EXPECT_EQ(m_paintedRects.front(), m_pages.at(1).rect);
+
+    ASSERT_TRUE(waitForRasters(cache));
+
+    QImage image = paintOverview(cache);
+    EXPECT_EQ(image.pixelColor(360, 110), QColor(Qt::white));
+    EXPECT_EQ(image.pixelColor(360, 210), QColor(Qt::black));
+}
+
+TEST_F(Notation_PageThumbnailCacheTests, Update_VisiblePagesFirst_RestQueued)
+{
+    //! [GIVEN] More pages than are recorded at once
+    for (int i = 0; i < 4; ++i) {
+        addPage();
+    }
+
+    ASSERT_GT(m_pages.size(), NotationPageThumbnailCache::MAX_RECORDS_PER_UPDATE);
+
+    NotationPageThumbnailCache cache(SCALE);
+    cache.setPages(m_pages);
+
+    int changedCount = 0;
+    cache.thumbnailsChanged().onNotify(this, [&changedCount]() {
+        ++changedCount;
+    });
+
+    //! [WHEN] The last pages are visible
+    const RectF visibleRect = m_pages.at(5).rect.united(m_pages.at(6).rect);
+    update(cache, visibleRect);
+
+    //! [THEN] Only a few pages are recorded, the visible ones first
+    ASSERT_EQ(m_paintedRects.size(), NotationPageThumbnailCache::MAX_RECORDS_PER_UPDATE);
+    EXPECT_EQ(m_paintedRects.at(0), m_pages.at(5).rect);
+    EXPECT_EQ(m_paintedRects.at(1), m_pages.at(6).rect);
+    EXPECT_EQ(m_paintedRects.at(2), m_pages.at(0).rect);
+
+    //! [THEN] The next update is asked from the queue of the main thread
+    EXPECT_FALSE(cache.isUpToDate());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (changedCount == 0 && std::chrono::steady_clock::now() < deadline) {
+        QCoreApplication::processEvents();
+        async::processEvents();
+    }
+
+    ASSERT_GT(changedCount, 0);
+
+    //! [WHEN] The view is updated until nothing is left
+    for (size_t i = 0; i < m_pages.size() && m_paintedRects.size() < m_pages.size(); ++i) {
+        update(cache, visibleRect);
+    }
+
+    //! [THEN] Every page is recorded once
+    EXPECT_EQ(m_paintedRects.size(), m_pages.size());
+    ASSERT_TRUE(waitForRasters(cache));
+    EXPECT_EQ(cache.statistic().records, m_pages.size());
+}
@@ -0,0 +1,199 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+
+#include <QEventLoop>
+#include <QTimer>
+
+#include "async/asyncable.h"
+#include "mpe/tests/mocks/articulationprofilesrepositorymock.h"
+
+#include "engraving/dom/masterscore.h"
+#include "engraving/dom/part.h"
+#include "engraving/tests/utils/scorerw.h"
+
+#include "mocks/notationconfigurationmock.h"
+
+#include "notation/internal/notationplayback.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace mu;
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::mpe;
+
+static const String TEST_SCORE_PATH(u"data/test.mscx");
+
+class Notation_NotationPlaybackTests : public ::testing::Test, public async::Asyncable
+{
+public:
+    class GetScore : public IGetScore
+    {
+    public:
+        engraving::Score* score() const override { return m_score; }
+        async::Notification scoreInited() const override { return m_scoreInited; }
+
+        engraving::Score* m_score = nullptr;
+        async::Notification m_scoreInited;
+    };
+
+protected:
+    void SetUp() override
+    {
+        m_score = engraving::ScoreRW::readScore(TEST_SCORE_PATH);
+        m_getScore.m_score = m_score;
+
+        m_configuration = std::make_shared<NiceMock<NotationConfigurationMock> >();
+        m_repository = std::make_shared<NiceMock<ArticulationProfilesRepositoryMock> >();
+        ON_CALL(*m_repository, defaultProfile(_)).WillByDefault(Return(std::make_shared<ArticulationsProfile>()));
+
+        m_playback = std::make_unique<NotationPlayback>(&m_getScore, m_notationChanged);
+        m_playback->configuration.set(m_configuration);
+        m_playback->playbackModel().profilesRepository.set(m_repository);
+    }
+
+    void TearDown() override
+    {
+        m_playback.reset();
+        delete m_score;
+    }
+
+    bool hasPendingUpdate() const
+    {
+        return m_playback->playbackModel().hasPendingUpdate();
+    }
+
+    void sendChanges(int tickFrom, int tickTo)
+    {
+        engraving::ScoreChangesRange range;
+        range.tickFrom = tickFrom;
+        range.tickTo = tickTo;
+        range.staffIdxFrom = 0;
+        range.staffIdxTo = 0;
+        range.changedTypes = { engraving::ElementType::NOTE };
+
+        m_score->changesChannel().send(range);
+    }
+
+    //! NOTE The playback model is updated from the timers of the main thread:
+    //! runs the event loop until the update is published, the timeout only guards against a hang
+    bool waitForPublishedUpdate(int timeoutMs)
+    {
+        QTimer timer;
+        timer.setSingleShot(true);
+
+        QEventLoop loop;
+        QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+        m_playback->playbackModel().dataChanged().onNotify(this, [&loop]() {
+            loop.quit();
+        });
+
+        timer.start(timeoutMs);
+        loop.exec();
+
+        m_playback->playbackModel().dataChanged().resetOnNotify(this);
+
+        return !hasPendingUpdate();
+    }
+
+    engraving::MasterScore* m_score = nullptr;
+    GetScore m_getScore;
+    async::Notification m_notationChanged;
+
+    std::shared_ptr<NiceMock<NotationConfigurationMock> > m_configuration;
+    std::shared_ptr<NiceMock<ArticulationProfilesRepositoryMock> > m_repository;
+    std::unique_ptr<NotationPlayback> m_playback;
+};
+
+TEST_F(Notation_NotationPlaybackTests, Changes_RenderedBetweenEvents_PublishedOnce)
+{
+    ASSERT_TRUE(m_score);
+
+    //! [GIVEN] The playback of the score
+    m_playback->init();
+
+    const engraving::Part* part = m_score->parts().front();
+    const PlaybackData& data = m_playback->trackPlaybackData({ part->id(), part->instrumentId() });
+    const PlaybackEventsMap expectedEvents = data.originEvents;
+    ASSERT_FALSE(expectedEvents.empty());
+
+    int receivedCount = 0;
+    auto mainStream = data.mainStream;
+    mainStream.onReceive(this, [&receivedCount](const PlaybackEventsMap&, const DynamicLevelMap&, const PlaybackParamMap&) {
+        ++receivedCount;
+    });
+
+    //! [WHEN] The score is changed twice in a row
+    sendChanges(0, 1920);
+    sendChanges(3840, 5760);
+
+    //! [THEN] Nothing is rendered inside the notifications
+    EXPECT_TRUE(hasPendingUpdate());
+    EXPECT_EQ(receivedCount, 0);
+
+    //! [WHEN] The events of the main thread are processed
+    ASSERT_TRUE(waitForPublishedUpdate(10000));
+
+    //! [THEN] The events are published once and are the same as before
+    EXPECT_EQ(receivedCount, 1);
+    EXPECT_EQ(data.originEvents.size(), expectedEvents.size());
+}
+
+TEST_F(Notation_NotationPlaybackTests, Changes_DuringCommand_RenderedAfterIt)
+{
+    ASSERT_TRUE(m_score);
+
+    m_playback->init();
+
+    const engraving::Part* part = m_score->parts().front();
+    const PlaybackData& data = m_playback->trackPlaybackData({ part->id(), part->instrumentId() });
+
+    int receivedCount = 0;
+    auto mainStream = data.mainStream;
+    mainStream.onReceive(this, [&receivedCount](const PlaybackEventsMap&, const DynamicLevelMap&, const PlaybackParamMap&) {
+        ++receivedCount;
+    });
+
+    //! [GIVEN] A command is in progress, e.g. a drag
+    m_score->startCmd();
+
+    //! [WHEN] The score is changed
+    sendChanges(0, 1920);
+
+    //! [THEN] Nothing is rendered while the command is open, however long the events are processed
+    EXPECT_FALSE(waitForPublishedUpdate(200));
+    EXPECT_EQ(receivedCount, 0);
+
+    //! [WHEN] The command ends
+    m_score->endCmd(true);
+
+    //! [THEN] The change is rendered and published
+    ASSERT_TRUE(waitForPublishedUpdate(10000));
+    EXPECT_EQ(receivedCount, 1);
+}
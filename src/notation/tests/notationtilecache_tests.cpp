@@ -0,0 +1,232 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+
+#include "draw/painter.h"
+#include "draw/internal/qimagepainterprovider.h"
+
+#include "engraving/dom/masterscore.h"
+#include "engraving/dom/mscoreview.h"
+#include "engraving/tests/utils/scorerw.h"
+
+#include "notation/view/notationtilecache.h"
+
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::draw;
+
+static constexpr int VIEW_SIZE = 512;
+static constexpr int TILE_SIZE = 128;
+
+static const String TEST_SCORE_PATH(u"data/test.mscx");
+
+class Notation_TileCacheTests : public ::testing::Test
+{
+protected:
+    //! NOTE Paints the view offscreen: the background, the score from the tiles and a cursor over them
+    QImage paintView(NotationTileCache& cache, const Transform& matrix, const RectF& rect = RectF(0, 0, VIEW_SIZE, VIEW_SIZE))
+    {
+        auto pixmap = std::make_shared<Pixmap>(VIEW_SIZE, VIEW_SIZE);
+
+        Painter painter(QImagePainterProvider::make(pixmap), "view");
+        painter.fillRect(RectF(0, 0, VIEW_SIZE, VIEW_SIZE), Color::WHITE);
+        painter.setClipRect(rect);
+
+        cache.paint(&painter, rect, matrix, [this](Painter* tilePainter, const RectF& logicRect) {
+            m_paintedRects.push_back(logicRect);
+            tilePainter->fillRect(m_noteRect, Color::BLACK);
+        });
+
+        painter.setWorldTransform(matrix);
+        painter.fillRect(m_cursorRect, Color::BLUE);
+        painter.endDraw();
+
+        return Pixmap::toQImage(*pixmap);
+    }
+
+    //! NOTE Passes the updates of the score to the tiles, as the notation view does through the painting
+    class TileCacheViewer : public mu::engraving::MuseScoreView
+    {
+    public:
+        TileCacheViewer(NotationTileCache& cache)
+            : m_cache(cache) {}
+
+        void dataChanged(const RectF& rect) override { m_cache.invalidate(rect); }
+        void updateAll() override { m_cache.invalidate(); }
+        void drawBackground(Painter*, const RectF&) const override {}
+        const Rect geometry() const override { return Rect(); }
+
+    private:
+        NotationTileCache& m_cache;
+    };
+
+    RectF m_noteRect = RectF(40, 40, 20, 20);
+    RectF m_cursorRect = RectF(100, 0, 4, 50);
+    std::vector<RectF> m_paintedRects;
+};
+
+TEST_F(Notation_TileCacheTests, Repaint_UsesCachedTiles)
+{
+    NotationTileCache cache(TILE_SIZE);
+
+    //! [GIVEN] The first paint of the view rasterises every visible tile
+    QImage image = paintView(cache, Transform());
+
+    EXPECT_EQ(cache.statistic().rasters, 16u);
+    EXPECT_EQ(cache.statistic().hits, 0u);
+    EXPECT_EQ(cache.tileCount(), 16u);
+    EXPECT_EQ(image.pixelColor(50, 50), QColor(Qt::black));
+    EXPECT_EQ(image.pixelColor(101, 10), QColor(Qt::blue));
+    EXPECT_EQ(image.pixelColor(300, 300), QColor(Qt::white));
+
+    //! [WHEN] The cursor moves and only its rects are repainted
+    cache.resetStatistic();
+    m_paintedRects.clear();
+
+    for (int x = 100; x < 300; x += 10) {
+        RectF oldCursorRect = m_cursorRect;
+        m_cursorRect.moveTo(x, m_cursorRect.y());
+        image = paintView(cache, Transform(), oldCursorRect.united(m_cursorRect).adjusted(-1, -1, 1, 1));
+    }
+
+    //! [THEN] The score is not painted again
+    EXPECT_TRUE(m_paintedRects.empty());
+    EXPECT_EQ(cache.statistic().rasters, 0u);
+    EXPECT_GT(cache.statistic().hits, 0);
+    EXPECT_EQ(image.pixelColor(static_cast<int>(m_cursorRect.x()) + 1, 10), QColor(Qt::blue));
+}
+
+TEST_F(Notation_TileCacheTests, Scroll_ByWholePixels_ReusesTiles)
+{
+    NotationTileCache cache(TILE_SIZE);
+    paintView(cache, Transform());
+    cache.resetStatistic();
+
+    //! [WHEN] The view is scrolled by a whole number of pixels
+    QImage image = paintView(cache, Transform(1, 0, 0, 1, 100, 100));
+
+    //! [THEN] Only the tiles which became visible are rasterised
+    EXPECT_EQ(cache.statistic().hits, 16u);
+    EXPECT_EQ(cache.statistic().rasters, 9u);
+    EXPECT_EQ(image.pixelColor(150, 150), QColor(Qt::black));
+    EXPECT_EQ(image.pixelColor(50, 50), QColor(Qt::white));
+}
+
+TEST_F(Notation_TileCacheTests, Zoom_RastersAllTiles)
+{
+    NotationTileCache cache(TILE_SIZE);
+    paintView(cache, Transform());
+    cache.resetStatistic();
+
+    //! [WHEN] The view is zoomed
+    QImage image = paintView(cache, Transform(2, 0, 0, 2, 0, 0));
+
+    //! [THEN] No tile is reused
+    EXPECT_EQ(cache.statistic().hits, 0u);
+    EXPECT_EQ(cache.statistic().rasters, 16u);
+    EXPECT_EQ(cache.tileCount(), 16u);
+    EXPECT_EQ(image.pixelColor(100, 100), QColor(Qt::black));
+}
+
+TEST_F(Notation_TileCacheTests, Invalidate_Rect_RastersOnlyIntersectingTiles)
+{
+    NotationTileCache cache(TILE_SIZE);
+    paintView(cache, Transform(2, 0, 0, 2, 0, 0));
+    cache.resetStatistic();
+
+    //! [GIVEN] The note is moved
+    const RectF oldNoteRect = m_noteRect;
+    m_noteRect.moveTo(150, 150);
+
+    //! [WHEN] The refresh rect is invalidated
+    cache.invalidate(oldNoteRect.united(m_noteRect));
+    QImage image = paintView(cache, Transform(2, 0, 0, 2, 0, 0));
+
+    //! [THEN] Only the tiles under the refresh rect are painted again
+    EXPECT_EQ(cache.statistic().rasters, 9u);
+    EXPECT_EQ(cache.statistic().hits, 7u);
+    EXPECT_EQ(image.pixelColor(100, 100), QColor(Qt::white));
+    EXPECT_EQ(image.pixelColor(320, 320), QColor(Qt::black));
+}
+
+TEST_F(Notation_TileCacheTests, MaxTileCount_EvictsLeastRecentlyUsedTiles)
+{
+    NotationTileCache cache(TILE_SIZE, 4);
+
+    //! [GIVEN] The visible tiles are kept even above the limit
+    paintView(cache, Transform());
+    EXPECT_EQ(cache.tileCount(), 16u);
+
+    //! [WHEN] Only the top left corner is painted
+    paintView(cache, Transform(), RectF(0, 0, TILE_SIZE, TILE_SIZE));
+
+    //! [THEN] The other tiles are dropped
+    EXPECT_EQ(cache.tileCount(), 4u);
+    EXPECT_EQ(cache.statistic().evictions, 12u);
+
+    //! [THEN] The corner is still cached
+    cache.resetStatistic();
+    paintView(cache, Transform(), RectF(0, 0, TILE_SIZE, TILE_SIZE));
+    EXPECT_EQ(cache.statistic().hits, 1u);
+    EXPECT_EQ(cache.statistic().rasters, 0u);
+}
+
+TEST_F(Notation_TileCacheTests, ShowInvisible_InvalidatesAllTiles)
+{
+    //! [GIVEN] The tiles of a score are painted
+    mu::engraving::MasterScore* score = mu::engraving::ScoreRW::readScore(TEST_SCORE_PATH);
+    ASSERT_TRUE(score);
+
+    NotationTileCache cache(TILE_SIZE);
+    TileCacheViewer viewer(cache);
+    score->addViewer(&viewer);
+
+    paintView(cache, Transform());
+    EXPECT_EQ(cache.tileCount(), 16u);
+
+    //! [WHEN] The invisible elements are shown or hidden, nothing is laid out again
+    score->startCmd();
+    score->setShowInvisible(!score->isShowInvisible());
+    score->endCmd();
+
+    //! [THEN] Every tile is painted again
+    EXPECT_EQ(cache.tileCount(), 0u);
+
+    cache.resetStatistic();
+    paintView(cache, Transform());
+    EXPECT_EQ(cache.statistic().rasters, 16u);
+    EXPECT_EQ(cache.statistic().hits, 0u);
+
+    //! [WHEN] The same value is set again
+    score->startCmd();
+    score->setShowInvisible(score->isShowInvisible());
+    score->endCmd();
+
+    //! [THEN] The tiles are kept
+    EXPECT_EQ(cache.tileCount(), 16u);
+
+    score->removeViewer(&viewer);
+    delete score;
+}
@@ -71,7 +71,7 @@ AbstractNotationPaintView::AbstractNotationPaintView(QQuickItem* parent)
 
     //! NOTE For diagnostic tools
     dispatcher()->reg(this, "diagnostic-notationview-redraw", [this]() {
-        scheduleRedraw();
+        redrawScore();
     });
 
     m_enableAutoScrollTimer.setSingleShot(true);
@@ -109,7 +109,7 @@ void AbstractNotationPaintView::load()
         emit viewportChanged();
     });
 
-    scheduleRedraw();
+    redrawScore();
 }
 
 void AbstractNotationPaintView::initBackground()
@@ -124,8 +124,10 @@ void AbstractNotationPaintView::initBackground()
 
 void AbstractNotationPaintView::initNavigatorOrientation()
 {
+    //! NOTE The notation lays the score out again, without reporting the changed areas
     configuration()->canvasOrientation().ch.onReceive(this, [this](muse::Orientation) {
         moveCanvasToPosition(PointF(0, 0));
+        redrawScore();
     });
 }
 
@@ -237,19 +239,26 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
 
     INotationInteractionPtr interaction = notationInteraction();
 
+    //! NOTE The changed areas of the score come with scoreAreaChanged (all of it when the score sets updateAll,
+    //! e.g. when invisible elements are shown), here only the overlay (shadow note, drag and drop, text cursor) is painted again
     m_notation->notationChanged().onNotify(this, [this, interaction]() {
         interaction->hideShadowNote();
         m_shadowNoteRect = RectF();
         scheduleRedraw();
     });
 
+    m_notation->painting()->scoreAreaChanged().onReceive(this, [this](const RectF& logicRect) {
+        redrawScore(logicRect);
+    });
+
     onNoteInputStateChanged();
     interaction->noteInput()->stateChanged().onNotify(this, [this]() {
         onNoteInputStateChanged();
     });
 
+    updateSelectedElementsRects();
     interaction->selectionChanged().onNotify(this, [this]() {
-        scheduleRedraw();
+        updateSelectedElementsRects();
     });
 
     interaction->showItemRequested().onReceive(this, [this](const INotationInteraction::ShowItemRequest& request) {
@@ -279,7 +288,9 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
         updateLoopMarkers();
     });
 
+    //! NOTE The score is laid out again in the other mode, without reporting the changed areas
     m_notation->viewModeChanged().onNotify(this, [this]() {
+        redrawScore();
         updateLoopMarkers();
         ensureViewportInsideScrollableArea();
     });
@@ -308,7 +319,7 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
     }
 
     forceFocusIn();
-    scheduleRedraw();
+    redrawScore();
 
     emit horizontalScrollChanged();
     emit verticalScrollChanged();
@@ -318,10 +329,13 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
 void AbstractNotationPaintView::onUnloadNotation(INotationPtr)
 {
     m_notation->notationChanged().resetOnNotify(this);
+    m_notation->painting()->scoreAreaChanged().resetOnReceive(this);
     INotationInteractionPtr interaction = m_notation->interaction();
     interaction->noteInput()->stateChanged().resetOnNotify(this);
     interaction->selectionChanged().resetOnNotify(this);
 
+    m_selectedElementsRects.clear();
+
     if (isMainView()) {
         m_notation->accessibility()->setMapToScreenFunc(nullptr);
         m_notation->interaction()->setGetViewRectFunc(nullptr);
@@ -585,10 +599,19 @@ void AbstractNotationPaintView::paint(QPainter* qp)
     Transform guiScalingCompensation;
     guiScalingCompensation.scale(guiScaling, guiScaling);
 
-    painter->setWorldTransform(m_matrix * guiScalingCompensation);
+    const Transform matrix = m_matrix * guiScalingCompensation;
 
     bool isPrinting = publishMode() || m_inputController->readonly();
-    notation()->painting()->paintView(painter, toLogical(rect), isPrinting);
+
+    //! NOTE The score comes from a cache, the rest is painted over it every time
+    paintScore(painter, rect, matrix, isPrinting);
+
+    INotationPaintingPtr painting = notation()->painting();
+    painter->setWorldTransform(matrix);
+
+    if (!isPrinting) {
+        painting->paintViewOverlay(painter);
+    }
 
     m_playbackCursor->paint(painter);
     m_noteInputCursor->paint(painter);
@@ -605,6 +628,19 @@ void AbstractNotationPaintView::paint(QPainter* qp)
     }
 }
 
+void AbstractNotationPaintView::paintScore(Painter* painter, const RectF& rect, const Transform& matrix, bool isPrinting)
+{
+    if (m_isTileCachePrinting != isPrinting) {
+        m_isTileCachePrinting = isPrinting;
+        m_tileCache.invalidate();
+    }
+
+    INotationPaintingPtr painting = notation()->painting();
+    m_tileCache.paint(painter, rect, matrix, [painting, isPrinting](Painter* tilePainter, const RectF& logicRect) {
+        painting->paintViewScore(tilePainter, logicRect, isPrinting);
+    });
+}
+
 void AbstractNotationPaintView::onNotationSetup()
 {
     TRACEFUNC;
@@ -624,15 +660,19 @@ void AbstractNotationPaintView::onNotationSetup()
     });
 
     configuration()->foregroundChanged().onNotify(this, [this]() {
-        scheduleRedraw();
+        redrawScore();
     });
 
     uiConfiguration()->currentThemeChanged().onNotify(this, [this]() {
-        scheduleRedraw();
+        redrawScore();
     });
 
     engravingConfiguration()->debuggingOptionsChanged().onNotify(this, [this]() {
-        scheduleRedraw();
+        redrawScore();
+    });
+
+    engravingConfiguration()->selectionColorChanged().onReceive(this, [this](engraving::voice_idx_t, const muse::draw::Color&) {
+        redrawScore();
     });
 }
 
@@ -986,6 +1026,53 @@ void AbstractNotationPaintView::scheduleRedraw(const muse::RectF& rect)
     update(qrect);
 }
 
+void AbstractNotationPaintView::updateSelectedElementsRects()
+{
+    //! NOTE The selected elements are painted with the selection colors:
+    //! the tiles under the elements that were selected and under the ones that are now are painted again
+    for (const RectF& rect : m_selectedElementsRects) {
+        redrawScore(rect);
+    }
+
+    m_selectedElementsRects.clear();
+
+    INotationSelectionPtr selection = notationSelection();
+    if (!selection) {
+        return;
+    }
+
+    RectF unitedRect;
+    for (const EngravingItem* element : selection->elements()) {
+        const RectF rect = element->canvasBoundingRect();
+        if (!rect.isValid()) {
+            continue;
+        }
+
+        unitedRect.unite(rect);
+        m_selectedElementsRects.push_back(rect);
+    }
+
+    //! NOTE A large selection usually covers most of the tiles anyway
+    if (m_selectedElementsRects.size() > MAX_SELECTED_ELEMENTS_RECTS) {
+        m_selectedElementsRects = { unitedRect };
+    }
+
+    for (const RectF& rect : m_selectedElementsRects) {
+        redrawScore(rect);
+    }
+}
+
+void AbstractNotationPaintView::redrawScore(const muse::RectF& logicRect)
+{
+    m_tileCache.invalidate(logicRect);
+
+    if (logicRect.isValid()) {
+        scheduleRedraw(fromLogical(logicRect));
+    } else {
+        scheduleRedraw();
+    }
+}
+
 RectF AbstractNotationPaintView::correctDrawRect(const RectF& rect) const
 {
     if (!rect.isValid() || rect.isNull()) {
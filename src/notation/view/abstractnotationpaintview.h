@@ -45,6 +45,7 @@
 #include "playbackcursor.h"
 #include "loopmarker.h"
 #include "continuouspanel.h"
+#include "notationtilecache.h"
 #include "abstractelementpopupmodel.h"
 
 namespace mu::notation {
@@ -176,6 +177,9 @@ protected:
     // Draw
     void paint(QPainter* painter) override;
 
+    //! NOTE Paints the score without the overlay; rect is in device coordinates
+    virtual void paintScore(muse::draw::Painter* painter, const muse::RectF& rect, const muse::draw::Transform& matrix, bool isPrinting);
+
     virtual void onNotationSetup();
 
     virtual void onLoadNotation(INotationPtr notation);
@@ -203,6 +207,8 @@ private:
     bool doMoveCanvas(qreal dx, qreal dy);
 
     void scheduleRedraw(const muse::RectF& rect = muse::RectF());
+    void redrawScore(const muse::RectF& logicRect = muse::RectF());
+    void updateSelectedElementsRects();
     muse::RectF correctDrawRect(const muse::RectF& rect) const;
 
     // Input
@@ -261,6 +267,12 @@ private:
     std::unique_ptr<LoopMarker> m_loopOutMarker;
     std::unique_ptr<ContinuousPanel> m_continuousPanel;
 
+    NotationTileCache m_tileCache;
+    bool m_isTileCachePrinting = false;
+
+    static constexpr size_t MAX_SELECTED_ELEMENTS_RECTS = 256;
+    std::vector<muse::RectF> m_selectedElementsRects;
+
     qreal m_previousVerticalScrollPosition = 0;
     qreal m_previousHorizontalScrollPosition = 0;
 
@@ -21,11 +21,14 @@
  */
 #include "notationnavigator.h"
 
+#include "engraving/dom/measurebase.h"
+#include "engraving/dom/page.h"
 #include "engraving/dom/system.h"
 
 #include "log.h"
 
 using namespace muse;
+using namespace muse::draw;
 using namespace mu::notation;
 
 NotationNavigatorCursorView::NotationNavigatorCursorView(QQuickItem* parent)
@@ -54,6 +57,10 @@ NotationNavigator::NotationNavigator(QQuickItem* parent)
     : AbstractNotationPaintView(parent), m_cursorRectView(new NotationNavigatorCursorView(this))
 {
     setReadonly(true);
+
+    m_pageThumbnails.thumbnailsChanged().onNotify(this, [this]() {
+        update();
+    });
 }
 
 void NotationNavigator::load()
@@ -64,10 +71,16 @@ void NotationNavigator::load()
     initVisible();
 
     uiConfiguration()->currentThemeChanged().onNotify(this, [this]() {
+        m_pageThumbnails.invalidate();
         update();
         m_cursorRectView->update();
     });
 
+    configuration()->foregroundChanged().onNotify(this, [this]() {
+        m_pageThumbnails.invalidate();
+        update();
+    });
+
     AbstractNotationPaintView::load();
 }
 
@@ -91,6 +104,26 @@ PageList NotationNavigator::pages() const
     return elements->pages();
 }
 
+std::vector<NotationPageThumbnailCache::PageInfo> NotationNavigator::pageInfos() const
+{
+    std::vector<NotationPageThumbnailCache::PageInfo> infos;
+
+    for (const Page* page : pages()) {
+        NotationPageThumbnailCache::PageInfo info;
+        info.rect = page->ldata()->bbox().translated(page->pos());
+        info.systemCount = page->systems().size();
+
+        if (!page->systems().empty() && !page->systems().front()->measures().empty()) {
+            info.tickFrom = page->systems().front()->measures().front()->tick().ticks();
+            info.tickTo = page->endTick().ticks();
+        }
+
+        infos.push_back(info);
+    }
+
+    return infos;
+}
+
 void NotationNavigator::rescale()
 {
     TRACEFUNC;
@@ -270,10 +303,50 @@ void NotationNavigator::paint(QPainter* painter)
     paintPageNumbers(painter);
 }
 
+void NotationNavigator::paintScore(Painter* painter, const RectF& rect, const Transform& matrix, bool isPrinting)
+{
+    TRACEFUNC;
+
+    m_pageThumbnails.setPages(pageInfos());
+
+    const RectF logicalRect = matrix.inverted().map(rect);
+
+    INotationPaintingPtr painting = notation()->painting();
+    m_pageThumbnails.update([painting, isPrinting](Painter* thumbnailPainter, const RectF& logicRect) {
+        painting->paintViewScore(thumbnailPainter, logicRect, isPrinting);
+    }, logicalRect);
+
+    painter->setWorldTransform(matrix);
+    m_pageThumbnails.paint(painter, logicalRect);
+}
+
 void NotationNavigator::onViewSizeChanged()
 {
 }
 
+void NotationNavigator::onLoadNotation(INotationPtr notation)
+{
+    AbstractNotationPaintView::onLoadNotation(notation);
+
+    m_pageThumbnails.invalidate();
+
+    //! NOTE Only the pages with the edited ticks are rasterised again, the ones whose layout moved are found by setPages()
+    notation->undoStack()->changesChannel().onReceive(this, [this](const ChangesRange& range) {
+        if (range.isValidBoundary() && range.changedStyleIdSet.empty()) {
+            m_pageThumbnails.invalidate(range.tickFrom, range.tickTo);
+        } else {
+            m_pageThumbnails.invalidate();
+        }
+    });
+}
+
+void NotationNavigator::onUnloadNotation(INotationPtr notation)
+{
+    AbstractNotationPaintView::onUnloadNotation(notation);
+
+    notation->undoStack()->changesChannel().resetOnReceive(this);
+}
+
 void NotationNavigator::paintPageNumbers(QPainter* painter)
 {
     if (notationViewMode() != ViewMode::PAGE) {
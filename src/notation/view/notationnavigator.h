@@ -35,6 +35,7 @@
 #include "ui/iuiconfiguration.h"
 #include "engraving/iengravingconfiguration.h"
 #include "abstractnotationpaintview.h"
+#include "notationpagethumbnailcache.h"
 
 namespace mu::notation {
 class NotationNavigatorCursorView : public QQuickPaintedItem
@@ -88,8 +89,13 @@ private:
     void rescale();
 
     void paint(QPainter* painter) override;
+    void paintScore(muse::draw::Painter* painter, const muse::RectF& rect, const muse::draw::Transform& matrix,
+                    bool isPrinting) override;
     void onViewSizeChanged() override;
 
+    void onLoadNotation(INotationPtr notation) override;
+    void onUnloadNotation(INotationPtr notation) override;
+
     void wheelEvent(QWheelEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
@@ -101,10 +107,14 @@ private:
     bool isVerticalOrientation() const;
 
     PageList pages() const;
+    std::vector<NotationPageThumbnailCache::PageInfo> pageInfos() const;
 
     muse::RectF m_cursorRect;
     NotationNavigatorCursorView* m_cursorRectView = nullptr;
     muse::PointF m_startMove;
+
+    //! NOTE The overview is painted from the page thumbnails, not from the score
+    NotationPageThumbnailCache m_pageThumbnails;
 };
 }
 
@@ -0,0 +1,309 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "notationpagethumbnailcache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QPainter>
+
+#include "async/async.h"
+#include "concurrency/taskscheduler.h"
+#include "global/runtime.h"
+
+#include "draw/bufferedpaintprovider.h"
+#include "draw/utils/drawdatapaint.h"
+
+#include "log.h"
+
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::async;
+using namespace muse::draw;
+
+static bool hasPixmaps(const DrawData::Item& item)
+{
+    for (const DrawData::Data& data : item.datas) {
+        if (!data.pixmaps.empty()) {
+            return true;
+        }
+    }
+
+    for (const DrawData::Item& child : item.chilren) {
+        if (hasPixmaps(child)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static QImage rasterPage(const DrawDataPtr& data, int width, int height)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter qp(&image);
+    Painter painter(&qp, "pagethumbnail");
+    DrawDataPaint::paint(&painter, data);
+    painter.endDraw();
+
+    return image;
+}
+
+bool NotationPageThumbnailCache::PageInfo::operator==(const PageInfo& other) const
+{
+    return rect == other.rect
+           && tickFrom == other.tickFrom
+           && tickTo == other.tickTo
+           && systemCount == other.systemCount;
+}
+
+NotationPageThumbnailCache::NotationPageThumbnailCache(double scale)
+    : m_scale(scale > 0.0 ? scale : DEFAULT_SCALE), m_self(std::make_shared<NotationPageThumbnailCache*>(this))
+{
+}
+
+NotationPageThumbnailCache::~NotationPageThumbnailCache()
+{
+    //! NOTE The rasters still on the way are dropped
+    m_self.reset();
+}
+
+void NotationPageThumbnailCache::setPages(const std::vector<PageInfo>& pages)
+{
+    m_thumbnails.resize(pages.size());
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        Thumbnail& thumbnail = m_thumbnails[i];
+        if (thumbnail.page == pages[i]) {
+            continue;
+        }
+
+        //! NOTE The old thumbnail is shown until the new one is ready
+        thumbnail.page = pages[i];
+        thumbnail.isDirty = true;
+    }
+}
+
+void NotationPageThumbnailCache::invalidate()
+{
+    for (Thumbnail& thumbnail : m_thumbnails) {
+        thumbnail.isDirty = true;
+    }
+}
+
+void NotationPageThumbnailCache::invalidate(int tickFrom, int tickTo)
+{
+    for (Thumbnail& thumbnail : m_thumbnails) {
+        const PageInfo& page = thumbnail.page;
+        if (page.tickFrom < 0 || page.tickFrom > tickTo || page.tickTo < tickFrom) {
+            continue;
+        }
+
+        thumbnail.isDirty = true;
+    }
+}
+
+void NotationPageThumbnailCache::update(const PaintFunc& paintFunc, const RectF& visibleRect)
+{
+    std::vector<size_t> dirtyPages;
+    for (size_t i = 0; i < m_thumbnails.size(); ++i) {
+        const Thumbnail& thumbnail = m_thumbnails[i];
+        if (thumbnail.isDirty && thumbnail.page.rect.isValid()) {
+            dirtyPages.push_back(i);
+        }
+    }
+
+    //! NOTE The visible pages first, the others in their order
+    std::stable_partition(dirtyPages.begin(), dirtyPages.end(), [this, &visibleRect](size_t pageIdx) {
+        return m_thumbnails[pageIdx].page.rect.intersects(visibleRect);
+    });
+
+    const size_t recordCount = std::min(dirtyPages.size(), MAX_RECORDS_PER_UPDATE);
+    for (size_t i = 0; i < recordCount; ++i) {
+        record(dirtyPages[i], m_thumbnails[dirtyPages[i]], paintFunc);
+    }
+
+    if (recordCount < dirtyPages.size()) {
+        queueUpdate();
+    }
+}
+
+void NotationPageThumbnailCache::queueUpdate()
+{
+    if (m_isUpdateQueued) {
+        return;
+    }
+
+    m_isUpdateQueued = true;
+
+    //! NOTE The next pages are recorded after the events already queued, so the UI stays responsive
+    std::weak_ptr<NotationPageThumbnailCache*> self = m_self;
+    Async::call(nullptr, [self]() {
+        if (std::shared_ptr<NotationPageThumbnailCache*> cache = self.lock()) {
+            (*cache)->m_isUpdateQueued = false;
+            (*cache)->m_thumbnailsChanged.notify();
+        }
+    }, runtime::mainThreadId());
+}
+
+double NotationPageThumbnailCache::thumbnailScale(const RectF& pageRect) const
+{
+    const double maxSide = std::max(pageRect.width(), pageRect.height());
+    if (maxSide * m_scale <= MAX_THUMBNAIL_SIZE) {
+        return m_scale;
+    }
+
+    return MAX_THUMBNAIL_SIZE / maxSide;
+}
+
+void NotationPageThumbnailCache::record(size_t pageIdx, Thumbnail& thumbnail, const PaintFunc& paintFunc)
+{
+    TRACEFUNC;
+
+    const RectF& rect = thumbnail.page.rect;
+    const double scale = thumbnailScale(rect);
+    const int width = std::max(static_cast<int>(std::ceil(rect.width() * scale)), 1);
+    const int height = std::max(static_cast<int>(std::ceil(rect.height() * scale)), 1);
+
+    std::shared_ptr<BufferedPaintProvider> provider = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(provider, "pagethumbnail");
+
+        //! NOTE The recording keeps the absolute transforms, so the scale is applied here
+        painter.setAntialiasing(true);
+        painter.setWorldTransform(Transform(scale, 0, 0, scale, -rect.x() * scale, -rect.y() * scale));
+
+        paintFunc(&painter, rect);
+
+        painter.endDraw();
+    }
+
+    DrawDataPtr data = provider->drawData();
+
+    thumbnail.scale = scale;
+    thumbnail.version = ++m_version;
+    thumbnail.isDirty = false;
+    thumbnail.isRastering = true;
+
+    m_statistic.records++;
+
+    const uint64_t version = thumbnail.version;
+
+    //! NOTE QPixmap may be used only on the main thread, so do the pages with images right away
+    if (hasPixmaps(data->item)) {
+        onRastered(pageIdx, version, rasterPage(data, width, height));
+        return;
+    }
+
+    std::weak_ptr<NotationPageThumbnailCache*> self = m_self;
+    TaskScheduler::instance(ThreadPriority::Background)->push([self, pageIdx, version, data, width, height]() {
+        QImage image = rasterPage(data, width, height);
+
+        Async::call(nullptr, [self, pageIdx, version, image]() {
+            if (std::shared_ptr<NotationPageThumbnailCache*> cache = self.lock()) {
+                (*cache)->onRastered(pageIdx, version, image);
+            }
+        }, runtime::mainThreadId());
+    });
+}
+
+void NotationPageThumbnailCache::onRastered(size_t pageIdx, uint64_t version, const QImage& image)
+{
+    if (pageIdx >= m_thumbnails.size()) {
+        return;
+    }
+
+    //! NOTE The page was recorded again in the meantime
+    Thumbnail& thumbnail = m_thumbnails[pageIdx];
+    if (thumbnail.version != version) {
+        return;
+    }
+
+    thumbnail.pixmap = QPixmap::fromImage(image);
+    thumbnail.isRastering = false;
+
+    m_statistic.rasters++;
+
+    m_thumbnailsChanged.notify();
+}
+
+void NotationPageThumbnailCache::paint(Painter* painter, const RectF& logicalRect) const
+{
+    TRACEFUNC;
+
+    for (const Thumbnail& thumbnail : m_thumbnails) {
+        if (thumbnail.pixmap.isNull() || !thumbnail.page.rect.intersects(logicalRect)) {
+            continue;
+        }
+
+        painter->save();
+        painter->translate(thumbnail.page.rect.topLeft());
+        painter->scale(1.0 / thumbnail.scale, 1.0 / thumbnail.scale);
+        painter->drawPixmap(PointF(), thumbnail.pixmap);
+        painter->restore();
+    }
+}
+
+bool NotationPageThumbnailCache::isUpToDate() const
+{
+    for (const Thumbnail& thumbnail : m_thumbnails) {
+        if (thumbnail.isDirty || thumbnail.isRastering) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Notification NotationPageThumbnailCache::thumbnailsChanged() const
+{
+    return m_thumbnailsChanged;
+}
+
+double NotationPageThumbnailCache::scale() const
+{
+    return m_scale;
+}
+
+size_t NotationPageThumbnailCache::pageCount() const
+{
+    return m_thumbnails.size();
+}
+
+size_t NotationPageThumbnailCache::thumbnailCount() const
+{
+    return std::count_if(m_thumbnails.cbegin(), m_thumbnails.cend(), [](const Thumbnail& thumbnail) {
+        return !thumbnail.pixmap.isNull();
+    });
+}
+
+const NotationPageThumbnailCache::Statistic& NotationPageThumbnailCache::statistic() const
+{
+    return m_statistic;
+}
+
+void NotationPageThumbnailCache::resetStatistic()
+{
+    m_statistic = Statistic();
+}
@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_NOTATION_NOTATIONPAGETHUMBNAILCACHE_H
+#define MU_NOTATION_NOTATIONPAGETHUMBNAILCACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QImage>
+#include <QPixmap>
+
+#include "async/notification.h"
+#include "draw/painter.h"
+#include "draw/types/geometry.h"
+
+namespace mu::notation {
+//! NOTE Keeps every page rasterised at a fixed low resolution, for the overviews of the score.
+//! The DOM is not thread safe, so a page is recorded on the main thread, without rasterising it,
+//! and the recording is rasterised on a background thread. A page is done again only if
+//! its layout has changed or if it contains edited ticks.
+class NotationPageThumbnailCache
+{
+public:
+    //! NOTE Paints the score inside the logical rect, the world transform is already set
+    using PaintFunc = std::function<void (muse::draw::Painter* painter, const muse::RectF& logicalRect)>;
+
+    struct PageInfo {
+        muse::RectF rect; // logical
+        int tickFrom = -1;
+        int tickTo = -1;
+        size_t systemCount = 0;
+
+        bool operator==(const PageInfo& other) const;
+    };
+
+    struct Statistic {
+        size_t records = 0;
+        size_t rasters = 0;
+    };
+
+    //! NOTE Device pixels per logical unit: 24 dpi, the score is laid out at 360
+    static constexpr double DEFAULT_SCALE = 1.0 / 15.0;
+
+    //! NOTE Very long pages, like the one of the continuous view, get a lower resolution
+    static constexpr int MAX_THUMBNAIL_SIZE = 8192;
+
+    //! NOTE Recording is done on the main thread, so a large score is recorded over several updates
+    static constexpr size_t MAX_RECORDS_PER_UPDATE = 3;
+
+    explicit NotationPageThumbnailCache(double scale = DEFAULT_SCALE);
+    ~NotationPageThumbnailCache();
+
+    //! NOTE The pages whose info differs from the previous one are recorded again
+    void setPages(const std::vector<PageInfo>& pages);
+
+    void invalidate();
+    void invalidate(int tickFrom, int tickTo);
+
+    //! NOTE Records the pages which are out of date and sends them to be rasterised.
+    //! The pages inside the visible rect go first. If more pages are out of date than
+    //! may be recorded at once, thumbnailsChanged() is sent from the main thread queue
+    //! to ask for the next update
+    void update(const PaintFunc& paintFunc, const muse::RectF& visibleRect);
+
+    //! NOTE Paints the thumbnails into the page rects, the world transform of the painter
+    //! maps logical coordinates to the device ones. A page not rasterised yet is left blank
+    void paint(muse::draw::Painter* painter, const muse::RectF& logicalRect) const;
+
+    bool isUpToDate() const;
+    muse::async::Notification thumbnailsChanged() const;
+
+    double scale() const;
+    size_t pageCount() const;
+    size_t thumbnailCount() const;
+
+    const Statistic& statistic() const;
+    void resetStatistic();
+
+private:
+    struct Thumbnail {
+        PageInfo page;
+        double scale = 0.0;
+        uint64_t version = 0;
+        bool isDirty = true;
+        bool isRastering = false;
+        QPixmap pixmap;
+    };
+
+    double thumbnailScale(const muse::RectF& pageRect) const;
+    void record(size_t pageIdx, Thumbnail& thumbnail, const PaintFunc& paintFunc);
+    void onRastered(size_t pageIdx, uint64_t version, const QImage& image);
+    void queueUpdate();
+
+    double m_scale = DEFAULT_SCALE;
+    std::vector<Thumbnail> m_thumbnails;
+    uint64_t m_version = 0;
+    bool m_isUpdateQueued = false;
+
+    //! NOTE The rasters come back through the main thread queue, the cache may be gone by then
+    std::shared_ptr<NotationPageThumbnailCache*> m_self;
+
+    muse::async::Notification m_thumbnailsChanged;
+    Statistic m_statistic;
+};
+}
+
+#endif // MU_NOTATION_NOTATIONPAGETHUMBNAILCACHE_H
@@ -0,0 +1,199 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "notationtilecache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "log.h"
+
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::draw;
+
+NotationTileCache::NotationTileCache(int tileSize, size_t maxTileCount)
+    : m_tileSize(std::max(tileSize, 1)), m_maxTileCount(maxTileCount)
+{
+}
+
+int64_t NotationTileCache::tileKey(int i, int j)
+{
+    return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(i)) << 32) | static_cast<uint32_t>(j));
+}
+
+void NotationTileCache::paint(Painter* painter, const RectF& deviceRect, const Transform& matrix, const PaintFunc& paintFunc)
+{
+    TRACEFUNC;
+
+    if (deviceRect.isEmpty()) {
+        return;
+    }
+
+    updateCanvasTransform(matrix);
+
+    //! NOTE The whole-pixel part of the translation, the tiles are blitted without any scaling
+    const double originX = std::floor(matrix.dx());
+    const double originY = std::floor(matrix.dy());
+
+    const RectF canvasRect = deviceRect.translated(-originX, -originY);
+    const int firstI = static_cast<int>(std::floor(canvasRect.left() / m_tileSize));
+    const int lastI = static_cast<int>(std::ceil(canvasRect.right() / m_tileSize));
+    const int firstJ = static_cast<int>(std::floor(canvasRect.top() / m_tileSize));
+    const int lastJ = static_cast<int>(std::ceil(canvasRect.bottom() / m_tileSize));
+
+    ++m_frame;
+
+    for (int j = firstJ; j < lastJ; ++j) {
+        for (int i = firstI; i < lastI; ++i) {
+            const Tile& tile = findOrRasterTile(i, j, paintFunc);
+            painter->drawPixmap(PointF(originX + i * m_tileSize, originY + j * m_tileSize), tile.pixmap);
+        }
+    }
+
+    evictUnusedTiles();
+}
+
+void NotationTileCache::updateCanvasTransform(const Transform& matrix)
+{
+    const Transform canvasTransform(matrix.m11(), matrix.m12(), matrix.m21(), matrix.m22(),
+                                    matrix.dx() - std::floor(matrix.dx()), matrix.dy() - std::floor(matrix.dy()));
+
+    if (m_hasCanvasTransform && canvasTransform == m_canvasTransform) {
+        return;
+    }
+
+    invalidate();
+
+    m_canvasTransform = canvasTransform;
+    m_hasCanvasTransform = true;
+}
+
+NotationTileCache::Tile& NotationTileCache::findOrRasterTile(int i, int j, const PaintFunc& paintFunc)
+{
+    const int64_t key = tileKey(i, j);
+
+    auto it = m_tileByKey.find(key);
+    if (it != m_tileByKey.end()) {
+        m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+        m_statistic.hits++;
+
+        Tile& tile = m_tiles.front();
+        tile.frame = m_frame;
+        return tile;
+    }
+
+    Tile tile;
+    tile.key = key;
+    tile.i = i;
+    tile.j = j;
+    tile.frame = m_frame;
+    tile.pixmap = QPixmap(m_tileSize, m_tileSize);
+    tile.pixmap.fill(Qt::transparent);
+
+    {
+        const double tileX = static_cast<double>(i) * m_tileSize;
+        const double tileY = static_cast<double>(j) * m_tileSize;
+        const Transform tileTransform(m_canvasTransform.m11(), m_canvasTransform.m12(),
+                                      m_canvasTransform.m21(), m_canvasTransform.m22(),
+                                      m_canvasTransform.dx() - tileX, m_canvasTransform.dy() - tileY);
+
+        Painter painter(&tile.pixmap, "notationtile");
+
+        //! NOTE Same as the painter of QuickPaintedView
+        painter.setAntialiasing(false);
+        painter.setWorldTransform(tileTransform);
+
+        const RectF logicalRect = tileTransform.inverted().map(RectF(0, 0, m_tileSize, m_tileSize));
+        paintFunc(&painter, logicalRect);
+
+        painter.endDraw();
+    }
+
+    m_statistic.rasters++;
+
+    m_tiles.push_front(std::move(tile));
+    m_tileByKey[key] = m_tiles.begin();
+
+    return m_tiles.front();
+}
+
+void NotationTileCache::evictUnusedTiles()
+{
+    //! NOTE The tiles of the current frame are kept even above the limit, the view needs them all
+    while (m_tiles.size() > m_maxTileCount && m_tiles.back().frame != m_frame) {
+        m_tileByKey.erase(m_tiles.back().key);
+        m_tiles.pop_back();
+        m_statistic.evictions++;
+    }
+}
+
+void NotationTileCache::invalidate()
+{
+    m_tiles.clear();
+    m_tileByKey.clear();
+}
+
+void NotationTileCache::invalidate(const RectF& logicalRect)
+{
+    if (!logicalRect.isValid()) {
+        invalidate();
+        return;
+    }
+
+    if (m_tiles.empty()) {
+        return;
+    }
+
+    //! NOTE Grow by a pixel, antialiased edges may reach into the next tile
+    const RectF canvasRect = m_canvasTransform.map(logicalRect).adjusted(-1, -1, 1, 1);
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        const RectF tileRect(it->i * m_tileSize, it->j * m_tileSize, m_tileSize, m_tileSize);
+        if (!tileRect.intersects(canvasRect)) {
+            ++it;
+            continue;
+        }
+
+        m_tileByKey.erase(it->key);
+        it = m_tiles.erase(it);
+    }
+}
+
+int NotationTileCache::tileSize() const
+{
+    return m_tileSize;
+}
+
+size_t NotationTileCache::tileCount() const
+{
+    return m_tiles.size();
+}
+
+const NotationTileCache::Statistic& NotationTileCache::statistic() const
+{
+    return m_statistic;
+}
+
+void NotationTileCache::resetStatistic()
+{
+    m_statistic = Statistic();
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_NOTATION_NOTATIONTILECACHE_H
+#define MU_NOTATION_NOTATIONTILECACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include <QPixmap>
+
+#include "draw/painter.h"
+#include "draw/types/geometry.h"
+#include "draw/types/transform.h"
+
+namespace mu::notation {
+//! NOTE Keeps the score rasterised at the current zoom, in square tiles of device pixels.
+//! The tiles are laid out on the grid of the canvas, so scrolling by whole pixels reuses them,
+//! any other change of the matrix throws them all away. The least recently used tiles are
+//! dropped when there are more than maxTileCount of them.
+class NotationTileCache
+{
+public:
+    //! NOTE Paints the score inside the logical rect, the world transform is already set
+    using PaintFunc = std::function<void (muse::draw::Painter* painter, const muse::RectF& logicalRect)>;
+
+    struct Statistic {
+        size_t hits = 0;
+        size_t rasters = 0;
+        size_t evictions = 0;
+    };
+
+    static constexpr int DEFAULT_TILE_SIZE = 256;
+    static constexpr size_t DEFAULT_MAX_TILE_COUNT = 128;
+
+    explicit NotationTileCache(int tileSize = DEFAULT_TILE_SIZE, size_t maxTileCount = DEFAULT_MAX_TILE_COUNT);
+
+    //! NOTE Fills the device rect of the painter, which must have no world transform;
+    //! matrix maps logical coordinates to the device ones
+    void paint(muse::draw::Painter* painter, const muse::RectF& deviceRect, const muse::draw::Transform& matrix,
+               const PaintFunc& paintFunc);
+
+    void invalidate();
+    void invalidate(const muse::RectF& logicalRect);
+
+    int tileSize() const;
+    size_t tileCount() const;
+
+    const Statistic& statistic() const;
+    void resetStatistic();
+
+private:
+    struct Tile {
+        int64_t key = 0;
+        int i = 0;
+        int j = 0;
+        QPixmap pixmap;
+        uint64_t frame = 0;
+    };
+
+    using TileList = std::list<Tile>;
+
+    static int64_t tileKey(int i, int j);
+
+    void updateCanvasTransform(const muse::draw::Transform& matrix);
+    Tile& findOrRasterTile(int i, int j, const PaintFunc& paintFunc);
+    void evictUnusedTiles();
+
+    int m_tileSize = DEFAULT_TILE_SIZE;
+    size_t m_maxTileCount = DEFAULT_MAX_TILE_COUNT;
+
+    //! NOTE Logical to canvas coordinates: the matrix without the whole-pixel translation
+    muse::draw::Transform m_canvasTransform;
+    bool m_hasCanvasTransform = false;
+
+    TileList m_tiles; // most recently used first
+    std::unordered_map<int64_t, TileList::iterator> m_tileByKey;
+    uint64_t m_frame = 0;
+
+    Statistic m_statistic;
+};
+}
+
+#endif // MU_NOTATION_NOTATIONTILECACHE_H
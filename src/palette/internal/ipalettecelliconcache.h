@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_PALETTE_IPALETTECELLICONCACHE_H
+#define MU_PALETTE_IPALETTECELLICONCACHE_H
+
+#include <QByteArray>
+#include <QImage>
+
+#include "modularity/imoduleinterface.h"
+#include "async/notification.h"
+
+namespace mu::palette {
+class IPaletteCellIconCache : MODULE_EXPORT_INTERFACE
+{
+    INTERFACE_ID(IPaletteCellIconCache)
+
+public:
+    virtual ~IPaletteCellIconCache() = default;
+
+    //! NOTE The key must describe everything the icon depends on:
+    //! the cell itself, the size, the DPI, the colors...
+    //! Returns a null image if the icon is not in memory. If it may be on the disk, isLoading is set:
+    //! it is decoded in the background, iconsLoaded() is notified once it is in memory
+    virtual QImage icon(const QByteArray& key, bool& isLoading) const = 0;
+    virtual void setIcon(const QByteArray& key, const QImage& icon) = 0;
+
+    virtual muse::async::Notification iconsLoaded() const = 0;
+};
+}
+
+#endif // MU_PALETTE_IPALETTECELLICONCACHE_H
@@ -0,0 +1,198 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "palettecelliconcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "async/async.h"
+#include "concurrency/taskscheduler.h"
+#include "global/runtime.h"
+
+#include "log.h"
+
+using namespace mu::palette;
+using namespace muse;
+using namespace muse::async;
+
+//! NOTE A palette cell icon takes from a few to some tens of KB
+static constexpr qsizetype MAX_MEMORY_COST = 64 * 1024 * 1024;
+static constexpr int MAX_FILE_COUNT = 8192;
+
+static const char* ICON_FILE_SUFFIX = ".png";
+
+PaletteCellIconCache::PaletteCellIconCache()
+    : m_self(std::make_shared<PaletteCellIconCache*>(this))
+{
+    m_icons.setMaxCost(MAX_MEMORY_COST);
+}
+
+PaletteCellIconCache::~PaletteCellIconCache()
+{
+    m_self.reset();
+}
+
+void PaletteCellIconCache::init()
+{
+    m_dirPath = configuration()->cellIconCacheDirPath().toQString();
+
+    //! NOTE The icons of other versions may look different, they get other ids
+    m_revision = QByteArray::fromStdString(application()->fullVersion().toStdString())
+                 + application()->revision().toQString().toUtf8();
+
+    QString dirPath = m_dirPath;
+    TaskScheduler::instance(ThreadPriority::Background)->push([dirPath]() {
+        QDir().mkpath(dirPath);
+        pruneDir(dirPath, MAX_FILE_COUNT);
+    });
+}
+
+QString PaletteCellIconCache::iconId(const QByteArray& key) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(m_revision);
+    hash.addData(key);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString PaletteCellIconCache::iconFilePath(const QString& id) const
+{
+    return m_dirPath + "/" + id + ICON_FILE_SUFFIX;
+}
+
+QImage PaletteCellIconCache::icon(const QByteArray& key, bool& isLoading) const
+{
+    isLoading = false;
+
+    const QString id = iconId(key);
+
+    if (const QImage* icon = m_icons.object(id)) {
+        return *icon;
+    }
+
+    if (m_dirPath.isEmpty() || m_missingIds.contains(id)) {
+        return QImage();
+    }
+
+    isLoading = true;
+
+    if (!m_loadingIds.contains(id)) {
+        m_loadingIds.insert(id);
+        loadIcon(id);
+    }
+
+    return QImage();
+}
+
+void PaletteCellIconCache::setIcon(const QByteArray& key, const QImage& icon)
+{
+    if (icon.isNull()) {
+        return;
+    }
+
+    const QString id = iconId(key);
+    insertIcon(id, icon);
+    m_missingIds.remove(id);
+
+    if (m_dirPath.isEmpty()) {
+        return;
+    }
+
+    QString filePath = iconFilePath(id);
+    TaskScheduler::instance(ThreadPriority::Background)->push([filePath, icon]() {
+        //! NOTE Other instances of the app may write the same icon at the same time
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || !icon.save(&file, "PNG") || !file.commit()) {
+            LOGW() << "Unable to save palette cell icon: " << filePath;
+        }
+    });
+}
+
+muse::async::Notification PaletteCellIconCache::iconsLoaded() const
+{
+    return m_iconsLoaded;
+}
+
+void PaletteCellIconCache::insertIcon(const QString& id, const QImage& icon) const
+{
+    m_icons.insert(id, new QImage(icon), icon.sizeInBytes());
+}
+
+//! NOTE Even a small PNG takes a while to decode, so it is done with the files,
+//! the icons loaded meanwhile are notified at once
+void PaletteCellIconCache::loadIcon(const QString& id) const
+{
+    std::weak_ptr<PaletteCellIconCache*> self = m_self;
+    const QString filePath = iconFilePath(id);
+
+    TaskScheduler::instance(ThreadPriority::Background)->push([self, id, filePath]() {
+        QImage icon;
+        icon.load(filePath, "PNG");
+
+        Async::call(nullptr, [self, id, icon]() {
+            if (std::shared_ptr<PaletteCellIconCache*> cache = self.lock()) {
+                (*cache)->onIconLoaded(id, icon);
+            }
+        }, runtime::mainThreadId());
+    });
+}
+
+void PaletteCellIconCache::onIconLoaded(const QString& id, const QImage& icon)
+{
+    m_loadingIds.remove(id);
+
+    if (icon.isNull()) {
+        m_missingIds.insert(id);
+    } else {
+        insertIcon(id, icon);
+    }
+
+    if (m_isLoadedNotifyQueued) {
+        return;
+    }
+
+    m_isLoadedNotifyQueued = true;
+
+    std::weak_ptr<PaletteCellIconCache*> self = m_self;
+    Async::call(nullptr, [self]() {
+        if (std::shared_ptr<PaletteCellIconCache*> cache = self.lock()) {
+            (*cache)->m_isLoadedNotifyQueued = false;
+            (*cache)->m_iconsLoaded.notify();
+        }
+    }, runtime::mainThreadId());
+}
+
+void PaletteCellIconCache::pruneDir(const QString& dirPath, int maxFileCount)
+{
+    QDir dir(dirPath);
+    QFileInfoList files = dir.entryInfoList({ QString("*") + ICON_FILE_SUFFIX }, QDir::Files, QDir::Time);
+    if (files.size() <= maxFileCount) {
+        return;
+    }
+
+    //! NOTE The list is sorted by time, the newest first
+    for (qsizetype i = maxFileCount; i < files.size(); ++i) {
+        QFile::remove(files.at(i).absoluteFilePath());
+    }
+}
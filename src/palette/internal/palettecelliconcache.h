@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_PALETTE_PALETTECELLICONCACHE_H
+#define MU_PALETTE_PALETTECELLICONCACHE_H
+
+#include <memory>
+
+#include <QCache>
+#include <QSet>
+#include <QString>
+
+#include "ipalettecelliconcache.h"
+
+#include "modularity/ioc.h"
+#include "iapplication.h"
+#include "../ipaletteconfiguration.h"
+
+namespace mu::palette {
+//! NOTE Rendered cell icons, kept in memory and as PNG files in the app data dir,
+//! so that they survive restarts. The files are written and decoded on a background thread.
+class PaletteCellIconCache : public IPaletteCellIconCache
+{
+public:
+    INJECT(IPaletteConfiguration, configuration)
+    INJECT(muse::IApplication, application)
+
+public:
+    PaletteCellIconCache();
+    ~PaletteCellIconCache() override;
+
+    void init();
+
+    QImage icon(const QByteArray& key, bool& isLoading) const override;
+    void setIcon(const QByteArray& key, const QImage& icon) override;
+
+    muse::async::Notification iconsLoaded() const override;
+
+    //! NOTE Removes the oldest icon files, over the max count
+    static void pruneDir(const QString& dirPath, int maxFileCount);
+
+private:
+    QString iconId(const QByteArray& key) const;
+    QString iconFilePath(const QString& id) const;
+
+    void insertIcon(const QString& id, const QImage& icon) const;
+
+    void loadIcon(const QString& id) const;
+    void onIconLoaded(const QString& id, const QImage& icon);
+
+    QString m_dirPath;
+    QByteArray m_revision;
+
+    mutable QCache<QString, QImage> m_icons;
+    mutable QSet<QString> m_loadingIds;
+    QSet<QString> m_missingIds;
+
+    muse::async::Notification m_iconsLoaded;
+    bool m_isLoadedNotifyQueued = false;
+
+    std::shared_ptr<PaletteCellIconCache*> m_self;
+};
+}
+
+#endif // MU_PALETTE_PALETTECELLICONCACHE_H
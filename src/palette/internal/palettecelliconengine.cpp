@@ -21,6 +21,7 @@
  */
 #include "palettecelliconengine.h"
 
+#include <QDataStream>
 #include <QPainter>
 
 #include "draw/types/geometry.h"
@@ -49,18 +50,83 @@ QIconEngine* PaletteCellIconEngine::clone() const
 
 void PaletteCellIconEngine::paint(QPainter* qp, const QRect& rect, QIcon::Mode mode, QIcon::State state)
 {
-    qreal dpi = qp->device()->logicalDpiX();
-    Painter p(qp, "palettecell");
-    p.save();
-    p.setAntialiasing(true);
-    paintCell(p, RectF::fromQRectF(rect), mode == QIcon::Selected, state == QIcon::On, dpi);
-    p.restore();
+    {
+        Painter p(qp, "palettecell");
+        p.save();
+        p.setAntialiasing(true);
+        paintBackground(p, RectF::fromQRectF(rect), mode == QIcon::Selected, state == QIcon::On);
+        p.restore();
+    }
+
+    if (!m_cell || !m_cell->element || rect.isEmpty()) {
+        return;
+    }
+
+    //! NOTE The background depends on the state of the cell, the cell itself is painted from the cache
+    const QImage icon = cellIcon(rect.size(), qp->device()->logicalDpiX(), qp->device()->devicePixelRatioF());
+    if (!icon.isNull()) {
+        qp->drawImage(rect, icon);
+    }
+}
+
+QByteArray PaletteCellIconEngine::cellIconKey(const PaletteCell& cell, const QByteArray& cellData, qreal extraMag, const QSize& size,
+                                              qreal dpi, qreal devicePixelRatio, qreal paletteSpatium, const QColor& elementsColor)
+{
+    QByteArray key = cellData;
+
+    QDataStream stream(&key, QIODevice::Append);
+    stream << extraMag << cell.mag << cell.xoffset << cell.yoffset << cell.drawStaff
+           << size << dpi << devicePixelRatio
+           << paletteSpatium << elementsColor.rgba();
+
+    return key;
+}
+
+QByteArray PaletteCellIconEngine::iconCacheKey(const QSize& size, qreal dpi, qreal devicePixelRatio) const
+{
+    //! NOTE The cell may be changed while the engine lives, e.g. its element retranslated,
+    //! so it is written every time: that is still much cheaper than painting it
+    return cellIconKey(*m_cell, m_cell->toMimeData(), m_extraMag, size, dpi, devicePixelRatio,
+                       configuration()->paletteSpatium(), configuration()->elementsColor());
 }
 
-void PaletteCellIconEngine::paintCell(Painter& painter, const RectF& rect, bool selected, bool current, qreal dpi) const
+QImage PaletteCellIconEngine::cellIcon(const QSize& size, qreal dpi, qreal devicePixelRatio) const
 {
-    paintBackground(painter, rect, selected, current);
+    const QByteArray key = iconCacheKey(size, dpi, devicePixelRatio);
+
+    //! NOTE An icon being loaded from the disk is painted once it is there
+    if (iconCache()) {
+        bool isLoading = false;
+        QImage icon = iconCache()->icon(key, isLoading);
+        if (!icon.isNull() || isLoading) {
+            return icon;
+        }
+    }
+
+    QImage icon(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    icon.setDevicePixelRatio(devicePixelRatio);
+
+    //! NOTE The fonts are sized by the DPI of the device, it must be the same as on the screen
+    const int dotsPerMeter = qRound(dpi / 0.0254);
+    icon.setDotsPerMeterX(dotsPerMeter);
+    icon.setDotsPerMeterY(dotsPerMeter);
+    icon.fill(Qt::transparent);
+
+    {
+        Painter p(&icon, "palettecell");
+        p.setAntialiasing(true);
+        paintCell(p, RectF(0, 0, size.width(), size.height()), dpi);
+    }
+
+    if (iconCache()) {
+        iconCache()->setIcon(key, icon);
+    }
 
+    return icon;
+}
+
+void PaletteCellIconEngine::paintCell(Painter& painter, const RectF& rect, qreal dpi) const
+{
     if (!m_cell) {
         return;
     }
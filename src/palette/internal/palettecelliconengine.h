@@ -28,6 +28,7 @@
 
 #include "modularity/ioc.h"
 #include "ipaletteconfiguration.h"
+#include "ipalettecelliconcache.h"
 #include "engraving/rendering/isinglerenderer.h"
 
 namespace muse::draw {
@@ -39,6 +40,7 @@ class PaletteCellIconEngine : public QIconEngine
 {
     INJECT_STATIC(IPaletteConfiguration, configuration)
     INJECT_STATIC(engraving::rendering::ISingleRenderer, engravingRender)
+    INJECT_STATIC(IPaletteCellIconCache, iconCache)
 
 public:
     explicit PaletteCellIconEngine(PaletteCellConstPtr cell, qreal extraMag = 1.0);
@@ -56,8 +58,15 @@ public:
 
     static void paintPaletteItem(void* context, mu::engraving::EngravingItem* element);
 
+    //! NOTE Everything the icon of the cell depends on
+    static QByteArray cellIconKey(const PaletteCell& cell, const QByteArray& cellData, qreal extraMag, const QSize& size, qreal dpi,
+                                  qreal devicePixelRatio, qreal paletteSpatium, const QColor& elementsColor);
+
 private:
-    void paintCell(muse::draw::Painter& painter, const muse::RectF& rect, bool selected, bool current, qreal dpi) const;
+    QByteArray iconCacheKey(const QSize& size, qreal dpi, qreal devicePixelRatio) const;
+    QImage cellIcon(const QSize& size, qreal dpi, qreal devicePixelRatio) const;
+
+    void paintCell(muse::draw::Painter& painter, const muse::RectF& rect, qreal dpi) const;
     void paintBackground(muse::draw::Painter& painter, const muse::RectF& rect, bool selected, bool current) const;
     void paintActionIcon(muse::draw::Painter& painter, const muse::RectF& rect, mu::engraving::EngravingItem* element, double dpi) const;
     qreal paintStaff(muse::draw::Painter& painter, const muse::RectF& rect, qreal spatium) const;
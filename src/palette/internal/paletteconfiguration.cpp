@@ -137,6 +137,11 @@ muse::io::path_t PaletteConfiguration::timeSignaturesDirPath() const
     return globalConfiguration()->userAppDataPath() + "/timesigs";
 }
 
+muse::io::path_t PaletteConfiguration::cellIconCacheDirPath() const
+{
+    return globalConfiguration()->userAppDataPath() + "/palette_icons";
+}
+
 bool PaletteConfiguration::useFactorySettings() const
 {
     return globalConfiguration()->useFactorySettings();
@@ -57,6 +57,7 @@ public:
 
     muse::io::path_t keySignaturesDirPath() const override;
     muse::io::path_t timeSignaturesDirPath() const override;
+    muse::io::path_t cellIconCacheDirPath() const override;
 
     bool useFactorySettings() const override;
     bool enableExperimental() const override;
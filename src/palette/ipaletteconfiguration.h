@@ -57,6 +57,7 @@ public:
 
     virtual muse::io::path_t keySignaturesDirPath() const = 0;
     virtual muse::io::path_t timeSignaturesDirPath() const = 0;
+    virtual muse::io::path_t cellIconCacheDirPath() const = 0;
 
     virtual bool useFactorySettings() const = 0;
     virtual bool enableExperimental() const = 0;
@@ -37,6 +37,7 @@
 #include "internal/paletteworkspacesetup.h"
 #include "internal/paletteprovider.h"
 #include "internal/palettecell.h"
+#include "internal/palettecelliconcache.h"
 
 #include "view/paletterootmodel.h"
 #include "view/palettepropertiesmodel.h"
@@ -74,9 +75,11 @@ void PaletteModule::registerExports()
     m_paletteUiActions = std::make_shared<PaletteUiActions>(m_actionsController);
     m_configuration = std::make_shared<PaletteConfiguration>();
     m_paletteWorkspaceSetup = std::make_shared<PaletteWorkspaceSetup>();
+    m_cellIconCache = std::make_shared<PaletteCellIconCache>();
 
     ioc()->registerExport<IPaletteProvider>(moduleName(), m_paletteProvider);
     ioc()->registerExport<IPaletteConfiguration>(moduleName(), m_configuration);
+    ioc()->registerExport<IPaletteCellIconCache>(moduleName(), m_cellIconCache);
 }
 
 void PaletteModule::resolveImports()
@@ -141,6 +144,7 @@ void PaletteModule::onInit(const IApplication::RunMode& mode)
     }
 
     m_configuration->init();
+    m_cellIconCache->init();
     m_actionsController->init();
     m_paletteUiActions->init();
     m_paletteProvider->init();
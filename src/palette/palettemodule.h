@@ -32,6 +32,7 @@ class PaletteActionsController;
 class PaletteUiActions;
 class PaletteConfiguration;
 class PaletteWorkspaceSetup;
+class PaletteCellIconCache;
 class PaletteModule : public muse::modularity::IModuleSetup
 {
 public:
@@ -54,6 +55,7 @@ private:
     std::shared_ptr<PaletteUiActions> m_paletteUiActions;
     std::shared_ptr<PaletteConfiguration> m_configuration;
     std::shared_ptr<PaletteWorkspaceSetup> m_paletteWorkspaceSetup;
+    std::shared_ptr<PaletteCellIconCache> m_cellIconCache;
 };
 }
 
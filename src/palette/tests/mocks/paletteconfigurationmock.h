@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_PALETTE_PALETTECONFIGURATIONMOCK_H
+#define MU_PALETTE_PALETTECONFIGURATIONMOCK_H
+
+#include <gmock/gmock.h>
+
+#include "palette/ipaletteconfiguration.h"
+
+namespace mu::palette {
+class PaletteConfigurationMock : public IPaletteConfiguration
+{
+public:
+    MOCK_METHOD(double, paletteSpatium, (), (const, override));
+
+    MOCK_METHOD(double, paletteScaling, (), (const, override));
+    MOCK_METHOD(void, setPaletteScaling, (double), (override));
+
+    MOCK_METHOD(muse::ValCh<bool>, isSinglePalette, (), (const, override));
+    MOCK_METHOD(void, setIsSinglePalette, (bool), (override));
+
+    MOCK_METHOD(muse::ValCh<bool>, isSingleClickToOpenPalette, (), (const, override));
+    MOCK_METHOD(void, setIsSingleClickToOpenPalette, (bool), (override));
+
+    MOCK_METHOD(QColor, elementsBackgroundColor, (), (const, override));
+    MOCK_METHOD(QColor, elementsColor, (), (const, override));
+    MOCK_METHOD(QColor, gridColor, (), (const, override));
+    MOCK_METHOD(QColor, accentColor, (), (const, override));
+    MOCK_METHOD(muse::async::Notification, colorsChanged, (), (const, override));
+
+    MOCK_METHOD(muse::io::path_t, keySignaturesDirPath, (), (const, override));
+    MOCK_METHOD(muse::io::path_t, timeSignaturesDirPath, (), (const, override));
+    MOCK_METHOD(muse::io::path_t, cellIconCacheDirPath, (), (const, override));
+
+    MOCK_METHOD(bool, useFactorySettings, (), (const, override));
+    MOCK_METHOD(bool, enableExperimental, (), (const, override));
+
+    MOCK_METHOD(muse::ValCh<PaletteConfig>, paletteConfig, (const QString&), (const, override));
+    MOCK_METHOD(void, setPaletteConfig, (const QString&, const PaletteConfig&), (override));
+
+    MOCK_METHOD(muse::ValCh<PaletteCellConfig>, paletteCellConfig, (const QString&), (const, override));
+    MOCK_METHOD(void, setPaletteCellConfig, (const QString&, const PaletteCellConfig&), (override));
+};
+}
+
+#endif // MU_PALETTE_PALETTECONFIGURATIONMOCK_H
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "async/processevents.h"
+#include "concurrency/taskscheduler.h"
+
+#include "palette/internal/palettecell.h"
+#include "palette/internal/palettecelliconcache.h"
+#include "palette/internal/palettecelliconengine.h"
+
+#include "global/tests/mocks/applicationmock.h"
+#include "mocks/paletteconfigurationmock.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace mu;
+using namespace mu::palette;
+using namespace muse;
+
+class Palette_PaletteCellIconCacheTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_configuration = std::make_shared<NiceMock<PaletteConfigurationMock> >();
+        ON_CALL(*m_configuration, cellIconCacheDirPath()).WillByDefault(Return(io::path_t(m_dir.path())));
+
+        m_application = std::make_shared<NiceMock<ApplicationMock> >();
+        ON_CALL(*m_application, fullVersion()).WillByDefault(Return(Version(4, 4)));
+        ON_CALL(*m_application, revision()).WillByDefault(Return(String(u"abc")));
+    }
+
+    std::unique_ptr<PaletteCellIconCache> createCache()
+    {
+        std::unique_ptr<PaletteCellIconCache> cache = std::make_unique<PaletteCellIconCache>();
+        cache->configuration.set(m_configuration);
+        cache->application.set(m_application);
+        cache->init();
+
+        return cache;
+    }
+
+    static QImage makeIcon(const QColor& color)
+    {
+        QImage icon(16, 16, QImage::Format_ARGB32_Premultiplied);
+        icon.fill(color);
+        return icon;
+    }
+
+    //! NOTE The files are written and decoded on the background thread,
+    //! the decoded icons come back through the queue of the main thread
+    static QImage loadIcon(const PaletteCellIconCache& cache, const QByteArray& key)
+    {
+        TaskScheduler::instance(ThreadPriority::Background)->waitForAllTasksComplete();
+
+        bool isLoaded = false;
+        async::Asyncable receiver;
+        cache.iconsLoaded().onNotify(&receiver, [&isLoaded]() {
+            isLoaded = true;
+        });
+
+        bool isLoading = false;
+        QImage icon = cache.icon(key, isLoading);
+        if (!isLoading) {
+            return icon;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!isLoaded && std::chrono::steady_clock::now() < deadline) {
+            QCoreApplication::processEvents();
+            async::processEvents();
+        }
+
+        icon = cache.icon(key, isLoading);
+        EXPECT_FALSE(isLoading);
+
+        return icon;
+    }
+
+    QTemporaryDir m_dir;
+    std::shared_ptr<NiceMock<PaletteConfigurationMock> > m_configuration;
+    std::shared_ptr<NiceMock<ApplicationMock> > m_application;
+};
+
+TEST_F(Palette_PaletteCellIconCacheTests, CellIconKey_ChangesWithEverythingTheIconDependsOn)
+{
+    //! [GIVEN] A cell and its key
+    PaletteCell cell;
+    const QByteArray cellData = "<Cell/>";
+    const QSize size(40, 40);
+
+    auto key = [&](qreal extraMag, qreal devicePixelRatio, const QColor& elementsColor) {
+        return PaletteCellIconEngine::cellIconKey(cell, cellData, extraMag, size, 96.0, devicePixelRatio, 1.7, elementsColor);
+    };
+
+    const QByteArray origin = key(1.0, 1.0, Qt::black);
+
+    //! [THEN] The same cell gives the same key
+    EXPECT_EQ(key(1.0, 1.0, Qt::black), origin);
+
+    //! [THEN] The magnification, the device pixel ratio and the elements color change the key
+    EXPECT_NE(key(1.5, 1.0, Qt::black), origin);
+    EXPECT_NE(key(1.0, 2.0, Qt::black), origin);
+    EXPECT_NE(key(1.0, 1.0, Qt::white), origin);
+
+    //! [THEN] So do the magnification of the cell and its data
+    cell.mag = 2.0;
+    EXPECT_NE(key(1.0, 1.0, Qt::black), origin);
+
+    cell.mag = 1.0;
+    EXPECT_EQ(key(1.0, 1.0, Qt::black), origin);
+    EXPECT_NE(PaletteCellIconEngine::cellIconKey(cell, "<Cell name=\"other\"/>", 1.0, size, 96.0, 1.0, 1.7, Qt::black), origin);
+}
+
+TEST_F(Palette_PaletteCellIconCacheTests, SetIcon_RoundTripThroughDisk)
+{
+    //! [GIVEN] An icon is set
+    const QImage icon = makeIcon(Qt::red);
+    createCache()->setIcon("key", icon);
+
+    //! [WHEN] Another instance of the app asks for it
+    std::unique_ptr<PaletteCellIconCache> cache = createCache();
+
+    //! [THEN] It is loaded from the disk, in the background
+    const QImage loaded = loadIcon(*cache, "key");
+    ASSERT_FALSE(loaded.isNull());
+    EXPECT_EQ(loaded.convertToFormat(icon.format()), icon);
+
+    //! [THEN] Then it is in memory
+    bool isLoading = true;
+    EXPECT_FALSE(cache->icon("key", isLoading).isNull());
+    EXPECT_FALSE(isLoading);
+}
+
+TEST_F(Palette_PaletteCellIconCacheTests, Icon_Missing_NotLoadingOnceLookedUp)
+{
+    std::unique_ptr<PaletteCellIconCache> cache = createCache();
+
+    //! [WHEN] An icon is not on the disk
+    EXPECT_TRUE(loadIcon(*cache, "missing").isNull());
+
+    //! [THEN] It is not looked up again, it is to be rendered
+    bool isLoading = true;
+    EXPECT_TRUE(cache->icon("missing", isLoading).isNull());
+    EXPECT_FALSE(isLoading);
+
+    //! [WHEN] It is rendered
+    cache->setIcon("missing", makeIcon(Qt::blue));
+
+    //! [THEN] It is there
+    EXPECT_FALSE(cache->icon("missing", isLoading).isNull());
+}
+
+TEST_F(Palette_PaletteCellIconCacheTests, Revision_Changed_IconsNotReused)
+{
+    //! [GIVEN] An icon is set by a build
+    createCache()->setIcon("key", makeIcon(Qt::red));
+
+    //! [WHEN] Another build asks for it
+    ON_CALL(*m_application, revision()).WillByDefault(Return(String(u"def")));
+    std::unique_ptr<PaletteCellIconCache> cache = createCache();
+
+    //! [THEN] It is not found
+    EXPECT_TRUE(loadIcon(*cache, "key").isNull());
+}
+
+TEST_F(Palette_PaletteCellIconCacheTests, PruneDir_OldestIconsRemoved)
+{
+    //! [GIVEN] Icons written at different times, and another file
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < 5; ++i) {
+        QFile file(m_dir.filePath(QString("%1.png").arg(i)));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("png");
+        ASSERT_TRUE(file.setFileTime(now.addSecs(-60 * i), QFileDevice::FileModificationTime));
+    }
+
+    QFile other(m_dir.filePath("other.txt"));
+    ASSERT_TRUE(other.open(QIODevice::WriteOnly));
+    other.close();
+
+    //! [WHEN] The dir is pruned
+    PaletteCellIconCache::pruneDir(m_dir.path(), 3);
+
+    //! [THEN] Only the newest icons are left, the other file is kept
+    const QStringList expected = { "0.png", "1.png", "2.png", "other.txt" };
+    EXPECT_EQ(QDir(m_dir.path()).entryList(QDir::Files, QDir::Name), expected);
+}
@@ -57,6 +57,13 @@ PaletteTreeModel::PaletteTreeModel(PaletteTreePtr tree, QObject* parent)
     configuration()->colorsChanged().onNotify(this, [this]() {
         notifyAboutCellsChanged(Qt::DecorationRole);
     });
+
+    //! NOTE The icons loaded from the disk are painted by the new icon engines
+    if (iconCache()) {
+        iconCache()->iconsLoaded().onNotify(this, [this]() {
+            notifyAboutCellsChanged(Qt::DecorationRole);
+        });
+    }
 }
 
 //---------------------------------------------------------
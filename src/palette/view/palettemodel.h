@@ -30,6 +30,7 @@
 
 #include "modularity/ioc.h"
 #include "ipaletteconfiguration.h"
+#include "internal/ipalettecelliconcache.h"
 #include "async/asyncable.h"
 
 namespace mu::engraving {
@@ -103,6 +104,7 @@ class PaletteTreeModel : public QAbstractItemModel, public muse::async::Asyncabl
     Q_OBJECT
 
     INJECT(IPaletteConfiguration, configuration)
+    INJECT(IPaletteCellIconCache, iconCache)
 
 public:
     enum PaletteTreeModelRoles {
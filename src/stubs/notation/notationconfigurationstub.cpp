@@ -377,6 +377,21 @@ void NotationConfigurationStub::setNotePlayDurationMilliseconds(int)
 {
 }
 
+int NotationConfigurationStub::undoHistoryMemoryLimitMb() const
+{
+    return 0;
+}
+
+void NotationConfigurationStub::setUndoHistoryMemoryLimitMb(int)
+{
+}
+
+muse::async::Notification NotationConfigurationStub::undoHistoryMemoryLimitMbChanged() const
+{
+    static muse::async::Notification n;
+    return n;
+}
+
 void NotationConfigurationStub::setTemplateModeEnabled(std::optional<bool>)
 {
 }
@@ -142,6 +142,10 @@ public:
     int notePlayDurationMilliseconds() const override;
     void setNotePlayDurationMilliseconds(int durationMs)  override;
 
+    int undoHistoryMemoryLimitMb() const override;
+    void setUndoHistoryMemoryLimitMb(int limitMb) override;
+    muse::async::Notification undoHistoryMemoryLimitMbChanged() const override;
+
     void setTemplateModeEnabled(std::optional<bool> enabled) override;
     void setTestModeEnabled(std::optional<bool> enabled) override;
 
@@ -91,6 +91,11 @@ muse::io::path_t PaletteConfigurationStub::timeSignaturesDirPath() const
     return muse::io::path_t();
 }
 
+muse::io::path_t PaletteConfigurationStub::cellIconCacheDirPath() const
+{
+    return muse::io::path_t();
+}
+
 bool PaletteConfigurationStub::useFactorySettings() const
 {
     return false;
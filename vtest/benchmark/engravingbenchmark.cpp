@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "engravingbenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QBuffer>
+#include <QImage>
+#include <QJsonArray>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPdfWriter>
+
+#include "global/io/buffer.h"
+
+#include "draw/painter.h"
+
+#include "engraving/compat/scoreaccess.h"
+#include "engraving/infrastructure/localfileinfoprovider.h"
+#include "engraving/infrastructure/mscio.h"
+#include "engraving/rw/mscloader.h"
+#include "engraving/rw/rwregister.h"
+#include "engraving/dom/chord.h"
+#include "engraving/dom/masterscore.h"
+#include "engraving/dom/measure.h"
+#include "engraving/dom/mscore.h"
+#include "engraving/dom/note.h"
+#include "engraving/dom/segment.h"
+#include "engraving/playback/playbackmodel.h"
+
+#include "importexport/midi/internal/midiexport/exportmidi.h"
+
+#include "memorycounters.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::draw;
+using namespace mu::engraving;
+using namespace mu::vtest;
+
+EngravingBenchmark::EngravingBenchmark(const Options& options)
+    : m_options(options)
+{
+    m_options.repeat = std::max(m_options.repeat, 1);
+}
+
+QJsonObject EngravingBenchmark::run(const QString& name, const muse::io::path_t& path)
+{
+    LOGI() << "benchmark: " << name;
+
+    QJsonObject result;
+    result["name"] = name;
+
+    QJsonObject stages;
+
+    // load
+    MasterScore* score = nullptr;
+    bool loaded = false;
+    stages["load"] = measure([&]() {
+        delete score;
+        score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+        loaded = loadScore(score, path);
+        return loaded;
+    });
+
+    if (!loaded) {
+        LOGE() << "failed load score: " << path;
+        delete score;
+        result["ok"] = false;
+        result["stages"] = stages;
+        return result;
+    }
+
+    // full layout
+    stages["layout"] = measure([score]() {
+        score->doLayout();
+        return true;
+    });
+
+    // same as ScoreRW::readScore, the repeat list may be out of date after the load
+    score->setPlaylistDirty();
+
+    result["pages"] = static_cast<int>(score->npages());
+    result["measures"] = static_cast<int>(score->nmeasures());
+
+    // the relayout after a single note edit, undone after every run
+    Note* note = findNoteToEdit(score);
+    if (note) {
+        stages["editRelayout"] = measure([score, note]() {
+            score->select(note);
+            score->startCmd();
+            score->upDown(true, UpDownMode::CHROMATIC);
+            score->endCmd();
+            return true;
+        }, [score]() {
+            score->undoRedo(true, nullptr);
+            return true;
+        });
+    }
+
+    // save
+    stages["save"] = measure([score]() {
+        io::Buffer buffer;
+        buffer.open(io::IODevice::WriteOnly);
+        return rw::RWRegister::writer()->writeScore(score, &buffer, false);
+    });
+
+    // paint
+    stages["paintPng"] = measure([this, score]() {
+        return paintPng(score);
+    });
+
+    stages["paintPdf"] = measure([this, score]() {
+        return paintPdf(score);
+    });
+
+    // midi export
+    stages["exportMidi"] = measure([score]() {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+
+        iex::midi::ExportMidi exporter(score);
+        return exporter.write(&buffer, true, true);
+    });
+
+    // playback model, destroyed out of the measure
+    std::optional<PlaybackModel> playbackModel;
+    stages["playbackModelLoad"] = measure([score, &playbackModel]() {
+        playbackModel.emplace();
+        playbackModel->load(score);
+        return true;
+    }, [&playbackModel]() {
+        playbackModel.reset();
+        return true;
+    });
+
+    delete score;
+
+    result["ok"] = true;
+    result["stages"] = stages;
+
+    return result;
+}
+
+QJsonObject EngravingBenchmark::measure(const Func& func, const Func& after) const
+{
+    std::vector<double> times;
+    AllocationCount allocations;
+    const uint64_t peakRssBefore = peakRssKb();
+
+    for (int i = 0; i < m_options.repeat; ++i) {
+        const AllocationCount allocationsBefore = allocationCount();
+        const auto start = std::chrono::steady_clock::now();
+
+        const bool ok = func();
+
+        const auto end = std::chrono::steady_clock::now();
+        allocations = allocationCount() - allocationsBefore;
+
+        if (after) {
+            after();
+        }
+
+        if (!ok) {
+            return QJsonObject { { "ok", false } };
+        }
+
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+
+    QJsonObject result;
+    result["ok"] = true;
+    result["minMs"] = times.front();
+    result["medianMs"] = times.at(times.size() / 2);
+    result["allocations"] = static_cast<qint64>(allocations.count);
+    result["allocatedBytes"] = static_cast<qint64>(allocations.bytes);
+    result["peakRssGrowthKb"] = static_cast<qint64>(peakRssKb() - peakRssBefore);
+
+    return result;
+}
+
+bool EngravingBenchmark::loadScore(MasterScore* score, const muse::io::path_t& path) const
+{
+    TRACEFUNC;
+
+    score->setFileInfoProvider(std::make_shared<LocalFileInfoProvider>(path));
+
+    std::string suffix = io::suffix(path);
+    if (!isMuseScoreFile(suffix)) {
+        NOT_SUPPORTED;
+        return false;
+    }
+
+    MscReader::Params params;
+    params.filePath = path;
+    params.mode = mscIoModeBySuffix(suffix);
+
+    MscReader reader(params);
+    if (!reader.open()) {
+        return false;
+    }
+
+    MscLoader scoreReader;
+    SettingsCompat settingsCompat;
+    Ret ret = scoreReader.loadMscz(score, reader, settingsCompat, true);
+    if (!ret) {
+        LOGE() << "failed read file: " << path << ", err: " << ret.toString();
+        return false;
+    }
+
+    return true;
+}
+
+Note* EngravingBenchmark::findNoteToEdit(MasterScore* score) const
+{
+    //! NOTE A note in the middle of the score, so that the edit is not at the edge of the layout
+    const size_t middle = score->nmeasures() / 2;
+
+    size_t idx = 0;
+    for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure(), ++idx) {
+        if (idx < middle) {
+            continue;
+        }
+
+        for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+            EngravingItem* item = s->element(0);
+            if (item && item->isChord()) {
+                return toChord(item)->upNote();
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+bool EngravingBenchmark::paintPng(MasterScore* score) const
+{
+    const SizeF pageSizeInch = scoreRenderer()->pageSizeInch(score);
+
+    const int width = std::lrint(pageSizeInch.width() * m_options.pngDpi);
+    const int height = std::lrint(pageSizeInch.height() * m_options.pngDpi);
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.setDotsPerMeterX(std::lrint((m_options.pngDpi * 1000) / INCH));
+    image.setDotsPerMeterY(std::lrint((m_options.pngDpi * 1000) / INCH));
+
+    //! NOTE Every page is painted into the same image, the encoding of the PNG is not measured
+    for (size_t page = 0; page < score->npages(); ++page) {
+        image.fill(Qt::white);
+
+        Painter painter(&image, "vtest_benchmark");
+
+        rendering::IScoreRenderer::PaintOptions opt;
+        opt.fromPage = static_cast<int>(page);
+        opt.toPage = static_cast<int>(page);
+        opt.deviceDpi = m_options.pngDpi;
+        opt.printPageBackground = false;
+        opt.isSetViewport = true;
+        opt.isMultiPage = false;
+        opt.isPrinting = true;
+
+        scoreRenderer()->paintScore(&painter, score, opt);
+
+        painter.endDraw();
+    }
+
+    return true;
+}
+
+bool EngravingBenchmark::paintPdf(MasterScore* score) const
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    const SizeF pageSizeInch = scoreRenderer()->pageSizeInch(score);
+
+    QPdfWriter pdfWriter(&buffer);
+    pdfWriter.setPageMargins(QMarginsF());
+    pdfWriter.setPageLayout(QPageLayout(QPageSize(pageSizeInch.toQSizeF(), QPageSize::Inch), QPageLayout::Orientation::Portrait,
+                                        QMarginsF()));
+
+    Painter painter(&pdfWriter, "vtest_benchmark");
+    if (!painter.isActive()) {
+        return false;
+    }
+
+    rendering::IScoreRenderer::PaintOptions opt;
+    opt.deviceDpi = pdfWriter.logicalDpiX();
+    opt.isSetViewport = true;
+    opt.isMultiPage = false;
+    opt.isPrinting = true;
+    opt.onNewPage = [&pdfWriter]() { pdfWriter.newPage(); };
+
+    scoreRenderer()->paintScore(&painter, score, opt);
+
+    painter.endDraw();
+
+    return !data.isEmpty();
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_VTEST_ENGRAVINGBENCHMARK_H
+#define MU_VTEST_ENGRAVINGBENCHMARK_H
+
+#include <functional>
+
+#include <QJsonObject>
+
+#include "global/io/path.h"
+#include "modularity/ioc.h"
+#include "engraving/rendering/iscorerenderer.h"
+
+namespace mu::engraving {
+class MasterScore;
+class Note;
+}
+
+namespace mu::vtest {
+//! NOTE Measures, one by one, the stages a score goes through:
+//! load, full layout, the relayout after a single note edit, save,
+//! painting to PNG and PDF, MIDI export and the load of the playback model
+class EngravingBenchmark
+{
+    INJECT(engraving::rendering::IScoreRenderer, scoreRenderer)
+
+public:
+    struct Options {
+        int repeat = 3;
+        int pngDpi = 150;
+    };
+
+    explicit EngravingBenchmark(const Options& options);
+
+    //! NOTE The result of every stage: the min and median time, and the allocations and the peak RSS of the last run
+    QJsonObject run(const QString& name, const muse::io::path_t& path);
+
+private:
+    using Func = std::function<bool ()>;
+
+    QJsonObject measure(const Func& func, const Func& after = nullptr) const;
+
+    bool loadScore(engraving::MasterScore* score, const muse::io::path_t& path) const;
+    engraving::Note* findNoteToEdit(engraving::MasterScore* score) const;
+
+    bool paintPng(engraving::MasterScore* score) const;
+    bool paintPdf(engraving::MasterScore* score) const;
+
+    Options m_options;
+};
+}
+
+#endif // MU_VTEST_ENGRAVINGBENCHMARK_H
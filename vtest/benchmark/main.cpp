@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+
+#include "global/runtime.h"
+#include "testing/environment.h"
+
+#include "draw/drawmodule.h"
+#include "mpe/mpemodule.h"
+#include "engraving/engravingmodule.h"
+#include "engraving/dom/engravingitem.h"
+#include "engraving/dom/instrtemplate.h"
+#include "engraving/dom/mscore.h"
+
+#include "engraving/tests/mocks/engravingconfigurationmock.h"
+
+#include "engravingbenchmark.h"
+#include "memorycounters.h"
+#include "syntheticscores.h"
+
+#include "log.h"
+
+using namespace mu::vtest;
+
+static const QString DEFAULT_SCORES_DIR(VTEST_ROOT_DIR "/scores");
+
+static void setupEnvironment()
+{
+    //! NOTE Same as the environment of the engraving tests, but not in the test mode,
+    //! the scores are read the same way the application does
+    muse::testing::Environment::setDependency({
+        new muse::draw::DrawModule(),
+        new muse::mpe::MpeModule(),
+        new mu::engraving::EngravingModule()
+    });
+
+    muse::testing::Environment::setPostInit([]() {
+        mu::engraving::MScore::noGui = true;
+
+        mu::engraving::loadInstrumentTemplates(":/data/instruments.xml");
+
+        std::shared_ptr<::testing::NiceMock<mu::engraving::EngravingConfigurationMock> > configurator
+            = std::make_shared<::testing::NiceMock<mu::engraving::EngravingConfigurationMock> >();
+        ON_CALL(*configurator, isAccessibleEnabled()).WillByDefault(::testing::Return(false));
+        ON_CALL(*configurator, defaultColor()).WillByDefault(::testing::Return(muse::draw::Color::BLACK));
+        mu::engraving::EngravingItem::engravingConfiguration.set(configurator);
+    });
+
+    muse::testing::Environment::setDeInit([]() {
+        mu::engraving::EngravingItem::engravingConfiguration.set(nullptr);
+    });
+
+    muse::testing::Environment::setup();
+}
+
+int main(int argc, char** argv)
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the engraving stages on the vtest scores and writes the results as JSON");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("scores", "Directory of the scores", "dir", DEFAULT_SCORES_DIR));
+    parser.addOption(QCommandLineOption("filter", "Only the scores whose file name matches", "regexp"));
+    parser.addOption(QCommandLineOption("repeat", "Number of runs of every stage", "count", "3"));
+    parser.addOption(QCommandLineOption("dpi", "Resolution of the PNG painting", "dpi", "150"));
+    parser.addOption(QCommandLineOption("no-synthetic", "Skip the generated large scores"));
+    parser.addOption(QCommandLineOption({ "o", "output" }, "Output JSON file", "file", "benchmark.json"));
+    parser.process(app);
+
+    muse::runtime::mainThreadId(); //! NOTE Needs only call
+    muse::runtime::setThreadName("main");
+
+    setupEnvironment();
+
+    EngravingBenchmark::Options options;
+    options.repeat = parser.value("repeat").toInt();
+    options.pngDpi = parser.value("dpi").toInt();
+
+    EngravingBenchmark benchmark(options);
+
+    std::vector<std::pair<QString, QString> > scores;
+
+    const QRegularExpression filter(parser.value("filter"));
+    const QDir scoresDir(parser.value("scores"));
+    for (const QString& file : scoresDir.entryList({ "*.mscx", "*.mscz" }, QDir::Files, QDir::Name)) {
+        if (filter.match(file).hasMatch()) {
+            scores.push_back({ file, scoresDir.absoluteFilePath(file) });
+        }
+    }
+
+    QTemporaryDir syntheticDir;
+    if (!parser.isSet("no-synthetic") && syntheticDir.isValid()) {
+        for (const SyntheticScore& synthetic : defaultSyntheticScores()) {
+            const QString file = synthetic.name + ".mscx";
+            if (!filter.match(file).hasMatch()) {
+                continue;
+            }
+
+            QFile out(syntheticDir.filePath(file));
+            if (!out.open(QIODevice::WriteOnly) || out.write(generateSyntheticScore(synthetic)) < 0) {
+                LOGE() << "failed write synthetic score: " << out.fileName();
+                continue;
+            }
+
+            scores.push_back({ file, out.fileName() });
+        }
+    }
+
+    QJsonArray results;
+    int failed = 0;
+    for (size_t i = 0; i < scores.size(); ++i) {
+        LOGI() << (i + 1) << "/" << scores.size() << " " << scores[i].first;
+
+        QJsonObject result = benchmark.run(scores[i].first, scores[i].second);
+        if (!result["ok"].toBool()) {
+            ++failed;
+        }
+
+        results.append(result);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["repeat"] = options.repeat;
+    root["pngDpi"] = options.pngDpi;
+    root["scores"] = results;
+    root["peakRssKb"] = static_cast<qint64>(peakRssKb());
+
+    QFile outFile(parser.value("output"));
+    if (!outFile.open(QIODevice::WriteOnly)) {
+        LOGE() << "failed open output file: " << outFile.fileName();
+        return 1;
+    }
+
+    outFile.write(QJsonDocument(root).toJson());
+    outFile.close();
+
+    LOGI() << "scores: " << scores.size() << ", failed: " << failed << ", output: " << outFile.fileName();
+
+    muse::testing::Environment::deinit();
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "memorycounters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace mu::vtest;
+
+static std::atomic<uint64_t> s_allocCount = 0;
+static std::atomic<uint64_t> s_allocBytes = 0;
+
+static void* countedAlloc(std::size_t size)
+{
+    s_allocCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return std::malloc(size ? size : 1);
+}
+
+//! NOTE The over-aligned types (alignas above the default) go through these,
+//! their memory is released with alignedFree
+static void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment)
+{
+    s_allocCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+
+    const std::size_t align = static_cast<std::size_t>(alignment);
+
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, std::max(align, sizeof(void*)), size ? size : 1) != 0) {
+        return nullptr;
+    }
+    return p;
+#endif
+}
+
+static void alignedFree(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* p = countedAlignedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    void* p = countedAlignedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    alignedFree(p);
+}
+
+AllocationCount mu::vtest::allocationCount()
+{
+    return { s_allocCount.load(std::memory_order_relaxed), s_allocBytes.load(std::memory_order_relaxed) };
+}
+
+uint64_t mu::vtest::peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // bytes on macOS
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
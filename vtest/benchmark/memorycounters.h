@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_VTEST_MEMORYCOUNTERS_H
+#define MU_VTEST_MEMORYCOUNTERS_H
+
+#include <cstdint>
+
+namespace mu::vtest {
+//! NOTE Counts the calls of the global operator new of the process.
+//! The memory Qt containers take with malloc directly is not counted
+struct AllocationCount {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+
+    AllocationCount operator-(const AllocationCount& other) const
+    {
+        return { count - other.count, bytes - other.bytes };
+    }
+};
+
+AllocationCount allocationCount();
+
+//! NOTE The high water mark of the resident set of the process, in kilobytes, 0 if unknown.
+//! It never goes down: the difference over a stage is how much the stage raised it
+uint64_t peakRssKb();
+}
+
+#endif // MU_VTEST_MEMORYCOUNTERS_H
@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "syntheticscores.h"
+
+#include <algorithm>
+
+#include <QXmlStreamWriter>
+
+using namespace mu::vtest;
+
+// tpc of every pitch class, spelled with sharps
+static const int PITCH_CLASS_TPC[12] = { 14, 21, 16, 23, 18, 13, 20, 15, 22, 17, 24, 19 };
+
+// the notes of every measure cycle through these patterns
+static const std::vector<std::vector<const char*> > MEASURE_PATTERNS = {
+    { "quarter", "eighth", "eighth", "half" },
+    { "eighth", "eighth", "eighth", "eighth", "eighth", "eighth", "eighth", "eighth" },
+    { "half", "quarter", "quarter" },
+    { "whole" },
+};
+
+std::vector<SyntheticScore> mu::vtest::defaultSyntheticScores()
+{
+    return {
+        { "synthetic-solo-1000", 1, 1000 },
+        { "synthetic-ensemble-16x300", 16, 300 },
+    };
+}
+
+static void writeNote(QXmlStreamWriter& xml, int pitch)
+{
+    xml.writeStartElement("Note");
+    xml.writeTextElement("pitch", QString::number(pitch));
+    xml.writeTextElement("tpc", QString::number(PITCH_CLASS_TPC[pitch % 12]));
+    xml.writeEndElement();
+}
+
+static void writePart(QXmlStreamWriter& xml, int partIdx, bool bassClef)
+{
+    const QString name = QString("Piano %1").arg(partIdx + 1);
+
+    xml.writeStartElement("Part");
+    xml.writeAttribute("id", QString::number(partIdx + 1));
+
+    xml.writeStartElement("Staff");
+    xml.writeAttribute("id", QString::number(partIdx + 1));
+    xml.writeStartElement("StaffType");
+    xml.writeAttribute("group", "pitched");
+    xml.writeTextElement("name", "stdNormal");
+    xml.writeEndElement();
+    if (bassClef) {
+        xml.writeTextElement("defaultClef", "F");
+    }
+    xml.writeEndElement();
+
+    xml.writeTextElement("trackName", name);
+
+    xml.writeStartElement("Instrument");
+    xml.writeAttribute("id", "piano");
+    xml.writeTextElement("longName", name);
+    xml.writeTextElement("shortName", QString("Pno. %1").arg(partIdx + 1));
+    xml.writeTextElement("trackName", name);
+    xml.writeTextElement("minPitchP", "21");
+    xml.writeTextElement("maxPitchP", "108");
+    xml.writeTextElement("minPitchA", "21");
+    xml.writeTextElement("maxPitchA", "108");
+    xml.writeTextElement("instrumentId", "keyboard.piano");
+    xml.writeStartElement("Channel");
+    xml.writeEmptyElement("program");
+    xml.writeAttribute("value", "0");
+    xml.writeEndElement();
+    xml.writeEndElement();
+
+    xml.writeEndElement();
+}
+
+static void writeStaff(QXmlStreamWriter& xml, int partIdx, int measures, int basePitch, bool bassClef)
+{
+    xml.writeStartElement("Staff");
+    xml.writeAttribute("id", QString::number(partIdx + 1));
+
+    for (int m = 0; m < measures; ++m) {
+        xml.writeStartElement("Measure");
+        xml.writeStartElement("voice");
+
+        if (m == 0) {
+            if (bassClef) {
+                xml.writeStartElement("Clef");
+                xml.writeTextElement("concertClefType", "F");
+                xml.writeTextElement("transposingClefType", "F");
+                xml.writeEndElement();
+            }
+
+            xml.writeStartElement("KeySig");
+            xml.writeTextElement("concertKey", "0");
+            xml.writeEndElement();
+
+            xml.writeStartElement("TimeSig");
+            xml.writeTextElement("sigN", "4");
+            xml.writeTextElement("sigD", "4");
+            xml.writeEndElement();
+        }
+
+        if (m % 8 == 0) {
+            xml.writeStartElement("Dynamic");
+            xml.writeTextElement("subtype", (m / 8) % 2 ? "p" : "f");
+            xml.writeEndElement();
+        }
+
+        const std::vector<const char*>& pattern = MEASURE_PATTERNS[m % MEASURE_PATTERNS.size()];
+        for (size_t n = 0; n < pattern.size(); ++n) {
+            const int pitch = basePitch + static_cast<int>((m * 3 + n * 2) % 12);
+
+            xml.writeStartElement("Chord");
+            xml.writeTextElement("durationType", pattern[n]);
+            writeNote(xml, pitch);
+
+            // a triad at the start of every other measure
+            if (n == 0 && m % 2 == 0) {
+                writeNote(xml, pitch + 4);
+                writeNote(xml, pitch + 7);
+            }
+
+            xml.writeEndElement();
+        }
+
+        xml.writeEndElement();
+        xml.writeEndElement();
+    }
+
+    xml.writeEndElement();
+}
+
+QByteArray mu::vtest::generateSyntheticScore(const SyntheticScore& score)
+{
+    QByteArray data;
+
+    QXmlStreamWriter xml(&data);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+
+    xml.writeStartElement("museScore");
+    xml.writeAttribute("version", "4.40");
+
+    xml.writeStartElement("Score");
+    xml.writeTextElement("Division", "480");
+
+    xml.writeStartElement("metaTag");
+    xml.writeAttribute("name", "workTitle");
+    xml.writeCharacters(score.name);
+    xml.writeEndElement();
+
+    std::vector<int> basePitches;
+    for (int p = 0; p < score.parts; ++p) {
+        // from the top down, the lower parts in the bass clef
+        const int basePitch = 72 - (p * 36) / std::max(score.parts, 1);
+        basePitches.push_back(basePitch);
+        writePart(xml, p, basePitch < 60);
+    }
+
+    for (int p = 0; p < score.parts; ++p) {
+        writeStaff(xml, p, score.measures, basePitches[p], basePitches[p] < 60);
+    }
+
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+
+    return data;
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_VTEST_SYNTHETICSCORES_H
+#define MU_VTEST_SYNTHETICSCORES_H
+
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+namespace mu::vtest {
+//! NOTE Large scores made of simple content, the vtest scores are all small
+struct SyntheticScore {
+    QString name;
+    int parts = 1;
+    int measures = 100;
+};
+
+std::vector<SyntheticScore> defaultSyntheticScores();
+
+//! NOTE Writes the score as mscx
+QByteArray generateSyntheticScore(const SyntheticScore& score);
+}
+
+#endif // MU_VTEST_SYNTHETICSCORES_H
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-only
+# MuseScore-Studio-CLA-applies
+#
+# MuseScore Studio
+# Music Composition & Notation
+#
+# Copyright (C) 2024 MuseScore Limited
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 3 as
+# published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+
+"""
+Compares the results of the engraving benchmark (vtest_benchmark) with a baseline
+and flags the stages which became slower or allocate more.
+
+    vtest-compare-benchmark.py --baseline baseline.json --current benchmark.json
+
+Exits with 1 if there is a regression.
+"""
+
+import argparse
+import json
+import shutil
+import sys
+
+STAGES = ["load", "layout", "editRelayout", "save", "paintPng", "paintPdf", "exportMidi", "playbackModelLoad"]
+
+
+def load_results(path):
+    with open(path, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    return {score["name"]: score for score in data.get("scores", [])}
+
+
+def compare_stage(name, stage, base, cur, args):
+    problems = []
+
+    if not cur.get("ok", False):
+        problems.append(f"{name}: {stage}: failed")
+        return problems
+
+    # the median is less noisy than the min on a busy machine, small absolute changes are noise anyway
+    base_ms = base.get("medianMs", 0.0)
+    cur_ms = cur.get("medianMs", 0.0)
+    if cur_ms - base_ms > args.min_ms and cur_ms > base_ms * (1.0 + args.time_threshold):
+        problems.append(f"{name}: {stage}: time {base_ms:.2f} ms -> {cur_ms:.2f} ms")
+
+    # the allocations are deterministic, any real growth is worth a look
+    base_allocs = base.get("allocations", 0)
+    cur_allocs = cur.get("allocations", 0)
+    if cur_allocs > base_allocs * (1.0 + args.alloc_threshold) and cur_allocs - base_allocs > args.min_allocs:
+        problems.append(f"{name}: {stage}: allocations {base_allocs} -> {cur_allocs}")
+
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare engraving benchmark results with a baseline")
+    parser.add_argument("--baseline", required=True, help="baseline results (JSON)")
+    parser.add_argument("--current", required=True, help="current results (JSON)")
+    parser.add_argument("--time-threshold", type=float, default=0.10, help="relative time growth to flag, default 0.10")
+    parser.add_argument("--min-ms", type=float, default=1.0, help="absolute time growth below which nothing is flagged, default 1 ms")
+    parser.add_argument("--alloc-threshold", type=float, default=0.02, help="relative allocation growth to flag, default 0.02")
+    parser.add_argument("--min-allocs", type=int, default=100, help="absolute allocation growth below which nothing is flagged")
+    parser.add_argument("--rss-threshold", type=float, default=0.10, help="relative growth of the peak RSS to flag, default 0.10")
+    parser.add_argument("--update-baseline", action="store_true", help="replace the baseline with the current results")
+    args = parser.parse_args()
+
+    if args.update_baseline:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+
+    problems = []
+    improvements = 0
+    for name, cur_score in sorted(current.items()):
+        base_score = baseline.get(name)
+        if base_score is None:
+            print(f"{name}: not in the baseline, skipped")
+            continue
+
+        if not cur_score.get("ok", False):
+            problems.append(f"{name}: failed")
+            continue
+
+        for stage in STAGES:
+            base_stage = base_score.get("stages", {}).get(stage)
+            cur_stage = cur_score.get("stages", {}).get(stage)
+            if base_stage is None or cur_stage is None:
+                continue
+
+            problems += compare_stage(name, stage, base_stage, cur_stage, args)
+
+            if cur_stage.get("medianMs", 0.0) < base_stage.get("medianMs", 0.0) * (1.0 - args.time_threshold):
+                improvements += 1
+
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name}: missing in the current results")
+
+    with open(args.baseline, "r", encoding="utf-8") as f:
+        base_rss = json.load(f).get("peakRssKb", 0)
+    with open(args.current, "r", encoding="utf-8") as f:
+        cur_rss = json.load(f).get("peakRssKb", 0)
+    if base_rss > 0 and cur_rss > base_rss * (1.0 + args.rss_threshold):
+        problems.append(f"peak RSS {base_rss} KB -> {cur_rss} KB")
+
+    for problem in problems:
+        print(f"REGRESSION {problem}")
+
+    print(f"Compared: {len(current)} scores, regressions: {len(problems)}, faster stages: {improvements}")
+
+    return 1 if problems else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())